@@ -0,0 +1,326 @@
+## @file
+# Decode the boot trace stream saved by the BootTraceInfo application.
+#
+# The stream carries the memory allocation events of the DXE core, the
+# performance measurements of DxeCorePerformanceLib and the image load events
+# on the same performance counter. This script maps the allocations to the
+# images and to the measurements open at the time, and reports allocation
+# storms, that is the busiest windows of allocations per image.
+#
+# Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+# This program and the accompanying materials
+# are licensed and made available under the terms and conditions of the BSD License
+# which accompanies this distribution.  The full text of the license may be found at
+# http://opensource.org/licenses/bsd-license.php
+#
+# THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+# WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+#
+
+from __future__ import print_function
+
+import sys
+import argparse
+import struct
+import uuid
+import bisect
+
+#
+# Globals for help information
+#
+__prog__        = 'BootTraceDecode'
+__version__     = '%s Version %s' % (__prog__, '0.1 ')
+__copyright__   = 'Copyright (c) 2017, Intel Corporation. All rights reserved.'
+__description__ = 'Decode the boot trace stream saved by the BootTraceInfo application.\n'
+
+#
+# Layout of MdeModulePkg/Include/Guid/BootTrace.h
+#
+BOOT_TRACE_HEADER_SIGNATURE   = 0x44485442   # 'BTHD'
+BOOT_TRACE_HEADER             = struct.Struct('<IHHQQQQII')
+BOOT_TRACE_RECORD_HEADER      = struct.Struct('<HH4xQ')
+BOOT_TRACE_MEMORY_RECORD      = struct.Struct('<QQQII')
+BOOT_TRACE_PERF_RECORD        = struct.Struct('<QII32s32s')
+BOOT_TRACE_IMAGE_RECORD       = struct.Struct('<16sQQQ')
+
+BOOT_TRACE_RECORD_TYPE_MEMORY       = 1
+BOOT_TRACE_RECORD_TYPE_PERF_START   = 2
+BOOT_TRACE_RECORD_TYPE_PERF_END     = 3
+BOOT_TRACE_RECORD_TYPE_IMAGE_LOAD   = 4
+BOOT_TRACE_RECORD_TYPE_IMAGE_UNLOAD = 5
+
+MEMORY_PROFILE_ACTION_BASIC_MASK          = 0x000F
+MEMORY_PROFILE_ACTION_EXTENSION_LIB_MASK  = 0x8000
+MEMORY_PROFILE_ACTION_ALLOCATE_PAGES      = 1
+MEMORY_PROFILE_ACTION_ALLOCATE_POOL       = 3
+
+class BootTraceError (Exception):
+  pass
+
+class Image (object):
+  def __init__ (self, FileName, ImageBase, ImageSize, EntryPoint, PdbString, LoadTime):
+    self.FileName   = FileName
+    self.ImageBase  = ImageBase
+    self.ImageSize  = ImageSize
+    self.EntryPoint = EntryPoint
+    self.PdbString  = PdbString
+    self.LoadTime   = LoadTime
+    self.UnloadTime = None
+    self.Events     = []
+
+  def Name (self):
+    if self.PdbString:
+      return self.PdbString.replace ('\\', '/').split ('/')[-1]
+    return str (self.FileName)
+
+  def Contains (self, Address, Time):
+    if Address < self.ImageBase or Address >= self.ImageBase + self.ImageSize:
+      return False
+    return self.UnloadTime is None or Time <= self.UnloadTime
+
+class Measurement (object):
+  def __init__ (self, Handle, Token, Module, Identifier, StartTime):
+    self.Handle     = Handle
+    self.Token      = Token
+    self.Module     = Module
+    self.Identifier = Identifier
+    self.StartTime  = StartTime
+    self.EndTime    = None
+    self.Count      = 0
+    self.Bytes      = 0
+
+  def Name (self):
+    Name = self.Token
+    if self.Module:
+      Name += ':' + self.Module
+    if self.Identifier:
+      Name += ' (0x%x)' % self.Identifier
+    return Name
+
+class MemoryEvent (object):
+  def __init__ (self, Time, CallerAddress, Buffer, Size, Action, MemoryType):
+    self.Time          = Time
+    self.CallerAddress = CallerAddress
+    self.Buffer        = Buffer
+    self.Size          = Size
+    self.Action        = Action
+    self.MemoryType    = MemoryType
+
+  def IsAllocate (self):
+    return (self.Action & MEMORY_PROFILE_ACTION_BASIC_MASK) in (MEMORY_PROFILE_ACTION_ALLOCATE_PAGES, MEMORY_PROFILE_ACTION_ALLOCATE_POOL)
+
+  def IsLibrary (self):
+    return (self.Action & MEMORY_PROFILE_ACTION_EXTENSION_LIB_MASK) != 0
+
+def CString (Buffer):
+  return Buffer.split (b'\0', 1)[0].decode ('ascii', 'replace')
+
+class BootTrace (object):
+  def __init__ (self, Buffer):
+    if len (Buffer) < BOOT_TRACE_HEADER.size:
+      raise BootTraceError ('stream is too short')
+    (Signature, Length, self.Revision, self.Frequency, self.TimerStartValue,
+     self.TimerEndValue, RecordSize, self.RecordCount, self.LostRecordCount) = BOOT_TRACE_HEADER.unpack_from (Buffer, 0)
+    if Signature != BOOT_TRACE_HEADER_SIGNATURE:
+      raise BootTraceError ('invalid signature 0x%08x' % Signature)
+    if Length + RecordSize > len (Buffer):
+      raise BootTraceError ('stream is truncated')
+    if self.Frequency == 0:
+      raise BootTraceError ('invalid performance counter frequency')
+
+    self.Images       = []
+    self.Measurements = []
+    self.MemoryEvents = []
+    self.UnknownCount = 0
+    self.UnpairedEnd  = 0
+
+    OpenMeasurements = {}
+    Offset = Length
+    End    = Length + RecordSize
+    while Offset + BOOT_TRACE_RECORD_HEADER.size <= End:
+      Type, RecordLength, TimeStamp = BOOT_TRACE_RECORD_HEADER.unpack_from (Buffer, Offset)
+      if RecordLength < BOOT_TRACE_RECORD_HEADER.size or Offset + RecordLength > End:
+        raise BootTraceError ('invalid record at offset 0x%x' % Offset)
+      Data = Offset + BOOT_TRACE_RECORD_HEADER.size
+      Time = self.TicksToNs (TimeStamp)
+      if Type == BOOT_TRACE_RECORD_TYPE_MEMORY:
+        self.MemoryEvents.append (MemoryEvent (Time, *BOOT_TRACE_MEMORY_RECORD.unpack_from (Buffer, Data)))
+      elif Type == BOOT_TRACE_RECORD_TYPE_PERF_START:
+        Handle, GaugeIndex, Identifier, Token, Module = BOOT_TRACE_PERF_RECORD.unpack_from (Buffer, Data)
+        Entry = Measurement (Handle, CString (Token), CString (Module), Identifier, Time)
+        OpenMeasurements[GaugeIndex] = Entry
+        self.Measurements.append (Entry)
+      elif Type == BOOT_TRACE_RECORD_TYPE_PERF_END:
+        Handle, GaugeIndex, Identifier, Token, Module = BOOT_TRACE_PERF_RECORD.unpack_from (Buffer, Data)
+        Entry = OpenMeasurements.pop (GaugeIndex, None)
+        if Entry is None:
+          self.UnpairedEnd += 1
+        else:
+          Entry.EndTime = Time
+      elif Type == BOOT_TRACE_RECORD_TYPE_IMAGE_LOAD:
+        FileName, ImageBase, ImageSize, EntryPoint = BOOT_TRACE_IMAGE_RECORD.unpack_from (Buffer, Data)
+        PdbString = CString (Buffer[Data + BOOT_TRACE_IMAGE_RECORD.size:Offset + RecordLength])
+        self.Images.append (Image (uuid.UUID (bytes_le = FileName), ImageBase, ImageSize, EntryPoint, PdbString, Time))
+      elif Type == BOOT_TRACE_RECORD_TYPE_IMAGE_UNLOAD:
+        FileName, ImageBase, ImageSize, EntryPoint = BOOT_TRACE_IMAGE_RECORD.unpack_from (Buffer, Data)
+        for Entry in reversed (self.Images):
+          if Entry.ImageBase == ImageBase and Entry.UnloadTime is None:
+            Entry.UnloadTime = Time
+            break
+      else:
+        self.UnknownCount += 1
+      Offset += RecordLength
+
+    self.Correlate ()
+
+  def TicksToNs (self, Ticks):
+    #
+    # The performance counter may count down.
+    #
+    if self.TimerEndValue >= self.TimerStartValue:
+      Delta = Ticks - self.TimerStartValue
+    else:
+      Delta = self.TimerStartValue - Ticks
+    return Delta * 1000000000 // self.Frequency
+
+  def FindImage (self, Event):
+    for Entry in reversed (self.Images):
+      if Entry.LoadTime <= Event.Time and Entry.Contains (Event.CallerAddress, Event.Time):
+        return Entry
+    return None
+
+  def FindMeasurement (self, Event):
+    #
+    # The innermost measurement open at the time of the event.
+    #
+    Found = None
+    for Entry in self.Measurements:
+      if Entry.StartTime > Event.Time:
+        break
+      if Entry.EndTime is None or Entry.EndTime < Event.Time:
+        continue
+      if Found is None or Entry.StartTime >= Found.StartTime:
+        Found = Entry
+    return Found
+
+  def Correlate (self):
+    self.Measurements.sort (key = lambda Entry: Entry.StartTime)
+    self.UnknownImage = Image (None, 0, 0, 0, '<unknown>', 0)
+    #
+    # Records appended through the protocol may carry their own time stamp, so
+    # the events are sorted for Storm () to search the events of each image.
+    #
+    self.MemoryEvents.sort (key = lambda Event: Event.Time)
+    for Event in self.MemoryEvents:
+      #
+      # The library level events of MemoryAllocationLib are followed by the
+      # core events for the same buffer, so only the core events are counted.
+      #
+      if Event.IsLibrary () or not Event.IsAllocate ():
+        continue
+      Entry = self.FindImage (Event)
+      if Entry is None:
+        Entry = self.UnknownImage
+      Entry.Events.append (Event)
+      Entry = self.FindMeasurement (Event)
+      if Entry is not None:
+        Entry.Count += 1
+        Entry.Bytes += Event.Size
+
+  def Storm (self, Events, Window):
+    #
+    # The window of Window ns with the most allocations.
+    #
+    Times = [Event.Time for Event in Events]
+    Best = (0, 0)
+    for Index, Time in enumerate (Times):
+      Count = bisect.bisect_right (Times, Time + Window) - Index
+      if Count > Best[0]:
+        Best = (Count, Time)
+    return Best
+
+def FormatNs (Ns):
+  return '%d.%03d ms' % (Ns // 1000000, (Ns // 1000) % 1000)
+
+if __name__ == '__main__':
+  #
+  # Create command line argument parser object
+  #
+  parser = argparse.ArgumentParser(prog = __prog__,
+                                   description = __description__ + __copyright__,
+                                   conflict_handler = 'resolve')
+  parser.add_argument("--version", action = 'version', version = __version__)
+  parser.add_argument("-i", "--input", dest = 'InputFile', type = argparse.FileType('rb'),
+                      help = "Boot trace file saved by BootTraceInfo", required = True)
+  parser.add_argument("-w", "--window", dest = 'Window', type = float, default = 1.0,
+                      help = "Allocation storm window in ms.  Default is 1 ms.")
+  parser.add_argument("-n", "--top", dest = 'Top', type = int, default = 20,
+                      help = "Number of measurements and images to report.  Default is 20.")
+  parser.add_argument("-t", "--timeline", dest = 'Timeline', action = "store_true",
+                      help = "Print the merged timeline of all records")
+
+  #
+  # Parse command line arguments
+  #
+  args = parser.parse_args()
+
+  try:
+    Buffer = args.InputFile.read()
+    args.InputFile.close()
+    Trace = BootTrace (Buffer)
+  except (IOError, struct.error, BootTraceError) as Error:
+    print ('BootTraceDecode: error: %s' % Error)
+    sys.exit(1)
+
+  print ('Frequency       : %d Hz' % Trace.Frequency)
+  print ('Records         : %d' % Trace.RecordCount)
+  print ('Lost records    : %d' % Trace.LostRecordCount)
+  print ('Images          : %d' % len (Trace.Images))
+  print ('Measurements    : %d' % len (Trace.Measurements))
+  print ('Memory events   : %d' % len (Trace.MemoryEvents))
+  if Trace.UnpairedEnd or Trace.UnknownCount:
+    print ('Unpaired ends   : %d' % Trace.UnpairedEnd)
+    print ('Unknown records : %d' % Trace.UnknownCount)
+  if Trace.LostRecordCount:
+    print ('warning: the trace buffer was full, increase PcdBootTraceBufferSize')
+
+  if args.Timeline:
+    print ('')
+    print ('==== Timeline ====')
+    Lines = []
+    for Entry in Trace.Images:
+      Lines.append ((Entry.LoadTime, 'Load      %s @ 0x%x' % (Entry.Name (), Entry.ImageBase)))
+      if Entry.UnloadTime is not None:
+        Lines.append ((Entry.UnloadTime, 'Unload    %s @ 0x%x' % (Entry.Name (), Entry.ImageBase)))
+    for Entry in Trace.Measurements:
+      Lines.append ((Entry.StartTime, 'Start     %s' % Entry.Name ()))
+      if Entry.EndTime is not None:
+        Lines.append ((Entry.EndTime, 'End       %s' % Entry.Name ()))
+    for Event in Trace.MemoryEvents:
+      Lines.append ((Event.Time, 'Memory    action 0x%x type 0x%x size 0x%x buffer 0x%x caller 0x%x' %
+                     (Event.Action, Event.MemoryType, Event.Size, Event.Buffer, Event.CallerAddress)))
+    Lines.sort (key = lambda Line: Line[0])
+    for Time, Text in Lines:
+      print ('%14s  %s' % (FormatNs (Time), Text))
+
+  print ('')
+  print ('==== Allocations per measurement ====')
+  Measurements = [Entry for Entry in Trace.Measurements if Entry.Count]
+  Measurements.sort (key = lambda Entry: Entry.Bytes, reverse = True)
+  for Entry in Measurements[:args.Top]:
+    Duration = Entry.EndTime - Entry.StartTime
+    print ('%14s %8d allocations %12d bytes  %s' % (FormatNs (Duration), Entry.Count, Entry.Bytes, Entry.Name ()))
+
+  print ('')
+  print ('==== Allocation storms per image (window %s ms) ====' % args.Window)
+  Window = int (args.Window * 1000000)
+  Storms = []
+  for Entry in Trace.Images + [Trace.UnknownImage]:
+    if Entry.Events:
+      Count, Time = Trace.Storm (Entry.Events, Window)
+      Storms.append ((Count, Time, Entry))
+  Storms.sort (key = lambda Storm: Storm[0], reverse = True)
+  for Count, Time, Entry in Storms[:args.Top]:
+    Bytes = sum ([Event.Size for Event in Entry.Events])
+    print ('%8d allocations at %14s  (%d allocations, %d bytes in total)  %s' %
+           (Count, FormatNs (Time), len (Entry.Events), Bytes, Entry.Name ()))
@@ -0,0 +1,197 @@
+## @file
+# Time VfrCompile over the preprocessed VFR files of a build, or over a
+# generated VFR of a given size, and optionally compare against another
+# VfrCompile binary.
+#
+# Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+# This program and the accompanying materials
+# are licensed and made available under the terms and conditions of the BSD License
+# which accompanies this distribution.  The full text of the license may be found at
+# http://opensource.org/licenses/bsd-license.php
+#
+# THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+# WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+#
+
+'''
+VfrCompileBenchmark
+'''
+
+import os
+import sys
+import argparse
+import filecmp
+import shutil
+import subprocess
+import tempfile
+import time
+
+#
+# Globals for help information
+#
+__prog__        = 'VfrCompileBenchmark'
+__version__     = '%s Version %s' % (__prog__, '0.1 ')
+__copyright__   = 'Copyright (c) 2017, Intel Corporation. All rights reserved.'
+__description__ = 'Time VfrCompile over the preprocessed VFR files of a build.\n'
+
+#
+# The build preprocesses every VFR file into $(OUTPUT_DIR)/<name>.i and the
+# string package of the module is $(OUTPUT_DIR)/<module>StrDefs.hpk.
+#
+def FindVfrFiles (PathList):
+  VfrList = []
+  for Path in PathList:
+    if os.path.isfile (Path):
+      VfrList.append (Path)
+      continue
+    for Root, Dirs, Files in os.walk (Path):
+      for File in Files:
+        if not File.endswith ('.i'):
+          continue
+        FullPath = os.path.join (Root, File)
+        with open (FullPath, 'rb') as Fd:
+          if 'formset' not in Fd.read ():
+            continue
+        VfrList.append (FullPath)
+  return sorted (VfrList)
+
+def FindStringDb (VfrFile):
+  Dir = os.path.dirname (os.path.abspath (VfrFile))
+  for File in sorted (os.listdir (Dir)):
+    if File.endswith ('StrDefs.hpk'):
+      return os.path.join (Dir, File)
+  return None
+
+def GenerateVfr (Path, QuestionCount, TypeCount):
+  Guid = '{ 0xA04A27f4, 0xDF00, 0x4D42, {0xB5, 0x52, 0x39, 0x51, 0x13, 0x02, 0x11, 0x3D} }'
+  Lines = ['#pragma pack(1)']
+  for Index in range (TypeCount):
+    Lines.append ('typedef struct {\n  UINT8 A%d;\n  UINT16 B%d;\n  UINT32 C%d[4];\n} TYPE_%d;' % (Index, Index, Index, Index))
+  Lines.append ('typedef struct {')
+  for Index in range (QuestionCount):
+    Lines.append ('  UINT8 Field%d;' % (Index))
+  if TypeCount > 0:
+    Lines.append ('  TYPE_%d Tail;' % (TypeCount - 1))
+  Lines.append ('} BENCH_CONFIG;')
+  Lines.append ('#pragma pack()')
+  Lines.append ('formset\n  guid = %s,\n  title = STRING_TOKEN(0x0002),\n  help = STRING_TOKEN(0x0003),' % (Guid))
+  Lines.append ('  varstore BENCH_CONFIG,\n    varid = 0x1000,\n    name = Bench,\n    guid = %s;' % (Guid))
+  for Start in range (0, QuestionCount, 200):
+    Lines.append ('  form formid = %d,\n       title = STRING_TOKEN(0x0002);' % (Start / 200 + 1))
+    for Index in range (Start, min (QuestionCount, Start + 200)):
+      if Index % 3 == 0:
+        Lines.append ('    checkbox varid = Bench.Field%d,\n      prompt = STRING_TOKEN(0x0002),\n      help = STRING_TOKEN(0x0003),\n      flags = CHECKBOX_DEFAULT,\n    endcheckbox;' % (Index))
+      elif Index % 3 == 1:
+        Lines.append ('    numeric varid = Bench.Field%d,\n      questionid = %d,\n      prompt = STRING_TOKEN(0x0002),\n      help = STRING_TOKEN(0x0003),\n      minimum = 0,\n      maximum = 200,\n      step = 1,\n      default = 10,\n    endnumeric;' % (Index, 0x1000 + Index))
+      else:
+        Lines.append ('    oneof varid = Bench.Field%d,\n      prompt = STRING_TOKEN(0x0002),\n      help = STRING_TOKEN(0x0003),\n      option text = STRING_TOKEN(0x0002), value = 0, flags = DEFAULT;\n      option text = STRING_TOKEN(0x0003), value = 1, flags = 0;\n    endoneof;' % (Index))
+    Lines.append ('  endform;')
+  Lines.append ('endformset;')
+  with open (Path, 'w') as Fd:
+    Fd.write ('\n'.join (Lines) + '\n')
+
+#
+# Run VfrCompile on one file and return the best wall time of all runs, or
+# None if it failed.
+#
+def RunVfrCompile (VfrCompile, VfrFile, OutputDir, Repeat):
+  Command = [VfrCompile, '-l', '-n', '--output-directory', OutputDir]
+  StringDb = FindStringDb (VfrFile)
+  if StringDb:
+    Command += ['--string-db', StringDb]
+  Command.append (VfrFile)
+
+  Best = None
+  for Index in range (Repeat):
+    if os.path.exists (OutputDir):
+      shutil.rmtree (OutputDir)
+    os.makedirs (OutputDir)
+    Start = time.time ()
+    Process = subprocess.Popen (Command, stdout = subprocess.PIPE, stderr = subprocess.STDOUT)
+    Output = Process.communicate ()[0]
+    Elapsed = time.time () - Start
+    if Process.returncode != 0 or 'ERROR' in Output:
+      sys.stderr.write (Output)
+      return None
+    if Best is None or Elapsed < Best:
+      Best = Elapsed
+  return Best
+
+def SameOutput (DirA, DirB):
+  Compare = filecmp.dircmp (DirA, DirB)
+  if Compare.left_only or Compare.right_only:
+    return False
+  Match, Mismatch, Errors = filecmp.cmpfiles (DirA, DirB, Compare.common_files, shallow = False)
+  return not Mismatch and not Errors
+
+if __name__ == '__main__':
+  parser = argparse.ArgumentParser (prog = __prog__,
+                                    version = __version__,
+                                    description = __description__ + __copyright__,
+                                    conflict_handler = 'resolve')
+  parser.add_argument ('Paths', nargs = '*',
+                       help = 'Preprocessed VFR files (.i), or build directories to search for them.')
+  parser.add_argument ('--vfr-compile', dest = 'VfrCompile', default = 'VfrCompile',
+                       help = 'VfrCompile binary to time. Default is VfrCompile in PATH.')
+  parser.add_argument ('--baseline', dest = 'Baseline',
+                       help = 'Another VfrCompile binary to time and to compare the outputs with.')
+  parser.add_argument ('--synthetic', dest = 'Synthetic', type = int, default = 0,
+                       help = 'Also time a generated VFR with this number of questions.')
+  parser.add_argument ('--synthetic-types', dest = 'SyntheticTypes', type = int, default = 100,
+                       help = 'Number of structure types in the generated VFR. Default is 100.')
+  parser.add_argument ('--repeat', dest = 'Repeat', type = int, default = 3,
+                       help = 'Runs per file; the best time is reported. Default is 3.')
+  args = parser.parse_args ()
+
+  WorkDir = tempfile.mkdtemp (prefix = 'VfrBench')
+  try:
+    VfrList = FindVfrFiles (args.Paths)
+    if args.Synthetic > 0:
+      Synthetic = os.path.join (WorkDir, 'Synthetic%d.i' % (args.Synthetic))
+      GenerateVfr (Synthetic, args.Synthetic, args.SyntheticTypes)
+      VfrList.append (Synthetic)
+    if not VfrList:
+      print 'No preprocessed VFR files found.'
+      sys.exit (1)
+
+    Failed = False
+    Total = 0.0
+    BaselineTotal = 0.0
+    for Index, VfrFile in enumerate (VfrList):
+      OutputDir = os.path.join (WorkDir, 'out%d' % (Index))
+      Elapsed = RunVfrCompile (args.VfrCompile, VfrFile, OutputDir, args.Repeat)
+      if Elapsed is None:
+        print '%-60s FAILED' % (os.path.basename (VfrFile))
+        Failed = True
+        continue
+      Total += Elapsed
+      if not args.Baseline:
+        print '%-60s %8.3fs' % (os.path.basename (VfrFile), Elapsed)
+        continue
+
+      BaselineDir = os.path.join (WorkDir, 'base%d' % (Index))
+      BaselineElapsed = RunVfrCompile (args.Baseline, VfrFile, BaselineDir, args.Repeat)
+      if BaselineElapsed is None:
+        print '%-60s %8.3fs  baseline FAILED' % (os.path.basename (VfrFile), Elapsed)
+        Failed = True
+        continue
+      BaselineTotal += BaselineElapsed
+      Same = SameOutput (OutputDir, BaselineDir)
+      if not Same:
+        Failed = True
+      print '%-60s %8.3fs %8.3fs %6.1fx %s' % (
+              os.path.basename (VfrFile),
+              Elapsed,
+              BaselineElapsed,
+              BaselineElapsed / max (Elapsed, 0.001),
+              'same' if Same else 'DIFFERENT'
+              )
+
+    if args.Baseline:
+      print '%-60s %8.3fs %8.3fs %6.1fx' % ('Total', Total, BaselineTotal, BaselineTotal / max (Total, 0.001))
+    else:
+      print '%-60s %8.3fs' % ('Total', Total)
+  finally:
+    shutil.rmtree (WorkDir, True)
+
+  sys.exit (1 if Failed else 0)
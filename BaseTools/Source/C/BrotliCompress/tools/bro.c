@@ -373,6 +373,76 @@ end:
   return (result == BROTLI_RESULT_SUCCESS) ? 1 : 0;
 }
 
+/* Decodes the whole compressed file in a single call, straight from an
+   input buffer into an output buffer of the size recorded in the header,
+   the same way the firmware decompressor does. Only the allocations made
+   by the decoder itself (state and ring buffer) are charged to |memsize|,
+   so the result is the scratch size the firmware has to provide. */
+static int DecompressInPlace(const char* path, const char* dictionary_path,
+    void *memsize) {
+  uint8_t* dictionary = NULL;
+  uint8_t* input = NULL;
+  uint8_t* output = NULL;
+  int64_t file_size;
+  int64_t decoded_size;
+  size_t total_out = 0;
+  size_t available_in;
+  const uint8_t* next_in;
+  size_t available_out;
+  uint8_t* next_out;
+  BrotliResult result = BROTLI_RESULT_ERROR;
+  BrotliState* s = NULL;
+  FILE* fin = NULL;
+
+  file_size = FileSize(path);
+  if (file_size < 16) {
+    fprintf(stderr, "corrupt input\n");
+    return 0;
+  }
+  fin = OpenInputFile(path);
+  input = (uint8_t*)malloc((size_t)file_size);
+  if (!input) {
+    fprintf(stderr, "out of memory\n");
+    goto end;
+  }
+  if (fread(input, 1, (size_t)file_size, fin) != (size_t)file_size) {
+    fprintf(stderr, "failed to read input\n");
+    goto end;
+  }
+  memcpy(&decoded_size, input, sizeof(int64_t));
+  output = (uint8_t*)malloc(decoded_size > 0 ? (size_t)decoded_size : 1);
+  s = BrotliCreateState(BrAlloc, BrFree, memsize);
+  if (!output || !s) {
+    fprintf(stderr, "out of memory\n");
+    goto end;
+  }
+  if (dictionary_path != NULL) {
+    size_t dictionary_size = 0;
+    dictionary = ReadDictionary(dictionary_path, &dictionary_size, memsize);
+    BrotliSetCustomDictionary(dictionary_size, dictionary, s);
+  }
+  next_in = input + 16;
+  available_in = (size_t)file_size - 16;
+  next_out = output;
+  available_out = (size_t)decoded_size;
+  result = BrotliDecompressStream(&available_in, &next_in,
+      &available_out, &next_out, &total_out, s);
+  if (result != BROTLI_RESULT_SUCCESS || total_out != (size_t)decoded_size) {
+    fprintf(stderr, "corrupt input\n");
+    result = BROTLI_RESULT_ERROR;
+  }
+
+end:
+  if (s) {
+    BrotliDestroyState(s);
+  }
+  BrFree(memsize, dictionary);
+  free(input);
+  free(output);
+  fclose(fin);
+  return (result == BROTLI_RESULT_SUCCESS) ? 1 : 0;
+}
+
 static int Compress(int quality, int lgwin, FILE* fin, FILE* fout,
     const char *dictionary_path, void *memsize) {
   BrotliEncoderState* s = BrotliEncoderCreateInstance(BrAlloc, BrFree, memsize);
@@ -495,25 +565,11 @@ int main(int argc, char** argv) {
     /* after compression operation then execute decompression operation
        to get decompression required memory size. */
     if (decompress == 0) {
-      fin = OpenInputFile(output_path);
-      fout = tmpfile ();
       msize = 0;
-      if (fseek(fin, 16, SEEK_SET) != 0) {
-        fclose(fin);
-        return -1;
-      }
-      is_ok = Decompress(fin, fout, dictionary_path, (void *)&msize);
+      is_ok = DecompressInPlace(output_path, dictionary_path, (void *)&msize);
       if (!is_ok) {
         exit(1);
       }
-      if (fclose(fin) != 0) {
-        perror("fclose");
-        exit(1);
-      }
-      if (fclose(fout) != 0) {
-        perror("fclose");
-        exit(1);
-      }
       fout = fopen(output_path, "rb+");  /* open output_path file and add in head info */
       /* seek to the offset of decompression required memory size */
       if (fseek(fout, 8, SEEK_SET) != 0) {
@@ -1,7 +1,7 @@
 /** @file
 EFI tools utility functions to display warning, error, and informational messages
 
-Copyright (c) 2004 - 2016, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2004 - 2017, Intel Corporation. All rights reserved.<BR>
 This program and the accompanying materials
 are licensed and made available under the terms and conditions of the BSD License
 which accompanies this distribution.  The full text of the license may be found at
@@ -642,6 +642,27 @@ Returns:
   return mStatus;
 }
 
+VOID
+SetUtilityStatus (
+  STATUS  Status
+  )
+/*++
+
+Routine Description:
+  Set the worst-case status kept by this module, so that a utility which
+  handles several jobs in one process can report the status of each job.
+
+Arguments:
+  Status - The new status, as returned by GetUtilityStatus().
+
+Returns:
+  None.
+
+--*/
+{
+  mStatus = Status;
+}
+
 VOID
 SetPrintLevel (
   UINT64  LogLevel
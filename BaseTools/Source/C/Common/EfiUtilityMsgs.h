@@ -52,6 +52,15 @@ GetUtilityStatus (
   VOID
   );
 
+//
+// Tools which handle several independent jobs in one process use this to
+// save and restore the worst-case status around each job.
+//
+VOID
+SetUtilityStatus (
+  STATUS  Status
+  );
+
 //
 // If someone prints an error message and didn't specify a source file name,
 // then we print the utility name instead. However they must tell us the
@@ -21,6 +21,7 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <time.h>
 #include "GenFvInternalLib.h"
 
 //
@@ -123,6 +124,12 @@ Returns:
                         If value is FALSE, will always not take reabse action\n\
                         If not specified, will take rebase action if rebase address greater than zero, \n\
                         will not take rebase action if rebase address is zero.\n");
+  fprintf (stdout, "  --pack                Reorder the RAW, FREEFORM and APPLICATION FFS files to\n\
+                        minimise the padding required by their alignment.\n\
+                        Files of all other types, APRIORI and VTF files keep\n\
+                        their positions, so the dispatch order is unchanged.\n\
+                        Code that walks the files of one of the moved types in\n\
+                        FV order will see a different order.\n");
   fprintf (stdout, "  -a AddressFile, --addrfile AddressFile\n\
                         AddressFile is one file used to record the child\n\
                         FV base address when current FV base address is set.\n");
@@ -197,7 +204,9 @@ Returns:
   EFI_CAPSULE_HEADER    *CapsuleHeader;
   UINT64                LogLevel, TempNumber;
   UINT32                Index;
+  clock_t               StartTime;
 
+  StartTime     = clock ();
   InfFileName   = NULL;
   AddrFileName  = NULL;
   InfFileImage  = NULL;
@@ -373,6 +382,13 @@ Returns:
       return STATUS_ERROR; 
     }
 
+    if (stricmp (argv[0], "--pack") == 0) {
+      mFvDataInfo.PackFiles = TRUE;
+      argc --;
+      argv ++;
+      continue; 
+    }
+
     if ((stricmp (argv[0], "-c") == 0) || (stricmp (argv[0], "--capsule") == 0)) {
       CapsuleFlag = TRUE;
       argc --;
@@ -694,6 +710,7 @@ Returns:
     DebugMsg (NULL, 0, 9, "The space Fv size", "%s = 0x%x", EFI_FV_SPACE_SIZE_STRING, (unsigned) (mFvTotalSize - mFvTakenSize));
   }
 
+  VerboseMsg ("%s tool run time is %u ms.", UTILITY_NAME, (unsigned) ((clock () - StartTime) * 1000 / CLOCKS_PER_SEC));
   VerboseMsg ("%s tool done with return code is 0x%x.", UTILITY_NAME, GetUtilityStatus ());
 
   return GetUtilityStatus ();
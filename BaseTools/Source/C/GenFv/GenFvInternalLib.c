@@ -31,6 +31,8 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include <io.h>
 #endif
 #include <assert.h>
+#include <stdarg.h>
+#include <time.h>
 
 #include <Guid/FfsSectionAlignmentPadding.h>
 
@@ -39,6 +41,14 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include "PeCoffLib.h"
 #include "WinNtInclude.h"
 
+#ifndef __GNUC__
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/time.h>
+#endif
+
 #define ARMT_UNCONDITIONAL_JUMP_INSTRUCTION       0xEB000000
 #define ARM64_UNCONDITIONAL_JUMP_INSTRUCTION      0x14000000
 
@@ -50,6 +60,8 @@ EFI_GUID  mFileGuidArray [MAX_NUMBER_OF_FILES_IN_FV];
 EFI_GUID  mZeroGuid                           = {0x0, 0x0, 0x0, {0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0}};
 EFI_GUID  mDefaultCapsuleGuid                 = {0x3B6686BD, 0x0D76, 0x4030, { 0xB7, 0x0E, 0xB5, 0x51, 0x9E, 0x2F, 0xC5, 0xA0 }};
 EFI_GUID  mEfiFfsSectionAlignmentPaddingGuid  = EFI_FFS_SECTION_ALIGNMENT_PADDING_GUID;
+EFI_GUID  mPeiAprioriFileNameGuid            = {0x1b45cc0a, 0x156a, 0x428a, { 0xaf, 0x62, 0x49, 0x86, 0x4d, 0xa0, 0xe6, 0xe6 }};
+EFI_GUID  mAprioriGuid                       = {0xfc510ee7, 0xffdc, 0x11d4, { 0xbd, 0x41, 0x00, 0x80, 0xc7, 0x3c, 0x88, 0x81 }};
 
 CHAR8      *mFvbAttributeName[] = {
   EFI_FVB2_READ_DISABLED_CAP_STRING, 
@@ -169,6 +181,15 @@ BOOLEAN                     mIsLargeFfs = FALSE;
 EFI_PHYSICAL_ADDRESS mFvBaseAddress[0x10];
 UINT32               mFvBaseAddressNumber = 0;
 
+STATIC FFS_REBASE_JOB  mRebaseJobs[MAX_NUMBER_OF_FILES_IN_FV];
+STATIC UINTN           mRebaseJobCount = 0;
+STATIC UINTN           mRebaseJobNext  = 0;
+#ifdef __GNUC__
+STATIC pthread_mutex_t  mRebaseLock;
+#else
+STATIC CRITICAL_SECTION mRebaseLock;
+#endif
+
 EFI_STATUS
 ParseFvInf (
   IN  MEMORY_FILE  *InfFile,
@@ -706,9 +727,159 @@ Returns:
   }
 }
 
+STATIC
+VOID
+RebaseMessage (
+  IN OUT FFS_REBASE_JOB  *Job,
+  IN     UINT32          Type,
+  IN     UINT32          MessageCode,
+  IN     CHAR8           *Text,
+  IN     CHAR8           *MsgFmt,
+  ...
+  )
+/*++
+
+Routine Description:
+
+  Record a message of a rebase job. Error, Warning and VerboseMsg update the
+  global utility status and are not thread safe, so the rebase threads record
+  their messages and RebaseFfsFiles prints them after the threads end.
+
+Arguments:
+
+  Job           The rebase job.
+  Type          REBASE_MESSAGE_ERROR, REBASE_MESSAGE_WARNING or REBASE_MESSAGE_VERBOSE.
+  MessageCode   The message code passed to Error or Warning.
+  Text          The text passed to Error or Warning.
+  MsgFmt        The format string of the message.
+
+--*/
+{
+  va_list             List;
+  CHAR8               Line[MAX_LINE_LEN];
+  FFS_REBASE_MESSAGE  *Messages;
+  CHAR8               *Message;
+
+  va_start (List, MsgFmt);
+  vsnprintf (Line, sizeof (Line), MsgFmt, List);
+  va_end (List);
+  Line[sizeof (Line) - 1] = '\0';
+
+  Messages = realloc (Job->Messages, (Job->MessageCount + 1) * sizeof (FFS_REBASE_MESSAGE));
+  if (Messages == NULL) {
+    return;
+  }
+  Job->Messages = Messages;
+
+  Message = malloc (strlen (Line) + 1);
+  if (Message == NULL) {
+    return;
+  }
+  strcpy (Message, Line);
+
+  Messages[Job->MessageCount].Type        = Type;
+  Messages[Job->MessageCount].MessageCode = MessageCode;
+  Messages[Job->MessageCount].Text        = Text;
+  Messages[Job->MessageCount].Message     = Message;
+  Job->MessageCount++;
+}
+
+STATIC
+VOID
+RebaseMapPrint (
+  IN OUT FFS_REBASE_JOB  *Job,
+  IN     CHAR8           *MsgFmt,
+  ...
+  )
+/*++
+
+Routine Description:
+
+  Append formatted map file records of a rebase job to its in-memory map
+  data, which RebaseFfsFiles writes to the FV map file in FV order.
+
+Arguments:
+
+  Job           The rebase job.
+  MsgFmt        The format string of the records.
+
+--*/
+{
+  va_list  List;
+  int      Length;
+  UINTN    Size;
+  CHAR8    *Buffer;
+
+  if (Job->MapDataLost) {
+    return;
+  }
+
+  va_start (List, MsgFmt);
+  Length = vsnprintf (NULL, 0, MsgFmt, List);
+  va_end (List);
+  if (Length < 0) {
+    return;
+  }
+
+  if (Job->MapDataSize + Length + 1 > Job->MapBufferSize) {
+    Size = Job->MapBufferSize * 2;
+    if (Size < Job->MapDataSize + Length + 1 + MAX_LINE_LEN) {
+      Size = Job->MapDataSize + Length + 1 + MAX_LINE_LEN;
+    }
+    Buffer = realloc (Job->MapData, Size);
+    if (Buffer == NULL) {
+      Job->MapDataLost = TRUE;
+      return;
+    }
+    Job->MapData       = Buffer;
+    Job->MapBufferSize = Size;
+  }
+
+  va_start (List, MsgFmt);
+  vsnprintf (Job->MapData + Job->MapDataSize, Job->MapBufferSize - Job->MapDataSize, MsgFmt, List);
+  va_end (List);
+  Job->MapDataSize += Length;
+}
+
+STATIC
+FILE *
+OpenRebaseFile (
+  IN CHAR8  *FileName,
+  IN CHAR8  *Mode
+  )
+/*++
+
+Routine Description:
+
+  Open a file from a rebase thread. LongFilePath uses a global buffer on
+  Windows, so the conversion and the open are done under the rebase lock.
+
+Arguments:
+
+  FileName      The name of the file to open.
+  Mode          The fopen mode.
+
+Returns:
+
+  The opened file, or NULL if it can't be opened.
+
+--*/
+{
+  FILE  *File;
+
+#ifndef __GNUC__
+  EnterCriticalSection (&mRebaseLock);
+#endif
+  File = fopen (LongFilePath (FileName), Mode);
+#ifndef __GNUC__
+  LeaveCriticalSection (&mRebaseLock);
+#endif
+  return File;
+}
+
 EFI_STATUS
 WriteMapFile (
-  IN OUT FILE                  *FvMapFile,
+  IN OUT FFS_REBASE_JOB        *Job,
   IN     CHAR8                 *FileName,
   IN     EFI_FFS_FILE_HEADER   *FfsFile, 
   IN     EFI_PHYSICAL_ADDRESS  ImageBaseAddress,
@@ -723,7 +894,7 @@ Routine Description:
 
 Arguments:
 
-  FvMapFile             A pointer to FvMap File
+  Job                   The rebase job collecting the FvMap file records
   FileName              Ffs File PathName
   FfsFile               A pointer to Ffs file image.
   ImageBaseAddress      PeImage Base Address.
@@ -834,11 +1005,11 @@ Returns:
   // module information output
   //
   if (ImageBaseAddress == 0) {
-    fprintf (FvMapFile, "%s (dummy) (", KeyWord);
-    fprintf (FvMapFile, "BaseAddress=%010llx, ", (unsigned long long) ImageBaseAddress);
+    RebaseMapPrint (Job, "%s (dummy) (", KeyWord);
+    RebaseMapPrint (Job, "BaseAddress=%010llx, ", (unsigned long long) ImageBaseAddress);
   } else {
-    fprintf (FvMapFile, "%s (Fixed Flash Address, ", KeyWord);
-    fprintf (FvMapFile, "BaseAddress=0x%010llx, ", (unsigned long long) (ImageBaseAddress + Offset));
+    RebaseMapPrint (Job, "%s (Fixed Flash Address, ", KeyWord);
+    RebaseMapPrint (Job, "BaseAddress=0x%010llx, ", (unsigned long long) (ImageBaseAddress + Offset));
   }
 
   if (FfsFile->Type != EFI_FV_FILETYPE_SECURITY_CORE && pImageContext->Machine == EFI_IMAGE_MACHINE_IA64) {
@@ -846,13 +1017,13 @@ Returns:
     // Process IPF PLABEL to get the real address after the image has been rebased. 
     // PLABEL structure is got by AddressOfEntryPoint offset to ImageBuffer stored in pImageContext->Handle.
     //
-    fprintf (FvMapFile, "EntryPoint=0x%010llx", (unsigned long long) (*(UINT64 *)((UINTN) pImageContext->Handle + (UINTN) AddressOfEntryPoint)));
+    RebaseMapPrint (Job, "EntryPoint=0x%010llx", (unsigned long long) (*(UINT64 *)((UINTN) pImageContext->Handle + (UINTN) AddressOfEntryPoint)));
   } else {
-    fprintf (FvMapFile, "EntryPoint=0x%010llx", (unsigned long long) (ImageBaseAddress + AddressOfEntryPoint));
+    RebaseMapPrint (Job, "EntryPoint=0x%010llx", (unsigned long long) (ImageBaseAddress + AddressOfEntryPoint));
   }
-  fprintf (FvMapFile, ")\n"); 
+  RebaseMapPrint (Job, ")\n"); 
   
-  fprintf (FvMapFile, "(GUID=%s", FileGuidName);
+  RebaseMapPrint (Job, "(GUID=%s", FileGuidName);
   TextVirtualAddress = 0;
   DataVirtualAddress = 0;
   for (; Index > 0; Index --, SectionHeader ++) {
@@ -864,19 +1035,19 @@ Returns:
   	  DataVirtualAddress = SectionHeader->VirtualAddress;
   	}
   }
-  fprintf (FvMapFile, " .textbaseaddress=0x%010llx", (unsigned long long) (ImageBaseAddress + TextVirtualAddress));
-  fprintf (FvMapFile, " .databaseaddress=0x%010llx", (unsigned long long) (ImageBaseAddress + DataVirtualAddress));
-  fprintf (FvMapFile, ")\n\n");
+  RebaseMapPrint (Job, " .textbaseaddress=0x%010llx", (unsigned long long) (ImageBaseAddress + TextVirtualAddress));
+  RebaseMapPrint (Job, " .databaseaddress=0x%010llx", (unsigned long long) (ImageBaseAddress + DataVirtualAddress));
+  RebaseMapPrint (Job, ")\n\n");
    
   //
   // Open PeMapFile
   //
-  PeMapFile = fopen (LongFilePath (PeMapFileName), "r");
+  PeMapFile = OpenRebaseFile (PeMapFileName, "r");
   if (PeMapFile == NULL) {
     // fprintf (stdout, "can't open %s file to reading\n", PeMapFileName);
     return EFI_ABORTED;
   }
-  VerboseMsg ("The map file is %s", PeMapFileName);
+  RebaseMessage (Job, REBASE_MESSAGE_VERBOSE, 0, NULL, "The map file is %s", PeMapFileName);
   
   //
   // Output Functions information into Fv Map file
@@ -920,22 +1091,22 @@ Returns:
       sscanf (Line, "%s %s %llx %s", KeyWord, FunctionName, &TempLongAddress, FunctionTypeName);
       FunctionAddress = (UINT64) TempLongAddress;
       if (FunctionTypeName [1] == '\0' && (FunctionTypeName [0] == 'f' || FunctionTypeName [0] == 'F')) {
-        fprintf (FvMapFile, "  0x%010llx    ", (unsigned long long) (ImageBaseAddress + FunctionAddress - LinkTimeBaseAddress));
-        fprintf (FvMapFile, "%s\n", FunctionName);
+        RebaseMapPrint (Job, "  0x%010llx    ", (unsigned long long) (ImageBaseAddress + FunctionAddress - LinkTimeBaseAddress));
+        RebaseMapPrint (Job, "%s\n", FunctionName);
       }
     } else if (FunctionType == 2) {
       sscanf (Line, "%s %s %llx %s", KeyWord, FunctionName, &TempLongAddress, FunctionTypeName);
       FunctionAddress = (UINT64) TempLongAddress;
       if (FunctionTypeName [1] == '\0' && (FunctionTypeName [0] == 'f' || FunctionTypeName [0] == 'F')) {
-        fprintf (FvMapFile, "  0x%010llx    ", (unsigned long long) (ImageBaseAddress + FunctionAddress - LinkTimeBaseAddress));
-        fprintf (FvMapFile, "%s\n", FunctionName);
+        RebaseMapPrint (Job, "  0x%010llx    ", (unsigned long long) (ImageBaseAddress + FunctionAddress - LinkTimeBaseAddress));
+        RebaseMapPrint (Job, "%s\n", FunctionName);
       }
     }
   }
   //
   // Close PeMap file
   //
-  fprintf (FvMapFile, "\n\n");
+  RebaseMapPrint (Job, "\n\n");
   fclose (PeMapFile);
   
   return EFI_SUCCESS;
@@ -1264,18 +1435,19 @@ Returns:
         return EFI_ABORTED;
       }
       //
-      // Rebase the PE or TE image in FileBuffer of FFS file for XIP 
+      // copy VTF File
+      //
+      memcpy (*VtfFileImage, FileBuffer, FileSize);
+
+      //
+      // Queue the PE or TE image of the VTF file in the FvImage for XIP rebase
       // Rebase for the debug genfvmap tool
       //
-      Status = FfsRebase (FvInfo, FvInfo->FvFiles[Index], (EFI_FFS_FILE_HEADER *) FileBuffer, (UINTN) *VtfFileImage - (UINTN) FvImage->FileImage, FvMapFile);
+      Status = QueueFfsRebase (FvInfo, FvInfo->FvFiles[Index], *VtfFileImage, (UINTN) *VtfFileImage - (UINTN) FvImage->FileImage);
       if (EFI_ERROR (Status)) {
-        Error (NULL, 0, 3000, "Invalid", "Could not rebase %s.", FvInfo->FvFiles[Index]);
+        free (FileBuffer);
         return Status;
-      }	  
-      //
-      // copy VTF File
-      //
-      memcpy (*VtfFileImage, FileBuffer, FileSize);
+      }
       
       PrintGuidToBuffer ((EFI_GUID *) FileBuffer, FileGuidString, sizeof (FileGuidString), TRUE); 
       fprintf (FvReportFile, "0x%08X %s\n", (unsigned)(UINTN) (((UINT8 *)*VtfFileImage) - (UINTN)FvImage->FileImage), FileGuidString);
@@ -1310,18 +1482,18 @@ Returns:
   //
   if ((UINTN) (FvImage->CurrentFilePointer + FileSize) <= (UINTN) (*VtfFileImage)) {
     //
-    // Rebase the PE or TE image in FileBuffer of FFS file for XIP. 
-    // Rebase Bs and Rt drivers for the debug genfvmap tool.
-    //
-    Status = FfsRebase (FvInfo, FvInfo->FvFiles[Index], (EFI_FFS_FILE_HEADER *) FileBuffer, (UINTN) FvImage->CurrentFilePointer - (UINTN) FvImage->FileImage, FvMapFile);
-	if (EFI_ERROR (Status)) {
-	  Error (NULL, 0, 3000, "Invalid", "Could not rebase %s.", FvInfo->FvFiles[Index]);
-	  return Status;
-	}	  	
-    //
     // Copy the file
     //
     memcpy (FvImage->CurrentFilePointer, FileBuffer, FileSize);
+    //
+    // Queue the PE or TE image of the FFS file in the FvImage for XIP rebase.
+    // Rebase Bs and Rt drivers for the debug genfvmap tool.
+    //
+    Status = QueueFfsRebase (FvInfo, FvInfo->FvFiles[Index], (EFI_FFS_FILE_HEADER *) FvImage->CurrentFilePointer, (UINTN) FvImage->CurrentFilePointer - (UINTN) FvImage->FileImage);
+    if (EFI_ERROR (Status)) {
+      free (FileBuffer);
+      return Status;
+    }
     PrintGuidToBuffer ((EFI_GUID *) FileBuffer, FileGuidString, sizeof (FileGuidString), TRUE); 
     fprintf (FvReportFile, "0x%08X %s\n", (unsigned) (FvImage->CurrentFilePointer - FvImage->FileImage), FileGuidString);
     FvImage->CurrentFilePointer += FileSize;
@@ -2803,6 +2975,14 @@ Returns:
     }
   }
 
+  //
+  // Rebase the XIP images of the files in the FvImage
+  //
+  Status = RebaseFfsFiles (&mFvDataInfo, FvMapFile);
+  if (EFI_ERROR (Status)) {
+    goto Finish;
+  }
+
   //
   // If there is a VTF file, some special actions need to occur.
   //
@@ -2994,6 +3174,360 @@ Returns:
   }
 }
 
+STATIC
+UINTN
+GetPackedFfsEndOffset (
+  IN FFS_PACK_ENTRY   *Entry,
+  IN UINTN            CurrentOffset
+  )
+/*++
+Routine Description:
+  Get the offset following the FFS file when it is placed at CurrentOffset,
+  including the pad file needed to satisfy its alignment. This follows the
+  same rules as CalculateFvSize.
+
+Arguments:
+  Entry          - The packing information of the FFS file.
+  CurrentOffset  - The offset in the FV where the FFS file would be placed.
+
+Returns:
+  The QWord aligned offset of the next FFS file.
+--*/
+{
+  if (Entry->IsVtf) {
+    //
+    // VTF file is always placed at the top of the FV.
+    //
+    return CurrentOffset;
+  }
+
+  if (((CurrentOffset + Entry->HeaderSize) % Entry->Alignment) != 0) {
+    CurrentOffset = (CurrentOffset + Entry->HeaderSize + sizeof (EFI_FFS_FILE_HEADER) + Entry->Alignment - 1) & ~(Entry->Alignment - 1);
+    CurrentOffset -= Entry->HeaderSize;
+  }
+  CurrentOffset += Entry->Size;
+
+  return (CurrentOffset + EFI_FFS_FILE_HEADER_ALIGNMENT - 1) & ~(EFI_FFS_FILE_HEADER_ALIGNMENT - 1);
+}
+
+STATIC
+UINTN
+GetPackedLayoutEndOffset (
+  IN FFS_PACK_ENTRY   *Entries,
+  IN UINTN            *Order,
+  IN UINTN            FileNumber,
+  IN UINTN            CurrentOffset
+  )
+/*++
+Routine Description:
+  Get the end offset of all FFS files when they are placed in the given order.
+
+Arguments:
+  Entries        - The packing information of all FFS files.
+  Order          - The order in which the FFS files are placed.
+  FileNumber     - The number of FFS files.
+  CurrentOffset  - The offset in the FV of the first FFS file.
+
+Returns:
+  The end offset of the last FFS file.
+--*/
+{
+  UINTN   Index;
+
+  for (Index = 0; Index < FileNumber; Index++) {
+    CurrentOffset = GetPackedFfsEndOffset (&Entries[Order[Index]], CurrentOffset);
+  }
+
+  return CurrentOffset;
+}
+
+STATIC
+VOID
+SortPackedOrderByAlignment (
+  IN FFS_PACK_ENTRY   *Entries,
+  IN UINTN            FileNumber,
+  IN OUT UINTN        *Order
+  )
+/*++
+Routine Description:
+  Place the movable FFS files in descending alignment order. Pinned files
+  keep their slots and the sort is stable, so files with the same alignment
+  keep their original relative order.
+
+Arguments:
+  Entries        - The packing information of all FFS files.
+  FileNumber     - The number of FFS files.
+  Order          - On input the original order, on output the sorted order.
+--*/
+{
+  UINTN   Index;
+  UINTN   Index2;
+  UINTN   Slot;
+  UINTN   Current;
+
+  //
+  // Insertion sort over the movable slots only.
+  //
+  for (Index = 1; Index < FileNumber; Index++) {
+    if (Entries[Order[Index]].IsPinned) {
+      continue;
+    }
+    Current = Order[Index];
+    Slot    = Index;
+    for (Index2 = Index; Index2 > 0; Index2--) {
+      if (Entries[Order[Index2 - 1]].IsPinned) {
+        continue;
+      }
+      if (Entries[Order[Index2 - 1]].Alignment >= Entries[Current].Alignment) {
+        break;
+      }
+      Order[Slot] = Order[Index2 - 1];
+      Slot        = Index2 - 1;
+    }
+    Order[Slot] = Current;
+  }
+}
+
+STATIC
+VOID
+FillPackedOrder (
+  IN FFS_PACK_ENTRY   *Entries,
+  IN UINTN            FileNumber,
+  IN UINTN            CurrentOffset,
+  IN OUT UINTN        *Order
+  )
+/*++
+Routine Description:
+  Place the remaining FFS file with the largest alignment in every movable
+  slot, unless a smaller file fits into the padding in front of it without
+  moving it. The largest such file fills the gap instead.
+
+Arguments:
+  Entries        - The packing information of all FFS files.
+  FileNumber     - The number of FFS files.
+  CurrentOffset  - The offset in the FV of the first FFS file.
+  Order          - On input the identity order, on output the packed order.
+--*/
+{
+  UINTN           Index;
+  UINTN           Index2;
+  UINTN           Big;
+  UINTN           Best;
+  UINTN           BigOffset;
+  UINTN           Temp;
+  FFS_PACK_ENTRY  *Entry;
+  FFS_PACK_ENTRY  *BigEntry;
+
+  for (Index = 0; Index < FileNumber; Index++) {
+    if (!Entries[Order[Index]].IsPinned) {
+      //
+      // The files not placed yet are the movable ones from Index onwards.
+      // Order holds the original index, which breaks the ties.
+      //
+      Big = Index;
+      for (Index2 = Index + 1; Index2 < FileNumber; Index2++) {
+        Entry    = &Entries[Order[Index2]];
+        BigEntry = &Entries[Order[Big]];
+        if (Entry->IsPinned) {
+          continue;
+        }
+        if (Entry->Alignment > BigEntry->Alignment ||
+            (Entry->Alignment == BigEntry->Alignment && Order[Index2] < Order[Big])) {
+          Big = Index2;
+        }
+      }
+      BigEntry  = &Entries[Order[Big]];
+      BigOffset = GetPackedFfsEndOffset (BigEntry, CurrentOffset) - BigEntry->Size;
+
+      Best = Big;
+      if (BigOffset > CurrentOffset) {
+        for (Index2 = Index; Index2 < FileNumber; Index2++) {
+          Entry = &Entries[Order[Index2]];
+          if (Entry->IsPinned || Index2 == Big) {
+            continue;
+          }
+          if (GetPackedFfsEndOffset (BigEntry, GetPackedFfsEndOffset (Entry, CurrentOffset)) - BigEntry->Size != BigOffset) {
+            continue;
+          }
+          if (Best == Big || Entry->Size > Entries[Order[Best]].Size ||
+              (Entry->Size == Entries[Order[Best]].Size && Order[Index2] < Order[Best])) {
+            Best = Index2;
+          }
+        }
+      }
+      Temp         = Order[Index];
+      Order[Index] = Order[Best];
+      Order[Best]  = Temp;
+    }
+    CurrentOffset = GetPackedFfsEndOffset (&Entries[Order[Index]], CurrentOffset);
+  }
+}
+
+EFI_STATUS
+PackFvFiles (
+  IN OUT FV_INFO  *FvInfoPtr,
+  IN UINTN        CurrentOffset
+  )
+/*++
+Routine Description:
+  Reorder the FFS files of a PI FV to minimise the pad files required by
+  their alignment. Only RAW, FREEFORM and APPLICATION files may move. Every
+  other file keeps its position: the dispatchers walk PEIMs, drivers and FV
+  images in FV order, so moving them could change the dispatch order of
+  modules with a TRUE or absent depex. The APRIORI files and the VTF file are
+  of a movable type but are pinned as well. The original order, a descending
+  alignment order and a gap filling order are evaluated and the smallest
+  layout is kept.
+
+Arguments:
+  FvInfoPtr      - The pointer to FV_INFO structure.
+  CurrentOffset  - The offset in the FV of the first FFS file.
+
+Returns:
+  EFI_ABORTED           - Ffs Image Error
+  EFI_OUT_OF_RESOURCES  - No enough buffer to be allocated
+  EFI_SUCCESS           - Successfully packed the FFS files
+--*/
+{
+  UINTN               FileNumber;
+  UINTN               Index;
+  FILE                *fpin;
+  UINTN               FfsFileSize;
+  EFI_FFS_FILE_HEADER FfsHeader;
+  UINT32              FfsAlignment;
+  FFS_PACK_ENTRY      *Entries;
+  UINTN               *Order;
+  UINTN               *Candidate;
+  UINTN               OriginalSize;
+  UINTN               PackedSize;
+  UINTN               CandidateSize;
+  CHAR8               (*FvFiles)[MAX_LONG_FILE_PATH];
+  UINT32              *SizeofFvFiles;
+  clock_t             StartTime;
+  EFI_STATUS          Status;
+
+  if (!FvInfoPtr->IsPiFvImage) {
+    return EFI_SUCCESS;
+  }
+
+  for (FileNumber = 0; FileNumber < MAX_NUMBER_OF_FILES_IN_FV && FvInfoPtr->FvFiles[FileNumber][0] != 0; FileNumber++);
+  if (FileNumber < 2) {
+    return EFI_SUCCESS;
+  }
+
+  StartTime     = clock ();
+  Status        = EFI_SUCCESS;
+  Entries       = malloc (FileNumber * sizeof (FFS_PACK_ENTRY));
+  Order         = malloc (FileNumber * sizeof (UINTN));
+  Candidate     = malloc (FileNumber * sizeof (UINTN));
+  FvFiles       = NULL;
+  SizeofFvFiles = NULL;
+  if (Entries == NULL || Order == NULL || Candidate == NULL) {
+    Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Done;
+  }
+
+  //
+  // Read every FFS header once.
+  //
+  for (Index = 0; Index < FileNumber; Index++) {
+    fpin = fopen (LongFilePath (FvInfoPtr->FvFiles[Index]), "rb");
+    if (fpin == NULL) {
+      Error (NULL, 0, 0001, "Error opening file", FvInfoPtr->FvFiles[Index]);
+      Status = EFI_ABORTED;
+      goto Done;
+    }
+    FfsFileSize = _filelength (fileno (fpin));
+    if (fread (&FfsHeader, sizeof (UINT8), sizeof (EFI_FFS_FILE_HEADER), fpin) != sizeof (EFI_FFS_FILE_HEADER)) {
+      fclose (fpin);
+      Error (NULL, 0, 0004, "Error reading file", FvInfoPtr->FvFiles[Index]);
+      Status = EFI_ABORTED;
+      goto Done;
+    }
+    fclose (fpin);
+
+    ReadFfsAlignment (&FfsHeader, &FfsAlignment);
+    Entries[Index].HeaderSize = FfsFileSize >= MAX_FFS_SIZE ? sizeof (EFI_FFS_FILE_HEADER2) : sizeof (EFI_FFS_FILE_HEADER);
+    Entries[Index].Alignment  = 1 << FfsAlignment;
+    Entries[Index].Size       = FvInfoPtr->SizeofFvFiles[Index] > FfsFileSize ? FvInfoPtr->SizeofFvFiles[Index] : FfsFileSize;
+    Entries[Index].IsVtf      = IsVtfFile (&FfsHeader);
+    Entries[Index].IsPinned   = (BOOLEAN) (Entries[Index].IsVtf ||
+                                  CompareGuid (&FfsHeader.Name, &mPeiAprioriFileNameGuid) == 0 ||
+                                  CompareGuid (&FfsHeader.Name, &mAprioriGuid) == 0 ||
+                                  (FfsHeader.Type != EFI_FV_FILETYPE_RAW &&
+                                   FfsHeader.Type != EFI_FV_FILETYPE_FREEFORM &&
+                                   FfsHeader.Type != EFI_FV_FILETYPE_APPLICATION));
+    Order[Index] = Index;
+  }
+
+  OriginalSize = GetPackedLayoutEndOffset (Entries, Order, FileNumber, CurrentOffset);
+  PackedSize   = OriginalSize;
+
+  memcpy (Candidate, Order, FileNumber * sizeof (UINTN));
+  SortPackedOrderByAlignment (Entries, FileNumber, Candidate);
+  CandidateSize = GetPackedLayoutEndOffset (Entries, Candidate, FileNumber, CurrentOffset);
+  if (CandidateSize < PackedSize) {
+    PackedSize = CandidateSize;
+    memcpy (Order, Candidate, FileNumber * sizeof (UINTN));
+  }
+
+  for (Index = 0; Index < FileNumber; Index++) {
+    Candidate[Index] = Index;
+  }
+  FillPackedOrder (Entries, FileNumber, CurrentOffset, Candidate);
+  CandidateSize = GetPackedLayoutEndOffset (Entries, Candidate, FileNumber, CurrentOffset);
+  if (CandidateSize < PackedSize) {
+    PackedSize = CandidateSize;
+    memcpy (Order, Candidate, FileNumber * sizeof (UINTN));
+  }
+
+  if (PackedSize < OriginalSize) {
+    //
+    // Apply the new order to the FV file list.
+    //
+    FvFiles       = malloc (FileNumber * MAX_LONG_FILE_PATH);
+    SizeofFvFiles = malloc (FileNumber * sizeof (UINT32));
+    if (FvFiles == NULL || SizeofFvFiles == NULL) {
+      Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
+      Status = EFI_OUT_OF_RESOURCES;
+      goto Done;
+    }
+    memcpy (FvFiles, FvInfoPtr->FvFiles, FileNumber * MAX_LONG_FILE_PATH);
+    memcpy (SizeofFvFiles, FvInfoPtr->SizeofFvFiles, FileNumber * sizeof (UINT32));
+    for (Index = 0; Index < FileNumber; Index++) {
+      memcpy (FvInfoPtr->FvFiles[Index], FvFiles[Order[Index]], MAX_LONG_FILE_PATH);
+      FvInfoPtr->SizeofFvFiles[Index] = SizeofFvFiles[Order[Index]];
+      DebugMsg (NULL, 0, 9, "Packed FV component file", "the %uth name is %s", (unsigned) Index, FvInfoPtr->FvFiles[Index]);
+    }
+  }
+
+  VerboseMsg (
+    "FV file packing saved %u bytes of padding for %u files in %u ms",
+    (unsigned) (OriginalSize - PackedSize),
+    (unsigned) FileNumber,
+    (unsigned) ((clock () - StartTime) * 1000 / CLOCKS_PER_SEC)
+    );
+
+Done:
+  if (Entries != NULL) {
+    free (Entries);
+  }
+  if (Order != NULL) {
+    free (Order);
+  }
+  if (Candidate != NULL) {
+    free (Candidate);
+  }
+  if (FvFiles != NULL) {
+    free (FvFiles);
+  }
+  if (SizeofFvFiles != NULL) {
+    free (SizeofFvFiles);
+  }
+  return Status;
+}
+
 EFI_STATUS
 CalculateFvSize (
   FV_INFO *FvInfoPtr
@@ -3021,6 +3555,7 @@ Returns:
   EFI_FFS_FILE_HEADER FfsHeader;
   BOOLEAN             VtfFileFlag;
   UINTN               VtfFileSize;
+  EFI_STATUS          Status;
   
   FvExtendHeaderSize = 0;
   VtfFileSize = 0;
@@ -3071,6 +3606,16 @@ Returns:
     CurrentOffset = (CurrentOffset + 7) & (~7);
   }
 
+  //
+  // Reorder the FFS files to minimise the alignment padding.
+  //
+  if (FvInfoPtr->PackFiles) {
+    Status = PackFvFiles (FvInfoPtr, CurrentOffset);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
   //
   // Accumlate every FFS file size.
   //
@@ -3298,13 +3843,386 @@ Returns:
   return EFI_SUCCESS;
 }
 
+STATIC
+UINT64
+GetRebaseTime (
+  VOID
+  )
+/*++
+
+Routine Description:
+
+  Get the wall clock time in milliseconds, used to report the rebase cost.
+
+Returns:
+
+  The current time in milliseconds.
+
+--*/
+{
+#ifdef __GNUC__
+  struct timeval  Now;
+
+  gettimeofday (&Now, NULL);
+  return (UINT64) Now.tv_sec * 1000 + Now.tv_usec / 1000;
+#else
+  return GetTickCount ();
+#endif
+}
+
+STATIC
+UINTN
+GetRebaseThreadCount (
+  IN UINTN  JobCount
+  )
+/*++
+
+Routine Description:
+
+  Get the number of rebase threads, one per processor but no more than
+  the number of queued files.
+
+Arguments:
+
+  JobCount      The number of queued files.
+
+Returns:
+
+  The number of threads to start.
+
+--*/
+{
+  UINTN         ThreadCount;
+#ifndef __GNUC__
+  SYSTEM_INFO   SystemInfo;
+
+  GetSystemInfo (&SystemInfo);
+  ThreadCount = SystemInfo.dwNumberOfProcessors;
+#else
+  long          Processors;
+
+  Processors  = sysconf (_SC_NPROCESSORS_ONLN);
+  ThreadCount = Processors > 0 ? (UINTN) Processors : 1;
+#endif
+
+  if (ThreadCount > MAX_NUMBER_OF_REBASE_THREADS) {
+    ThreadCount = MAX_NUMBER_OF_REBASE_THREADS;
+  }
+  if (ThreadCount > JobCount) {
+    ThreadCount = JobCount;
+  }
+  return ThreadCount;
+}
+
+STATIC
+FFS_REBASE_JOB *
+GetNextRebaseJob (
+  VOID
+  )
+/*++
+
+Routine Description:
+
+  Take the next queued file to rebase.
+
+Returns:
+
+  The next rebase job, or NULL when all jobs have been taken.
+
+--*/
+{
+  FFS_REBASE_JOB  *Job;
+
+  Job = NULL;
+#ifdef __GNUC__
+  pthread_mutex_lock (&mRebaseLock);
+#else
+  EnterCriticalSection (&mRebaseLock);
+#endif
+  if (mRebaseJobNext < mRebaseJobCount) {
+    Job = &mRebaseJobs[mRebaseJobNext++];
+  }
+#ifdef __GNUC__
+  pthread_mutex_unlock (&mRebaseLock);
+#else
+  LeaveCriticalSection (&mRebaseLock);
+#endif
+  return Job;
+}
+
+STATIC
+VOID
+RunRebaseJobs (
+  IN FV_INFO  *FvInfo
+  )
+/*++
+
+Routine Description:
+
+  Rebase queued files until no job is left. The map file records and the
+  messages of every file are collected in its job, so that they can be
+  written in FV order by the main thread.
+
+Arguments:
+
+  FvInfo        A pointer to FV_INFO struture.
+
+--*/
+{
+  FFS_REBASE_JOB  *Job;
+
+  while ((Job = GetNextRebaseJob ()) != NULL) {
+    Job->Status = FfsRebase (FvInfo, Job->FileName, Job->FfsFile, Job->XipOffset, Job);
+  }
+}
+
+#ifdef __GNUC__
+STATIC
+VOID *
+RebaseThread (
+  IN VOID  *Context
+  )
+#else
+STATIC
+DWORD
+WINAPI
+RebaseThread (
+  IN LPVOID  Context
+  )
+#endif
+/*++
+
+Routine Description:
+
+  Entry point of the rebase worker threads.
+
+Arguments:
+
+  Context       A pointer to FV_INFO struture.
+
+--*/
+{
+  RunRebaseJobs ((FV_INFO *) Context);
+  return 0;
+}
+
+EFI_STATUS
+QueueFfsRebase (
+  IN      FV_INFO               *FvInfo,
+  IN      CHAR8                 *FileName,
+  IN OUT  EFI_FFS_FILE_HEADER   *FfsFile,
+  IN      UINTN                 XipOffset
+  )
+/*++
+
+Routine Description:
+
+  This function queues a file that has been copied into the FV image so that
+  its PE32 and TE sections are rebased in place by RebaseFfsFiles. Child FV
+  base addresses are recorded right away to keep them in FV order.
+
+Arguments:
+
+  FvInfo            A pointer to FV_INFO struture.
+  FileName          Ffs File PathName
+  FfsFile           A pointer to the Ffs file in the FV image.
+  XipOffset         The offset address to use for rebasing the XIP file image.
+
+Returns:
+
+  EFI_SUCCESS             The file was queued or does not need a rebase.
+  EFI_OUT_OF_RESOURCES    Too many files are queued.
+
+--*/
+{
+  FFS_REBASE_JOB  *Job;
+
+  //
+  // Don't need to relocate image when BaseAddress is zero and no ForceRebase Flag specified.
+  // If ForceRebase Flag specified to FALSE, will always not take rebase action.
+  //
+  if (((FvInfo->BaseAddress == 0) && (FvInfo->ForceRebase == -1)) || FvInfo->ForceRebase == 0) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // We only queue files potentially containing PE32 sections.
+  //
+  switch (FfsFile->Type) {
+    case EFI_FV_FILETYPE_SECURITY_CORE:
+    case EFI_FV_FILETYPE_PEI_CORE:
+    case EFI_FV_FILETYPE_PEIM:
+    case EFI_FV_FILETYPE_COMBINED_PEIM_DRIVER:
+    case EFI_FV_FILETYPE_DRIVER:
+    case EFI_FV_FILETYPE_DXE_CORE:
+      break;
+    case EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE:
+      //
+      // Rebase the inside FvImage.
+      //
+      GetChildFvFromFfs (FvInfo, FfsFile, XipOffset);
+      break;
+    default:
+      return EFI_SUCCESS;
+  }
+
+  if (mRebaseJobCount >= MAX_NUMBER_OF_FILES_IN_FV) {
+    Error (NULL, 0, 4001, "Resource", "too many files to rebase in one FV.");
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Job = &mRebaseJobs[mRebaseJobCount++];
+  memset (Job, 0, sizeof (FFS_REBASE_JOB));
+  Job->FileName  = FileName;
+  Job->FfsFile   = FfsFile;
+  Job->XipOffset = XipOffset;
+
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+RebaseFfsFiles (
+  IN OUT  FV_INFO               *FvInfo,
+  IN      FILE                  *FvMapFile
+  )
+/*++
+
+Routine Description:
+
+  This function rebases all files queued by QueueFfsRebase in the FV image.
+  The files are independent, so they are spread over one thread per
+  processor. The map file records, the messages and the machine type of
+  every file are reported in FV order after all threads end.
+
+Arguments:
+
+  FvInfo            A pointer to FV_INFO struture.
+  FvMapFile         FvMapFile to record the function address in one Fvimage
+
+Returns:
+
+  EFI_SUCCESS             All images were properly rebased.
+  EFI_ABORTED             An error occurred while rebasing a file image.
+  EFI_OUT_OF_RESOURCES    Could not allocate a required resource.
+
+--*/
+{
+  EFI_STATUS      Status;
+  UINT64          StartTime;
+  UINTN           ThreadCount;
+  UINTN           Index;
+  UINTN           MessageIndex;
+  FFS_REBASE_JOB  *Job;
+  FFS_REBASE_MESSAGE  *Message;
+#ifdef __GNUC__
+  pthread_t       Threads[MAX_NUMBER_OF_REBASE_THREADS];
+#else
+  HANDLE          Threads[MAX_NUMBER_OF_REBASE_THREADS];
+#endif
+
+  if (mRebaseJobCount == 0) {
+    return EFI_SUCCESS;
+  }
+
+  StartTime      = GetRebaseTime ();
+  ThreadCount    = GetRebaseThreadCount (mRebaseJobCount);
+  mRebaseJobNext = 0;
+
+  //
+  // The calling thread takes jobs as well, start the other threads.
+  //
+#ifdef __GNUC__
+  pthread_mutex_init (&mRebaseLock, NULL);
+  for (Index = 1; Index < ThreadCount; Index++) {
+    if (pthread_create (&Threads[Index], NULL, RebaseThread, FvInfo) != 0) {
+      break;
+    }
+  }
+#else
+  InitializeCriticalSection (&mRebaseLock);
+  for (Index = 1; Index < ThreadCount; Index++) {
+    Threads[Index] = CreateThread (NULL, 0, RebaseThread, FvInfo, 0, NULL);
+    if (Threads[Index] == NULL) {
+      break;
+    }
+  }
+#endif
+  ThreadCount = Index;
+
+  RunRebaseJobs (FvInfo);
+
+  for (Index = 1; Index < ThreadCount; Index++) {
+#ifdef __GNUC__
+    pthread_join (Threads[Index], NULL);
+#else
+    WaitForSingleObject (Threads[Index], INFINITE);
+    CloseHandle (Threads[Index]);
+#endif
+  }
+#ifdef __GNUC__
+  pthread_mutex_destroy (&mRebaseLock);
+#else
+  DeleteCriticalSection (&mRebaseLock);
+#endif
+
+  //
+  // Print the messages, write the map file records and report the first
+  // error in FV order.
+  //
+  Status = EFI_SUCCESS;
+  for (Index = 0; Index < mRebaseJobCount; Index++) {
+    Job = &mRebaseJobs[Index];
+    for (MessageIndex = 0; MessageIndex < Job->MessageCount; MessageIndex++) {
+      Message = &Job->Messages[MessageIndex];
+      if (Message->Type == REBASE_MESSAGE_ERROR) {
+        Error (NULL, 0, Message->MessageCode, Message->Text, "%s", Message->Message);
+      } else if (Message->Type == REBASE_MESSAGE_WARNING) {
+        Warning (NULL, 0, Message->MessageCode, Message->Text, "%s", Message->Message);
+      } else {
+        VerboseMsg ("%s", Message->Message);
+      }
+      free (Message->Message);
+    }
+    if (Job->Messages != NULL) {
+      free (Job->Messages);
+      Job->Messages = NULL;
+    }
+    if (Job->IsArm) {
+      mArm = TRUE;
+    }
+    if (Job->MapData != NULL) {
+      fwrite (Job->MapData, 1, Job->MapDataSize, FvMapFile);
+      free (Job->MapData);
+      Job->MapData = NULL;
+    }
+    if (Job->MapDataLost && !EFI_ERROR (Job->Status)) {
+      Error (NULL, 0, 4001, "Resource", "memory cannot be allocated for the map file records of %s", Job->FileName);
+      Job->Status = EFI_OUT_OF_RESOURCES;
+    }
+    if (EFI_ERROR (Job->Status) && !EFI_ERROR (Status)) {
+      Error (NULL, 0, 3000, "Invalid", "Could not rebase %s.", Job->FileName);
+      Status = Job->Status;
+    }
+  }
+
+  VerboseMsg (
+    "Rebased %u FFS files in %u ms using %u threads",
+    (unsigned) mRebaseJobCount,
+    (unsigned) (GetRebaseTime () - StartTime),
+    (unsigned) ThreadCount
+    );
+  mRebaseJobCount = 0;
+
+  return Status;
+}
+
 EFI_STATUS
 FfsRebase ( 
   IN OUT  FV_INFO               *FvInfo, 
   IN      CHAR8                 *FileName,           
   IN OUT  EFI_FFS_FILE_HEADER   *FfsFile,
   IN      UINTN                 XipOffset,
-  IN      FILE                  *FvMapFile
+  IN OUT  FFS_REBASE_JOB        *Job
   )
 /*++
 
@@ -3319,7 +4237,10 @@ Arguments:
   FileName          Ffs File PathName
   FfsFile           A pointer to Ffs file image.
   XipOffset         The offset address to use for rebasing the XIP file image.
-  FvMapFile         FvMapFile to record the function address in one Fvimage
+  Job               The rebase job recording the map file records, the
+                    messages and the machine type of the file. This
+                    function may run on a rebase thread, so it must not
+                    print messages or update globals itself.
 
 Returns:
 
@@ -3391,11 +4312,7 @@ Returns:
       break;
     case EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE:
       //
-      // Rebase the inside FvImage.
-      //
-      GetChildFvFromFfs (FvInfo, FfsFile, XipOffset);
-
-      //
+      // The inside FvImage base is recorded by QueueFfsRebase.
       // Search PE/TE section in FV sectin.
       //
       break;
@@ -3431,13 +4348,13 @@ Returns:
     ImageContext.ImageRead  = (PE_COFF_LOADER_READ_FILE) FfsRebaseImageRead;
     Status                  = PeCoffLoaderGetImageInfo (&ImageContext);
     if (EFI_ERROR (Status)) {
-      Error (NULL, 0, 3000, "Invalid PeImage", "The input file is %s and the return status is %x", FileName, (int) Status);
+      RebaseMessage (Job, REBASE_MESSAGE_ERROR, 3000, "Invalid PeImage", "The input file is %s and the return status is %x", FileName, (int) Status);
       return Status;
     }
 
     if ( (ImageContext.Machine == EFI_IMAGE_MACHINE_ARMT) ||
          (ImageContext.Machine == EFI_IMAGE_MACHINE_AARCH64) ) {
-      mArm = TRUE;
+      Job->IsArm = TRUE;
     }
 
     //
@@ -3470,7 +4387,7 @@ Returns:
           //
           // Xip module has the same section alignment and file alignment.
           //
-          Error (NULL, 0, 3000, "Invalid", "Section-Alignment and File-Alignment do not match : %s.", FileName);
+          RebaseMessage (Job, REBASE_MESSAGE_ERROR, 3000, "Invalid", "Section-Alignment and File-Alignment do not match : %s.", FileName);
           return EFI_ABORTED;
         }
         //
@@ -3486,7 +4403,7 @@ Returns:
             Cptr --;
           }
           if (*Cptr != '.') {
-            Error (NULL, 0, 3000, "Invalid", "The file %s has no .reloc section.", FileName);
+            RebaseMessage (Job, REBASE_MESSAGE_ERROR, 3000, "Invalid", "The file %s has no .reloc section.", FileName);
             return EFI_ABORTED;
           } else {
             *(Cptr + 1) = 'e';
@@ -3494,9 +4411,9 @@ Returns:
             *(Cptr + 3) = 'i';
             *(Cptr + 4) = '\0';
           }
-          PeFile = fopen (LongFilePath (PeFileName), "rb");
+          PeFile = OpenRebaseFile (PeFileName, "rb");
           if (PeFile == NULL) {
-            Warning (NULL, 0, 0, "Invalid", "The file %s has no .reloc section.", FileName);
+            RebaseMessage (Job, REBASE_MESSAGE_WARNING, 0, "Invalid", "The file %s has no .reloc section.", FileName);
             //Error (NULL, 0, 3000, "Invalid", "The file %s has no .reloc section.", FileName);
             //return EFI_ABORTED;
             break;
@@ -3508,7 +4425,7 @@ Returns:
           PeFileBuffer = (UINT8 *) malloc (PeFileSize);
           if (PeFileBuffer == NULL) {
             fclose (PeFile);
-            Error (NULL, 0, 4001, "Resource", "memory cannot be allocated on rebase of %s", FileName);
+            RebaseMessage (Job, REBASE_MESSAGE_ERROR, 4001, "Resource", "memory cannot be allocated on rebase of %s", FileName);
             return EFI_OUT_OF_RESOURCES;
           }
           //
@@ -3525,7 +4442,7 @@ Returns:
           ImageContext.Handle = PeFileBuffer;
           Status              = PeCoffLoaderGetImageInfo (&ImageContext);
           if (EFI_ERROR (Status)) {
-            Error (NULL, 0, 3000, "Invalid PeImage", "The input file is %s and the return status is %x", FileName, (int) Status);
+            RebaseMessage (Job, REBASE_MESSAGE_ERROR, 3000, "Invalid PeImage", "The input file is %s and the return status is %x", FileName, (int) Status);
             return Status;
           }
           ImageContext.RelocationsStripped = FALSE;
@@ -3543,7 +4460,7 @@ Returns:
           //
           // Xip module has the same section alignment and file alignment.
           //
-          Error (NULL, 0, 3000, "Invalid", "Section-Alignment and File-Alignment do not match : %s.", FileName);
+          RebaseMessage (Job, REBASE_MESSAGE_ERROR, 3000, "Invalid", "Section-Alignment and File-Alignment do not match : %s.", FileName);
           return EFI_ABORTED;
         }
         NewPe32BaseAddress = XipBase + (UINTN) CurrentPe32Section.Pe32Section + CurSecHdrSize - (UINTN)FfsFile;
@@ -3560,7 +4477,7 @@ Returns:
     // Relocation doesn't exist
     //
     if (ImageContext.RelocationsStripped) {
-      Warning (NULL, 0, 0, "Invalid", "The file %s has no .reloc section.", FileName);
+      RebaseMessage (Job, REBASE_MESSAGE_WARNING, 0, "Invalid", "The file %s has no .reloc section.", FileName);
       continue;
     }
 
@@ -3572,7 +4489,7 @@ Returns:
     //
     MemoryImagePointer = (UINT8 *) malloc ((UINTN) ImageContext.ImageSize + ImageContext.SectionAlignment);
     if (MemoryImagePointer == NULL) {
-      Error (NULL, 0, 4001, "Resource", "memory cannot be allocated on rebase of %s", FileName);
+      RebaseMessage (Job, REBASE_MESSAGE_ERROR, 4001, "Resource", "memory cannot be allocated on rebase of %s", FileName);
       return EFI_OUT_OF_RESOURCES;
     }
     memset ((VOID *) MemoryImagePointer, 0, (UINTN) ImageContext.ImageSize + ImageContext.SectionAlignment);
@@ -3580,7 +4497,7 @@ Returns:
     
     Status =  PeCoffLoaderLoadImage (&ImageContext);
     if (EFI_ERROR (Status)) {
-      Error (NULL, 0, 3000, "Invalid", "LocateImage() call failed on rebase of %s", FileName);
+      RebaseMessage (Job, REBASE_MESSAGE_ERROR, 3000, "Invalid", "LocateImage() call failed on rebase of %s", FileName);
       free ((VOID *) MemoryImagePointer);
       return Status;
     }
@@ -3588,7 +4505,7 @@ Returns:
     ImageContext.DestinationAddress = NewPe32BaseAddress;
     Status                          = PeCoffLoaderRelocateImage (&ImageContext);
     if (EFI_ERROR (Status)) {
-      Error (NULL, 0, 3000, "Invalid", "RelocateImage() call failed on rebase of %s", FileName);
+      RebaseMessage (Job, REBASE_MESSAGE_ERROR, 3000, "Invalid", "RelocateImage() call failed on rebase of %s", FileName);
       free ((VOID *) MemoryImagePointer);
       return Status;
     }
@@ -3626,7 +4543,7 @@ Returns:
     } else if (ImgHdr->Pe32Plus.OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR64_MAGIC) {
       ImgHdr->Pe32Plus.OptionalHeader.ImageBase = NewPe32BaseAddress;
     } else {
-      Error (NULL, 0, 3000, "Invalid", "unknown PE magic signature %X in PE32 image %s",
+      RebaseMessage (Job, REBASE_MESSAGE_ERROR, 3000, "Invalid", "unknown PE magic signature %X in PE32 image %s",
         ImgHdr->Pe32.OptionalHeader.Magic,
         FileName
         );
@@ -3658,7 +4575,7 @@ Returns:
       PdbPointer = FileName;
     }
 
-    WriteMapFile (FvMapFile, PdbPointer, FfsFile, NewPe32BaseAddress, &OrigImageContext);
+    WriteMapFile (Job, PdbPointer, FfsFile, NewPe32BaseAddress, &OrigImageContext);
   }
 
   if (FfsFile->Type != EFI_FV_FILETYPE_SECURITY_CORE &&
@@ -3703,13 +4620,13 @@ Returns:
     ImageContext.ImageRead  = (PE_COFF_LOADER_READ_FILE) FfsRebaseImageRead;
     Status                  = PeCoffLoaderGetImageInfo (&ImageContext);
     if (EFI_ERROR (Status)) {
-      Error (NULL, 0, 3000, "Invalid TeImage", "The input file is %s and the return status is %x", FileName, (int) Status);
+      RebaseMessage (Job, REBASE_MESSAGE_ERROR, 3000, "Invalid TeImage", "The input file is %s and the return status is %x", FileName, (int) Status);
       return Status;
     }
 
     if ( (ImageContext.Machine == EFI_IMAGE_MACHINE_ARMT) ||
          (ImageContext.Machine == EFI_IMAGE_MACHINE_AARCH64) ) {
-      mArm = TRUE;
+      Job->IsArm = TRUE;
     }
 
     //
@@ -3742,7 +4659,7 @@ Returns:
       }
 
       if (*Cptr != '.') {
-        Error (NULL, 0, 3000, "Invalid", "The file %s has no .reloc section.", FileName);
+        RebaseMessage (Job, REBASE_MESSAGE_ERROR, 3000, "Invalid", "The file %s has no .reloc section.", FileName);
         return EFI_ABORTED;
       } else {
         *(Cptr + 1) = 'e';
@@ -3751,9 +4668,9 @@ Returns:
         *(Cptr + 4) = '\0';
       }
 
-      PeFile = fopen (LongFilePath (PeFileName), "rb");
+      PeFile = OpenRebaseFile (PeFileName, "rb");
       if (PeFile == NULL) {
-        Warning (NULL, 0, 0, "Invalid", "The file %s has no .reloc section.", FileName);
+        RebaseMessage (Job, REBASE_MESSAGE_WARNING, 0, "Invalid", "The file %s has no .reloc section.", FileName);
         //Error (NULL, 0, 3000, "Invalid", "The file %s has no .reloc section.", FileName);
         //return EFI_ABORTED;
       } else {
@@ -3764,7 +4681,7 @@ Returns:
         PeFileBuffer = (UINT8 *) malloc (PeFileSize);
         if (PeFileBuffer == NULL) {
           fclose (PeFile);
-          Error (NULL, 0, 4001, "Resource", "memory cannot be allocated on rebase of %s", FileName);
+          RebaseMessage (Job, REBASE_MESSAGE_ERROR, 4001, "Resource", "memory cannot be allocated on rebase of %s", FileName);
           return EFI_OUT_OF_RESOURCES;
         }
         //
@@ -3781,7 +4698,7 @@ Returns:
         ImageContext.Handle = PeFileBuffer;
         Status              = PeCoffLoaderGetImageInfo (&ImageContext);
         if (EFI_ERROR (Status)) {
-          Error (NULL, 0, 3000, "Invalid TeImage", "The input file is %s and the return status is %x", FileName, (int) Status);
+          RebaseMessage (Job, REBASE_MESSAGE_ERROR, 3000, "Invalid TeImage", "The input file is %s and the return status is %x", FileName, (int) Status);
           return Status;
         }
         ImageContext.RelocationsStripped = FALSE;
@@ -3791,7 +4708,7 @@ Returns:
     // Relocation doesn't exist
     //
     if (ImageContext.RelocationsStripped) {
-      Warning (NULL, 0, 0, "Invalid", "The file %s has no .reloc section.", FileName);
+      RebaseMessage (Job, REBASE_MESSAGE_WARNING, 0, "Invalid", "The file %s has no .reloc section.", FileName);
       continue;
     }
 
@@ -3803,7 +4720,7 @@ Returns:
     //
     MemoryImagePointer = (UINT8 *) malloc ((UINTN) ImageContext.ImageSize + ImageContext.SectionAlignment);
     if (MemoryImagePointer == NULL) {
-      Error (NULL, 0, 4001, "Resource", "memory cannot be allocated on rebase of %s", FileName);
+      RebaseMessage (Job, REBASE_MESSAGE_ERROR, 4001, "Resource", "memory cannot be allocated on rebase of %s", FileName);
       return EFI_OUT_OF_RESOURCES;
     }
     memset ((VOID *) MemoryImagePointer, 0, (UINTN) ImageContext.ImageSize + ImageContext.SectionAlignment);
@@ -3811,7 +4728,7 @@ Returns:
 
     Status =  PeCoffLoaderLoadImage (&ImageContext);
     if (EFI_ERROR (Status)) {
-      Error (NULL, 0, 3000, "Invalid", "LocateImage() call failed on rebase of %s", FileName);
+      RebaseMessage (Job, REBASE_MESSAGE_ERROR, 3000, "Invalid", "LocateImage() call failed on rebase of %s", FileName);
       free ((VOID *) MemoryImagePointer);
       return Status;
     }
@@ -3821,7 +4738,7 @@ Returns:
     ImageContext.DestinationAddress = NewPe32BaseAddress;
     Status                          = PeCoffLoaderRelocateImage (&ImageContext);
     if (EFI_ERROR (Status)) {
-      Error (NULL, 0, 3000, "Invalid", "RelocateImage() call failed on rebase of TE image %s", FileName);
+      RebaseMessage (Job, REBASE_MESSAGE_ERROR, 3000, "Invalid", "RelocateImage() call failed on rebase of TE image %s", FileName);
       free ((VOID *) MemoryImagePointer);
       return Status;
     }
@@ -3886,7 +4803,7 @@ Returns:
     }
 
     WriteMapFile (
-      FvMapFile, 
+      Job, 
       PdbPointer, 
       FfsFile,
       NewPe32BaseAddress, 
@@ -55,6 +55,10 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #define MAX_NUMBER_OF_FILES_IN_CAP      1000
 #define EFI_FFS_FILE_HEADER_ALIGNMENT   8
 //
+// The maximum number of threads used to rebase the files in the FV
+//
+#define MAX_NUMBER_OF_REBASE_THREADS    64
+//
 // INF file strings
 //
 #define OPTIONS_SECTION_STRING                "[options]"
@@ -210,6 +214,48 @@ typedef struct {
   CHAR8 ComponentName[MAX_LONG_FILE_PATH];
 } COMPONENT_INFO;
 
+//
+// FFS file information used to reorder the files of an FV
+//
+typedef struct {
+  UINTN   Size;
+  UINT32  HeaderSize;
+  UINT32  Alignment;
+  BOOLEAN IsVtf;
+  BOOLEAN IsPinned;
+} FFS_PACK_ENTRY;
+
+//
+// Message recorded by a rebase job and printed after the rebase threads end
+//
+#define REBASE_MESSAGE_ERROR    0
+#define REBASE_MESSAGE_WARNING  1
+#define REBASE_MESSAGE_VERBOSE  2
+
+typedef struct {
+  UINT32                Type;
+  UINT32                MessageCode;
+  CHAR8                 *Text;
+  CHAR8                 *Message;
+} FFS_REBASE_MESSAGE;
+
+//
+// FFS file in the FV image waiting to be rebased
+//
+typedef struct {
+  CHAR8                 *FileName;
+  EFI_FFS_FILE_HEADER   *FfsFile;
+  UINTN                 XipOffset;
+  CHAR8                 *MapData;
+  UINTN                 MapDataSize;
+  UINTN                 MapBufferSize;
+  BOOLEAN               MapDataLost;
+  FFS_REBASE_MESSAGE    *Messages;
+  UINTN                 MessageCount;
+  BOOLEAN               IsArm;
+  EFI_STATUS            Status;
+} FFS_REBASE_JOB;
+
 //
 // FV and capsule information holder
 //
@@ -229,6 +275,7 @@ typedef struct {
   UINT32                  SizeofFvFiles[MAX_NUMBER_OF_FILES_IN_FV];
   BOOLEAN                 IsPiFvImage;
   INT8                    ForceRebase;
+  BOOLEAN                 PackFiles;
 } FV_INFO;
 
 typedef struct {
@@ -343,12 +390,32 @@ CalculateFvSize (
   FV_INFO *FvInfoPtr
   );
 
+EFI_STATUS
+PackFvFiles (
+  IN OUT FV_INFO  *FvInfoPtr,
+  IN UINTN        CurrentOffset
+  );
+
 EFI_STATUS
 FfsRebase ( 
   IN OUT  FV_INFO               *FvInfo, 
   IN      CHAR8                 *FileName,           
   IN OUT  EFI_FFS_FILE_HEADER   *FfsFile,
   IN      UINTN                 XipOffset,
+  IN OUT  FFS_REBASE_JOB        *Job
+  );
+
+EFI_STATUS
+QueueFfsRebase (
+  IN      FV_INFO               *FvInfo,
+  IN      CHAR8                 *FileName,
+  IN OUT  EFI_FFS_FILE_HEADER   *FfsFile,
+  IN      UINTN                 XipOffset
+  );
+
+EFI_STATUS
+RebaseFfsFiles (
+  IN OUT  FV_INFO               *FvInfo,
   IN      FILE                  *FvMapFile
   );
 
@@ -73,6 +73,12 @@ CleanUp32 (
   VOID
   );
 
+STATIC
+BOOLEAN
+InitializeShdrFilter (
+  VOID
+  );
+
 //
 // Rename ELF32 strucutres to common names to help when porting to ELF64.
 //
@@ -108,6 +114,14 @@ STATIC const UINT16 mCoffNbrSections = 4;
 //
 STATIC UINT32 *mCoffSectionsOffset = NULL;
 
+//
+// Filters each ELF section belongs to, as a bit mask of SECTION_FILTER_BIT(),
+// and the string table section. Both are looked up once per image, instead
+// of comparing section names in every pass.
+//
+STATIC UINT8    *mShdrFilter = NULL;
+STATIC Elf_Shdr *mStrtabShdr = NULL;
+
 //
 // Offsets in COFF file
 //
@@ -171,6 +185,14 @@ InitializeElf32 (
     return FALSE;
   }
   memset(mCoffSectionsOffset, 0, mEhdr->e_shnum * sizeof(UINT32));
+  mCoffAlignment = 0x20;
+
+  //
+  // Sort the sections into the text, data and HII filters.
+  //
+  if (!InitializeShdrFilter ()) {
+    return FALSE;
+  }
 
   //
   // Fill in function pointers.
@@ -297,6 +319,53 @@ FindStrtabShdr (
   return NULL;
 }
 
+STATIC
+BOOLEAN
+InitializeShdrFilter (
+  VOID
+  )
+{
+  UINT32   Index;
+  Elf_Shdr *Shdr;
+
+  mShdrFilter = (UINT8 *) malloc (mEhdr->e_shnum);
+  if (mShdrFilter == NULL) {
+    Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
+    return FALSE;
+  }
+
+  //
+  // A section may match more than one filter, e.g. a read-only .hii section
+  // is both text and HII, so keep one bit per filter.
+  //
+  for (Index = 0; Index < mEhdr->e_shnum; Index++) {
+    Shdr = GetShdrByIndex (Index);
+    mShdrFilter[Index] = 0;
+    if (IsTextShdr (Shdr)) {
+      mShdrFilter[Index] |= SECTION_FILTER_BIT (SECTION_TEXT);
+    }
+    if (IsHiiRsrcShdr (Shdr)) {
+      mShdrFilter[Index] |= SECTION_FILTER_BIT (SECTION_HII);
+    }
+    if (IsDataShdr (Shdr)) {
+      mShdrFilter[Index] |= SECTION_FILTER_BIT (SECTION_DATA);
+    }
+  }
+
+  mStrtabShdr = FindStrtabShdr ();
+  return TRUE;
+}
+
+STATIC
+BOOLEAN
+IsShdrInFilter (
+  UINT32                Index,
+  SECTION_FILTER_TYPES  FilterType
+  )
+{
+  return (BOOLEAN) ((mShdrFilter[Index] & SECTION_FILTER_BIT (FilterType)) != 0);
+}
+
 STATIC
 const UINT8 *
 GetSymName (
@@ -312,7 +381,7 @@ GetSymName (
     return NULL;
   }
 
-  StrtabShdr = FindStrtabShdr();
+  StrtabShdr = mStrtabShdr;
   if (StrtabShdr == NULL) {
     return NULL;
   }
@@ -378,7 +447,7 @@ ScanSections32 (
     if (shdr->sh_addralign <= mCoffAlignment) {
       continue;
     }
-    if (IsTextShdr(shdr) || IsDataShdr(shdr) || IsHiiRsrcShdr(shdr)) {
+    if (mShdrFilter[i] != 0) {
       mCoffAlignment = (UINT32)shdr->sh_addralign;
     }
   }
@@ -402,7 +471,7 @@ ScanSections32 (
   SectionCount = 0;
   for (i = 0; i < mEhdr->e_shnum; i++) {
     Elf_Shdr *shdr = GetShdrByIndex(i);
-    if (IsTextShdr(shdr)) {
+    if (IsShdrInFilter (i, SECTION_TEXT)) {
       if ((shdr->sh_addralign != 0) && (shdr->sh_addralign != 1)) {
         // the alignment field is valid
         if ((shdr->sh_addr & (shdr->sh_addralign - 1)) == 0) {
@@ -453,7 +522,7 @@ ScanSections32 (
   SectionCount = 0;
   for (i = 0; i < mEhdr->e_shnum; i++) {
     Elf_Shdr *shdr = GetShdrByIndex(i);
-    if (IsDataShdr(shdr)) {
+    if (IsShdrInFilter (i, SECTION_DATA)) {
       if ((shdr->sh_addralign != 0) && (shdr->sh_addralign != 1)) {
         // the alignment field is valid
         if ((shdr->sh_addr & (shdr->sh_addralign - 1)) == 0) {
@@ -506,7 +575,7 @@ ScanSections32 (
   mHiiRsrcOffset = mCoffOffset;
   for (i = 0; i < mEhdr->e_shnum; i++) {
     Elf_Shdr *shdr = GetShdrByIndex(i);
-    if (IsHiiRsrcShdr(shdr)) {
+    if (IsShdrInFilter (i, SECTION_HII)) {
       if ((shdr->sh_addralign != 0) && (shdr->sh_addralign != 1)) {
         // the alignment field is valid
         if ((shdr->sh_addr & (shdr->sh_addralign - 1)) == 0) {
@@ -638,20 +707,14 @@ WriteSections32 (
   UINT32      Idx;
   Elf_Shdr    *SecShdr;
   UINT32      SecOffset;
-  BOOLEAN     (*Filter)(Elf_Shdr *);
 
   //
-  // Initialize filter pointer
+  // Check filter type
   //
   switch (FilterType) {
     case SECTION_TEXT:
-      Filter = IsTextShdr;
-      break;
     case SECTION_HII:
-      Filter = IsHiiRsrcShdr;
-      break;
     case SECTION_DATA:
-      Filter = IsDataShdr;
       break;
     default:
       return FALSE;
@@ -662,7 +725,7 @@ WriteSections32 (
   //
   for (Idx = 0; Idx < mEhdr->e_shnum; Idx++) {
     Elf_Shdr *Shdr = GetShdrByIndex(Idx);
-    if ((*Filter)(Shdr)) {
+    if (IsShdrInFilter (Idx, FilterType)) {
       switch (Shdr->sh_type) {
       case SHT_PROGBITS:
         /* Copy.  */
@@ -707,7 +770,7 @@ WriteSections32 (
     //
     // Only process relocations for the current filter type.
     //
-    if (RelShdr->sh_type == SHT_REL && (*Filter)(SecShdr)) {
+    if (RelShdr->sh_type == SHT_REL && IsShdrInFilter (RelShdr->sh_info, FilterType)) {
       UINT32 RelOffset;
       
       //
@@ -891,7 +954,7 @@ WriteRelocations32 (
     Elf_Shdr *RelShdr = GetShdrByIndex(Index);
     if ((RelShdr->sh_type == SHT_REL) || (RelShdr->sh_type == SHT_RELA)) {
       Elf_Shdr *SecShdr = GetShdrByIndex (RelShdr->sh_info);
-      if (IsTextShdr(SecShdr) || IsDataShdr(SecShdr)) {
+      if (IsShdrInFilter (RelShdr->sh_info, SECTION_TEXT) || IsShdrInFilter (RelShdr->sh_info, SECTION_DATA)) {
         UINT32 RelIdx;
 
         FoundRelocations = TRUE;
@@ -1168,7 +1231,13 @@ CleanUp32 (
 {
   if (mCoffSectionsOffset != NULL) {
     free (mCoffSectionsOffset);
+    mCoffSectionsOffset = NULL;
+  }
+  if (mShdrFilter != NULL) {
+    free (mShdrFilter);
+    mShdrFilter = NULL;
   }
+  mStrtabShdr = NULL;
 }
 
 
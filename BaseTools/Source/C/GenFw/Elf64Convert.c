@@ -73,6 +73,12 @@ CleanUp64 (
   VOID
   );
 
+STATIC
+BOOLEAN
+InitializeShdrFilter (
+  VOID
+  );
+
 //
 // Rename ELF32 strucutres to common names to help when porting to ELF64.
 //
@@ -109,6 +115,14 @@ STATIC const UINT16 mCoffNbrSections = 4;
 //
 STATIC UINT32 *mCoffSectionsOffset = NULL;
 
+//
+// Filters each ELF section belongs to, as a bit mask of SECTION_FILTER_BIT(),
+// and the string table section. Both are looked up once per image, instead
+// of comparing section names in every pass.
+//
+STATIC UINT8    *mShdrFilter = NULL;
+STATIC Elf_Shdr *mStrtabShdr = NULL;
+
 //
 // Offsets in COFF file
 //
@@ -176,6 +190,14 @@ InitializeElf64 (
     return FALSE;
   }
   memset(mCoffSectionsOffset, 0, mEhdr->e_shnum * sizeof(UINT32));
+  mCoffAlignment = 0x20;
+
+  //
+  // Sort the sections into the text, data and HII filters.
+  //
+  if (!InitializeShdrFilter ()) {
+    return FALSE;
+  }
 
   //
   // Fill in function pointers.
@@ -289,6 +311,53 @@ FindStrtabShdr (
   return NULL;
 }
 
+STATIC
+BOOLEAN
+InitializeShdrFilter (
+  VOID
+  )
+{
+  UINT32   Index;
+  Elf_Shdr *Shdr;
+
+  mShdrFilter = (UINT8 *) malloc (mEhdr->e_shnum);
+  if (mShdrFilter == NULL) {
+    Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
+    return FALSE;
+  }
+
+  //
+  // A section may match more than one filter, e.g. a read-only .hii section
+  // is both text and HII, so keep one bit per filter.
+  //
+  for (Index = 0; Index < mEhdr->e_shnum; Index++) {
+    Shdr = GetShdrByIndex (Index);
+    mShdrFilter[Index] = 0;
+    if (IsTextShdr (Shdr)) {
+      mShdrFilter[Index] |= SECTION_FILTER_BIT (SECTION_TEXT);
+    }
+    if (IsHiiRsrcShdr (Shdr)) {
+      mShdrFilter[Index] |= SECTION_FILTER_BIT (SECTION_HII);
+    }
+    if (IsDataShdr (Shdr)) {
+      mShdrFilter[Index] |= SECTION_FILTER_BIT (SECTION_DATA);
+    }
+  }
+
+  mStrtabShdr = FindStrtabShdr ();
+  return TRUE;
+}
+
+STATIC
+BOOLEAN
+IsShdrInFilter (
+  UINT32                Index,
+  SECTION_FILTER_TYPES  FilterType
+  )
+{
+  return (BOOLEAN) ((mShdrFilter[Index] & SECTION_FILTER_BIT (FilterType)) != 0);
+}
+
 STATIC
 const UINT8 *
 GetSymName (
@@ -304,7 +373,7 @@ GetSymName (
     return NULL;
   }
 
-  StrtabShdr = FindStrtabShdr();
+  StrtabShdr = mStrtabShdr;
   if (StrtabShdr == NULL) {
     return NULL;
   }
@@ -371,7 +440,7 @@ ScanSections64 (
     if (shdr->sh_addralign <= mCoffAlignment) {
       continue;
     }
-    if (IsTextShdr(shdr) || IsDataShdr(shdr) || IsHiiRsrcShdr(shdr)) {
+    if (mShdrFilter[i] != 0) {
       mCoffAlignment = (UINT32)shdr->sh_addralign;
     }
   }
@@ -395,7 +464,7 @@ ScanSections64 (
   SectionCount = 0;
   for (i = 0; i < mEhdr->e_shnum; i++) {
     Elf_Shdr *shdr = GetShdrByIndex(i);
-    if (IsTextShdr(shdr)) {
+    if (IsShdrInFilter (i, SECTION_TEXT)) {
       if ((shdr->sh_addralign != 0) && (shdr->sh_addralign != 1)) {
         // the alignment field is valid
         if ((shdr->sh_addr & (shdr->sh_addralign - 1)) == 0) {
@@ -446,7 +515,7 @@ ScanSections64 (
   SectionCount = 0;
   for (i = 0; i < mEhdr->e_shnum; i++) {
     Elf_Shdr *shdr = GetShdrByIndex(i);
-    if (IsDataShdr(shdr)) {
+    if (IsShdrInFilter (i, SECTION_DATA)) {
       if ((shdr->sh_addralign != 0) && (shdr->sh_addralign != 1)) {
         // the alignment field is valid
         if ((shdr->sh_addr & (shdr->sh_addralign - 1)) == 0) {
@@ -498,7 +567,7 @@ ScanSections64 (
   mHiiRsrcOffset = mCoffOffset;
   for (i = 0; i < mEhdr->e_shnum; i++) {
     Elf_Shdr *shdr = GetShdrByIndex(i);
-    if (IsHiiRsrcShdr(shdr)) {
+    if (IsShdrInFilter (i, SECTION_HII)) {
       if ((shdr->sh_addralign != 0) && (shdr->sh_addralign != 1)) {
         // the alignment field is valid
         if ((shdr->sh_addr & (shdr->sh_addralign - 1)) == 0) {
@@ -633,20 +702,14 @@ WriteSections64 (
   UINT32      Idx;
   Elf_Shdr    *SecShdr;
   UINT32      SecOffset;
-  BOOLEAN     (*Filter)(Elf_Shdr *);
 
   //
-  // Initialize filter pointer
+  // Check filter type
   //
   switch (FilterType) {
     case SECTION_TEXT:
-      Filter = IsTextShdr;
-      break;
     case SECTION_HII:
-      Filter = IsHiiRsrcShdr;
-      break;
     case SECTION_DATA:
-      Filter = IsDataShdr;
       break;
     default:
       return FALSE;
@@ -657,7 +720,7 @@ WriteSections64 (
   //
   for (Idx = 0; Idx < mEhdr->e_shnum; Idx++) {
     Elf_Shdr *Shdr = GetShdrByIndex(Idx);
-    if ((*Filter)(Shdr)) {
+    if (IsShdrInFilter (Idx, FilterType)) {
       switch (Shdr->sh_type) {
       case SHT_PROGBITS:
         /* Copy.  */
@@ -717,7 +780,7 @@ WriteSections64 (
     //
     // Only process relocations for the current filter type.
     //
-    if (RelShdr->sh_type == SHT_RELA && (*Filter)(SecShdr)) {
+    if (RelShdr->sh_type == SHT_RELA && IsShdrInFilter (RelShdr->sh_info, FilterType)) {
       UINT64 RelIdx;
 
       //
@@ -961,7 +1024,7 @@ WriteRelocations64 (
     Elf_Shdr *RelShdr = GetShdrByIndex(Index);
     if ((RelShdr->sh_type == SHT_REL) || (RelShdr->sh_type == SHT_RELA)) {
       Elf_Shdr *SecShdr = GetShdrByIndex (RelShdr->sh_info);
-      if (IsTextShdr(SecShdr) || IsDataShdr(SecShdr)) {
+      if (IsShdrInFilter (RelShdr->sh_info, SECTION_TEXT) || IsShdrInFilter (RelShdr->sh_info, SECTION_DATA)) {
         UINT64 RelIdx;
 
         for (RelIdx = 0; RelIdx < RelShdr->sh_size; RelIdx += RelShdr->sh_entsize) {
@@ -1121,7 +1184,13 @@ CleanUp64 (
 {
   if (mCoffSectionsOffset != NULL) {
     free (mCoffSectionsOffset);
+    mCoffSectionsOffset = NULL;
+  }
+  if (mShdrFilter != NULL) {
+    free (mShdrFilter);
+    mShdrFilter = NULL;
   }
+  mStrtabShdr = NULL;
 }
 
 
@@ -1,7 +1,7 @@
 /** @file
 Elf convert solution
 
-Copyright (c) 2010 - 2016, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2010 - 2017, Intel Corporation. All rights reserved.<BR>
 
 This program and the accompanying materials are licensed and made available 
 under the terms and conditions of the BSD License which accompanies this 
@@ -41,6 +41,11 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 //
 UINT8 *mCoffFile = NULL;
 
+//
+// Allocated size of the Coff file buffer.
+//
+STATIC UINT32 mCoffFileSize;
+
 //
 // COFF relocation data
 //
@@ -80,6 +85,8 @@ CoffAddFixup(
   UINT8  Type
   )
 {
+  UINT32  NewSize;
+
   if (mCoffBaseRel == NULL
       || mCoffBaseRel->VirtualAddress != (Offset & ~0xfff)) {
     if (mCoffBaseRel != NULL) {
@@ -95,14 +102,22 @@ CoffAddFixup(
         CoffAddFixupEntry (0);
     }
 
-    mCoffFile = realloc (
-      mCoffFile,
-      mCoffOffset + sizeof(EFI_IMAGE_BASE_RELOCATION) + 2 * MAX_COFF_ALIGNMENT
-      );
-    if (mCoffFile == NULL) {
-      Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
+    //
+    // Grow the buffer geometrically, a new block is started for every 4 KB
+    // page that has fixups.
+    //
+    NewSize = mCoffOffset + sizeof(EFI_IMAGE_BASE_RELOCATION) + 2 * MAX_COFF_ALIGNMENT;
+    if (NewSize > mCoffFileSize) {
+      if (NewSize < 2 * mCoffFileSize) {
+        NewSize = 2 * mCoffFileSize;
+      }
+      mCoffFile = realloc (mCoffFile, NewSize);
+      if (mCoffFile == NULL) {
+        Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
+      }
+      assert (mCoffFile != NULL);
+      mCoffFileSize = NewSize;
     }
-    assert (mCoffFile != NULL);
     memset (
       mCoffFile + mCoffOffset, 0,
       sizeof(EFI_IMAGE_BASE_RELOCATION) + 2 * MAX_COFF_ALIGNMENT
@@ -197,6 +212,13 @@ ConvertElf (
   VerboseMsg ("Compute sections new address.");
   ElfFunctions.ScanSections ();
 
+  //
+  // ScanSections allocated the Coff file, and no fixup block is started yet.
+  //
+  mCoffFileSize = mCoffOffset;
+  mCoffBaseRel  = NULL;
+  mCoffEntryRel = NULL;
+
   //
   // Write and relocate sections.
   //
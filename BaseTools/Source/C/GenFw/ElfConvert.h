@@ -1,7 +1,7 @@
 /** @file
 Header file for Elf convert solution
 
-Copyright (c) 2010 - 2014, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2010 - 2017, Intel Corporation. All rights reserved.<BR>
 
 This program and the accompanying materials are licensed and made available 
 under the terms and conditions of the BSD License which accompanies this 
@@ -47,6 +47,8 @@ typedef enum {
   
 } SECTION_FILTER_TYPES;
 
+#define SECTION_FILTER_BIT(FilterType) (1 << (FilterType))
+
 //
 // FunctionTalbe
 //
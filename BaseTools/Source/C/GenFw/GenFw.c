@@ -1,7 +1,7 @@
 /** @file
 Converts a pe32+ image to an FW, Te image type, or other specific image.
 
-Copyright (c) 2004 - 2016, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2004 - 2017, Intel Corporation. All rights reserved.<BR>
 This program and the accompanying materials
 are licensed and made available under the terms and conditions of the BSD License
 which accompanies this distribution.  The full text of the license may be found at
@@ -60,6 +60,12 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #define DEFAULT_MC_ALIGNMENT       16
 
 #define STATUS_IGNORE 0xA
+
+//
+// Limits of one line of a --batch list file
+//
+#define MAX_BATCH_LINE_LEN      0x2000
+#define MAX_BATCH_ARGUMENT_NUM  0x100
 //
 // Structure definition for a microcode header
 //
@@ -284,6 +290,12 @@ Returns:
                         except for -o or -r option. It is a action option.\n\
                         If it is combined with other action options, the later\n\
                         input action option will override the previous one.\n");
+  fprintf (stdout, "  --batch ListFile      Run the options on each line of ListFile in turn, so that\n\
+                        many images are handled by one process. Each line holds\n\
+                        the options and input files of one image, separated by\n\
+                        spaces and quoted with \" if needed. Empty lines and lines\n\
+                        starting with # are skipped. It stops at the first line\n\
+                        that fails. It can't be combined with any other option.\n");
   fprintf (stdout, "  -v, --verbose         Turn on verbose output with informational messages.\n");
   fprintf (stdout, "  -q, --quiet           Disable all messages except key message and fatal error\n");
   fprintf (stdout, "  -d, --debug level     Enable debug messages, at input debug level.\n");
@@ -1031,8 +1043,9 @@ Returns:
   return Status;
 }
 
+STATIC
 int
-main (
+GenFwImage (
   int  argc,
   char *argv[]
   )
@@ -1040,7 +1053,7 @@ main (
 
 Routine Description:
 
-  Main function.
+  Handle one image as specified by the command line options.
 
 Arguments:
 
@@ -1115,7 +1128,12 @@ Returns:
   time_t                           OutputFileTime;
   struct stat                      Stat_Buf;
 
-  SetUtilityName (UTILITY_NAME);
+  //
+  // Reset the image information left by the previous image in batch mode.
+  //
+  mImageTimeStamp   = 0;
+  mImageSize        = 0;
+  mOutImageType     = FW_DUMMY_IMAGE;
 
   //
   // Assign to fix compile warning
@@ -1912,15 +1930,21 @@ Returns:
   }
 
   //
-  // Open input file and read file data into file buffer.
+  // The input data is only needed again to compare with and to restore the
+  // replaced input file. Otherwise work on it directly instead of a copy.
   //
   FileLength = InputFileLength;
-  FileBuffer = malloc (FileLength);
-  if (FileBuffer == NULL) {
-    Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
-    goto Finish;
+  if (!ReplaceFlag) {
+    FileBuffer      = InputFileBuffer;
+    InputFileBuffer = NULL;
+  } else {
+    FileBuffer = malloc (FileLength);
+    if (FileBuffer == NULL) {
+      Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
+      goto Finish;
+    }
+    memcpy (FileBuffer, InputFileBuffer, InputFileLength);
   }
-  memcpy (FileBuffer, InputFileBuffer, InputFileLength);
 
   //
   // Dump TeImage Header into output file.
@@ -2747,6 +2771,162 @@ Finish:
   return GetUtilityStatus ();
 }
 
+STATIC
+int
+GenFwBatch (
+  CHAR8  *ListFileName
+  )
+/*++
+
+Routine Description:
+
+  Handle the images listed in a batch list file, one line per image, in one
+  process.
+
+Arguments:
+
+  ListFileName - Name of the list file.
+
+Returns:
+  STATUS_SUCCESS - All images are handled successfully.
+  STATUS_WARNING - All images are handled, and some lines reported warnings.
+  STATUS_ERROR   - The list file can't be read, or one line failed.
+
+--*/
+{
+  FILE    *fpList;
+  CHAR8   *Line;
+  CHAR8   *Ptr;
+  CHAR8   *ArgList[MAX_BATCH_ARGUMENT_NUM + 2];
+  int     ArgNum;
+  UINT32  LineNum;
+  int     Status;
+  STATUS  LineStatus;
+  STATUS  WorstStatus;
+
+  fpList = fopen (LongFilePath (ListFileName), "r");
+  if (fpList == NULL) {
+    Error (NULL, 0, 0001, "Error opening file", ListFileName);
+    return STATUS_ERROR;
+  }
+
+  Line = (CHAR8 *) malloc (MAX_BATCH_LINE_LEN);
+  if (Line == NULL) {
+    Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
+    fclose (fpList);
+    return STATUS_ERROR;
+  }
+
+  Status      = STATUS_SUCCESS;
+  WorstStatus = GetUtilityStatus ();
+  LineNum     = 0;
+  while (fgets (Line, MAX_BATCH_LINE_LEN, fpList) != NULL) {
+    LineNum++;
+    if ((strlen (Line) == MAX_BATCH_LINE_LEN - 1) && (Line[MAX_BATCH_LINE_LEN - 2] != '\n') && !feof (fpList)) {
+      Error (ListFileName, LineNum, 1003, "Invalid batch line", "line is longer than %d characters", MAX_BATCH_LINE_LEN - 2);
+      Status = STATUS_ERROR;
+      break;
+    }
+
+    //
+    // Split the line into arguments in place. Double quotes group an
+    // argument with spaces and are removed.
+    //
+    ArgList[0] = UTILITY_NAME;
+    ArgNum     = 1;
+    Ptr        = Line;
+    while (*Ptr != 0) {
+      while ((*Ptr != 0) && isspace ((int) *Ptr)) {
+        Ptr++;
+      }
+      if ((*Ptr == 0) || ((ArgNum == 1) && (*Ptr == '#'))) {
+        break;
+      }
+      if (ArgNum > MAX_BATCH_ARGUMENT_NUM) {
+        Error (ListFileName, LineNum, 1003, "Invalid batch line", "more than %d arguments", MAX_BATCH_ARGUMENT_NUM);
+        Status = STATUS_ERROR;
+        break;
+      }
+      if (*Ptr == '"') {
+        ArgList[ArgNum++] = ++Ptr;
+        while ((*Ptr != 0) && (*Ptr != '"')) {
+          Ptr++;
+        }
+      } else {
+        ArgList[ArgNum++] = Ptr;
+        while ((*Ptr != 0) && !isspace ((int) *Ptr)) {
+          Ptr++;
+        }
+      }
+      if (*Ptr != 0) {
+        *Ptr++ = 0;
+      }
+    }
+    if (Status != STATUS_SUCCESS) {
+      break;
+    }
+    if (ArgNum == 1) {
+      continue;
+    }
+    ArgList[ArgNum] = NULL;
+
+    //
+    // Each line starts with the default message level and a clean status,
+    // so that the messages of one line don't decide the result of the next.
+    //
+    SetPrintLevel (INFO_LOG_LEVEL);
+    SetUtilityStatus (STATUS_SUCCESS);
+    LineStatus = GenFwImage (ArgNum, ArgList);
+    if (LineStatus > WorstStatus) {
+      WorstStatus = LineStatus;
+    }
+    SetUtilityStatus (WorstStatus);
+    if (LineStatus == STATUS_ERROR) {
+      Error (ListFileName, LineNum, 3000, "Batch line failed", "%s", ArgList[ArgNum - 1]);
+      Status = STATUS_ERROR;
+      break;
+    }
+  }
+
+  free (Line);
+  fclose (fpList);
+  if (Status != STATUS_SUCCESS) {
+    return Status;
+  }
+  return WorstStatus;
+}
+
+int
+main (
+  int  argc,
+  char *argv[]
+  )
+/*++
+
+Routine Description:
+
+  Main function.
+
+Arguments:
+
+  argc - Number of command line parameters.
+  argv - Array of pointers to command line parameter strings.
+
+Returns:
+  STATUS_SUCCESS - Utility exits successfully.
+  STATUS_ERROR   - Some error occurred during execution.
+
+--*/
+{
+  SetUtilityName (UTILITY_NAME);
+
+  if ((argc == 3) && (stricmp (argv[1], "--batch") == 0)) {
+    return GenFwBatch (argv[2]);
+  }
+
+  return GenFwImage (argc, argv);
+}
+
 STATIC
 EFI_STATUS
 ZeroDebugData (
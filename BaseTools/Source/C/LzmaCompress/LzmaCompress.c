@@ -5,7 +5,7 @@
     LzmaUtil.c -- Test application for LZMA compression
     2016-10-04 : Igor Pavlov : Public domain
 
-  Copyright (c) 2006 - 2016, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2006 - 2017, Intel Corporation. All rights reserved.<BR>
   This program and the accompanying materials
   are licensed and made available under the terms and conditions of the BSD License
   which accompanies this distribution.  The full text of the license may be found at
@@ -21,6 +21,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "Sdk/C/Alloc.h"
 #include "Sdk/C/7zFile.h"
@@ -29,9 +30,20 @@
 #include "Sdk/C/LzmaEnc.h"
 #include "Sdk/C/Bra.h"
 #include "CommonLib.h"
+#include <Common/PiFirmwareFile.h>
+#include <Guid/ChunkedSection.h>
 
 #define LZMA_HEADER_SIZE (LZMA_PROPS_SIZE + 8)
 
+//
+// With --chunk-size, each chunk is stored as a complete LZMA GUIDed section of
+// a chunked GUIDed section, so that the chunks can be decoded independently,
+// and in parallel, by the firmware.
+//
+#define MAX_CHUNK_SIZE             0x800000
+
+EFI_GUID mLzmaCustomDecompressGuid = { 0xEE4E5898, 0x3914, 0x4259, { 0x9D, 0x6E, 0xDC, 0x7B, 0xD7, 0x94, 0x03, 0xCF } };
+
 typedef enum {
   NoConverter, 
   X86Converter,
@@ -44,6 +56,8 @@ const char *kCantAllocateMessage = "Can not allocate memory";
 const char *kDataErrorMessage = "Data error";
 
 static Bool mQuietMode = False;
+static Bool mVerboseMode = False;
+static size_t mChunkSize = 0;
 static CONVERTER_TYPE mConType = NoConverter;
 
 #define UTILITY_NAME "LzmaCompress"
@@ -58,10 +72,13 @@ void PrintHelp(char *buffer)
       "Based on LZMA Utility " MY_VERSION_COPYRIGHT_DATE "\n"
       "\nUsage:  LzmaCompress -e|-d [options] <inputFile>\n"
              "  -e: encode file\n"
-             "  -d: decode file\n"
+             "  -d: decode file, either an LZMA stream or chunked section data\n"
              "  -o FileName, --output FileName: specify the output filename\n"
              "  --f86: enable converter for x86 code\n"
-             "  -v, --verbose: increase output messages\n"
+             "  --chunk-size Size: encode the input as independent LZMA sections of\n"
+             "                 Size bytes, wrapped in a chunked GUIDed section\n"
+             "  -v, --verbose: increase output messages, report decoder scratch\n"
+             "                 memory and throughput when decoding\n"
              "  -q, --quiet: reduce output messages\n"
              "  --debug [0-9]: set debug level\n"
              "  --version: display the program version and exit\n"
@@ -93,6 +110,130 @@ void PrintVersion(char *buffer)
   sprintf (buffer, "%s Version %d.%d %s ", UTILITY_NAME, UTILITY_MAJOR_VERSION, UTILITY_MINOR_VERSION, __BUILD_VERSION);
 }
 
+//
+// Encode inSize bytes of inBuffer as an LZMA stream with the 13 byte header
+// (properties and decoded size). On input *outSize is the size of outBuffer,
+// on output it is the size of the stream.
+//
+static SRes EncodeBuffer(const Byte *inBuffer, size_t inSize, Byte *outBuffer, size_t *outSize)
+{
+  SRes res;
+  CLzmaEncProps props;
+  size_t outSizeProcessed;
+  size_t outPropsSize = LZMA_PROPS_SIZE;
+  int i;
+
+  if (*outSize < LZMA_HEADER_SIZE)
+    return SZ_ERROR_OUTPUT_EOF;
+
+  LzmaEncProps_Init(&props);
+  LzmaEncProps_Normalize(&props);
+
+  for (i = 0; i < 8; i++)
+    outBuffer[i + LZMA_PROPS_SIZE] = (Byte)((UInt64)inSize >> (8 * i));
+
+  outSizeProcessed = *outSize - LZMA_HEADER_SIZE;
+  res = LzmaEncode(outBuffer + LZMA_HEADER_SIZE, &outSizeProcessed,
+      inBuffer, inSize, &props, outBuffer, &outPropsSize, 0,
+      NULL, &g_Alloc, &g_Alloc);
+  if (res != SZ_OK)
+    return res;
+
+  *outSize = LZMA_HEADER_SIZE + outSizeProcessed;
+  return SZ_OK;
+}
+
+static SRes EncodeChunked(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 fileSize)
+{
+  SRes res;
+  size_t inSize = (size_t)fileSize;
+  Byte *inBuffer = 0;
+  Byte *outBuffer = 0;
+  size_t outSize;
+  size_t chunkCount;
+  size_t index;
+  size_t offset;
+  size_t chunkInSize;
+  size_t chunkOutSize;
+  CHUNKED_SECTION_HEADER *header;
+  CHUNKED_SECTION_ENTRY *entry;
+  EFI_GUID_DEFINED_SECTION *section;
+
+  if (inSize == 0)
+    return SZ_ERROR_INPUT_EOF;
+  if (fileSize > 0xFFFFFFFF)
+    return SZ_ERROR_PARAM;
+
+  inBuffer = (Byte *)MyAlloc(inSize);
+  if (inBuffer == 0)
+    return SZ_ERROR_MEM;
+
+  if (SeqInStream_Read(inStream, inBuffer, inSize) != SZ_OK) {
+    res = SZ_ERROR_READ;
+    goto Done;
+  }
+
+  chunkCount = (inSize + mChunkSize - 1) / mChunkSize;
+
+  //
+  // Headers, plus 105% of each chunk + 64KB, plus section header and alignment per chunk.
+  //
+  outSize = sizeof (CHUNKED_SECTION_HEADER) + chunkCount * sizeof (CHUNKED_SECTION_ENTRY) +
+            inSize / 20 * 21 + chunkCount * ((1 << 16) + LZMA_HEADER_SIZE + sizeof (EFI_GUID_DEFINED_SECTION) + 3);
+  outBuffer = (Byte *)MyAlloc(outSize);
+  if (outBuffer == 0) {
+    res = SZ_ERROR_MEM;
+    goto Done;
+  }
+  memset(outBuffer, 0, outSize);
+
+  header = (CHUNKED_SECTION_HEADER *)outBuffer;
+  header->Signature   = CHUNKED_SECTION_SIGNATURE;
+  header->ChunkCount  = (UINT32)chunkCount;
+  header->DecodedSize = (UINT32)inSize;
+  entry = (CHUNKED_SECTION_ENTRY *)(header + 1);
+
+  offset = sizeof (CHUNKED_SECTION_HEADER) + chunkCount * sizeof (CHUNKED_SECTION_ENTRY);
+  for (index = 0; index < chunkCount; index++) {
+    offset = (offset + 3) & ~(size_t)3;
+    chunkInSize = inSize - index * mChunkSize;
+    if (chunkInSize > mChunkSize)
+      chunkInSize = mChunkSize;
+
+    section = (EFI_GUID_DEFINED_SECTION *)(outBuffer + offset);
+    chunkOutSize = outSize - offset - sizeof (EFI_GUID_DEFINED_SECTION);
+    res = EncodeBuffer(inBuffer + index * mChunkSize, chunkInSize, (Byte *)(section + 1), &chunkOutSize);
+    if (res != SZ_OK)
+      goto Done;
+
+    chunkOutSize += sizeof (EFI_GUID_DEFINED_SECTION);
+    if (chunkOutSize > 0xFFFFFF) {
+      res = SZ_ERROR_PARAM;
+      goto Done;
+    }
+    section->CommonHeader.Size[0] = (UINT8)(chunkOutSize & 0xFF);
+    section->CommonHeader.Size[1] = (UINT8)((chunkOutSize >> 8) & 0xFF);
+    section->CommonHeader.Size[2] = (UINT8)((chunkOutSize >> 16) & 0xFF);
+    section->CommonHeader.Type    = EFI_SECTION_GUID_DEFINED;
+    memcpy(&section->SectionDefinitionGuid, &mLzmaCustomDecompressGuid, sizeof (EFI_GUID));
+    section->DataOffset           = sizeof (EFI_GUID_DEFINED_SECTION);
+    section->Attributes           = EFI_GUIDED_SECTION_PROCESSING_REQUIRED;
+
+    entry[index].SectionOffset = (UINT32)offset;
+    entry[index].OutputOffset  = (UINT32)(index * mChunkSize);
+    offset += chunkOutSize;
+  }
+
+  if (outStream->Write(outStream, outBuffer, offset) != offset)
+    res = SZ_ERROR_WRITE;
+
+Done:
+  MyFree(outBuffer);
+  MyFree(inBuffer);
+
+  return res;
+}
+
 static SRes Encode(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 fileSize)
 {
   SRes res;
@@ -101,10 +242,6 @@ static SRes Encode(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 file
   Byte *outBuffer = 0;
   Byte *filteredStream = 0;
   size_t outSize;
-  CLzmaEncProps props;
-
-  LzmaEncProps_Init(&props);
-  LzmaEncProps_Normalize(&props);
 
   if (inSize != 0) {
     inBuffer = (Byte *)MyAlloc(inSize);
@@ -126,12 +263,6 @@ static SRes Encode(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 file
     res = SZ_ERROR_MEM;
     goto Done;
   }
-  
-  {
-    int i;
-    for (i = 0; i < 8; i++)
-      outBuffer[i + LZMA_PROPS_SIZE] = (Byte)(fileSize >> (8 * i));
-  }
 
   if (mConType != NoConverter)
   {
@@ -151,20 +282,9 @@ static SRes Encode(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 file
     }
   }
 
-  {
-    size_t outSizeProcessed = outSize - LZMA_HEADER_SIZE;
-    size_t outPropsSize = LZMA_PROPS_SIZE;
-    
-    res = LzmaEncode(outBuffer + LZMA_HEADER_SIZE, &outSizeProcessed,
-        mConType != NoConverter ? filteredStream : inBuffer, inSize,
-        &props, outBuffer, &outPropsSize, 0,
-        NULL, &g_Alloc, &g_Alloc);
-    
-    if (res != SZ_OK)
-      goto Done;
-
-    outSize = LZMA_HEADER_SIZE + outSizeProcessed;
-  }
+  res = EncodeBuffer(mConType != NoConverter ? filteredStream : inBuffer, inSize, outBuffer, &outSize);
+  if (res != SZ_OK)
+    goto Done;
 
   if (outStream->Write(outStream, outBuffer, outSize) != outSize)
     res = SZ_ERROR_WRITE;
@@ -177,6 +297,141 @@ Done:
   return res;
 }
 
+//
+// Allocator used by Decode() to account for the memory the decoder itself
+// allocates. The output buffer doubles as the dictionary, so this is the
+// scratch memory a firmware decompressor has to provide.
+//
+static size_t mDecodeScratchSize = 0;
+
+static void *CountingAlloc(void *p, size_t size)
+{
+  mDecodeScratchSize += size;
+  return MyAlloc(size);
+}
+
+static void CountingFree(void *p, void *address)
+{
+  MyFree(address);
+}
+
+static ISzAlloc g_CountingAlloc = { CountingAlloc, CountingFree };
+
+//
+// Decode the LZMA stream (with the 13 byte header) of inSize bytes at inBuffer
+// into outBuffer, whose size outSize is the decoded size given by the header.
+//
+static SRes DecodeBuffer(const Byte *inBuffer, size_t inSize, Byte *outBuffer, size_t outSize)
+{
+  SRes res;
+  size_t inSizePure;
+  size_t outSizeProcessed;
+  ELzmaStatus status;
+
+  inSizePure = inSize - LZMA_HEADER_SIZE;
+  outSizeProcessed = outSize;
+  res = LzmaDecode(outBuffer, &outSizeProcessed, inBuffer + LZMA_HEADER_SIZE, &inSizePure,
+      inBuffer, LZMA_PROPS_SIZE, LZMA_FINISH_END, &status, &g_CountingAlloc);
+  if (res == SZ_OK && outSizeProcessed != outSize)
+    res = SZ_ERROR_DATA;
+  return res;
+}
+
+//
+// Get the decoded size from the header of an LZMA stream of inSize bytes.
+//
+static SRes GetDecodedSize(const Byte *inBuffer, size_t inSize, size_t *outSize)
+{
+  UInt64 outSize64 = 0;
+  int i;
+
+  if (inSize < LZMA_HEADER_SIZE)
+    return SZ_ERROR_INPUT_EOF;
+
+  for (i = 0; i < 8; i++)
+    outSize64 += ((UInt64)inBuffer[LZMA_PROPS_SIZE + i]) << (i * 8);
+  if (outSize64 > (size_t)-1)
+    return SZ_ERROR_MEM;
+
+  *outSize = (size_t)outSize64;
+  return SZ_OK;
+}
+
+//
+// Decode chunked section data, as written by --chunk-size, into a buffer of
+// the decoded size of the whole section. Each chunk must be an LZMA GUIDed
+// section, and the chunks must cover the output without overlapping.
+//
+static SRes DecodeChunked(const Byte *inBuffer, size_t inSize, Byte **outBuffer, size_t *outSize)
+{
+  SRes res;
+  const CHUNKED_SECTION_HEADER *header;
+  const CHUNKED_SECTION_ENTRY *entry;
+  const EFI_GUID_DEFINED_SECTION *section;
+  Byte *covered;
+  size_t sectionSize;
+  size_t chunkSize;
+  UInt32 index;
+
+  header = (const CHUNKED_SECTION_HEADER *)inBuffer;
+  if (header->ChunkCount > (inSize - sizeof (CHUNKED_SECTION_HEADER)) / sizeof (CHUNKED_SECTION_ENTRY))
+    return SZ_ERROR_DATA;
+
+  *outSize = header->DecodedSize;
+  *outBuffer = (Byte *)MyAlloc(*outSize + 1);
+  covered = (Byte *)MyAlloc(*outSize + 1);
+  if (*outBuffer == 0 || covered == 0) {
+    MyFree(covered);
+    return SZ_ERROR_MEM;
+  }
+  memset(covered, 0, *outSize + 1);
+
+  res = SZ_OK;
+  entry = (const CHUNKED_SECTION_ENTRY *)(header + 1);
+  for (index = 0; index < header->ChunkCount; index++) {
+    if (entry[index].SectionOffset > inSize - sizeof (EFI_GUID_DEFINED_SECTION)) {
+      res = SZ_ERROR_DATA;
+      break;
+    }
+    section = (const EFI_GUID_DEFINED_SECTION *)(inBuffer + entry[index].SectionOffset);
+    sectionSize = section->CommonHeader.Size[0] |
+                  (section->CommonHeader.Size[1] << 8) |
+                  (section->CommonHeader.Size[2] << 16);
+    if (sectionSize > inSize - entry[index].SectionOffset ||
+        section->DataOffset > sectionSize ||
+        memcmp(&section->SectionDefinitionGuid, &mLzmaCustomDecompressGuid, sizeof (EFI_GUID)) != 0) {
+      res = SZ_ERROR_DATA;
+      break;
+    }
+
+    res = GetDecodedSize((const Byte *)section + section->DataOffset, sectionSize - section->DataOffset, &chunkSize);
+    if (res != SZ_OK)
+      break;
+    if (entry[index].OutputOffset > *outSize ||
+        chunkSize > *outSize - entry[index].OutputOffset ||
+        memchr(covered + entry[index].OutputOffset, 1, chunkSize) != NULL) {
+      res = SZ_ERROR_DATA;
+      break;
+    }
+
+    res = DecodeBuffer((const Byte *)section + section->DataOffset, sectionSize - section->DataOffset,
+        *outBuffer + entry[index].OutputOffset, chunkSize);
+    if (res != SZ_OK)
+      break;
+    memset(covered + entry[index].OutputOffset, 1, chunkSize);
+  }
+
+  if (res == SZ_OK && memchr(covered, 0, *outSize) != NULL)
+    res = SZ_ERROR_DATA;
+
+  MyFree(covered);
+  if (res != SZ_OK) {
+    MyFree(*outBuffer);
+    *outBuffer = 0;
+  }
+  return res;
+}
+
 static SRes Decode(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 fileSize)
 {
   SRes res;
@@ -184,11 +439,8 @@ static SRes Decode(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 file
   Byte *inBuffer = 0;
   Byte *outBuffer = 0;
   size_t outSize = 0;
-  size_t inSizePure;
-  ELzmaStatus status;
-  UInt64 outSize64 = 0;
-
-  int i;
+  clock_t start;
+  double duration;
 
   if (inSize < LZMA_HEADER_SIZE) 
     return SZ_ERROR_INPUT_EOF;
@@ -202,28 +454,43 @@ static SRes Decode(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 file
     goto Done;
   }
 
-  for (i = 0; i < 8; i++)
-    outSize64 += ((UInt64)inBuffer[LZMA_PROPS_SIZE + i]) << (i * 8);
-
-  outSize = (size_t)outSize64;
-  if (outSize != 0) {
+  mDecodeScratchSize = 0;
+  start = clock();
+  if (inSize >= sizeof (CHUNKED_SECTION_HEADER) &&
+      ((CHUNKED_SECTION_HEADER *)inBuffer)->Signature == CHUNKED_SECTION_SIGNATURE) {
+    //
+    // Chunked section data, as written by --chunk-size, which does not
+    // support --f86.
+    //
+    if (mConType != NoConverter) {
+      res = SZ_ERROR_UNSUPPORTED;
+      goto Done;
+    }
+    res = DecodeChunked(inBuffer, inSize, &outBuffer, &outSize);
+  } else {
+    res = GetDecodedSize(inBuffer, inSize, &outSize);
+    if (res != SZ_OK || outSize == 0)
+      goto Done;
     outBuffer = (Byte *)MyAlloc(outSize);
     if (outBuffer == 0) {
       res = SZ_ERROR_MEM;
       goto Done;
     }
-  } else {
-    res = SZ_OK;
-    goto Done;
+    res = DecodeBuffer(inBuffer, inSize, outBuffer, outSize);
   }
-
-  inSizePure = inSize - LZMA_HEADER_SIZE;
-  res = LzmaDecode(outBuffer, &outSize, inBuffer + LZMA_HEADER_SIZE, &inSizePure,
-      inBuffer, LZMA_PROPS_SIZE, LZMA_FINISH_END, &status, &g_Alloc);
+  duration = (double)(clock() - start) / CLOCKS_PER_SEC;
 
   if (res != SZ_OK)
     goto Done;
 
+  if (mVerboseMode) {
+    if (duration < 1e-9) {
+      duration = 1e-9;
+    }
+    printf("Decoder scratch memory: %u bytes\n", (unsigned)mDecodeScratchSize);
+    printf("Decoded %u bytes, %g MB/s\n", (unsigned)outSize, (double)outSize / (1024.0 * 1024.0) / duration);
+  }
+
   if (mConType == X86Converter)
   {
     UInt32 x86State;
@@ -271,6 +538,17 @@ int main2(int numArgs, const char *args[], char *rs)
       modeWasSet = True;
     } else if (strcmp(args[param], "--f86") == 0) {
       mConType = X86Converter;
+    } else if (strcmp(args[param], "--chunk-size") == 0) {
+      unsigned long chunkSize;
+      char *end;
+      if (numArgs < (param + 2)) {
+        return PrintUserError(rs);
+      }
+      chunkSize = strtoul(args[++param], &end, 0);
+      if (*end != '\0' || chunkSize == 0 || chunkSize > MAX_CHUNK_SIZE) {
+        return PrintError(rs, "Chunk size must be between 1 and 0x800000");
+      }
+      mChunkSize = (size_t)chunkSize;
     } else if (strcmp(args[param], "-o") == 0 ||
                strcmp(args[param], "--output") == 0) {
       if (numArgs < (param + 2)) {
@@ -296,10 +574,7 @@ int main2(int numArgs, const char *args[], char *rs)
                 strcmp(args[param], "-v") == 0 ||
                 strcmp(args[param], "--verbose") == 0
               ) {
-      //
-      // For now we silently ignore this parameter to achieve command line
-      // parameter compatibility with other build tools.
-      //
+      mVerboseMode = True;
     } else if (
                 strcmp(args[param], "-q") == 0 ||
                 strcmp(args[param], "--quiet") == 0
@@ -319,6 +594,10 @@ int main2(int numArgs, const char *args[], char *rs)
     return PrintUserError(rs);
   }
 
+  if (mChunkSize != 0 && (!encodeMode || mConType != NoConverter)) {
+    return PrintError(rs, "--chunk-size is only supported for encoding without --f86, -d detects chunked data");
+  }
+
   {
     size_t t4 = sizeof(UInt32);
     size_t t8 = sizeof(UInt64);
@@ -341,7 +620,11 @@ int main2(int numArgs, const char *args[], char *rs)
     if (!mQuietMode) {
       printf("Encoding\n");
     }
-    res = Encode(&outStream.s, &inStream.s, fileSize);
+    if (mChunkSize != 0) {
+      res = EncodeChunked(&outStream.s, &inStream.s, fileSize);
+    } else {
+      res = Encode(&outStream.s, &inStream.s, fileSize);
+    }
   }
   else
   {
@@ -364,6 +647,8 @@ int main2(int numArgs, const char *args[], char *rs)
       return PrintError(rs, kCantWriteMessage);
     else if (res == SZ_ERROR_READ)
       return PrintError(rs, kCantReadMessage);
+    else if (res == SZ_ERROR_UNSUPPORTED)
+      return PrintError(rs, "--f86 is not supported for chunked data");
     return PrintErrorNumber(rs, res);
   }
   return 0;
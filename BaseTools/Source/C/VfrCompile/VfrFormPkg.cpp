@@ -1005,6 +1005,13 @@ CIfrRecordInfoDB::CIfrRecordInfoDB (
   mRecordCount       = EFI_IFR_RECORDINFO_IDX_START;
   mIfrRecordListHead = NULL;
   mIfrRecordListTail = NULL;
+  mRecordIndex       = NULL;
+  mRecordIndexCount  = 0;
+  mRecordIndexSize   = 0;
+  mRecordIndexValid  = TRUE;
+  mLineIndex         = NULL;
+  mLineIndexCount    = 0;
+  mLineIndexValid    = FALSE;
   mAllDefaultTypeCount = 0;
   for (UINT8 i = 0; i < EFI_HII_MAX_SUPPORT_DEFAULT_TYPE; i++) {
     mAllDefaultIdArray[i] = 0xffff;
@@ -1022,6 +1029,140 @@ CIfrRecordInfoDB::~CIfrRecordInfoDB (
     mIfrRecordListHead = mIfrRecordListHead->mNext;
     delete pNode;
   }
+
+  if (mRecordIndex != NULL) {
+    delete[] mRecordIndex;
+  }
+  if (mLineIndex != NULL) {
+    delete[] mLineIndex;
+  }
+}
+
+VOID
+CIfrRecordInfoDB::InvalidateRecordIndex (
+  VOID
+  )
+{
+  mRecordIndexValid = FALSE;
+  mLineIndexValid   = FALSE;
+}
+
+BOOLEAN
+CIfrRecordInfoDB::BuildRecordIndex (
+  VOID
+  )
+{
+  UINT32     Count;
+  SIfrRecord *pNode;
+
+  if (mRecordIndexValid) {
+    return TRUE;
+  }
+
+  for (Count = 0, pNode = mIfrRecordListHead; pNode != NULL; pNode = pNode->mNext) {
+    Count++;
+  }
+
+  if (Count > mRecordIndexSize) {
+    if (mRecordIndex != NULL) {
+      delete[] mRecordIndex;
+    }
+    mRecordIndexSize = Count;
+    if ((mRecordIndex = new SIfrRecord *[mRecordIndexSize]) == NULL) {
+      mRecordIndexSize = 0;
+      return FALSE;
+    }
+  }
+
+  for (Count = 0, pNode = mIfrRecordListHead; pNode != NULL; pNode = pNode->mNext) {
+    mRecordIndex[Count++] = pNode;
+  }
+  mRecordIndexCount = Count;
+  mRecordIndexValid = TRUE;
+
+  return TRUE;
+}
+
+BOOLEAN
+CIfrRecordInfoDB::BuildLineIndex (
+  VOID
+  )
+{
+  SIfrRecord **Src;
+  SIfrRecord **Dst;
+  SIfrRecord **Tmp;
+  SIfrRecord **Buffer;
+  UINT32     Width;
+  UINT32     Start;
+  UINT32     Mid;
+  UINT32     End;
+  UINT32     Left;
+  UINT32     Right;
+  UINT32     Index;
+
+  if (mLineIndexValid) {
+    return TRUE;
+  }
+
+  if (!BuildRecordIndex ()) {
+    return FALSE;
+  }
+
+  if (mLineIndex != NULL) {
+    delete[] mLineIndex;
+    mLineIndex = NULL;
+  }
+  mLineIndexCount = 0;
+
+  if (mRecordIndexCount == 0) {
+    mLineIndexValid = TRUE;
+    return TRUE;
+  }
+
+  if ((mLineIndex = new SIfrRecord *[mRecordIndexCount]) == NULL) {
+    return FALSE;
+  }
+  if ((Buffer = new SIfrRecord *[mRecordIndexCount]) == NULL) {
+    delete[] mLineIndex;
+    mLineIndex = NULL;
+    return FALSE;
+  }
+
+  //
+  // Bottom-up merge sort by line number. It is stable, so records sharing
+  // a line keep their list order, as the list file has always shown them.
+  //
+  memcpy (mLineIndex, mRecordIndex, mRecordIndexCount * sizeof (SIfrRecord *));
+  Src = mLineIndex;
+  Dst = Buffer;
+  for (Width = 1; Width < mRecordIndexCount; Width *= 2) {
+    for (Start = 0; Start < mRecordIndexCount; Start += 2 * Width) {
+      Mid   = (Start + Width < mRecordIndexCount) ? Start + Width : mRecordIndexCount;
+      End   = (Mid + Width < mRecordIndexCount) ? Mid + Width : mRecordIndexCount;
+      Left  = Start;
+      Right = Mid;
+      for (Index = Start; Index < End; Index++) {
+        if (Left < Mid && (Right >= End || Src[Left]->mLineNo <= Src[Right]->mLineNo)) {
+          Dst[Index] = Src[Left++];
+        } else {
+          Dst[Index] = Src[Right++];
+        }
+      }
+    }
+    Tmp = Src;
+    Src = Dst;
+    Dst = Tmp;
+  }
+
+  if (Src != mLineIndex) {
+    memcpy (mLineIndex, Src, mRecordIndexCount * sizeof (SIfrRecord *));
+  }
+  delete[] Buffer;
+
+  mLineIndexCount = mRecordIndexCount;
+  mLineIndexValid = TRUE;
+
+  return TRUE;
 }
 
 SIfrRecord *
@@ -1029,19 +1170,19 @@ CIfrRecordInfoDB::GetRecordInfoFromIdx (
   IN UINT32 RecordIdx
   )
 {
-  UINT32     Idx;
-  SIfrRecord *pNode = NULL;
-
   if (RecordIdx == EFI_IFR_RECORDINFO_IDX_INVALUD) {
     return NULL;
   }
 
-  for (Idx = (EFI_IFR_RECORDINFO_IDX_START + 1), pNode = mIfrRecordListHead;
-       (Idx != RecordIdx) && (pNode != NULL);
-       Idx++, pNode = pNode->mNext)
-  ;
+  if (RecordIdx <= EFI_IFR_RECORDINFO_IDX_START || !BuildRecordIndex ()) {
+    return NULL;
+  }
+
+  if (RecordIdx - (EFI_IFR_RECORDINFO_IDX_START + 1) >= mRecordIndexCount) {
+    return NULL;
+  }
 
-  return pNode;
+  return mRecordIndex[RecordIdx - (EFI_IFR_RECORDINFO_IDX_START + 1)];
 }
 
 UINT32
@@ -1071,6 +1212,32 @@ CIfrRecordInfoDB::IfrRecordRegister (
   }
   mRecordCount++;
 
+  //
+  // The new record is the tail, so a valid index only needs to grow.
+  //
+  if (mRecordIndexValid) {
+    if (mRecordIndexCount == mRecordIndexSize) {
+      SIfrRecord **NewIndex;
+      UINT32     NewSize;
+
+      NewSize = (mRecordIndexSize == 0) ? 256 : mRecordIndexSize * 2;
+      if ((NewIndex = new SIfrRecord *[NewSize]) == NULL) {
+        mRecordIndexValid = FALSE;
+      } else {
+        if (mRecordIndex != NULL) {
+          memcpy (NewIndex, mRecordIndex, mRecordIndexCount * sizeof (SIfrRecord *));
+          delete[] mRecordIndex;
+        }
+        mRecordIndex     = NewIndex;
+        mRecordIndexSize = NewSize;
+      }
+    }
+    if (mRecordIndexValid) {
+      mRecordIndex[mRecordIndexCount++] = pNew;
+    }
+  }
+  mLineIndexValid = FALSE;
+
   return mRecordCount;
 }
 
@@ -1100,6 +1267,9 @@ CIfrRecordInfoDB::IfrRecordInfoUpdate (
     }
   }
 
+  if (pNode->mLineNo != LineNo) {
+    mLineIndexValid = FALSE;
+  }
   pNode->mLineNo    = LineNo;
   pNode->mOffset    = Offset;
   pNode->mBinBufLen = BinBufLen;
@@ -1158,6 +1328,9 @@ CIfrRecordInfoDB::IfrRecordOutput (
   SIfrRecord *pNode;
   UINT8      Index;
   UINT32     TotalSize;
+  UINT32     Low;
+  UINT32     High;
+  UINT32     Mid;
 
   if (mSwitch == FALSE) {
     return;
@@ -1167,6 +1340,34 @@ CIfrRecordInfoDB::IfrRecordOutput (
     return;
   }
 
+  //
+  // The list file asks for the records of every source line in turn, so
+  // look them up in the line index instead of scanning the whole list.
+  //
+  if (LineNo != 0 && BuildLineIndex ()) {
+    Low  = 0;
+    High = mLineIndexCount;
+    while (Low < High) {
+      Mid = Low + (High - Low) / 2;
+      if (mLineIndex[Mid]->mLineNo < LineNo) {
+        Low = Mid + 1;
+      } else {
+        High = Mid;
+      }
+    }
+    for (; Low < mLineIndexCount && mLineIndex[Low]->mLineNo == LineNo; Low++) {
+      pNode = mLineIndex[Low];
+      fprintf (File, ">%08X: ", pNode->mOffset);
+      if (pNode->mIfrBinBuf != NULL) {
+        for (Index = 0; Index < pNode->mBinBufLen; Index++) {
+          fprintf (File, "%02X ", (UINT8)(pNode->mIfrBinBuf[Index]));
+        }
+      }
+      fprintf (File, "\n");
+    }
+    return;
+  }
+
   TotalSize = 0;
 
   for (pNode = mIfrRecordListHead; pNode != NULL; pNode = pNode->mNext) {
@@ -1329,6 +1530,7 @@ CIfrRecordInfoDB::IfrAdjustDynamicOpcodeInRecords (
   //
   // Adjust the node. pPreNode save the Node before mIfrRecordListTail
   //
+  InvalidateRecordIndex ();
   pNodeBeforeAdjust->mNext = pNodeBeforeDynamic->mNext;
   if (CreateOpcodeAfterParsingVfr) {
     //
@@ -1510,6 +1712,7 @@ CIfrRecordInfoDB::IfrRecordAdjust (
           uNode = uNode->mNext;
         }
 
+        InvalidateRecordIndex ();
         preNode->mNext = tNode->mNext;
         tNode->mNext = uNode->mNext;
         uNode->mNext = pNode;
@@ -1579,6 +1782,7 @@ CIfrRecordInfoDB::IfrRecordAdjust (
         // Insert varstore opcode beform form opcode if form opcode is found
         //
         if (uNode->mNext != NULL) {
+          InvalidateRecordIndex ();
           preNode->mNext = tNode->mNext;
           tNode->mNext = uNode->mNext;
           uNode->mNext = pNode;
@@ -213,6 +213,24 @@ private:
   UINT8      mAllDefaultTypeCount;
   UINT16     mAllDefaultIdArray[EFI_HII_MAX_SUPPORT_DEFAULT_TYPE];
 
+  //
+  // Records in list order, so that a record index is resolved without
+  // walking the list. Rebuilt on demand after the list is re-linked.
+  //
+  SIfrRecord **mRecordIndex;
+  UINT32     mRecordIndexCount;
+  UINT32     mRecordIndexSize;
+  BOOLEAN    mRecordIndexValid;
+  //
+  // Records stably sorted by line number, used when writing the list file.
+  //
+  SIfrRecord **mLineIndex;
+  UINT32     mLineIndexCount;
+  BOOLEAN    mLineIndexValid;
+
+  VOID             InvalidateRecordIndex (VOID);
+  BOOLEAN          BuildRecordIndex (VOID);
+  BOOLEAN          BuildLineIndex (VOID);
   SIfrRecord * GetRecordInfoFromIdx (IN UINT32);
   BOOLEAN          CheckQuestionOpCode (IN UINT8);
   BOOLEAN          CheckIdOpCode (IN UINT8);
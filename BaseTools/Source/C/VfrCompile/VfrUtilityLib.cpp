@@ -136,6 +136,7 @@ SConfigItem::SConfigItem (
   mGuid          = NULL;
   mId            = NULL;
   mInfoStrList = NULL;
+  mOffsetMap   = NULL;
   mNext        = NULL;
 
   if (Name != NULL) {
@@ -171,6 +172,7 @@ SConfigItem::SConfigItem (
   mGuid        = NULL;
   mId          = NULL;
   mInfoStrList = NULL;
+  mOffsetMap   = NULL;
   mNext        = NULL;
 
   if (Name != NULL) {
@@ -192,6 +194,10 @@ SConfigItem::SConfigItem (
   }
 
   mInfoStrList = new SConfigInfo(Type, Offset, Width, Value);
+  if ((mOffsetMap = new UINT8[0x10000 / 8]) != NULL) {
+    memset (mOffsetMap, 0, 0x10000 / 8);
+    mOffsetMap[Offset / 8] |= (UINT8) (1 << (Offset % 8));
+  }
 }
 
 SConfigItem::~SConfigItem (
@@ -203,6 +209,7 @@ SConfigItem::~SConfigItem (
   ARRAY_SAFE_FREE (mName);
   ARRAY_SAFE_FREE (mGuid);
   ARRAY_SAFE_FREE (mId);
+  ARRAY_SAFE_FREE (mOffsetMap);
   while (mInfoStrList != NULL) {
     Info = mInfoStrList;
     mInfoStrList = mInfoStrList->mNext;
@@ -325,17 +332,27 @@ CVfrBufferConfig::Write (
       }
       mItemListPos = pItem;
     } else {
-      // tranverse the list to find out if there's already the value for the same offset
-      for (pInfo = mItemListPos->mInfoStrList; pInfo != NULL; pInfo = pInfo->mNext) {
-        if (pInfo->mOffset == Offset) {
-          return 0;
+      //
+      // Check the offset bitmap to find out if there's already the value for the same offset
+      //
+      if (mItemListPos->mOffsetMap == NULL) {
+        if ((mItemListPos->mOffsetMap = new UINT8[0x10000 / 8]) == NULL) {
+          return 2;
+        }
+        memset (mItemListPos->mOffsetMap, 0, 0x10000 / 8);
+        for (pInfo = mItemListPos->mInfoStrList; pInfo != NULL; pInfo = pInfo->mNext) {
+          mItemListPos->mOffsetMap[pInfo->mOffset / 8] |= (UINT8) (1 << (pInfo->mOffset % 8));
         }
       }
+      if ((mItemListPos->mOffsetMap[Offset / 8] & (1 << (Offset % 8))) != 0) {
+        return 0;
+      }
       if((pInfo = new SConfigInfo (Type, Offset, Width, Value)) == NULL) {
         return 2;
       }
       pInfo->mNext = mItemListPos->mInfoStrList;
       mItemListPos->mInfoStrList = pInfo;
+      mItemListPos->mOffsetMap[Offset / 8] |= (UINT8) (1 << (Offset % 8));
     }
     break;
 
@@ -568,13 +585,41 @@ _STR2U32 (
   return Value;
 }
 
+STATIC
+UINT32
+_DATA_TYPE_HASH (
+  IN CONST CHAR8 *TypeName
+  )
+{
+  UINT32  Hash;
+
+  for (Hash = 0; *TypeName != '\0'; TypeName++) {
+    Hash = Hash * 31 + (UINT8) *TypeName;
+  }
+
+  return Hash % VFR_DATA_TYPE_HASH_SIZE;
+}
+
 VOID
 CVfrVarDataTypeDB::RegisterNewType (
   IN SVfrDataType  *New
   )
 {
+  UINT32 Bucket;
+
   New->mNext               = mDataTypeList;
   mDataTypeList            = New;
+
+  //
+  // New types shadow older ones of the same name, as in mDataTypeList.
+  //
+  Bucket                   = _DATA_TYPE_HASH (New->mTypeName);
+  New->mHashNext           = mDataTypeHash[Bucket];
+  mDataTypeHash[Bucket]    = New;
+
+  if (New->mType <= EFI_IFR_TYPE_REF && New->mType != EFI_IFR_TYPE_OTHER) {
+    mIfrDataType[New->mType] = New;
+  }
 }
 
 EFI_VFR_RETURN_CODE
@@ -873,6 +918,8 @@ CVfrVarDataTypeDB::CVfrVarDataTypeDB (
 {
   mDataTypeList  = NULL;
   mNewDataType   = NULL;
+  memset (mDataTypeHash, 0, sizeof (mDataTypeHash));
+  memset (mIfrDataType, 0, sizeof (mIfrDataType));
   mCurrDataField = NULL;
   mPackAlign     = DEFAULT_PACK_ALIGN;
   mPackStack     = NULL;
@@ -1019,6 +1066,7 @@ CVfrVarDataTypeDB::DataTypeAddField (
   SVfrDataField       *pNewField  = NULL;
   SVfrDataType        *pFieldType = NULL;
   SVfrDataField       *pTmp;
+  SVfrDataField       *pLast;
   UINT32              Align;
 
   CHECK_ERROR_RETURN (GetDataType (TypeName, &pFieldType), VFR_RETURN_SUCCESS);
@@ -1027,7 +1075,7 @@ CVfrVarDataTypeDB::DataTypeAddField (
    return VFR_RETURN_INVALID_PARAMETER;
   }
 
-  for (pTmp = mNewDataType->mMembers; pTmp != NULL; pTmp = pTmp->mNext) {
+  for (pLast = NULL, pTmp = mNewDataType->mMembers; pTmp != NULL; pLast = pTmp, pTmp = pTmp->mNext) {
     if (strcmp (pTmp->mFieldName, FieldName) == 0) {
       return VFR_RETURN_REDEFINED;
     }
@@ -1046,13 +1094,11 @@ CVfrVarDataTypeDB::DataTypeAddField (
   } else {
     pNewField->mOffset     = mNewDataType->mTotalSize + ALIGN_STUFF(mNewDataType->mTotalSize, Align);
   }
-  if (mNewDataType->mMembers == NULL) {
+  if (pLast == NULL) {
     mNewDataType->mMembers = pNewField;
     pNewField->mNext       = NULL;
   } else {
-    for (pTmp = mNewDataType->mMembers; pTmp->mNext != NULL; pTmp = pTmp->mNext)
-      ;
-    pTmp->mNext            = pNewField;
+    pLast->mNext           = pNewField;
     pNewField->mNext       = NULL;
   }
 
@@ -1101,7 +1147,7 @@ CVfrVarDataTypeDB::GetDataType (
 
   *DataType = NULL;
 
-  for (pDataType = mDataTypeList; pDataType != NULL; pDataType = pDataType->mNext) {
+  for (pDataType = mDataTypeHash[_DATA_TYPE_HASH (TypeName)]; pDataType != NULL; pDataType = pDataType->mHashNext) {
     if (strcmp (TypeName, pDataType->mTypeName) == 0) {
       *DataType = pDataType;
       return VFR_RETURN_SUCCESS;
@@ -1133,11 +1179,12 @@ CVfrVarDataTypeDB::GetDataTypeSize (
     return VFR_RETURN_SUCCESS;
   }
 
-  for (pDataType = mDataTypeList; pDataType != NULL; pDataType = pDataType->mNext) {
-    if (DataType == pDataType->mType) {
-      *Size = pDataType->mTotalSize;
-      return VFR_RETURN_SUCCESS;
-    }
+  //
+  // Only the internal types carry an IFR type other than EFI_IFR_TYPE_OTHER.
+  //
+  if (DataType <= EFI_IFR_TYPE_REF && (pDataType = mIfrDataType[DataType]) != NULL) {
+    *Size = pDataType->mTotalSize;
+    return VFR_RETURN_SUCCESS;
   }
 
   return VFR_RETURN_UNDEFINED;
@@ -1157,11 +1204,9 @@ CVfrVarDataTypeDB::GetDataTypeSize (
 
   *Size = 0;
 
-  for (pDataType = mDataTypeList; pDataType != NULL; pDataType = pDataType->mNext) {
-    if (strcmp (TypeName, pDataType->mTypeName) == 0) {
-      *Size = pDataType->mTotalSize;
-      return VFR_RETURN_SUCCESS;
-    }
+  if (GetDataType (TypeName, &pDataType) == VFR_RETURN_SUCCESS) {
+    *Size = pDataType->mTotalSize;
+    return VFR_RETURN_SUCCESS;
   }
 
   return VFR_RETURN_UNDEFINED;
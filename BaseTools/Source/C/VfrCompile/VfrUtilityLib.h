@@ -66,6 +66,7 @@ struct SConfigItem {
   EFI_GUID      *mGuid;         // varstore guid, varstore name + guid deside one varstore
   CHAR8         *mId;           // default ID
   SConfigInfo   *mInfoStrList;  // list of Offset/Value in the varstore
+  UINT8         *mOffsetMap;    // bitmap of the offsets present in mInfoStrList
   SConfigItem   *mNext;
 
 public:
@@ -108,6 +109,7 @@ extern CVfrBufferConfig gCVfrBufferConfig;
 
 #define ALIGN_STUFF(Size, Align) ((Align) - (Size) % (Align))
 #define INVALID_ARRAY_INDEX      0xFFFFFFFF
+#define VFR_DATA_TYPE_HASH_SIZE  0x100
 
 struct SVfrDataType;
 
@@ -126,6 +128,7 @@ struct SVfrDataType {
   UINT32                    mTotalSize;
   SVfrDataField             *mMembers;
   SVfrDataType              *mNext;
+  SVfrDataType              *mHashNext;
 };
 
 #define VFR_PACK_ASSIGN     0x01
@@ -185,6 +188,11 @@ public:
 
 private:
   SVfrDataType              *mDataTypeList;
+  //
+  // Name index over mDataTypeList, and the internal type for each IFR type.
+  //
+  SVfrDataType              *mDataTypeHash[VFR_DATA_TYPE_HASH_SIZE];
+  SVfrDataType              *mIfrDataType[EFI_IFR_TYPE_REF + 1];
 
   SVfrDataType              *mNewDataType;
   SVfrDataType              *mCurrDataType;
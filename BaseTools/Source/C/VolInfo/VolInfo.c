@@ -29,6 +29,7 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include <Common/PiFirmwareFile.h>
 #include <Common/PiFirmwareVolume.h>
 #include <Guid/PiFirmwareFileSystem.h>
+#include <Guid/ChunkedSection.h>
 #include <IndustryStandard/PeImage.h>
 #include <Protocol/GuidedSectionExtraction.h>
 
@@ -43,6 +44,9 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include "StringFuncs.h"
 #include "ParseInf.h"
 #include "PeCoffLib.h"
+#include "LzmaDec.h"
+#include "Bra.h"
+#include "decode.h"
 
 //
 // Utility global variables
@@ -59,6 +63,28 @@ EFI_GUID  gEfiCrc32GuidedSectionExtractionProtocolGuid = EFI_CRC32_GUIDED_SECTIO
 
 #define MAX_BASENAME_LEN  60  // not good to hardcode, but let's be reasonable
 
+#define MAX_JSON_DEPTH    0x100
+
+//
+// GUIDed sections decoded in-process, without running the tool given for them
+// in GuidedSectionTools.txt
+//
+STATIC EFI_GUID  mTianoCustomDecompressGuid   = { 0xA31280AD, 0x481E, 0x41B6, { 0x95, 0xE8, 0x12, 0x7F, 0x4C, 0x98, 0x47, 0x79 } };
+STATIC EFI_GUID  mLzmaCustomDecompressGuid    = { 0xEE4E5898, 0x3914, 0x4259, { 0x9D, 0x6E, 0xDC, 0x7B, 0xD7, 0x94, 0x03, 0xCF } };
+STATIC EFI_GUID  mLzmaF86CustomDecompressGuid = { 0xD42AE6BD, 0x1352, 0x4BFB, { 0x90, 0x9A, 0xCA, 0x72, 0xA6, 0xEA, 0xE8, 0x89 } };
+STATIC EFI_GUID  mBrotliCustomDecompressGuid  = { 0x3D532050, 0x5CDA, 0x4FD0, { 0x87, 0x9E, 0x0F, 0x7F, 0x63, 0x0D, 0x5A, 0xFB } };
+STATIC EFI_GUID  mChunkedSectionGuid          = EDKII_CHUNKED_SECTION_GUID;
+
+//
+// LZMA data starts with the coder properties and the 64-bit decoded size
+//
+#define LZMA_HEADER_SIZE  (LZMA_PROPS_SIZE + 8)
+
+//
+// Brotli data starts with the 64-bit decoded size and the 64-bit scratch size
+//
+#define BROTLI_HEADER_SIZE  16
+
 //
 // Structure to keep a list of guid-to-basenames
 //
@@ -80,6 +106,15 @@ CHAR8* mUtilityFilename = NULL;
 BOOLEAN EnableHash = FALSE;
 CHAR8 *OpenSslPath = NULL;
 
+//
+// JSON output state. mJsonClose keeps the closing character of every object
+// or array still open, so that the output can be completed on any error path.
+//
+STATIC FILE     *mJsonFile = NULL;
+STATIC UINT32   mJsonDepth = 0;
+STATIC BOOLEAN  mJsonFirst = TRUE;
+STATIC CHAR8    mJsonClose[MAX_JSON_DEPTH];
+
 EFI_STATUS
 ParseGuidBaseNameFile (
   CHAR8    *FileName
@@ -207,6 +242,648 @@ Unicode2AsciiString (
   *Destination = '\0';
 }
 
+STATIC
+VOID
+JsonWriteString (
+  IN CHAR8  *String
+  )
+/*++
+
+Routine Description:
+
+  Write a string to the JSON output as a quoted and escaped JSON string.
+
+Arguments:
+
+  String - The null-terminated ascii string to write.
+
+Returns:
+
+  None
+
+--*/
+{
+  fputc ('"', mJsonFile);
+  for (; *String != '\0'; String++) {
+    if (*String == '"' || *String == '\\') {
+      fputc ('\\', mJsonFile);
+      fputc (*String, mJsonFile);
+    } else if ((UINT8) *String < 0x20) {
+      fprintf (mJsonFile, "\\u%04x", (unsigned) (UINT8) *String);
+    } else {
+      fputc (*String, mJsonFile);
+    }
+  }
+  fputc ('"', mJsonFile);
+}
+
+STATIC
+VOID
+JsonWriteName (
+  IN CHAR8  *Name
+  )
+/*++
+
+Routine Description:
+
+  Start a new value in the JSON output: write the separator from the previous
+  value, the indentation and, inside an object, the name of the value.
+
+Arguments:
+
+  Name - Name of the value, or NULL for a value in an array.
+
+Returns:
+
+  None
+
+--*/
+{
+  UINT32  Index;
+
+  if (!mJsonFirst) {
+    fputc (',', mJsonFile);
+  }
+  if (mJsonDepth > 0) {
+    fputc ('\n', mJsonFile);
+  }
+  for (Index = 0; Index < mJsonDepth; Index++) {
+    fputs ("  ", mJsonFile);
+  }
+  mJsonFirst = FALSE;
+
+  if (Name != NULL) {
+    JsonWriteString (Name);
+    fputs (": ", mJsonFile);
+  }
+}
+
+STATIC
+VOID
+JsonBegin (
+  IN CHAR8  *Name,
+  IN CHAR8  Open
+  )
+/*++
+
+Routine Description:
+
+  Open a JSON object or array. Nothing is written if JSON output is off.
+
+Arguments:
+
+  Name - Name of the object or array, or NULL for a value in an array.
+  Open - '{' to open an object, '[' to open an array.
+
+Returns:
+
+  None
+
+--*/
+{
+  if (mJsonFile == NULL) {
+    return;
+  }
+  if (mJsonDepth == MAX_JSON_DEPTH) {
+    Error (NULL, 0, 0003, "JSON output is nested too deeply", "the JSON output file is truncated");
+    fclose (mJsonFile);
+    mJsonFile = NULL;
+    return;
+  }
+
+  JsonWriteName (Name);
+  fputc (Open, mJsonFile);
+  mJsonClose[mJsonDepth++] = (CHAR8) (Open == '{' ? '}' : ']');
+  mJsonFirst = TRUE;
+}
+
+STATIC
+VOID
+JsonEnd (
+  IN UINT32  Depth
+  )
+/*++
+
+Routine Description:
+
+  Close the JSON objects and arrays opened after the given nesting depth.
+
+Arguments:
+
+  Depth - Nesting depth to return to, as read from mJsonDepth before the
+          objects and arrays were opened.
+
+Returns:
+
+  None
+
+--*/
+{
+  UINT32  Index;
+
+  if (mJsonFile == NULL) {
+    return;
+  }
+
+  while (mJsonDepth > Depth) {
+    mJsonDepth--;
+    if (!mJsonFirst) {
+      fputc ('\n', mJsonFile);
+      for (Index = 0; Index < mJsonDepth; Index++) {
+        fputs ("  ", mJsonFile);
+      }
+    }
+    fputc (mJsonClose[mJsonDepth], mJsonFile);
+    mJsonFirst = FALSE;
+  }
+}
+
+STATIC
+VOID
+JsonString (
+  IN CHAR8  *Name,
+  IN CHAR8  *Value
+  )
+/*++
+
+Routine Description:
+
+  Write a named string value to the current JSON object.
+
+Arguments:
+
+  Name  - Name of the value.
+  Value - The null-terminated ascii string.
+
+Returns:
+
+  None
+
+--*/
+{
+  if (mJsonFile == NULL) {
+    return;
+  }
+  JsonWriteName (Name);
+  JsonWriteString (Value);
+}
+
+STATIC
+VOID
+JsonNumber (
+  IN CHAR8   *Name,
+  IN UINT64  Value
+  )
+/*++
+
+Routine Description:
+
+  Write a named number value to the current JSON object.
+
+Arguments:
+
+  Name  - Name of the value.
+  Value - The number.
+
+Returns:
+
+  None
+
+--*/
+{
+  if (mJsonFile == NULL) {
+    return;
+  }
+  JsonWriteName (Name);
+  fprintf (mJsonFile, "%llu", (unsigned long long) Value);
+}
+
+STATIC
+VOID
+JsonGuid (
+  IN CHAR8     *Name,
+  IN EFI_GUID  *Guid
+  )
+/*++
+
+Routine Description:
+
+  Write a named GUID value to the current JSON object, in registry format.
+
+Arguments:
+
+  Name  - Name of the value.
+  Guid  - The GUID.
+
+Returns:
+
+  None
+
+--*/
+{
+  UINT8  GuidBuffer[PRINTED_GUID_BUFFER_SIZE];
+
+  if (mJsonFile == NULL) {
+    return;
+  }
+  PrintGuidToBuffer (Guid, GuidBuffer, sizeof (GuidBuffer), TRUE);
+  JsonString (Name, (CHAR8 *) GuidBuffer);
+}
+
+STATIC
+VOID *
+LzmaAlloc (
+  IN VOID    *Context,
+  IN size_t  Size
+  )
+{
+  return malloc (Size);
+}
+
+STATIC
+VOID
+LzmaFree (
+  IN VOID  *Context,
+  IN VOID  *Address
+  )
+{
+  free (Address);
+}
+
+STATIC ISzAlloc mLzmaAlloc = { LzmaAlloc, LzmaFree };
+
+STATIC
+EFI_STATUS
+LzmaDecodeBuffer (
+  IN  UINT8    *Data,
+  IN  UINT32   DataLength,
+  IN  BOOLEAN  ConvertX86,
+  OUT UINT8    **Output,
+  OUT UINT32   *OutputLength
+  )
+/*++
+
+Routine Description:
+
+  Decode the data of an LZMA or LZMAF86 GUIDed section.
+
+Arguments:
+
+  Data         - The LZMA data, starting with the LZMA header.
+  DataLength   - Length of Data.
+  ConvertX86   - TRUE to undo the x86 branch conversion after decoding.
+  Output       - Decoded data, allocated by this function.
+  OutputLength - Length of the decoded data.
+
+Returns:
+
+  EFI_SUCCESS          - The data is decoded.
+  EFI_SECTION_ERROR    - The data is corrupted.
+  EFI_OUT_OF_RESOURCES - Memory allocation failed.
+
+--*/
+{
+  UINT64       DecodedSize;
+  SizeT        DestLength;
+  SizeT        SourceLength;
+  ELzmaStatus  LzmaStatus;
+  UInt32       X86State;
+  UINT8        *Buffer;
+  UINTN        Index;
+
+  if (DataLength < LZMA_HEADER_SIZE) {
+    return EFI_SECTION_ERROR;
+  }
+
+  DecodedSize = 0;
+  for (Index = 0; Index < 8; Index++) {
+    DecodedSize |= ((UINT64) Data[LZMA_PROPS_SIZE + Index]) << (Index * 8);
+  }
+  if (DecodedSize > 0xFFFFFFFF) {
+    return EFI_SECTION_ERROR;
+  }
+
+  Buffer = malloc ((size_t) DecodedSize + 1);
+  if (Buffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  DestLength   = (SizeT) DecodedSize;
+  SourceLength = DataLength - LZMA_HEADER_SIZE;
+  if (LzmaDecode (
+        Buffer,
+        &DestLength,
+        Data + LZMA_HEADER_SIZE,
+        &SourceLength,
+        Data,
+        LZMA_PROPS_SIZE,
+        LZMA_FINISH_END,
+        &LzmaStatus,
+        &mLzmaAlloc
+        ) != SZ_OK || DestLength != DecodedSize) {
+    free (Buffer);
+    return EFI_SECTION_ERROR;
+  }
+
+  if (ConvertX86) {
+    x86_Convert_Init (X86State);
+    x86_Convert (Buffer, DestLength, 0, &X86State, 0);
+  }
+
+  *Output       = Buffer;
+  *OutputLength = (UINT32) DestLength;
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+ChunkedDecodeBuffer (
+  IN  UINT8    *Data,
+  IN  UINT32   DataLength,
+  OUT UINT8    **Output,
+  OUT UINT32   *OutputLength
+  )
+/*++
+
+Routine Description:
+
+  Decode the data of a chunked GUIDed section. Each chunk is a complete LZMA
+  GUIDed section, decoded to its offset in the output. The decoded chunks must
+  cover the whole output without overlapping.
+
+Arguments:
+
+  Data         - The chunked section data, starting with CHUNKED_SECTION_HEADER.
+  DataLength   - Length of Data.
+  Output       - Decoded data, allocated by this function.
+  OutputLength - Length of the decoded data.
+
+Returns:
+
+  EFI_SUCCESS          - The data is decoded.
+  EFI_SECTION_ERROR    - The data is corrupted, or the chunks do not cover the
+                         whole output.
+  EFI_OUT_OF_RESOURCES - Memory allocation failed.
+
+--*/
+{
+  CHUNKED_SECTION_HEADER    *Header;
+  CHUNKED_SECTION_ENTRY     *Entry;
+  EFI_GUID_DEFINED_SECTION  *Section;
+  UINT32                    SectionLength;
+  UINT8                     *Buffer;
+  UINT8                     *Covered;
+  UINT8                     *Chunk;
+  UINT32                    ChunkLength;
+  UINT32                    Index;
+  EFI_STATUS                Status;
+
+  Header = (CHUNKED_SECTION_HEADER *) Data;
+  if (DataLength < sizeof (CHUNKED_SECTION_HEADER) ||
+      Header->Signature != CHUNKED_SECTION_SIGNATURE ||
+      Header->ChunkCount > (DataLength - sizeof (CHUNKED_SECTION_HEADER)) / sizeof (CHUNKED_SECTION_ENTRY)) {
+    return EFI_SECTION_ERROR;
+  }
+
+  //
+  // Covered marks the output bytes already decoded, so that a table leaving
+  // gaps or overlapping chunks is rejected instead of dumping heap bytes.
+  //
+  Buffer  = calloc ((size_t) Header->DecodedSize + 1, 1);
+  Covered = calloc ((size_t) Header->DecodedSize + 1, 1);
+  if (Buffer == NULL || Covered == NULL) {
+    free (Buffer);
+    free (Covered);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = EFI_SUCCESS;
+  Entry  = (CHUNKED_SECTION_ENTRY *) (Header + 1);
+  for (Index = 0; Index < Header->ChunkCount; Index++) {
+    if (Entry[Index].SectionOffset > DataLength - sizeof (EFI_GUID_DEFINED_SECTION)) {
+      Status = EFI_SECTION_ERROR;
+      break;
+    }
+    Section       = (EFI_GUID_DEFINED_SECTION *) (Data + Entry[Index].SectionOffset);
+    SectionLength = GetLength (Section->CommonHeader.Size);
+    if (SectionLength > DataLength - Entry[Index].SectionOffset ||
+        Section->DataOffset > SectionLength ||
+        CompareGuid (&Section->SectionDefinitionGuid, &mLzmaCustomDecompressGuid) != 0) {
+      Status = EFI_SECTION_ERROR;
+      break;
+    }
+
+    Status = LzmaDecodeBuffer (
+               (UINT8 *) Section + Section->DataOffset,
+               SectionLength - Section->DataOffset,
+               FALSE,
+               &Chunk,
+               &ChunkLength
+               );
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+    if (Entry[Index].OutputOffset > Header->DecodedSize ||
+        ChunkLength > Header->DecodedSize - Entry[Index].OutputOffset ||
+        memchr (Covered + Entry[Index].OutputOffset, 1, ChunkLength) != NULL) {
+      free (Chunk);
+      Status = EFI_SECTION_ERROR;
+      break;
+    }
+    memcpy (Buffer + Entry[Index].OutputOffset, Chunk, ChunkLength);
+    memset (Covered + Entry[Index].OutputOffset, 1, ChunkLength);
+    free (Chunk);
+  }
+
+  if (!EFI_ERROR (Status) && memchr (Covered, 0, Header->DecodedSize) != NULL) {
+    Status = EFI_SECTION_ERROR;
+  }
+
+  free (Covered);
+  if (EFI_ERROR (Status)) {
+    free (Buffer);
+    return Status;
+  }
+
+  *Output       = Buffer;
+  *OutputLength = Header->DecodedSize;
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+BrotliDecodeBuffer (
+  IN  UINT8    *Data,
+  IN  UINT32   DataLength,
+  OUT UINT8    **Output,
+  OUT UINT32   *OutputLength
+  )
+/*++
+
+Routine Description:
+
+  Decode the data of a Brotli GUIDed section.
+
+Arguments:
+
+  Data         - The Brotli data, starting with the decoded and scratch sizes.
+  DataLength   - Length of Data.
+  Output       - Decoded data, allocated by this function.
+  OutputLength - Length of the decoded data.
+
+Returns:
+
+  EFI_SUCCESS          - The data is decoded.
+  EFI_SECTION_ERROR    - The data is corrupted.
+  EFI_OUT_OF_RESOURCES - Memory allocation failed.
+
+--*/
+{
+  UINT64  DecodedSize;
+  size_t  DestLength;
+  UINT8   *Buffer;
+
+  if (DataLength < BROTLI_HEADER_SIZE) {
+    return EFI_SECTION_ERROR;
+  }
+
+  memcpy (&DecodedSize, Data, sizeof (DecodedSize));
+  if (DecodedSize > 0xFFFFFFFF) {
+    return EFI_SECTION_ERROR;
+  }
+
+  Buffer = malloc ((size_t) DecodedSize + 1);
+  if (Buffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  DestLength = (size_t) DecodedSize;
+  if (BrotliDecoderDecompress (
+        DataLength - BROTLI_HEADER_SIZE,
+        Data + BROTLI_HEADER_SIZE,
+        &DestLength,
+        Buffer
+        ) != BROTLI_DECODER_RESULT_SUCCESS || DestLength != DecodedSize) {
+    free (Buffer);
+    return EFI_SECTION_ERROR;
+  }
+
+  *Output       = Buffer;
+  *OutputLength = (UINT32) DestLength;
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+TianoDecodeBuffer (
+  IN  UINT8    *Data,
+  IN  UINT32   DataLength,
+  OUT UINT8    **Output,
+  OUT UINT32   *OutputLength
+  )
+/*++
+
+Routine Description:
+
+  Decode the data of a Tiano GUIDed section.
+
+Arguments:
+
+  Data         - The Tiano compressed data.
+  DataLength   - Length of Data.
+  Output       - Decoded data, allocated by this function.
+  OutputLength - Length of the decoded data.
+
+Returns:
+
+  EFI_SUCCESS          - The data is decoded.
+  EFI_SECTION_ERROR    - The data is corrupted.
+  EFI_OUT_OF_RESOURCES - Memory allocation failed.
+
+--*/
+{
+  UINT32      DstSize;
+  UINT32      ScratchSize;
+  UINT8       *Scratch;
+  UINT8       *Buffer;
+  EFI_STATUS  Status;
+
+  Status = TianoGetInfo (Data, DataLength, &DstSize, &ScratchSize);
+  if (EFI_ERROR (Status)) {
+    return EFI_SECTION_ERROR;
+  }
+
+  Scratch = malloc (ScratchSize);
+  Buffer  = malloc ((size_t) DstSize + 1);
+  if (Scratch == NULL || Buffer == NULL) {
+    free (Scratch);
+    free (Buffer);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = TianoDecompress (Data, DataLength, Buffer, DstSize, Scratch, ScratchSize);
+  free (Scratch);
+  if (EFI_ERROR (Status)) {
+    free (Buffer);
+    return EFI_SECTION_ERROR;
+  }
+
+  *Output       = Buffer;
+  *OutputLength = DstSize;
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+DecodeGuidedSection (
+  IN  EFI_GUID  *SectionGuid,
+  IN  UINT8     *Data,
+  IN  UINT32    DataLength,
+  OUT UINT8     **Output,
+  OUT UINT32    *OutputLength
+  )
+/*++
+
+Routine Description:
+
+  Decode the data of a GUIDed section in-process, for the section GUIDs of
+  the compression tools shipped with BaseTools.
+
+Arguments:
+
+  SectionGuid  - SectionDefinitionGuid of the section.
+  Data         - The section data, at DataOffset of the section.
+  DataLength   - Length of Data.
+  Output       - Decoded data, allocated by this function.
+  OutputLength - Length of the decoded data.
+
+Returns:
+
+  EFI_SUCCESS          - The data is decoded.
+  EFI_UNSUPPORTED      - The section GUID is not decoded in-process.
+  EFI_SECTION_ERROR    - The data is corrupted.
+  EFI_OUT_OF_RESOURCES - Memory allocation failed.
+
+--*/
+{
+  if (CompareGuid (SectionGuid, &mLzmaCustomDecompressGuid) == 0) {
+    return LzmaDecodeBuffer (Data, DataLength, FALSE, Output, OutputLength);
+  }
+  if (CompareGuid (SectionGuid, &mLzmaF86CustomDecompressGuid) == 0) {
+    return LzmaDecodeBuffer (Data, DataLength, TRUE, Output, OutputLength);
+  }
+  if (CompareGuid (SectionGuid, &mChunkedSectionGuid) == 0) {
+    return ChunkedDecodeBuffer (Data, DataLength, Output, OutputLength);
+  }
+  if (CompareGuid (SectionGuid, &mBrotliCustomDecompressGuid) == 0) {
+    return BrotliDecodeBuffer (Data, DataLength, Output, OutputLength);
+  }
+  if (CompareGuid (SectionGuid, &mTianoCustomDecompressGuid) == 0) {
+    return TianoDecodeBuffer (Data, DataLength, Output, OutputLength);
+  }
+  return EFI_UNSUPPORTED;
+}
+
 int
 main (
   int       argc,
@@ -239,6 +916,7 @@ Returns:
   UINT64                      LogLevel;
   CHAR8                       *OpenSslEnv;
   CHAR8                       *OpenSslCommand;
+  CHAR8                       *JsonFileName;
 
   SetUtilityName (UTILITY_NAME);
   //
@@ -260,6 +938,7 @@ Returns:
   argv++;
   LogLevel = 0;
   Offset = 0;
+  JsonFileName = NULL;
 
   //
   // Look for help options
@@ -350,6 +1029,17 @@ Returns:
       continue;
     }
 
+    if (stricmp (argv[0], "--json") == 0) {
+      if (argc < 2) {
+        Error (NULL, 0, 1003, "Invalid option value", "JSON file name is missing for --json option");
+        return GetUtilityStatus ();
+      }
+      JsonFileName = argv[1];
+      argc -= 2;
+      argv += 2;
+      continue;
+    }
+
     if ((stricmp (argv[0], "-v") == 0) || (stricmp (argv[0], "--verbose") == 0)) {
       SetPrintLevel (VERBOSE_LOG_LEVEL);
       argc --;
@@ -437,8 +1127,36 @@ Returns:
 
   LoadGuidedSectionToolsTxt (mUtilityFilename);
 
+  //
+  // The JSON output describes the same FV, file and section tree as the
+  // text printed to stdout.
+  //
+  if (JsonFileName != NULL) {
+    mJsonFile = fopen (LongFilePath (JsonFileName), "w");
+    if (mJsonFile == NULL) {
+      Error (NULL, 0, 0001, "Error opening the output file", JsonFileName);
+      free (FvImage);
+      return GetUtilityStatus ();
+    }
+    JsonBegin (NULL, '{');
+    JsonString ("Image", mUtilityFilename);
+    JsonNumber ("Offset", (UINT64) Offset);
+  }
+
   PrintFvInfo (FvImage, FALSE);
 
+  if (mJsonFile != NULL) {
+    //
+    // Close whatever a parse error left open, down to the top-level object
+    //
+    JsonEnd (1);
+    JsonNumber ("Status", (UINT64) GetUtilityStatus ());
+    JsonEnd (0);
+    fputc ('\n', mJsonFile);
+    fclose (mJsonFile);
+    mJsonFile = NULL;
+  }
+
   //
   // Clean up
   //
@@ -477,6 +1195,7 @@ Returns:
   UINTN                       FvSize;
   EFI_FFS_FILE_HEADER         *CurrentFile;
   UINTN                       Key;
+  UINT32                      JsonDepth;
 
   Status = FvBufGetSize (Fv, &FvSize);
 
@@ -485,6 +1204,12 @@ Returns:
     (((EFI_FIRMWARE_VOLUME_HEADER*)Fv)->Attributes & EFI_FVB2_ERASE_POLARITY) ?
       TRUE : FALSE;
 
+  JsonBegin ("Fv", '{');
+  JsonGuid ("FileSystemGuid", &((EFI_FIRMWARE_VOLUME_HEADER*)Fv)->FileSystemGuid);
+  JsonNumber ("Length", (UINT64) FvSize);
+  JsonNumber ("Attributes", (UINT64) ((EFI_FIRMWARE_VOLUME_HEADER*)Fv)->Attributes);
+  JsonBegin ("Files", '[');
+
   //
   // Get the first file
   //
@@ -506,7 +1231,9 @@ Returns:
     //
     // Display info about this file
     //
+    JsonDepth = mJsonDepth;
     Status = PrintFileInfo (Fv, CurrentFile, ErasePolarity);
+    JsonEnd (JsonDepth);
     if (EFI_ERROR (Status)) {
       Error (NULL, 0, 0003, "error parsing FV image", "failed to parse a file in the FV");
       return GetUtilityStatus ();
@@ -529,6 +1256,10 @@ Returns:
     printf ("There are a total of %d files in this FV\n", (int) NumberOfFiles);
   }
 
+  JsonEnd (mJsonDepth - 1);
+  JsonNumber ("FileCount", (UINT64) NumberOfFiles);
+  JsonEnd (mJsonDepth - 1);
+
   return EFI_SUCCESS;
 }
 
@@ -1160,6 +1891,13 @@ Returns:
   printf ("File Attributes:  0x%02X\n", FileHeader->Attributes);
   printf ("File State:       0x%02X\n", FileHeader->State);
 
+  JsonBegin (NULL, '{');
+  JsonString ("Name", (CHAR8 *) GuidBuffer);
+  JsonNumber ("Offset", (UINT64) ((UINTN) FileHeader - (UINTN) FvImage));
+  JsonNumber ("Length", (UINT64) FileLength);
+  JsonNumber ("Attributes", (UINT64) FileHeader->Attributes);
+  JsonNumber ("State", (UINT64) FileHeader->State);
+
   //
   // Print file state
   //
@@ -1249,6 +1987,7 @@ Returns:
   }
 
   printf ("File Type:        0x%02X  ", FileHeader->Type);
+  JsonNumber ("Type", (UINT64) FileHeader->Type);
 
   switch (FileHeader->Type) {
 
@@ -1325,6 +2064,7 @@ Returns:
     //
     // All other files have sections
     //
+    JsonBegin ("Sections", '[');
     Status = ParseSection (
               (UINT8 *) ((UINTN) FileHeader + HeaderSize),
               FvBufGetFfsFileSize (FileHeader) - HeaderSize
@@ -1673,6 +2413,7 @@ Returns:
   CHAR8               *ToolInputFileName;
   CHAR8               *ToolOutputFileName;
   CHAR8               *UIFileName;
+  UINT32              JsonDepth;
 
   ParsedLength = 0;
   ToolInputFileName = NULL;
@@ -1700,10 +2441,16 @@ Returns:
     SectionLength = GetSectionFileLength ((EFI_COMMON_SECTION_HEADER *) Ptr);
     SectionHeaderLen = GetSectionHeaderLength((EFI_COMMON_SECTION_HEADER *)Ptr);
 
+    JsonDepth = mJsonDepth;
+    JsonBegin (NULL, '{');
+    JsonNumber ("Type", (UINT64) Type);
+    JsonNumber ("Size", (UINT64) SectionLength);
+
     SectionName = SectionNameToStr (Type);
     if (SectionName != NULL) {
       printf ("------------------------------------------------------------\n");
       printf ("  Type:  %s\n  Size:  0x%08X\n", SectionName, (unsigned) SectionLength);
+      JsonString ("TypeName", SectionName);
       free (SectionName);
     }
 
@@ -1788,6 +2535,7 @@ Returns:
       }
       Unicode2AsciiString (((EFI_USER_INTERFACE_SECTION *) Ptr)->FileNameString, UIFileName);
       printf ("  String: %s\n", UIFileName);
+      JsonString ("String", UIFileName);
       free (UIFileName);
       break;
 
@@ -1830,6 +2578,8 @@ Returns:
       }
       CompressedLength    = SectionLength - RealHdrLen;
       printf ("  Uncompressed Length:  0x%08X\n", (unsigned) UncompressedLength);
+      JsonNumber ("UncompressedLength", (UINT64) UncompressedLength);
+      JsonNumber ("CompressionType", (UINT64) CompressionType);
 
       if (CompressionType == EFI_NOT_COMPRESSED) {
         printf ("  Compression Type:  EFI_NOT_COMPRESSED\n");
@@ -1893,6 +2643,7 @@ Returns:
         return EFI_SECTION_ERROR;
       }
 
+      JsonBegin ("Sections", '[');
       Status = ParseSection (UncompressedBuffer, UncompressedLength);
 
       if (CompressionType == EFI_STANDARD_COMPRESSION) {
@@ -1923,6 +2674,39 @@ Returns:
       printf ("\n");
       printf ("  DataOffset:             0x%04X\n", (unsigned) DataOffset);
       printf ("  Attributes:             0x%04X\n", (unsigned) Attributes);
+      JsonGuid ("SectionDefinitionGuid", EfiGuid);
+      JsonNumber ("DataOffset", (UINT64) DataOffset);
+      JsonNumber ("Attributes", (UINT64) Attributes);
+
+      if (DataOffset > SectionLength) {
+        Error (NULL, 0, 0003, "Error parsing section", "DataOffset of the GUIDED section is out of range");
+        return EFI_SECTION_ERROR;
+      }
+
+      //
+      // Decode the sections of the compression tools in BaseTools in-process,
+      // run the tool from GuidedSectionTools.txt for all others.
+      //
+      Status = DecodeGuidedSection (
+                 EfiGuid,
+                 Ptr + DataOffset,
+                 SectionLength - DataOffset,
+                 &ToolOutputBuffer,
+                 &ToolOutputLength
+                 );
+      if (Status == EFI_SUCCESS) {
+        JsonBegin ("Sections", '[');
+        Status = ParseSection (ToolOutputBuffer, ToolOutputLength);
+        free (ToolOutputBuffer);
+        if (EFI_ERROR (Status)) {
+          Error (NULL, 0, 0003, "parse of decoded GUIDED section failed", NULL);
+          return EFI_SECTION_ERROR;
+        }
+        break;
+      } else if (Status != EFI_UNSUPPORTED) {
+        Error (NULL, 0, 0003, "decode of GUIDED section failed", NULL);
+        return EFI_SECTION_ERROR;
+      }
 
       ExtractionTool =
         LookupGuidedSectionToolPath (
@@ -1990,8 +2774,8 @@ Returns:
         Status =
           PutFileImage (
             ToolInputFile,
-            (CHAR8*) SectionBuffer + DataOffset,
-            BufferLength - DataOffset
+            (CHAR8*) Ptr + DataOffset,
+            SectionLength - DataOffset
             );
 
         system (SystemCommand);
@@ -2012,10 +2796,12 @@ Returns:
           return EFI_SECTION_ERROR;
         }
 
+        JsonBegin ("Sections", '[');
         Status = ParseSection (
                   ToolOutputBuffer,
                   ToolOutputLength
                   );
+        free (ToolOutputBuffer);
         if (EFI_ERROR (Status)) {
           Error (NULL, 0, 0003, "parse of decoded GUIDED section failed", NULL);
           return EFI_SECTION_ERROR;
@@ -2032,9 +2818,10 @@ Returns:
         //
         // CRC32 guided section
         //
+        JsonBegin ("Sections", '[');
         Status = ParseSection (
-                  SectionBuffer + DataOffset,
-                  BufferLength - DataOffset
+                  Ptr + DataOffset,
+                  SectionLength - DataOffset
                   );
         if (EFI_ERROR (Status)) {
           Error (NULL, 0, 0003, "parse of CRC32 GUIDED section failed", NULL);
@@ -2058,6 +2845,8 @@ Returns:
       return EFI_SECTION_ERROR;
     }
 
+    JsonEnd (JsonDepth);
+
     ParsedLength += SectionLength;
     //
     // We make then next section begin on a 4-byte boundary
@@ -2385,7 +3174,7 @@ Returns:
   //
   // Copyright declaration
   // 
-  fprintf (stdout, "Copyright (c) 2007 - 2016, Intel Corporation. All rights reserved.\n\n");
+  fprintf (stdout, "Copyright (c) 2007 - 2017, Intel Corporation. All rights reserved.\n\n");
   fprintf (stdout, "  Display Tiano Firmware Volume FFS image information\n\n");
 
   //
@@ -2412,6 +3201,8 @@ Returns:
             processing an FV\n");
   fprintf (stdout, "  --hash\n\
             Generate HASH value of the entire PE image\n");
+  fprintf (stdout, "  --json JSON_FILENAME\n\
+            Also write the FV, file and section tree to JSON_FILENAME\n");
   fprintf (stdout, "  --sfo\n\
             Reserved for future use\n");
 }
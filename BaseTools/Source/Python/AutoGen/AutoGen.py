@@ -18,6 +18,7 @@ import re
 import os.path as path
 import copy
 import uuid
+import hashlib
 
 import GenC
 import GenMake
@@ -2636,6 +2637,10 @@ class ModuleAutoGen(AutoGen):
     #
     TimeDict = {}
 
+    ## Cache the content digests of metafiles of every module in a class variable
+    #
+    FileHashDict = {}
+
     ## The real constructor of ModuleAutoGen
     #
     #  This method is not supposed to be called by users of ModuleAutoGen. It's
@@ -2738,6 +2743,7 @@ class ModuleAutoGen(AutoGen):
         self._BuildRules              = None
 
         self._TimeStampPath           = None
+        self._Fingerprint             = None
 
         self.AutoGenDepSet = set()
 
@@ -4236,7 +4242,9 @@ class ModuleAutoGen(AutoGen):
         return self._LibraryAutoGenList
 
     ## Decide whether we can skip the ModuleAutoGen process
-    #  If any source file is newer than the modeule than we cannot skip
+    #  If any source file is newer than the modeule than we cannot skip.
+    #  If any workspace metafile is newer than the module, we can skip only if
+    #  the fingerprint of the module's AutoGen inputs is not changed.
     #
     def CanSkip(self):
         if not os.path.exists(self.GetTimeStampPath()):
@@ -4244,10 +4252,6 @@ class ModuleAutoGen(AutoGen):
         #last creation time of the module
         DstTimeStamp = os.stat(self.GetTimeStampPath())[8]
 
-        SrcTimeStamp = self.Workspace._SrcTimeStamp
-        if SrcTimeStamp > DstTimeStamp:
-            return False
-
         with open(self.GetTimeStampPath(),'r') as f:
             for source in f:
                 source = source.rstrip('\n')
@@ -4257,12 +4261,74 @@ class ModuleAutoGen(AutoGen):
                     ModuleAutoGen.TimeDict[source] = os.stat(source)[8]
                 if ModuleAutoGen.TimeDict[source] > DstTimeStamp:
                     return False
+
+        SrcTimeStamp = self.Workspace._SrcTimeStamp
+        if SrcTimeStamp > DstTimeStamp:
+            # PCD driver has the PCD database of whole platform in its AutoGen code
+            if self.PcdIsDriver:
+                return False
+            FingerprintPath = self.GetFingerprintPath()
+            if not os.path.exists(FingerprintPath):
+                return False
+            with open(FingerprintPath, 'r') as f:
+                if f.read() != self.GetFingerprint():
+                    return False
+            # let following builds decide by time stamp only, until any workspace metafile changes again
+            os.utime(self.GetTimeStampPath(), (SrcTimeStamp, SrcTimeStamp))
         return True
 
     def GetTimeStampPath(self):
         if self._TimeStampPath == None:
             self._TimeStampPath = os.path.join(self.MakeFileDir, 'AutoGenTimeStamp')
         return self._TimeStampPath
+
+    def GetFingerprintPath(self):
+        return os.path.join(self.MakeFileDir, 'AutoGenFingerprint')
+
+    ## Get the content digest of a metafile
+    def _GetFileHash(self, File):
+        if File not in ModuleAutoGen.FileHashDict:
+            with open(File, 'rb') as f:
+                ModuleAutoGen.FileHashDict[File] = hashlib.md5(f.read()).hexdigest()
+        return ModuleAutoGen.FileHashDict[File]
+
+    ## Get the fingerprint of the inputs of the module's AutoGen files and makefile
+    #
+    #   The fingerprint covers the INF and DEC files, the resolved library
+    #   instances, the PCD settings and the build options of the module, as well
+    #   as the global macros and build_rule.txt. Source files are checked by time
+    #   stamp in CanSkip().
+    #
+    #   @retval string      The digest of the module's AutoGen inputs
+    #
+    def GetFingerprint(self):
+        if self._Fingerprint == None:
+            Md5 = hashlib.md5()
+            Md5.update(str(sorted(GlobalData.gCommandLineDefines.items())))
+            Md5.update(str(GlobalData.BuildOptionPcd))
+            Md5.update(self._GetFileHash(os.path.join(GlobalData.gConfDirectory, gDefaultBuildRuleFile)))
+            Md5.update(str((self.PlatformInfo.Name, self.PlatformInfo.Guid, self.PlatformInfo.Version,
+                            self.PlatformInfo.OutputDir, self.BuildDir, self.SourceOverrideDir)))
+
+            MetaFileList = [self.MetaFile]
+            MetaFileList += [Package.MetaFile for Package in self.DependentPackageList]
+            MetaFileList += [Library.MetaFile for Library in self.DependentLibraryList]
+            for MetaFile in MetaFileList:
+                Md5.update(MetaFile.Path)
+                Md5.update(self._GetFileHash(MetaFile.Path))
+
+            PcdTokenNumber = self.PlatformInfo.PcdTokenNumber
+            for Pcd in self.ModulePcdList + self.LibraryPcdList:
+                Key = (Pcd.TokenCName, Pcd.TokenSpaceGuidCName)
+                TokenNumber = None
+                if Key in PcdTokenNumber:
+                    TokenNumber = PcdTokenNumber[Key]
+                Md5.update(str((Key, Pcd.Type, Pcd.DatumType, Pcd.DefaultValue, Pcd.MaxDatumSize, Pcd.TokenValue, TokenNumber)))
+
+            for Tool in sorted(self.BuildOption):
+                Md5.update(str((Tool, sorted(self.BuildOption[Tool].items()))))
+            self._Fingerprint = Md5.hexdigest()
+        return self._Fingerprint
     def CreateTimeStamp(self, Makefile):
 
         FileSet = set()
@@ -4284,6 +4350,8 @@ class ModuleAutoGen(AutoGen):
             for f in FileSet:
                 print >> file, f
 
+        SaveFileOnChange(self.GetFingerprintPath(), self.GetFingerprint(), False)
+
     Module          = property(_GetModule)
     Name            = property(_GetBaseName)
     Guid            = property(_GetGuid)
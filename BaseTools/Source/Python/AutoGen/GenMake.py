@@ -25,6 +25,7 @@ from Common.Misc import *
 from Common.String import *
 from BuildEngine import *
 import Common.GlobalData as GlobalData
+import Common.BuildProfile as BuildProfile
 
 ## Regular expression for finding header file inclusions
 gIncludePattern = re.compile(r"^[ \t]*#?[ \t]*include(?:[ \t]*(?:\\(?:\r\n|\r|\n))*[ \t]*)*(?:\(?[\"<]?[ \t]*)([-\w.\\/() \t]+)(?:[ \t]*[\">]?\)?)", re.MULTILINE | re.UNICODE | re.IGNORECASE)
@@ -929,13 +930,19 @@ cleanlib:
             if F in DepDb:
                 CurrentFileDependencyList = DepDb[F]
             else:
-                try:
-                    Fd = open(F.Path, 'r')
-                except BaseException, X:
-                    EdkLogger.error("build", FILE_OPEN_FAILURE, ExtraData=F.Path + "\n\t" + str(X))
+                #
+                # An AutoGen worker process hasn't written the files it generated
+                #
+                if GlobalData.gSavedFileDict and F.Path in GlobalData.gSavedFileDict:
+                    FileContent = GlobalData.gSavedFileDict[F.Path]
+                else:
+                    try:
+                        Fd = open(F.Path, 'r')
+                    except BaseException, X:
+                        EdkLogger.error("build", FILE_OPEN_FAILURE, ExtraData=F.Path + "\n\t" + str(X))
 
-                FileContent = Fd.read()
-                Fd.close()
+                    FileContent = Fd.read()
+                    Fd.close()
                 if len(FileContent) == 0:
                     continue
 
@@ -1450,6 +1457,9 @@ class TopLevelMakefile(BuildFile):
         if GlobalData.gIgnoreSource:
             ExtraOption += " --ignore-sources"
 
+        if BuildProfile.IsEnabled():
+            ExtraOption += " --profile-report %s" % os.path.join(PlatformInfo.BuildDir, BuildProfile.GENFDS_PROFILE_FILE)
+
         if GlobalData.BuildOptionPcd:
             for index, option in enumerate(GlobalData.gCommand):
                 if "--pcd" == option and GlobalData.gCommand[index+1]:
@@ -0,0 +1,222 @@
+## @file
+# This file is used to collect the time spent in each step of a build and to
+# save it as a profile report
+#
+# Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+# This program and the accompanying materials
+# are licensed and made available under the terms and conditions of the BSD License
+# which accompanies this distribution.  The full text of the license may be found at
+# http://opensource.org/licenses/bsd-license.php
+#
+# THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+# WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+#
+
+##
+# Import Modules
+#
+import os
+import json
+import time
+import threading
+from Common.LongFilePathSupport import OpenLongFilePath as open
+
+## Name of the profile report GenFds saves in the platform build directory for build
+GENFDS_PROFILE_FILE = 'GenFdsProfile.json'
+
+## Number of the slowest events listed in the report
+SLOWEST_EVENT_NUMBER = 30
+
+gEnabled = False
+gEventList = []
+gLock = threading.Lock()
+
+## Turn on event collection
+def Enable():
+    global gEnabled
+    gEnabled = True
+
+## Check if event collection is on
+def IsEnabled():
+    return gEnabled
+
+## Get the CPU time used by this process so far
+def GetCpuTime():
+    Times = os.times()
+    return Times[0] + Times[1]
+
+## Get the CPU time used by the waited-for child processes so far
+def GetChildCpuTime():
+    Times = os.times()
+    return Times[2] + Times[3]
+
+## Wait for a child process to exit
+#
+# Other threads may run commands at the same time, so the CPU time of this
+# one can only be told by reaping it with wait4(), where it is supported.
+#
+#   @param  Proc        The subprocess.Popen object of the child process
+#
+#   @retval float       CPU time of the child process and the children it waited for
+#   @retval None        The CPU time is unknown
+#
+def WaitProcess(Proc):
+    if not gEnabled or not hasattr(os, 'wait4'):
+        Proc.wait()
+        return None
+    Pid, Status, Usage = os.wait4(Proc.pid, 0)
+    if os.WIFSIGNALED(Status):
+        Proc.returncode = -os.WTERMSIG(Status)
+    else:
+        Proc.returncode = os.WEXITSTATUS(Status)
+    return Usage.ru_utime + Usage.ru_stime
+
+## Record an event
+#
+#   @param  Category    Step of the build, such as "Parse", "AutoGen", "Make" or "GenFds"
+#   @param  Name        What was processed, such as a file or a command
+#   @param  Start       Start time of the event, as returned by time.time()
+#   @param  Wall        Elapsed time of the event in seconds
+#   @param  Cpu         CPU time of the event in seconds, or None if unknown
+#   @param  Args        Dictionary of additional information
+#
+#   @retval dict        The event recorded
+#
+def AddEvent(Category, Name, Start, Wall, Cpu=None, Args=None):
+    Event = {
+        'Category'  : Category,
+        'Name'      : str(Name),
+        'Start'     : Start,
+        'Wall'      : Wall,
+        'Cpu'       : Cpu,
+        'Pid'       : os.getpid(),
+        'Thread'    : threading.currentThread().getName(),
+        'Args'      : Args or {}
+    }
+    AddEventList([Event])
+    return Event
+
+## Record events collected by another process
+def AddEventList(EventList):
+    if not gEnabled:
+        return
+    gLock.acquire()
+    try:
+        gEventList.extend(EventList)
+    finally:
+        gLock.release()
+
+## Measure the wall and CPU time of a step done in this process
+#
+#   Timer = ProfileTimer("AutoGen", Module)
+#   ...
+#   Timer.Stop()
+#
+class ProfileTimer(object):
+    def __init__(self, Category, Name, Args=None):
+        self.Category = Category
+        self.Name = Name
+        self.Args = Args
+        self.Start = time.time()
+        self.StartCpu = GetCpuTime()
+
+    ## Record the event
+    #
+    #   @retval dict    The event recorded, or None if collection is off
+    #
+    def Stop(self):
+        if not gEnabled:
+            return None
+        return AddEvent(self.Category, self.Name, self.Start, time.time() - self.Start,
+                        GetCpuTime() - self.StartCpu, self.Args)
+
+## Merge the events of a profile report saved by another process, and remove the report
+def LoadEvents(FileName):
+    if not os.path.isfile(FileName):
+        return
+    File = open(FileName, 'r')
+    try:
+        Report = json.load(File)
+    finally:
+        File.close()
+    os.remove(FileName)
+    if os.path.isfile(GetTraceFileName(FileName)):
+        os.remove(GetTraceFileName(FileName))
+    AddEventList(Report['Events'])
+
+## Save the profile report
+#
+# The report is written as JSON to FileName, with the totals of each category,
+# the slowest events and all events. The same events are also written as a
+# Chrome trace-event file next to it, which chrome://tracing can load.
+#
+#   @param  FileName    Path of the JSON report
+#   @param  Phases      List of (name, seconds) of the build phases, or None
+#
+def SaveReport(FileName, Phases=None):
+    if Phases == None:
+        Phases = []
+    EventList = sorted(gEventList, key=lambda Event: Event['Start'])
+    BaseTime = min([Event['Start'] for Event in EventList] or [time.time()])
+
+    Summary = {}
+    for Event in EventList:
+        Total = Summary.setdefault(Event['Category'], {'Count' : 0, 'Wall' : 0.0, 'Cpu' : 0.0})
+        Total['Count'] += 1
+        Total['Wall'] += Event['Wall']
+        if Event['Cpu'] != None:
+            Total['Cpu'] += Event['Cpu']
+
+    Report = {
+        'Version'   : 1,
+        'Start'     : time.strftime("%Y-%m-%d %H:%M:%S", time.localtime(BaseTime)),
+        'Phases'    : [{'Name' : Name, 'Wall' : Seconds} for Name, Seconds in Phases],
+        'Summary'   : Summary,
+        'Slowest'   : sorted(EventList, key=lambda Event: Event['Wall'], reverse=True)[:SLOWEST_EVENT_NUMBER],
+        'Events'    : EventList
+    }
+
+    ReportDir = os.path.dirname(os.path.abspath(FileName))
+    if not os.path.isdir(ReportDir):
+        os.makedirs(ReportDir)
+    File = open(FileName, 'w')
+    try:
+        json.dump(Report, File, indent=2, sort_keys=True)
+    finally:
+        File.close()
+
+    #
+    # Trace-event format: complete events ("ph" = "X") with microsecond times.
+    # Threads are numbered per process in the order they first show up.
+    #
+    ThreadIdDict = {}
+    TraceEventList = []
+    for Event in EventList:
+        Key = (Event['Pid'], Event['Thread'])
+        if Key not in ThreadIdDict:
+            ThreadIdDict[Key] = len([Pid for Pid, Thread in ThreadIdDict if Pid == Event['Pid']]) + 1
+            TraceEventList.append({'name' : 'thread_name', 'ph' : 'M', 'pid' : Event['Pid'],
+                                   'tid' : ThreadIdDict[Key], 'args' : {'name' : Event['Thread']}})
+        Args = dict(Event['Args'])
+        if Event['Cpu'] != None:
+            Args['cpu'] = round(Event['Cpu'], 6)
+        TraceEventList.append({
+            'name'  : Event['Name'],
+            'cat'   : Event['Category'],
+            'ph'    : 'X',
+            'ts'    : int((Event['Start'] - BaseTime) * 1000000),
+            'dur'   : int(Event['Wall'] * 1000000),
+            'pid'   : Event['Pid'],
+            'tid'   : ThreadIdDict[Key],
+            'args'  : Args
+        })
+
+    File = open(GetTraceFileName(FileName), 'w')
+    try:
+        json.dump({'traceEvents' : TraceEventList, 'displayTimeUnit' : 'ms'}, File)
+    finally:
+        File.close()
+
+## Get the name of the trace-event file saved with the report FileName
+def GetTraceFileName(FileName):
+    return os.path.splitext(FileName)[0] + '.trace.json'
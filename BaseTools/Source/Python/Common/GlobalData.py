@@ -1,7 +1,7 @@
 ## @file
 # This file is used to define common static strings used by INF/DEC/DSC files
 #
-# Copyright (c) 2007 - 2016, Intel Corporation. All rights reserved.<BR>
+# Copyright (c) 2007 - 2017, Intel Corporation. All rights reserved.<BR>
 # This program and the accompanying materials
 # are licensed and made available under the terms and conditions of the BSD License
 # which accompanies this distribution.  The full text of the license may be found at
@@ -61,11 +61,22 @@ gConfDirectory = ''
 #
 gDatabasePath = ".cache/build.db"
 
+#
+# Meta-files parsed or loaded from the database in this build
+#
+gMetaFileParseTime = {}     # {file path : (parse time in seconds, loaded from database or not)}
+
 #
 # Build flag for binary build
 #
 gIgnoreSource = False
 
+#
+# If not None, SaveFileOnChange() doesn't write the changed files but keeps
+# them here as {path : content}, for an AutoGen worker process to return them
+#
+gSavedFileDict = None
+
 #
 # FDF parser
 #
@@ -460,6 +460,8 @@ def IsChanged(File):
 #
 #  This method is used to save file only when its content is changed. This is
 #  quite useful for "make" system to decide what will be re-built and what won't.
+#  In an AutoGen worker process the changed file is only kept in
+#  GlobalData.gSavedFileDict, and the build process writes it.
 #
 #   @param      File            The path of file
 #   @param      Content         The new content of the file
@@ -479,6 +481,10 @@ def SaveFileOnChange(File, Content, IsBinaryFile=True):
         except:
             EdkLogger.error(None, FILE_OPEN_FAILURE, ExtraData=File)
 
+    if GlobalData.gSavedFileDict != None:
+        GlobalData.gSavedFileDict[File] = Content
+        return True
+
     DirName = os.path.dirname(File)
     if not CreateDirectory(DirName):
         EdkLogger.error(None, FILE_CREATE_FAILURE, "Could not create directory %s" % DirName)
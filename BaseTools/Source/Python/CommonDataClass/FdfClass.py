@@ -251,6 +251,8 @@ class GuidSectionClassObject (SectionClassObject) :
         self.ProcessRequired = False
         self.AuthStatusValid = False
         self.ExtraHeaderSize = -1
+        self.CompressionQuality = -1
+        self.CompressionWindow = -1
         self.FvAddr = []
         self.FvParentAddr = None
         self.IncludeFvSection = False
@@ -1,7 +1,7 @@
 ## @file
 # preprocess source file
 #
-#  Copyright (c) 2007 - 2014, Intel Corporation. All rights reserved.<BR>
+#  Copyright (c) 2007 - 2017, Intel Corporation. All rights reserved.<BR>
 #
 #  This program and the accompanying materials
 #  are licensed and made available under the terms and conditions of the BSD License
@@ -52,6 +52,29 @@ SEPERATOR_TUPLE = ('=', '|', ',', '{', '}')
 
 (T_PP_INCLUDE, T_PP_DEFINE, T_PP_OTHERS) = (0, 1, 2)
 
+## Tokens CLexer puts on the hidden channel
+#
+# White space, line continuations, comments and '#' lines (rules WS, BS, COMMENT,
+# LINE_COMMENT and LINE_COMMAND in C.g)
+#
+HIDDEN_TOKEN_PATTERN = re.compile(r'[ \t\r\n\x0c\\]+|/\*.*?\*/|//[^\r\n]*\r?\n|#[^\r\n]*\r?\n', re.DOTALL)
+
+## Check whether the parser would see no token at all in a text
+#
+#   @param  Text        The text to check
+#
+#   @retval True        The text has hidden tokens only
+#   @retval False       The text has tokens for the parser
+#
+def IsHiddenText(Text):
+    Pos = 0
+    while Pos < len(Text):
+        Match = HIDDEN_TOKEN_PATTERN.match(Text, Pos)
+        if Match == None:
+            return False
+        Pos = Match.end()
+    return True
+
 ## The collector for source code fragments.
 #
 # PreprocessFile method should be called prior to ParseFile
@@ -532,22 +555,26 @@ class CodeFragmentCollector:
         self.PreprocessFile()
         # restore from ListOfList to ListOfString
         self.Profile.FileLinesList = ["".join(list) for list in self.Profile.FileLinesList]
-        FileStringContents = ''
-        for fileLine in self.Profile.FileLinesList:
-            FileStringContents += fileLine
-        cStream = antlr3.StringStream(FileStringContents)
-        lexer = CLexer(cStream)
-        tStream = antlr3.CommonTokenStream(lexer)
-        parser = CParser(tStream)
-        parser.translation_unit()
+        self.__ParseString("".join(self.Profile.FileLinesList))
         
     def ParseFileWithClearedPPDirective(self):
         self.PreprocessFileWithClear()
         # restore from ListOfList to ListOfString
         self.Profile.FileLinesList = ["".join(list) for list in self.Profile.FileLinesList]
-        FileStringContents = ''
-        for fileLine in self.Profile.FileLinesList:
-            FileStringContents += fileLine
+        self.__ParseString("".join(self.Profile.FileLinesList))
+
+    ## __ParseString() method
+    #
+    #   Run the C parser on the preprocessed file contents. The generated lexer
+    #   and parser are slow, so they are skipped for contents like headers with
+    #   only macro definitions, in which the parser would see no token at all.
+    #
+    #   @param  self        The object pointer
+    #   @param  FileStringContents  The preprocessed file contents
+    #
+    def __ParseString(self, FileStringContents):
+        if IsHiddenText(FileStringContents):
+            return
         cStream = antlr3.StringStream(FileStringContents)
         lexer = CLexer(cStream)
         tStream = antlr3.CommonTokenStream(lexer)
@@ -1,7 +1,7 @@
 ## @file
 # This file is used to be the main entrance of ECC tool
 #
-# Copyright (c) 2009 - 2016, Intel Corporation. All rights reserved.<BR>
+# Copyright (c) 2009 - 2017, Intel Corporation. All rights reserved.<BR>
 # This program and the accompanying materials
 # are licensed and made available under the terms and conditions of the BSD License
 # which accompanies this distribution.  The full text of the license may be found at
@@ -372,6 +372,11 @@ class Ecc(object):
             self.ScanMetaData = False
         if Options.folders != None:
             self.OnlyScan = True
+        if Options.ParseJobs < 1:
+            EdkLogger.error("ECC", BuildToolError.OPTION_VALUE_INVALID, ExtraData="--parse-jobs must be at least 1")
+        EccGlobalData.gParseJobs = Options.ParseJobs
+        if Options.CacheDir != None:
+            EccGlobalData.gCacheDir = os.path.normpath(os.path.abspath(Options.CacheDir))
 
     ## SetLogLevel
     #
@@ -423,6 +428,10 @@ class Ecc(object):
         Parser.add_option("-d", "--debug", action="store", type="int", help="Enable debug messages at specified level.")
         Parser.add_option("-w", "--workspace", action="store", type="string", dest='Workspace', help="Specify workspace.")
         Parser.add_option("-f", "--folders", action="store_true", type=None, help="Only scanning specified folders which are recorded in config.ini file.")
+        Parser.add_option("--parse-jobs", action="store", type="int", dest="ParseJobs", default=1,
+            help="Number of processes to parse C source files in. Default is 1. Ignored on Windows.")
+        Parser.add_option("--cache-dir", action="store", type="string", dest="CacheDir",
+            help="Save the parse results of C source files in the specified directory, so that the files are not parsed again until they change.")
 
         (Opt, Args)=Parser.parse_args()
 
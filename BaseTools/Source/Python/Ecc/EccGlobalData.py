@@ -1,7 +1,7 @@
 ## @file
 # This file is used to save global datas used by ECC tool
 #
-# Copyright (c) 2008 - 2014, Intel Corporation. All rights reserved.<BR>
+# Copyright (c) 2008 - 2017, Intel Corporation. All rights reserved.<BR>
 # This program and the accompanying materials
 # are licensed and made available under the terms and conditions of the BSD License
 # which accompanies this distribution.  The full text of the license may be found at
@@ -24,4 +24,6 @@ gIdentifierTableList = []
 gCFileList = []
 gHFileList = []
 gUFileList = []
-gException = None
\ No newline at end of file
+gException = None
+gParseJobs = 1
+gCacheDir = None
\ No newline at end of file
@@ -15,6 +15,9 @@ import sys
 import Common.LongFilePathOs as os
 import re
 import string
+import cPickle
+import hashlib
+import multiprocessing
 import CodeFragmentCollector
 import FileProfile
 from CommonDataClass import DataClass
@@ -23,6 +26,11 @@ from Common import EdkLogger
 from EccToolError import *
 import EccGlobalData
 import MetaDataParser
+from Common.LongFilePathSupport import OpenLongFilePath as open
+
+## Version of the parse results saved in the cache directory. Change it when
+## the parser or the lists built from its output change.
+PARSE_CACHE_VERSION = 1
 
 IncludeFileListDict = {}
 AllIncludeFileListDict = {}
@@ -494,11 +502,118 @@ def GetFileModificationTimeFromDB(FullFileName):
         TimeValue = Result[0]
     return TimeValue
 
+## Parse a C source or header file
+#
+#   @param  FullName    Path of the file
+#
+#   @retval tuple       (FunctionList, IdentifierList, ParseError) of the file, where
+#                       ParseError tells the file was parsed again with cleared
+#                       preprocessor directives after a parse error
+#
+def ParseSourceFile(FullName):
+    collector = CodeFragmentCollector.CodeFragmentCollector(FullName)
+    collector.CleanFileProfileBuffer()
+    ParseError = False
+    try:
+        collector.ParseFile()
+    except UnicodeError:
+        ParseError = True
+        collector.CleanFileProfileBuffer()
+        collector.ParseFileWithClearedPPDirective()
+    Result = (GetFunctionList(), GetIdentifierList(), ParseError)
+    collector.CleanFileProfileBuffer()
+    return Result
+
+## Parse a C source or header file, or get its parse result from the cache
+#
+# The cache is keyed by the content of the file, so the result of a file is
+# reused as long as the file does not change, wherever the file is.
+#
+#   @param  Args        (FullName, CacheDir) of the file, CacheDir is None if
+#                       the cache is not used
+#
+#   @retval tuple       (FullName, FunctionList, IdentifierList, ParseError)
+#
+def ParseSourceFileCached(Args):
+    FullName, CacheDir = Args
+    if CacheDir == None:
+        return (FullName,) + ParseSourceFile(FullName)
+
+    File = open(FullName, 'rb')
+    try:
+        Digest = hashlib.md5(File.read())
+    finally:
+        File.close()
+    Digest.update(str(PARSE_CACHE_VERSION))
+    CacheFile = os.path.join(CacheDir, Digest.hexdigest() + '.pickle')
+    if os.path.isfile(CacheFile):
+        try:
+            File = open(CacheFile, 'rb')
+            try:
+                return (FullName,) + cPickle.load(File)
+            finally:
+                File.close()
+        except (IOError, EOFError, cPickle.UnpicklingError):
+            pass
+
+    Result = ParseSourceFile(FullName)
+    #
+    # Write a temporary file first, so that a cache file is always complete
+    # while other processes write the same one
+    #
+    TempFile = '%s.%d' % (CacheFile, multiprocessing.current_process().pid)
+    File = open(TempFile, 'wb')
+    try:
+        cPickle.dump(Result, File, cPickle.HIGHEST_PROTOCOL)
+    finally:
+        File.close()
+    try:
+        os.rename(TempFile, CacheFile)
+    except OSError:
+        os.remove(TempFile)
+    return (FullName,) + Result
+
+## Parse C source and header files
+#
+# The files are parsed in EccGlobalData.gParseJobs processes, except on
+# Windows, where the worker processes would have to load Ecc again.
+#
+#   @param  FileList    List of the paths of the files
+#
+#   @retval list        (FullName, FunctionList, IdentifierList, ParseError) of
+#                       each file, in the order of FileList
+#
+def ParseSourceFileList(FileList):
+    CacheDir = EccGlobalData.gCacheDir
+    if CacheDir != None and not os.path.isdir(CacheDir):
+        os.makedirs(CacheDir)
+    ArgsList = [(FullName, CacheDir) for FullName in FileList]
+
+    if EccGlobalData.gParseJobs <= 1 or sys.platform == 'win32' or len(ArgsList) <= 1:
+        ResultList = []
+        for Args in ArgsList:
+            EdkLogger.info("Parsing " + Args[0])
+            ResultList.append(ParseSourceFileCached(Args))
+        return ResultList
+
+    EdkLogger.info("Parsing %d files in %d processes" % (len(ArgsList), EccGlobalData.gParseJobs))
+    Pool = multiprocessing.Pool(min(EccGlobalData.gParseJobs, len(ArgsList)))
+    try:
+        ResultList = Pool.map_async(ParseSourceFileCached, ArgsList, 4).get(0xFFFFFFFF)
+        Pool.close()
+    except:
+        Pool.terminate()
+        raise
+    finally:
+        Pool.join()
+    return ResultList
+
 def CollectSourceCodeDataIntoDB(RootDir):
     FileObjList = []
     tuple = os.walk(RootDir)
     IgnoredPattern = GetIgnoredDirListPattern()
     ParseErrorFileList = []
+    FileList = []
 
     for dirpath, dirnames, filenames in tuple:
         if IgnoredPattern.match(dirpath.upper()):
@@ -516,28 +631,31 @@ def CollectSourceCodeDataIntoDB(RootDir):
         for f in filenames:
             if f.lower() in EccGlobalData.gConfig.SkipFileList:
                 continue
-            collector = None
-            FullName = os.path.normpath(os.path.join(dirpath, f))
-            model = DataClass.MODEL_FILE_OTHERS
-            if os.path.splitext(f)[1] in ('.h', '.c'):
-                EdkLogger.info("Parsing " + FullName)
-                model = f.endswith('c') and DataClass.MODEL_FILE_C or DataClass.MODEL_FILE_H
-                collector = CodeFragmentCollector.CodeFragmentCollector(FullName)
-                try:
-                    collector.ParseFile()
-                except UnicodeError:
-                    ParseErrorFileList.append(FullName)
-                    collector.CleanFileProfileBuffer()
-                    collector.ParseFileWithClearedPPDirective()
-#                collector.PrintFragments()
-            BaseName = os.path.basename(f)
-            DirName = os.path.dirname(FullName)
-            Ext = os.path.splitext(f)[1].lstrip('.')
-            ModifiedTime = os.path.getmtime(FullName)
-            FileObj = DataClass.FileClass(-1, BaseName, Ext, DirName, FullName, model, ModifiedTime, GetFunctionList(), GetIdentifierList(), [])
-            FileObjList.append(FileObj)
-            if collector:
-                collector.CleanFileProfileBuffer()
+            FileList.append(os.path.normpath(os.path.join(dirpath, f)))
+
+    #
+    # Parse the C files first, all other files have empty function and identifier lists
+    #
+    ParseResultDict = {}
+    for FullName, FunctionList, IdentifierList, ParseError in \
+            ParseSourceFileList([FullName for FullName in FileList if os.path.splitext(FullName)[1] in ('.h', '.c')]):
+        ParseResultDict[FullName] = (FunctionList, IdentifierList)
+        if ParseError:
+            ParseErrorFileList.append(FullName)
+
+    for FullName in FileList:
+        f = os.path.basename(FullName)
+        model = DataClass.MODEL_FILE_OTHERS
+        FunctionList, IdentifierList = [], []
+        if FullName in ParseResultDict:
+            model = f.endswith('c') and DataClass.MODEL_FILE_C or DataClass.MODEL_FILE_H
+            FunctionList, IdentifierList = ParseResultDict.pop(FullName)
+        BaseName = os.path.basename(f)
+        DirName = os.path.dirname(FullName)
+        Ext = os.path.splitext(f)[1].lstrip('.')
+        ModifiedTime = os.path.getmtime(FullName)
+        FileObj = DataClass.FileClass(-1, BaseName, Ext, DirName, FullName, model, ModifiedTime, FunctionList, IdentifierList, [])
+        FileObjList.append(FileObj)
 
     if len(ParseErrorFileList) > 0:
         EdkLogger.info("Found unrecoverable error during parsing:\n\t%s\n" % "\n\t".join(ParseErrorFileList))
@@ -85,6 +85,11 @@ ShortcutPcdPattern = re.compile("\s*\w+\s*=\s*(?P<value>(?:0x|0X)?[a-fA-F0-9]+)\
 
 AllIncludeFileList = []
 
+#
+# COMPRESSION_QUALITY and COMPRESSION_WINDOW are only understood by BrotliCompress
+#
+BROTLI_CUSTOM_DECOMPRESS_GUID = '3D532050-5CDA-4FD0-879E-0F7F630D5AFB'
+
 # Get the closest parent
 def GetParentAtLine (Line):
     for Profile in AllIncludeFileList:
@@ -2186,7 +2191,7 @@ class FdfParser:
             self.__GetSetStatements(FvObj)
 
             if not (self.__GetBlockStatement(FvObj) or self.__GetFvBaseAddress(FvObj) or 
-                self.__GetFvForceRebase(FvObj) or self.__GetFvAlignment(FvObj) or 
+                self.__GetFvForceRebase(FvObj) or self.__GetFvPackFiles(FvObj) or self.__GetFvAlignment(FvObj) or 
                 self.__GetFvAttributes(FvObj) or self.__GetFvNameGuid(FvObj) or 
                 self.__GetFvExtEntryStatement(FvObj) or self.__GetFvNameString(FvObj)):
                 break
@@ -2292,6 +2297,34 @@ class FdfParser:
            
         return True
 
+    ## __GetFvPackFiles() method
+    #
+    #   Get FvPackFiles for FV. When TRUE, GenFv reorders the RAW, FREEFORM and
+    #   APPLICATION files of the FV to reduce alignment padding; files of other
+    #   types keep their positions, so the dispatch order is unchanged.
+    #
+    #   @param  self        The object pointer
+    #   @param  Obj         for whom FvPackFiles is got
+    #   @retval True        Successfully find a FvPackFiles statement
+    #   @retval False       Not able to find a FvPackFiles statement
+    #
+    def __GetFvPackFiles(self, Obj):
+
+        if not self.__IsKeyword("FvPackFiles"):
+            return False
+
+        if not self.__IsToken( "="):
+            raise Warning("expected '='", self.FileName, self.CurrentLineNumber)
+
+        if not self.__GetNextToken():
+            raise Warning("expected FvPackFiles value", self.FileName, self.CurrentLineNumber)
+
+        if self.__Token.upper() not in ["TRUE", "FALSE", "0", "0X0", "0X00", "1", "0X1", "0X01"]:
+            raise Warning("Unknown FvPackFiles value '%s'" % self.__Token, self.FileName, self.CurrentLineNumber)
+
+        Obj.FvPackFiles = self.__Token.upper() in ["TRUE", "1", "0X1", "0X01"]
+        return True
+
 
     ## __GetFvAttributes() method
     #
@@ -3104,7 +3137,7 @@ class FdfParser:
             if self.__GetNextGuid():
                 GuidValue = self.__Token
 
-            AttribDict = self.__GetGuidAttrib()
+            AttribDict = self.__GetGuidAttrib(GuidValue)
             if not self.__IsToken("{"):
                 raise Warning("expected '{'", self.FileName, self.CurrentLineNumber)
             GuidSectionObj = GuidSection.GuidSection()
@@ -3114,6 +3147,8 @@ class FdfParser:
             GuidSectionObj.ProcessRequired = AttribDict["PROCESSING_REQUIRED"]
             GuidSectionObj.AuthStatusValid = AttribDict["AUTH_STATUS_VALID"]
             GuidSectionObj.ExtraHeaderSize = AttribDict["EXTRA_HEADER_SIZE"]
+            GuidSectionObj.CompressionQuality = AttribDict["COMPRESSION_QUALITY"]
+            GuidSectionObj.CompressionWindow = AttribDict["COMPRESSION_WINDOW"]
             # Recursive sections...
             while True:
                 IsLeafSection = self.__GetLeafSection(GuidSectionObj)
@@ -3134,16 +3169,20 @@ class FdfParser:
     #   Get attributes for GUID section
     #
     #   @param  self        The object pointer
+    #   @param  GuidValue   The GUID of the section, or None
     #   @retval AttribDict  Dictionary of key-value pair of section attributes
     #
-    def __GetGuidAttrib(self):
+    def __GetGuidAttrib(self, GuidValue):
 
         AttribDict = {}
         AttribDict["PROCESSING_REQUIRED"] = "NONE"
         AttribDict["AUTH_STATUS_VALID"] = "NONE"
         AttribDict["EXTRA_HEADER_SIZE"] = -1
+        AttribDict["COMPRESSION_QUALITY"] = -1
+        AttribDict["COMPRESSION_WINDOW"] = -1
         while self.__IsKeyword("PROCESSING_REQUIRED") or self.__IsKeyword("AUTH_STATUS_VALID") \
-            or self.__IsKeyword("EXTRA_HEADER_SIZE"):
+            or self.__IsKeyword("EXTRA_HEADER_SIZE") or self.__IsKeyword("COMPRESSION_QUALITY") \
+            or self.__IsKeyword("COMPRESSION_WINDOW"):
             AttribKey = self.__Token
 
             if not self.__IsToken("="):
@@ -3151,6 +3190,23 @@ class FdfParser:
 
             if not self.__GetNextToken():
                 raise Warning("expected TRUE(1)/FALSE(0)/Number", self.FileName, self.CurrentLineNumber)
+            elif AttribKey in ("COMPRESSION_QUALITY", "COMPRESSION_WINDOW"):
+                #
+                # Other GUIDed tools do not take -q/-w, or take them with a different meaning
+                #
+                if GuidValue == None or GuidValue.upper() != BROTLI_CUSTOM_DECOMPRESS_GUID:
+                    raise Warning("%s is only supported for Brotli GUIDed section %s" % (AttribKey, BROTLI_CUSTOM_DECOMPRESS_GUID), self.FileName, self.CurrentLineNumber)
+                #
+                # Brotli accepts quality 0 - 11 and window (log2 of the sliding window size) 10 - 24
+                #
+                if AttribKey == "COMPRESSION_QUALITY":
+                    MinValue, MaxValue = 0, 11
+                else:
+                    MinValue, MaxValue = 10, 24
+                if not self.__Token.isdigit() or int(self.__Token) < MinValue or int(self.__Token) > MaxValue:
+                    raise Warning("expected Number between %d and %d" % (MinValue, MaxValue), self.FileName, self.CurrentLineNumber)
+                AttribDict[AttribKey] = int(self.__Token)
+                continue
             elif AttribKey == "EXTRA_HEADER_SIZE":
                 Base = 10
                 if self.__Token[0:2].upper() == "0X":
@@ -4146,7 +4202,7 @@ class FdfParser:
             if self.__IsKeyword( "$(NAMED_GUID)"):
                 GuidValue = self.__Token
 
-            AttribDict = self.__GetGuidAttrib()
+            AttribDict = self.__GetGuidAttrib(GuidValue)
 
             if not self.__IsToken("{"):
                 raise Warning("expected '{'", self.FileName, self.CurrentLineNumber)
@@ -4156,6 +4212,8 @@ class FdfParser:
             GuidSectionObj.ProcessRequired = AttribDict["PROCESSING_REQUIRED"]
             GuidSectionObj.AuthStatusValid = AttribDict["AUTH_STATUS_VALID"]
             GuidSectionObj.ExtraHeaderSize = AttribDict["EXTRA_HEADER_SIZE"]
+            GuidSectionObj.CompressionQuality = AttribDict["COMPRESSION_QUALITY"]
+            GuidSectionObj.CompressionWindow = AttribDict["COMPRESSION_WINDOW"]
 
             # Efi sections...
             while True:
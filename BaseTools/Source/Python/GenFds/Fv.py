@@ -50,6 +50,7 @@ class FV (FvClassObject):
         self.CapsuleName = None
         self.FvBaseAddress = None
         self.FvForceRebase = None
+        self.FvPackFiles = False
         self.FvRegionInFD = None
         
     ## AddToBuffer()
@@ -143,6 +144,7 @@ class FV (FvClassObject):
                                 AddressFile=FvInfoFileName,
                                 FfsList=FfsFileList,
                                 ForceRebase=self.FvForceRebase,
+                                PackFiles=self.FvPackFiles,
                                 FileSystemGuid=FFSGuid
                                 )
 
@@ -176,6 +178,7 @@ class FV (FvClassObject):
                                         AddressFile=FvInfoFileName,
                                         FfsList=FfsFileList,
                                         ForceRebase=self.FvForceRebase,
+                                        PackFiles=self.FvPackFiles,
                                         FileSystemGuid=FFSGuid
                                         )
 
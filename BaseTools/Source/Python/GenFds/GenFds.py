@@ -17,6 +17,7 @@
 #
 from optparse import OptionParser
 import sys
+import time
 import Common.LongFilePathOs as os
 import linecache
 import FdfParser
@@ -32,6 +33,7 @@ import Common.TargetTxtClassObject as TargetTxtClassObject
 import Common.ToolDefClassObject as ToolDefClassObject
 from Common.DataType import *
 import Common.GlobalData as GlobalData
+import Common.BuildProfile as BuildProfile
 from Common import EdkLogger
 from Common.String import *
 from Common.Misc import DirCache, PathClass
@@ -65,8 +67,12 @@ def main():
     Workspace = ""
     ArchList = None
     ReturnCode = 0
+    StartTime = time.time()
 
     EdkLogger.Initialize()
+    if Options.ProfileReport != None:
+        Options.ProfileReport = os.path.abspath(Options.ProfileReport)
+        BuildProfile.Enable()
     try:
         if Options.verbose != None:
             EdkLogger.SetLevel(EdkLogger.VERBOSE)
@@ -353,6 +359,8 @@ def main():
         ReturnCode = CODE_ERROR
     finally:
         ClearDuplicatedInf()
+    if Options.ProfileReport != None:
+        BuildProfile.SaveReport(Options.ProfileReport, [("GenFds", time.time() - StartTime)])
     return ReturnCode
 
 gParamCheck = []
@@ -535,6 +543,9 @@ def myOptionParser():
     Parser.add_option("--conf", action="store", type="string", dest="ConfDirectory", help="Specify the customized Conf directory.")
     Parser.add_option("--ignore-sources", action="store_true", dest="IgnoreSources", default=False, help="Focus to a binary build and ignore all source files")
     Parser.add_option("--pcd", action="append", dest="OptionPcd", help="Set PCD value by command line. Format: \"PcdName=Value\" ")
+    Parser.add_option("--profile-report", action="store", type="string", dest="ProfileReport",
+                      help="Create/overwrite a JSON report of the time spent in each tool invocation to the specified filename, "\
+                           "and a Chrome trace-event file with the extension .trace.json next to it.")
 
     (Options, args) = Parser.parse_args()
     return Options
@@ -19,6 +19,7 @@ import Common.LongFilePathOs as os
 import sys
 import subprocess
 import struct
+import time
 import array
 
 from Common.BuildToolError import *
@@ -32,6 +33,7 @@ import Common.DataType as DataType
 from Common.Misc import PathClass
 from Common.LongFilePathSupport import OpenLongFilePath as open
 from Common.MultipleWorkspace import MultipleWorkspace as mws
+import Common.BuildProfile as BuildProfile
 
 ## Global variables
 #
@@ -459,7 +461,7 @@ class GenFdsGlobalVariable:
 
     @staticmethod
     def GenerateFirmwareVolume(Output, Input, BaseAddress=None, ForceRebase=None, Capsule=False, Dump=False,
-                               AddressFile=None, MapFile=None, FfsList=[], FileSystemGuid=None):
+                               AddressFile=None, MapFile=None, FfsList=[], FileSystemGuid=None, PackFiles=False):
         if not GenFdsGlobalVariable.NeedsUpdate(Output, Input+FfsList):
             return
         GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "%s needs update because of newer %s" % (Output, Input))
@@ -473,6 +475,9 @@ class GenFdsGlobalVariable:
         elif ForceRebase == True:
             Cmd += ["-F", "TRUE"]
 
+        if PackFiles:
+            Cmd += ["--pack"]
+
         if Capsule:
             Cmd += ["-c"]
         if Dump:
@@ -611,6 +616,8 @@ class GenFdsGlobalVariable:
             if GenFdsGlobalVariable.SharpCounter % GenFdsGlobalVariable.SharpNumberPerLine == 0:
                 sys.stdout.write('\n')
 
+        StartTime = time.time()
+        StartCpu = BuildProfile.GetChildCpuTime()
         try:
             PopenObject = subprocess.Popen(' '.join(cmd), stdout=subprocess.PIPE, stderr=subprocess.PIPE, shell=True)
         except Exception, X:
@@ -619,6 +626,21 @@ class GenFdsGlobalVariable:
 
         while PopenObject.returncode == None :
             PopenObject.wait()
+
+        if BuildProfile.IsEnabled():
+            #
+            # Tools are run one at a time, so the CPU time of all waited-for
+            # children since the start is the CPU time of this tool.
+            #
+            Tool = os.path.basename(cmd[0])
+            Category = "Tool"
+            if 'Compress' in Tool or (Tool == 'GenSec' and '-c' in cmd):
+                Category = "Compress"
+            Name = Tool
+            if '-o' in cmd and cmd.index('-o') + 1 < len(cmd):
+                Name += ' ' + os.path.basename(cmd[cmd.index('-o') + 1])
+            BuildProfile.AddEvent(Category, Name, StartTime, time.time() - StartTime,
+                                  BuildProfile.GetChildCpuTime() - StartCpu, {'Command' : ' '.join(cmd)})
         if returnValue != [] and returnValue[0] != 0:
             #get command return value
             returnValue[0] = PopenObject.returncode
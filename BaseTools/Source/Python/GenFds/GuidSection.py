@@ -172,6 +172,15 @@ class GuidSection(GuidSectionClassObject) :
             CmdOption = '-e'
             if ExternalOption != None:
                 CmdOption = CmdOption + ' ' + ExternalOption
+            #
+            # Per-section Brotli quality and window (only accepted by FdfParser for the
+            # Brotli GUID) are appended after the tools_def flags so that the FDF setting
+            # takes precedence.
+            #
+            if self.CompressionQuality != -1:
+                CmdOption = CmdOption + ' -q %d' % self.CompressionQuality
+            if self.CompressionWindow != -1:
+                CmdOption = CmdOption + ' -w %d' % self.CompressionWindow
             if self.ProcessRequired not in ("TRUE", "1") and self.IncludeFvSection and not FvAddrIsSet and self.FvParentAddr != None:
                 #FirstCall is only set for the encapsulated flash FV image without process required attribute.
                 FirstCall = True
@@ -168,7 +168,10 @@ class TableFile(Table):
         Path VARCHAR,
         FullPath VARCHAR NOT NULL,
         Model INTEGER DEFAULT 0,
-        TimeStamp SINGLE NOT NULL
+        TimeStamp SINGLE NOT NULL,
+        Hash VARCHAR,
+        Macros VARCHAR,
+        ParseTime REAL DEFAULT 0
         '''
     def __init__(self, Cursor):
         Table.__init__(self, Cursor, 'File')
@@ -183,9 +186,12 @@ class TableFile(Table):
     # @param FullPath:  FullPath of a File
     # @param Model:     Model of a File
     # @param TimeStamp: TimeStamp of a File
+    # @param Hash:      Digest of the content of a File
+    # @param Macros:    Digest of the macros used to parse a File
+    # @param ParseTime: Time in seconds used to parse a File
     #
-    def Insert(self, Name, ExtName, Path, FullPath, Model, TimeStamp):
-        (Name, ExtName, Path, FullPath) = ConvertToSqlString((Name, ExtName, Path, FullPath))
+    def Insert(self, Name, ExtName, Path, FullPath, Model, TimeStamp, Hash='', Macros='', ParseTime=0):
+        (Name, ExtName, Path, FullPath, Hash, Macros) = ConvertToSqlString((Name, ExtName, Path, FullPath, Hash, Macros))
         return Table.Insert(
             self,
             Name,
@@ -193,7 +199,10 @@ class TableFile(Table):
             Path,
             FullPath,
             Model,
-            TimeStamp
+            TimeStamp,
+            Hash,
+            Macros,
+            ParseTime
             )
 
     ## InsertFile
@@ -262,6 +271,38 @@ class TableFile(Table):
     def SetFileTimeStamp(self, FileId, TimeStamp):
         self.Exec("update %s set TimeStamp=%s where ID='%s'" % (self.Table, TimeStamp, FileId))
 
+    ## Get the parse state of a given file
+    #
+    #   @param  FileId      ID of file
+    #
+    #   @retval tuple       (TimeStamp, Hash, Macros, ParseTime) of given file in the table
+    #
+    def GetFileState(self, FileId):
+        QueryScript = "select TimeStamp, Hash, Macros, ParseTime from %s where ID = '%s'" % (self.Table, FileId)
+        RecordList = self.Exec(QueryScript)
+        if len(RecordList) == 0:
+            return None
+        return RecordList[0]
+
+    ## Update the parse state of a given file
+    #
+    #   @param  FileId      ID of file
+    #   @param  TimeStamp   Time stamp of file
+    #   @param  Hash        Digest of the content of file
+    #   @param  Macros      Digest of the macros used to parse file
+    #
+    def SetFileState(self, FileId, TimeStamp, Hash, Macros):
+        (Hash, Macros) = ConvertToSqlString((Hash, Macros))
+        self.Exec("update %s set TimeStamp=%s, Hash=%s, Macros=%s where ID='%s'" % (self.Table, TimeStamp, Hash, Macros, FileId))
+
+    ## Update the time used to parse a given file
+    #
+    #   @param  FileId      ID of file
+    #   @param  ParseTime   Time in seconds used to parse file
+    #
+    def SetFileParseTime(self, FileId, ParseTime):
+        self.Exec("update %s set ParseTime=%s where ID='%s'" % (self.Table, ParseTime, FileId))
+
     ## Get list of file with given type
     #
     #   @param  FileType    Type value of file
@@ -22,6 +22,7 @@ import copy
 
 import Common.EdkLogger as EdkLogger
 import Common.GlobalData as GlobalData
+import Common.BuildProfile as BuildProfile
 
 from CommonDataClass.DataClass import *
 from Common.DataType import *
@@ -233,10 +234,17 @@ class MetaFileParser(object):
         if not self._Finished:
             if self._RawTable.IsIntegrity():
                 self._Finished = True
+                if str(self.MetaFile) not in GlobalData.gMetaFileParseTime:
+                    GlobalData.gMetaFileParseTime[str(self.MetaFile)] = (self._RawTable.GetParseTime(), True)
             else:
                 self._Table = self._RawTable
                 self._PostProcessed = False
+                Timer = BuildProfile.ProfileTimer("Parse", self.MetaFile)
                 self.Start()
+                ParseTime = time.time() - Timer.Start
+                Timer.Stop()
+                self._RawTable.SetParseTime(ParseTime)
+                GlobalData.gMetaFileParseTime[str(self.MetaFile)] = (ParseTime, False)
 
         # No specific ARCH or Platform given, use raw data
         if self._RawTable and (len(DataInfo) == 1 or DataInfo[1] == None):
@@ -15,15 +15,34 @@
 # Import Modules
 #
 import uuid
+import hashlib
 
 import Common.EdkLogger as EdkLogger
+import Common.GlobalData as GlobalData
 from Common.BuildToolError import FORMAT_INVALID
+from Common.LongFilePathSupport import OpenLongFilePath as open
 
 from MetaDataTable import Table, TableFile
 from MetaDataTable import ConvertToSqlString
 from CommonDataClass.DataClass import MODEL_FILE_DSC, MODEL_FILE_DEC, MODEL_FILE_INF, \
                                       MODEL_FILE_OTHERS
 
+## Macros set by build for each target, tool chain and arch
+gBuildLoopMacros = ['TARGET', 'ARCH', 'TOOLCHAIN', 'TOOL_CHAIN_TAG', 'FAMILY']
+
+## Get the digest of the macros which may be used to parse a meta-file
+#
+#   Parsed data cached in the database can be reused only if both the content
+#   of the meta-file and these macros are the same as the ones used to parse it.
+#
+#   @retval string      The digest of macros
+#
+def GetMacroDigest():
+    MacroList = [('-D', Name, Value) for Name, Value in GlobalData.gCommandLineDefines.items() if Name not in gBuildLoopMacros]
+    MacroList += [('', Name, Value) for Name, Value in GlobalData.gGlobalDefines.items() if Name not in gBuildLoopMacros]
+    MacroList.sort()
+    return hashlib.md5(repr(MacroList)).hexdigest()
+
 class MetaFileTable(Table):
     # TRICK: use file ID as the part before '.'
     _ID_STEP_ = 0.00000001
@@ -52,21 +71,41 @@ class MetaFileTable(Table):
     def IsIntegrity(self):
         try:
             TimeStamp = self.MetaFile.TimeStamp
+            Macros = GetMacroDigest()
             Result = self.Cur.execute("select ID from %s where ID<0" % (self.Table)).fetchall()
             if not Result:
-                # update the timestamp in database
-                self._FileIndexTable.SetFileTimeStamp(self.IdBase, TimeStamp)                
+                # update the timestamp, content digest and macro digest in database
+                self._FileIndexTable.SetFileState(self.IdBase, TimeStamp, self.GetFileHash(), Macros)
                 return False
 
-            if TimeStamp != self._FileIndexTable.GetFileTimeStamp(self.IdBase):
-                # update the timestamp in database
-                self._FileIndexTable.SetFileTimeStamp(self.IdBase, TimeStamp)
-                return False
+            OldTimeStamp, OldHash, OldMacros, ParseTime = self._FileIndexTable.GetFileState(self.IdBase)
+            if TimeStamp != OldTimeStamp or Macros != OldMacros:
+                # file touched without change can still use the data in database
+                Hash = self.GetFileHash()
+                self._FileIndexTable.SetFileState(self.IdBase, TimeStamp, Hash, Macros)
+                if Hash != OldHash or Macros != OldMacros:
+                    return False
         except Exception, Exc:
             EdkLogger.debug(EdkLogger.DEBUG_5, str(Exc))
             return False
         return True
 
+    ## Get the digest of the content of the meta-file
+    def GetFileHash(self):
+        with open(str(self.MetaFile), 'rb') as File:
+            return hashlib.md5(File.read()).hexdigest()
+
+    ## Get the time used to parse the meta-file last time
+    def GetParseTime(self):
+        State = self._FileIndexTable.GetFileState(self.IdBase)
+        if not State or State[3] == None:
+            return 0
+        return State[3]
+
+    ## Save the time used to parse the meta-file
+    def SetParseTime(self, ParseTime):
+        self._FileIndexTable.SetFileParseTime(self.IdBase, ParseTime)
+
 ## Python class representation of table storing module data
 class ModuleTable(MetaFileTable):
     _ID_STEP_ = 0.00000001
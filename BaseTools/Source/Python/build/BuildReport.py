@@ -1697,8 +1697,9 @@ class PlatformReport(object):
     # @param File            The file object for report
     # @param BuildDuration   The total time to build the modules
     # @param ReportType      The kind of report items in the final report file
+    # @param PhaseDurationList The list of (phase name, duration) of the build
     #
-    def GenerateReport(self, File, BuildDuration, ReportType):
+    def GenerateReport(self, File, BuildDuration, ReportType, PhaseDurationList=None):
         FileWrite(File, "Platform Summary")
         FileWrite(File, "Platform Name:        %s" % self.PlatformName)
         FileWrite(File, "Platform DSC Path:    %s" % self.PlatformDscPath)
@@ -1708,6 +1709,8 @@ class PlatformReport(object):
         FileWrite(File, "Output Path:          %s" % self.OutputPath)
         FileWrite(File, "Build Environment:    %s" % self.BuildEnvironment)
         FileWrite(File, "Build Duration:       %s" % BuildDuration)
+        for (Phase, Duration) in PhaseDurationList or []:
+            FileWrite(File, "%-22s%s" % ("%s Duration:" % Phase, Duration))
         FileWrite(File, "Report Content:       %s" % ", ".join(ReportType))
 
         if GlobalData.MixedPcd:
@@ -1782,13 +1785,14 @@ class BuildReport(object):
     #
     # @param self            The object pointer
     # @param BuildDuration   The total time to build the modules
+    # @param PhaseDurationList The list of (phase name, duration) of the build
     #
-    def GenerateReport(self, BuildDuration):
+    def GenerateReport(self, BuildDuration, PhaseDurationList=None):
         if self.ReportFile:
             try:
                 File = StringIO('')
                 for (Wa, MaList) in self.ReportList:
-                    PlatformReport(Wa, MaList, self.ReportType).GenerateReport(File, BuildDuration, self.ReportType)
+                    PlatformReport(Wa, MaList, self.ReportType).GenerateReport(File, BuildDuration, self.ReportType, PhaseDurationList)
                 Content = FileLinesSplit(File.getvalue(), gLineMaxLength)
                 SaveFileOnChange(self.ReportFile, Content, True)
                 EdkLogger.quiet("Build report can be found at %s" % os.path.abspath(self.ReportFile))
@@ -26,6 +26,7 @@ import platform
 import traceback
 import encodings.ascii
 import itertools
+import multiprocessing
 
 from struct import *
 from threading import *
@@ -50,6 +51,7 @@ from PatchPcdValue.PatchPcdValue import *
 
 import Common.EdkLogger
 import Common.GlobalData as GlobalData
+import Common.BuildProfile as BuildProfile
 
 # Version and Copyright
 VersionNumber = "0.60" + ' ' + gBUILD_VERSION
@@ -66,6 +68,21 @@ gToolsDefinition = "tools_def.txt"
 TemporaryTablePattern = re.compile(r'^_\d+_\d+_[a-fA-F0-9]+$')
 TmpTableDict = {}
 
+## Meta-data read from the database before AutoGen worker processes are forked
+gModuleMetaData = ['Sources', 'Binaries', 'Packages', 'Pcds', 'Guids', 'Protocols', 'Ppis', 'Includes',
+                   'LibraryClasses', 'BuildOptions', 'Depex', 'DepexExpression', 'Defines', 'CustomMakefile',
+                   'ModuleEntryPointList', 'ModuleUnloadImageList', 'ConstructorList', 'DestructorList']
+gPackageMetaData = ['Guids', 'Protocols', 'Ppis', 'Includes', 'LibraryClasses', 'Pcds']
+gAutoGenMetaData = ['DependentPackageList', 'DependentLibraryList', 'ModulePcdList', 'LibraryPcdList',
+                    'GuidList', 'ProtocolList', 'PpiList', 'BuildOption', 'IncludePathList',
+                    'DepexList', 'DepexExpressionList']
+
+## AutoGen objects and actions shared with the AutoGen worker processes
+gAutoGenWorkerContext = None
+
+## State of the AutoGen objects copied back from the AutoGen worker processes
+gAutoGenWorkerState = ['IsCodeFileCreated', 'IsMakeFileCreated', 'DepexGenerated']
+
 ## Check environment PATH variable to make sure the specified tool is found
 #
 #   If the tool is found in the PATH, then True is returned
@@ -246,6 +263,36 @@ def ReadMessage(From, To, ExitFlag):
         if ExitFlag.isSet():
             break
 
+## Generate AutoGen code and makefile of a module in a worker process
+#
+# The worker is forked from the build process after the platform, PCD and
+# library data and the meta-data of the modules have been resolved, so the
+# AutoGen objects are inherited from gAutoGenWorkerContext and the workspace
+# database is not queried. The worker doesn't write the generated files: they
+# are returned with the state of the AutoGen object, and the build process
+# writes them and updates its own AutoGen object.
+#
+# @param  Index     The index of the AutoGen object in gAutoGenWorkerContext
+#
+# @retval tuple     (ErrorCode, ErrorInfo, FileDict, StateList, Event)
+#
+def AutoGenWorker(Index):
+    AutoGenList, CreateCodeFile, CreateMakeFile = gAutoGenWorkerContext
+    AutoGenObject = AutoGenList[Index]
+    GlobalData.gSavedFileDict = {}
+    Timer = BuildProfile.ProfileTimer("AutoGen", AutoGenObject)
+    try:
+        if CreateCodeFile:
+            AutoGenObject.CreateCodeFile(False)
+        if CreateMakeFile:
+            AutoGenObject.CreateMakeFile(False)
+    except FatalError, X:
+        return (X.args[0], str(AutoGenObject), None, None, None)
+    except:
+        return (CODE_ERROR, traceback.format_exc(), None, None, None)
+    StateList = [getattr(AutoGenObject, Name) for Name in gAutoGenWorkerState]
+    return (0, None, GlobalData.gSavedFileDict, StateList, Timer.Stop())
+
 ## Launch an external program
 #
 # This method will call subprocess.Popen to execute an external program with
@@ -255,8 +302,9 @@ def ReadMessage(From, To, ExitFlag):
 #
 # @param  Command               A list or string containing the call of the program
 # @param  WorkingDir            The directory in which the program will be running
+# @param  Category              The build step recorded in the profile report
 #
-def LaunchCommand(Command, WorkingDir):
+def LaunchCommand(Command, WorkingDir, Category="Make"):
     # if working directory doesn't exist, Popen() will raise an exception
     if not os.path.isdir(WorkingDir):
         EdkLogger.error("build", FILE_NOT_FOUND, ExtraData=WorkingDir)
@@ -272,6 +320,8 @@ def LaunchCommand(Command, WorkingDir):
 
     Proc = None
     EndOfProcedure = None
+    StartTime = time.time()
+    CpuTime = None
     try:
         # launch the command
         Proc = Popen(Command, stdout=PIPE, stderr=PIPE, env=os.environ, cwd=WorkingDir, bufsize=-1, shell=True)
@@ -292,7 +342,7 @@ def LaunchCommand(Command, WorkingDir):
             StdErrThread.start()
 
         # waiting for program exit
-        Proc.wait()
+        CpuTime = BuildProfile.WaitProcess(Proc)
     except: # in case of aborting
         # terminate the threads redirecting the program output
         EdkLogger.quiet("(Python %s on %s) " % (platform.python_version(), sys.platform) + traceback.format_exc())
@@ -308,6 +358,11 @@ def LaunchCommand(Command, WorkingDir):
     if Proc.stderr:
         StdErrThread.join()
 
+    if BuildProfile.IsEnabled():
+        if type(Command) != type(""):
+            Command = " ".join(Command)
+        BuildProfile.AddEvent(Category, "%s [%s]" % (Command, WorkingDir), StartTime, time.time() - StartTime, CpuTime)
+
     # check the return code of the program
     if Proc.returncode != 0:
         if type(Command) != type(""):
@@ -755,6 +810,7 @@ class Build():
         self.CapList        = BuildOptions.CapName
         self.SilentMode     = BuildOptions.SilentMode
         self.ThreadNumber   = BuildOptions.ThreadNumber
+        self.AutoGenJobs    = BuildOptions.AutoGenJobs
         self.SkipAutoGen    = BuildOptions.SkipAutoGen
         self.Reparse        = BuildOptions.Reparse
         self.SkuId          = BuildOptions.SkuId
@@ -794,6 +850,9 @@ class Build():
         self.LoadFixAddress = 0
         self.UniFlag        = BuildOptions.Flag
         self.BuildModules = []
+        self.AutoGenTime = 0
+        self.MakeTime = 0
+        self.GenFdsTime = 0
         self.Db_Flag = False
         self.LaunchPrebuildFlag = False
         self.PlatformBuildPath = os.path.join(GlobalData.gConfDirectory,'.cache', '.PlatformBuild')
@@ -1345,7 +1404,8 @@ class Build():
 
         # genfds
         if Target == 'fds':
-            LaunchCommand(AutoGenObject.GenFdsCommand, AutoGenObject.MakeFileDir)
+            LaunchCommand(AutoGenObject.GenFdsCommand, AutoGenObject.MakeFileDir, "GenFds")
+            BuildProfile.LoadEvents(os.path.join(AutoGenObject.BuildDir, BuildProfile.GENFDS_PROFILE_FILE))
             return True
 
         # run
@@ -1374,7 +1434,10 @@ class Build():
 
     ## Rebase module image and Get function address for the input module list.
     #
-    def _RebaseModule (self, MapBuffer, BaseAddress, ModuleList, AddrIsOffset = True, ModeIsSmm = False):
+    # The GenFw options to rebase the images are appended to RebaseList, and
+    # run later by _RebaseImages().
+    #
+    def _RebaseModule (self, MapBuffer, BaseAddress, ModuleList, RebaseList, AddrIsOffset = True, ModeIsSmm = False):
         if ModeIsSmm:
             AddrIsOffset = False
         InfFileNameList = ModuleList.keys()
@@ -1392,14 +1455,14 @@ class Build():
                 #
                 # Update Image to new BaseAddress by GenFw tool
                 #
-                LaunchCommand(["GenFw", "--rebase", str(BaseAddress), "-r", ModuleOutputImage], ModuleInfo.OutputDir)
-                LaunchCommand(["GenFw", "--rebase", str(BaseAddress), "-r", ModuleDebugImage], ModuleInfo.DebugDir)
+                RebaseList.append(["--rebase", str(BaseAddress), "-r", ModuleOutputImage])
+                RebaseList.append(["--rebase", str(BaseAddress), "-r", ModuleDebugImage])
             else:
                 #
                 # Set new address to the section header only for SMM driver.
                 #
-                LaunchCommand(["GenFw", "--address", str(BaseAddress), "-r", ModuleOutputImage], ModuleInfo.OutputDir)
-                LaunchCommand(["GenFw", "--address", str(BaseAddress), "-r", ModuleDebugImage], ModuleInfo.DebugDir)
+                RebaseList.append(["--address", str(BaseAddress), "-r", ModuleOutputImage])
+                RebaseList.append(["--address", str(BaseAddress), "-r", ModuleDebugImage])
             #
             # Collect funtion address from Map file
             #
@@ -1645,14 +1708,30 @@ class Build():
         BtBaseAddr  = TopMemoryAddress - RtSize
         RtBaseAddr  = TopMemoryAddress - ReservedRuntimeMemorySize
 
-        self._RebaseModule (MapBuffer, PeiBaseAddr, PeiModuleList, TopMemoryAddress == 0)
-        self._RebaseModule (MapBuffer, BtBaseAddr, BtModuleList, TopMemoryAddress == 0)
-        self._RebaseModule (MapBuffer, RtBaseAddr, RtModuleList, TopMemoryAddress == 0)
-        self._RebaseModule (MapBuffer, 0x1000, SmmModuleList, AddrIsOffset=False, ModeIsSmm=True)
+        RebaseList = []
+        self._RebaseModule (MapBuffer, PeiBaseAddr, PeiModuleList, RebaseList, TopMemoryAddress == 0)
+        self._RebaseModule (MapBuffer, BtBaseAddr, BtModuleList, RebaseList, TopMemoryAddress == 0)
+        self._RebaseModule (MapBuffer, RtBaseAddr, RtModuleList, RebaseList, TopMemoryAddress == 0)
+        self._RebaseModule (MapBuffer, 0x1000, SmmModuleList, RebaseList, AddrIsOffset=False, ModeIsSmm=True)
+        self._RebaseImages (RebaseList)
         MapBuffer.write('\n\n')
         sys.stdout.write ("\n")
         sys.stdout.flush()
 
+    ## Rebase module images with one GenFw process
+    #
+    #   @param  RebaseList  The list of GenFw options of each image
+    #
+    def _RebaseImages (self, RebaseList):
+        if not RebaseList:
+            return
+        ListFile = os.path.join(os.path.dirname(GlobalData.gDatabasePath), 'GenFwRebase.lst')
+        Content = ''
+        for Options in RebaseList:
+            Content += ' '.join(['"%s"' % Option for Option in Options]) + '\n'
+        SaveFileOnChange(ListFile, Content, False)
+        LaunchCommand(["GenFw", "--batch", ListFile], os.path.dirname(ListFile))
+
     ## Save platform Map file
     #
     def _SaveMapFile (self, MapBuffer, Wa):
@@ -1852,6 +1931,97 @@ class Build():
                     #
                     self._SaveMapFile (MapBuffer, Wa)
 
+    ## Generate AutoGen code and makefiles of modules
+    #
+    # When more than one AutoGen job is requested, the data of the modules and
+    # of their libraries is resolved first, then their AutoGen code and
+    # makefiles are generated in forked worker processes, which return the
+    # generated files to this process. Otherwise, or on hosts without fork(),
+    # the modules are processed one by one.
+    #
+    #   @param  MaList      The list of ModuleAutoGen objects
+    #
+    def _GenModuleAutoGenFiles(self, MaList):
+        global gAutoGenWorkerContext
+
+        CreateCode = not self.SkipAutoGen or self.Target == 'genc'
+        CreateMake = (not self.SkipAutoGen or self.Target == 'genmake') and self.Target != 'genc'
+        if not CreateCode and not CreateMake:
+            return
+
+        if self.AutoGenJobs <= 1 or sys.platform == 'win32' or len(MaList) <= 1:
+            for Ma in MaList:
+                Timer = BuildProfile.ProfileTimer("AutoGen", Ma)
+                if CreateCode:
+                    Ma.CreateCodeFile(True)
+                if CreateMake:
+                    Ma.CreateMakeFile(True)
+                Timer.Stop()
+            return
+
+        #
+        # Libraries are generated before modules so that a library shared by
+        # several modules is processed only once.
+        #
+        AutoGenList = []
+        AutoGenSet = set()
+        for Ma in MaList:
+            for Lib in Ma.LibraryAutoGenList:
+                if Lib not in AutoGenSet:
+                    AutoGenSet.add(Lib)
+                    AutoGenList.append(Lib)
+        for Ma in MaList:
+            if Ma not in AutoGenSet:
+                AutoGenSet.add(Ma)
+                AutoGenList.append(Ma)
+
+        #
+        # Resolve the meta-data and the platform settings applied to each
+        # module before forking, so that the workers inherit them instead of
+        # querying the database. The database is not used by this process
+        # while the workers run.
+        #
+        PackageSet = set()
+        for AutoGenObject in AutoGenList:
+            for Name in gModuleMetaData:
+                getattr(AutoGenObject.Module, Name)
+            for Package in AutoGenObject.Module.Packages:
+                if Package not in PackageSet:
+                    PackageSet.add(Package)
+                    for Name in gPackageMetaData:
+                        getattr(Package, Name)
+            for Name in gAutoGenMetaData:
+                getattr(AutoGenObject, Name)
+        self.Db.Conn.commit()
+        sys.stdout.flush()
+        sys.stderr.flush()
+
+        #
+        # The results are taken in order while the workers go on, and the
+        # remaining work is dropped at the first failure.
+        #
+        gAutoGenWorkerContext = (AutoGenList, CreateCode, CreateMake)
+        Pool = multiprocessing.Pool(min(self.AutoGenJobs, len(AutoGenList)))
+        try:
+            ResultIterator = Pool.imap(AutoGenWorker, range(len(AutoGenList)))
+            for AutoGenObject in AutoGenList:
+                ErrorCode, ErrorInfo, FileDict, StateList, Event = ResultIterator.next(0xFFFFFFFF)
+                if ErrorCode:
+                    EdkLogger.error("build", ErrorCode, "Failed to generate AutoGen files", ExtraData=ErrorInfo)
+                for File, Content in FileDict.items():
+                    SaveFileOnChange(File, Content, True)
+                for Name, Value in zip(gAutoGenWorkerState, StateList):
+                    setattr(AutoGenObject, Name, Value)
+                if Event:
+                    BuildProfile.AddEventList([Event])
+            Pool.close()
+        except:
+            Pool.terminate()
+            raise
+        finally:
+            Pool.join()
+            gAutoGenWorkerContext = None
+
     ## Build a platform in multi-thread mode
     #
     def _MultiThreadBuildPlatform(self):
@@ -1864,6 +2034,8 @@ class Build():
                 GlobalData.gGlobalDefines['TOOL_CHAIN_TAG'] = ToolChain
                 GlobalData.gGlobalDefines['FAMILY'] = self.ToolChainFamily[index]
                 index += 1
+                AutoGenStartTime = time.time()
+                Timer = BuildProfile.ProfileTimer("AutoGen", self.PlatformFile)
                 Wa = WorkspaceAutoGen(
                         self.WorkspaceDir,
                         self.PlatformFile,
@@ -1885,11 +2057,14 @@ class Build():
                 self.LoadFixAddress = Wa.Platform.LoadFixAddress
                 self.BuildReport.AddPlatformReport(Wa)
                 Wa.CreateMakeFile(False)
+                Timer.Stop()
+                self.AutoGenTime += time.time() - AutoGenStartTime
 
                 # multi-thread exit flag
                 ExitFlag = threading.Event()
                 ExitFlag.clear()
                 for Arch in Wa.ArchList:
+                    AutoGenStartTime = time.time()
                     GlobalData.gGlobalDefines['ARCH'] = Arch
                     Pa = PlatformAutoGen(Wa, self.PlatformFile, BuildTarget, ToolChain, Arch)
                     if Pa == None:
@@ -1904,27 +2079,24 @@ class Build():
                             if Inf in Pa.Platform.Modules:
                                 continue
                             ModuleList.append(Inf)
+                    MaList = []
                     for Module in ModuleList:
                         # Get ModuleAutoGen object to generate C code file and makefile
                         Ma = ModuleAutoGen(Wa, Module, BuildTarget, ToolChain, Arch, self.PlatformFile)
                         
                         if Ma == None:
                             continue
-                        # Not to auto-gen for targets 'clean', 'cleanlib', 'cleanall', 'run', 'fds'
-                        if self.Target not in ['clean', 'cleanlib', 'cleanall', 'run', 'fds']:
-                            # for target which must generate AutoGen code and makefile
-                            if not self.SkipAutoGen or self.Target == 'genc':
-                                Ma.CreateCodeFile(True)
-                            if self.Target == "genc":
-                                continue
-
-                            if not self.SkipAutoGen or self.Target == 'genmake':
-                                Ma.CreateMakeFile(True)
-                            if self.Target == "genmake":
-                                continue
-                        self.BuildModules.append(Ma)
+                        MaList.append(Ma)
+                    # Not to auto-gen for targets 'clean', 'cleanlib', 'cleanall', 'run', 'fds'
+                    if self.Target not in ['clean', 'cleanlib', 'cleanall', 'run', 'fds']:
+                        # for target which must generate AutoGen code and makefile
+                        self._GenModuleAutoGenFiles(MaList)
+                    if self.Target not in ["genc", "genmake"]:
+                        self.BuildModules.extend(MaList)
                     self.Progress.Stop("done!")
+                    self.AutoGenTime += time.time() - AutoGenStartTime
 
+                    MakeStartTime = time.time()
                     for Ma in self.BuildModules:
                         # Generate build task for the module
                         if not Ma.IsBinaryModule:
@@ -1942,6 +2114,7 @@ class Build():
 
                     # in case there's an interruption. we need a full version of makefile for platform
                     Pa.CreateMakeFile(False)
+                    self.MakeTime += time.time() - MakeStartTime
                     if BuildTask.HasError():
                         EdkLogger.error("build", BUILD_ERROR, "Failed to build module", ExtraData=GlobalData.gBuildingModule)
 
@@ -1957,8 +2130,10 @@ class Build():
                 # All modules have been put in build tasks queue. Tell task scheduler
                 # to exit if all tasks are completed
                 #
+                MakeStartTime = time.time()
                 ExitFlag.set()
                 BuildTask.WaitForComplete()
+                self.MakeTime += time.time() - MakeStartTime
                 self.CreateAsBuiltInf()
 
                 #
@@ -1997,7 +2172,10 @@ class Build():
                         #
                         # Generate FD image if there's a FDF file found
                         #
-                        LaunchCommand(Wa.GenFdsCommand, os.getcwd())
+                        GenFdsStartTime = time.time()
+                        LaunchCommand(Wa.GenFdsCommand, os.getcwd(), "GenFds")
+                        BuildProfile.LoadEvents(os.path.join(Wa.BuildDir, BuildProfile.GENFDS_PROFILE_FILE))
+                        self.GenFdsTime += time.time() - GenFdsStartTime
 
                         #
                         # Create MAP file for all platform FVs after GenFds.
@@ -2081,12 +2259,18 @@ class Build():
     def Launch(self):
         if not self.ModuleFile:
             if not self.SpawnMode or self.Target not in ["", "all"]:
+                if self.AutoGenJobs > 1:
+                    EdkLogger.warn("build", "--autogen-jobs is ignored because the platform is not built in multi-thread mode")
                 self.SpawnMode = False
                 self._BuildPlatform()
             else:
+                if self.AutoGenJobs > 1 and sys.platform == 'win32':
+                    EdkLogger.warn("build", "--autogen-jobs is ignored because worker processes can not be forked on Windows")
                 self._MultiThreadBuildPlatform()
             self.CreateGuidedSectionToolsFile()
         else:
+            if self.AutoGenJobs > 1:
+                EdkLogger.warn("build", "--autogen-jobs is ignored when a single module is built")
             self.SpawnMode = False
             self._BuildModule()
 
@@ -2175,6 +2359,8 @@ def MyOptionParser():
 
     Parser.add_option("-n", action="callback", type="int", dest="ThreadNumber", callback=SingleCheckCallback,
         help="Build the platform using multi-threaded compiler. The value overrides target.txt's MAX_CONCURRENT_THREAD_NUMBER. Less than 2 will disable multi-thread builds.")
+    Parser.add_option("--autogen-jobs", action="callback", type="int", dest="AutoGenJobs", callback=SingleCheckCallback, default=1,
+        help="Generate AutoGen code and makefiles of modules using the given number of worker processes in multi-thread platform builds. Less than 2, or a build on Windows, will disable multi-process AutoGen.")
 
     Parser.add_option("-f", "--fdf", action="callback", type="string", dest="FdfFile", callback=SingleCheckCallback,
         help="The name of the FDF file to use, which overrides the setting in the DSC file.")
@@ -2202,6 +2388,9 @@ def MyOptionParser():
     Parser.add_option("-D", "--define", action="append", type="string", dest="Macros", help="Macro: \"Name [= Value]\".")
 
     Parser.add_option("-y", "--report-file", action="store", dest="ReportFile", help="Create/overwrite the report to the specified filename.")
+    Parser.add_option("--profile-report", action="store", dest="ProfileReport",
+        help="Create/overwrite a JSON report of the wall and CPU time spent in each build step to the specified filename, "\
+             "and a Chrome trace-event file with the extension .trace.json next to it.")
     Parser.add_option("-Y", "--report-type", action="append", type="choice", choices=['PCD','LIBRARY','FLASH','DEPEX','BUILD_FLAGS','FIXED_ADDRESS','HASH','EXECUTION_ORDER'], dest="ReportType", default=[],
         help="Flags that control the type of build report to generate.  Must be one of: [PCD, LIBRARY, FLASH, DEPEX, BUILD_FLAGS, FIXED_ADDRESS, HASH, EXECUTION_ORDER].  "\
              "To specify more than one flag, repeat this option on the command line and the default flag set is [PCD, LIBRARY, FLASH, DEPEX, BUILD_FLAGS, FIXED_ADDRESS]")
@@ -2219,6 +2408,18 @@ def MyOptionParser():
     (Opt, Args) = Parser.parse_args()
     return (Opt, Args)
 
+## Format a duration in seconds as HH:MM:SS
+#
+#   @param  Seconds     The duration in seconds
+#
+#   @retval string      The formatted duration
+#
+def FormatDuration(Seconds):
+    Duration = time.gmtime(int(round(Seconds)))
+    if Duration.tm_yday > 1:
+        return time.strftime("%H:%M:%S", Duration) + ", %d day(s)" % (Duration.tm_yday - 1)
+    return time.strftime("%H:%M:%S", Duration)
+
 ## Tool entrance method
 #
 # This method mainly dispatch specific methods per the command line options.
@@ -2257,6 +2458,10 @@ def Main():
     if Option.WarningAsError == True:
         EdkLogger.SetWarningAsError()
 
+    if Option.ProfileReport != None:
+        Option.ProfileReport = os.path.abspath(Option.ProfileReport)
+        BuildProfile.Enable()
+
     if platform.platform().find("Windows") >= 0:
         GlobalData.gIsWindows = True
     else:
@@ -2399,19 +2604,32 @@ def Main():
     else:
         Conclusion = "Failed"
     FinishTime = time.time()
-    BuildDuration = time.gmtime(int(round(FinishTime - StartTime)))
-    BuildDurationStr = ""
-    if BuildDuration.tm_yday > 1:
-        BuildDurationStr = time.strftime("%H:%M:%S", BuildDuration) + ", %d day(s)" % (BuildDuration.tm_yday - 1)
-    else:
-        BuildDurationStr = time.strftime("%H:%M:%S", BuildDuration)
+    BuildDurationStr = FormatDuration(FinishTime - StartTime)
     if MyBuild != None:
         if not BuildError:
-            MyBuild.BuildReport.GenerateReport(BuildDurationStr)
+            PhaseDurationList = []
+            # Phase durations are only collected by the multi-thread platform build
+            if MyBuild.SpawnMode:
+                PhaseDurationList = [
+                    ("AutoGen", FormatDuration(MyBuild.AutoGenTime)),
+                    ("Make", FormatDuration(MyBuild.MakeTime)),
+                    ("GenFds", FormatDuration(MyBuild.GenFdsTime))
+                    ]
+            MyBuild.BuildReport.GenerateReport(BuildDurationStr, PhaseDurationList)
         MyBuild.Db.Close()
+    if Option.ProfileReport != None:
+        PhaseList = [("Build", FinishTime - StartTime)]
+        if MyBuild != None and MyBuild.SpawnMode:
+            PhaseList += [("AutoGen", MyBuild.AutoGenTime), ("Make", MyBuild.MakeTime), ("GenFds", MyBuild.GenFdsTime)]
+        BuildProfile.SaveReport(Option.ProfileReport, PhaseList)
     EdkLogger.SetLevel(EdkLogger.QUIET)
     EdkLogger.quiet("\n- %s -" % Conclusion)
     EdkLogger.quiet(time.strftime("Build end time: %H:%M:%S, %b.%d %Y", time.localtime()))
+    if GlobalData.gMetaFileParseTime:
+        ParsedList = [Time for (Time, Cached) in GlobalData.gMetaFileParseTime.values() if not Cached]
+        CachedList = [Time for (Time, Cached) in GlobalData.gMetaFileParseTime.values() if Cached]
+        EdkLogger.quiet("Meta-file parse time: %.2f seconds for %d file(s), %d file(s) loaded from database (saved %.2f seconds)" %
+                        (sum(ParsedList), len(ParsedList), len(CachedList), sum(CachedList)))
     EdkLogger.quiet("Build total time: %s\n" % BuildDurationStr)
     return ReturnCode
 
@@ -1,7 +1,7 @@
 /** @file  
   Application for Block Cipher Primitives Validation.
 
-Copyright (c) 2010, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2010 - 2017, Intel Corporation. All rights reserved.<BR>
 This program and the accompanying materials
 are licensed and made available under the terms and conditions of the BSD License
 which accompanies this distribution.  The full text of the license may be found at
@@ -115,6 +115,192 @@ GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 Aes128CbcCipher[] = {
   0x75, 0x86, 0x60, 0x2d, 0x25, 0x3c, 0xff, 0xf9, 0x1b, 0x82, 0x66, 0xbe, 0xa6, 0xd6, 0x1a, 0xb1
   };
 
+//
+// AES-128 CTR Test Vectors defined in "F.5.1 CTR-AES128.Encrypt" of NIST SP 800-38A.
+// The last block is truncated to check a partial block.
+//
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 Aes128CtrData[] = {
+  0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+  0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+  0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+  0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b
+  };
+
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 Aes128CtrKey[] = {
+  0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+  };
+
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 Aes128CtrIvec[] = {
+  0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff
+  };
+
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 Aes128CtrCipher[] = {
+  0x87, 0x4d, 0x61, 0x91, 0xb6, 0x20, 0xe3, 0x26, 0x1b, 0xef, 0x68, 0x64, 0x99, 0x0d, 0xb6, 0xce,
+  0x98, 0x06, 0xf6, 0x6b, 0x79, 0x70, 0xfd, 0xff, 0x86, 0x17, 0x18, 0x7b, 0xb9, 0xff, 0xfd, 0xff,
+  0x5a, 0xe4, 0xdf, 0x3e, 0xdb, 0xd5, 0xd3, 0x5e, 0x5b, 0x4f, 0x09, 0x02, 0x0d, 0xb0, 0x3e, 0xab,
+  0x1e, 0x03, 0x1d, 0xda, 0x2f, 0xbe, 0x03, 0xd1, 0x79, 0x21
+  };
+
+//
+// AES-128 GCM Test Vectors defined in "Test Case 4" of "The Galois/Counter Mode
+// of Operation (GCM)" by D. McGrew and J. Viega.
+//
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 Aes128GcmData[] = {
+  0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5, 0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26, 0x9a,
+  0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda, 0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72,
+  0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53, 0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25,
+  0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57, 0xba, 0x63, 0x7b, 0x39
+  };
+
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 Aes128GcmKey[] = {
+  0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c, 0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08
+  };
+
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 Aes128GcmIv[] = {
+  0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad, 0xde, 0xca, 0xf8, 0x88
+  };
+
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 Aes128GcmAData[] = {
+  0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef, 0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+  0xab, 0xad, 0xda, 0xd2
+  };
+
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 Aes128GcmCipher[] = {
+  0x42, 0x83, 0x1e, 0xc2, 0x21, 0x77, 0x74, 0x24, 0x4b, 0x72, 0x21, 0xb7, 0x84, 0xd0, 0xd4, 0x9c,
+  0xe3, 0xaa, 0x21, 0x2f, 0x2c, 0x02, 0xa4, 0xe0, 0x35, 0xc1, 0x7e, 0x23, 0x29, 0xac, 0xa1, 0x2e,
+  0x21, 0xd5, 0x14, 0xb2, 0x54, 0x66, 0x93, 0x1c, 0x7d, 0x8f, 0x6a, 0x5a, 0xac, 0x84, 0xaa, 0x05,
+  0x1b, 0xa3, 0x0b, 0x39, 0x6a, 0x0a, 0xac, 0x97, 0x3d, 0x58, 0xe0, 0x91
+  };
+
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 Aes128GcmTag[] = {
+  0x5b, 0xc9, 0x4f, 0xbc, 0x32, 0x21, 0xa5, 0xdb, 0x94, 0xfa, 0xe9, 0x5a, 0xe7, 0x12, 0x1a, 0x47
+  };
+
+//
+// Size and number of the buffers processed by MeasureAesThroughput()
+//
+#define AES_THROUGHPUT_DATA_SIZE  SIZE_1MB
+#define AES_THROUGHPUT_LOOPS      16
+
+//
+// AES function measured by MeasureAesThroughput(), with the prototype of
+// AesCbcEncrypt(), AesCbcDecrypt() and AesCtrEncrypt().
+//
+typedef
+BOOLEAN
+(EFIAPI *AES_THROUGHPUT_FUNCTION) (
+  IN   VOID         *AesContext,
+  IN   CONST UINT8  *Input,
+  IN   UINTN        InputSize,
+  IN   CONST UINT8  *Ivec,
+  OUT  UINT8        *Output
+  );
+
+/**
+  Encrypts a data buffer with AES-128-GCM, with the prototype of AesCbcEncrypt()
+  so that MeasureAesThroughput() can measure it.
+
+  @param[in]   AesContext  Unused, the key is the AES-128 GCM test key.
+  @param[in]   Input       Pointer to the buffer containing the data to be encrypted.
+  @param[in]   InputSize   Size of the Input buffer in bytes.
+  @param[in]   Ivec        Pointer to the 12-byte IV value.
+  @param[out]  Output      Pointer to a buffer that receives the encryption output.
+
+  @retval TRUE   AES-GCM encryption succeeded.
+  @retval FALSE  AES-GCM encryption failed.
+
+**/
+BOOLEAN
+EFIAPI
+AesGcmThroughputEncrypt (
+  IN   VOID         *AesContext,
+  IN   CONST UINT8  *Input,
+  IN   UINTN        InputSize,
+  IN   CONST UINT8  *Ivec,
+  OUT  UINT8        *Output
+  )
+{
+  UINT8  Tag[16];
+
+  return AeadAesGcmEncrypt (
+           Aes128GcmKey,
+           sizeof (Aes128GcmKey),
+           Ivec,
+           sizeof (Aes128GcmIv),
+           NULL,
+           0,
+           Input,
+           InputSize,
+           Tag,
+           sizeof (Tag),
+           Output,
+           NULL
+           );
+}
+
+/**
+  Measure the throughput of an AES-128 function.
+
+  The throughput is not printed when the performance counter does not advance,
+  for example with the NULL instance of TimerLib. Comparing the results on a
+  CPU with and without the AES instructions, e.g. QEMU "-cpu host" and
+  "-cpu qemu64", shows the gain of the accelerated AES functions.
+
+  @param[in]  Name      Name of the AES mode to print.
+  @param[in]  Function  The AES function to measure.
+
+**/
+VOID
+MeasureAesThroughput (
+  IN CONST CHAR16             *Name,
+  IN AES_THROUGHPUT_FUNCTION  Function
+  )
+{
+  VOID    *AesCtx;
+  UINT8   *Data;
+  UINTN   Index;
+  UINT64  StartValue;
+  UINT64  EndValue;
+  UINT64  Start;
+  UINT64  End;
+  UINT64  Ticks;
+  UINT64  Nanoseconds;
+
+  AesCtx = AllocatePool (AesGetContextSize ());
+  Data   = AllocateZeroPool (AES_THROUGHPUT_DATA_SIZE);
+  if (AesCtx == NULL || Data == NULL || !AesInit (AesCtx, Aes128CtrKey, 128)) {
+    goto Exit;
+  }
+
+  GetPerformanceCounterProperties (&StartValue, &EndValue);
+
+  Start = GetPerformanceCounter ();
+  for (Index = 0; Index < AES_THROUGHPUT_LOOPS; Index++) {
+    if (!Function (AesCtx, Data, AES_THROUGHPUT_DATA_SIZE, Aes128CtrIvec, Data)) {
+      goto Exit;
+    }
+  }
+  End = GetPerformanceCounter ();
+
+  Ticks       = (StartValue <= EndValue) ? End - Start : Start - End;
+  Nanoseconds = GetTimeInNanoSecond (Ticks);
+  if (Nanoseconds != 0) {
+    Print (
+      L"- %s %ld MB/s\n",
+      Name,
+      DivU64x64Remainder (MultU64x32 (AES_THROUGHPUT_LOOPS, 1000000000), Nanoseconds, NULL) * (AES_THROUGHPUT_DATA_SIZE / SIZE_1MB)
+      );
+  }
+
+Exit:
+  if (Data != NULL) {
+    FreePool (Data);
+  }
+  if (AesCtx != NULL) {
+    FreePool (AesCtx);
+  }
+}
+
 //
 // ARC4 Test Vector defined in "Appendix A.1 Test Vectors from [CRYPTLIB]" of
 // IETF Draft draft-kaukonen-cipher-arcfour-03 ("A Stream Cipher Encryption Algorithm 'Arcfour'").
@@ -147,6 +333,8 @@ ValidateCryptBlockCipher (
   VOID     *CipherCtx;
   UINT8    Encrypt[256];
   UINT8    Decrypt[256];
+  UINT8    Tag[16];
+  UINTN    OutSize;
   BOOLEAN  Status;
 
   Print (L"\nUEFI-OpenSSL Block Cipher Engine Testing: ");
@@ -418,6 +606,125 @@ ValidateCryptBlockCipher (
     return EFI_ABORTED;
   }
 
+  Print (L"CTR-128... ");
+
+  //
+  // AES-128 CTR Validation
+  //
+  ZeroMem (Encrypt, sizeof (Encrypt));
+  ZeroMem (Decrypt, sizeof (Decrypt));
+
+  Status = AesInit (CipherCtx, Aes128CtrKey, 128);
+  if (!Status) {
+    Print (L"[Fail]");
+    return EFI_ABORTED;
+  }
+
+  Status = AesCtrEncrypt (CipherCtx, Aes128CtrData, sizeof (Aes128CtrData), Aes128CtrIvec, Encrypt);
+  if (!Status) {
+    Print (L"[Fail]");
+    return EFI_ABORTED;
+  }
+
+  Status = AesCtrEncrypt (CipherCtx, Encrypt, sizeof (Aes128CtrData), Aes128CtrIvec, Decrypt);
+  if (!Status) {
+    Print (L"[Fail]");
+    return EFI_ABORTED;
+  }
+
+  if (CompareMem (Encrypt, Aes128CtrCipher, sizeof (Aes128CtrCipher)) != 0) {
+    Print (L"[Fail]");
+    return EFI_ABORTED;
+  }
+
+  if (CompareMem (Decrypt, Aes128CtrData, sizeof (Aes128CtrData)) != 0) {
+    Print (L"[Fail]");
+    return EFI_ABORTED;
+  }
+
+  Print (L"[Pass]");
+
+  Print (L"\n- AEAD Validation: ");
+
+  Print (L"GCM-128... ");
+
+  //
+  // AES-128 GCM Validation
+  //
+  ZeroMem (Encrypt, sizeof (Encrypt));
+  ZeroMem (Decrypt, sizeof (Decrypt));
+
+  OutSize = sizeof (Encrypt);
+  Status  = AeadAesGcmEncrypt (
+              Aes128GcmKey,
+              sizeof (Aes128GcmKey),
+              Aes128GcmIv,
+              sizeof (Aes128GcmIv),
+              Aes128GcmAData,
+              sizeof (Aes128GcmAData),
+              Aes128GcmData,
+              sizeof (Aes128GcmData),
+              Tag,
+              sizeof (Tag),
+              Encrypt,
+              &OutSize
+              );
+  if (!Status || OutSize != sizeof (Aes128GcmData)) {
+    Print (L"[Fail]");
+    return EFI_ABORTED;
+  }
+
+  if (CompareMem (Encrypt, Aes128GcmCipher, sizeof (Aes128GcmCipher)) != 0 ||
+      CompareMem (Tag, Aes128GcmTag, sizeof (Aes128GcmTag)) != 0) {
+    Print (L"[Fail]");
+    return EFI_ABORTED;
+  }
+
+  OutSize = sizeof (Decrypt);
+  Status  = AeadAesGcmDecrypt (
+              Aes128GcmKey,
+              sizeof (Aes128GcmKey),
+              Aes128GcmIv,
+              sizeof (Aes128GcmIv),
+              Aes128GcmAData,
+              sizeof (Aes128GcmAData),
+              Aes128GcmCipher,
+              sizeof (Aes128GcmCipher),
+              Aes128GcmTag,
+              sizeof (Aes128GcmTag),
+              Decrypt,
+              &OutSize
+              );
+  if (!Status || OutSize != sizeof (Aes128GcmData) ||
+      CompareMem (Decrypt, Aes128GcmData, sizeof (Aes128GcmData)) != 0) {
+    Print (L"[Fail]");
+    return EFI_ABORTED;
+  }
+
+  //
+  // A modified tag must be rejected.
+  //
+  CopyMem (Tag, Aes128GcmTag, sizeof (Tag));
+  Tag[0] ^= 1;
+  Status = AeadAesGcmDecrypt (
+             Aes128GcmKey,
+             sizeof (Aes128GcmKey),
+             Aes128GcmIv,
+             sizeof (Aes128GcmIv),
+             Aes128GcmAData,
+             sizeof (Aes128GcmAData),
+             Aes128GcmCipher,
+             sizeof (Aes128GcmCipher),
+             Tag,
+             sizeof (Tag),
+             Decrypt,
+             NULL
+             );
+  if (Status) {
+    Print (L"[Fail]");
+    return EFI_ABORTED;
+  }
+
   Print (L"[Pass]");
 
   Print (L"\n- ARC4 Validation: ");
@@ -469,5 +776,11 @@ ValidateCryptBlockCipher (
 
   Print (L"\n");
 
+  Print (L"\n UEFI-OpenSSL AES Throughput:\n");
+  MeasureAesThroughput (L"AES-128-CBC Encrypt", AesCbcEncrypt);
+  MeasureAesThroughput (L"AES-128-CBC Decrypt", AesCbcDecrypt);
+  MeasureAesThroughput (L"AES-128-CTR", AesCtrEncrypt);
+  MeasureAesThroughput (L"AES-128-GCM Encrypt", AesGcmThroughputEncrypt);
+
   return EFI_SUCCESS;
 }
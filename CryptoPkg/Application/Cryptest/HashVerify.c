@@ -1,7 +1,7 @@
 /** @file
   Application for Hash Primitives Validation.
 
-Copyright (c) 2010 - 2016, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2010 - 2017, Intel Corporation. All rights reserved.<BR>
 This program and the accompanying materials
 are licensed and made available under the terms and conditions of the BSD License
 which accompanies this distribution.  The full text of the license may be found at
@@ -73,6 +73,284 @@ GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 Sha512Digest[SHA512_DIGEST_SIZE] = {
   0x45, 0x4d, 0x44, 0x23, 0x64, 0x3c, 0xe8, 0x0e, 0x2a, 0x9a, 0xc9, 0x4f, 0xa5, 0x4c, 0xa4, 0x9f
   };
 
+//
+// Two-block messages for digest validation. The 448-bit message is used for
+// SHA-1 and SHA-256, the 896-bit message for SHA-384 and SHA-512.
+//
+GLOBAL_REMOVE_IF_UNREFERENCED CONST CHAR8 *HashData448 = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+GLOBAL_REMOVE_IF_UNREFERENCED CONST CHAR8 *HashData896 = "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu";
+
+//
+// Size of the message of one million 'a' for digest validation
+//
+#define MILLION_A_SIZE         1000000
+
+//
+// Size of the buffer digested by the throughput measurement, and number of times
+// it is digested.
+//
+#define THROUGHPUT_DATA_SIZE   SIZE_1MB
+#define THROUGHPUT_LOOPS       16
+
+//
+// Result for SHA-1 of the 448-bit message. (From the NIST examples of FIPS 180-2)
+//
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 Sha1LongDigest[SHA1_DIGEST_SIZE] = {
+  0x84, 0x98, 0x3e, 0x44, 0x1c, 0x3b, 0xd2, 0x6e, 0xba, 0xae, 0x4a, 0xa1, 0xf9, 0x51, 0x29, 0xe5,
+  0xe5, 0x46, 0x70, 0xf1
+  };
+
+//
+// Result for SHA-1 of one million 'a'. (From the NIST examples of FIPS 180-2)
+//
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 Sha1MillionDigest[SHA1_DIGEST_SIZE] = {
+  0x34, 0xaa, 0x97, 0x3c, 0xd4, 0xc4, 0xda, 0xa4, 0xf6, 0x1e, 0xeb, 0x2b, 0xdb, 0xad, 0x27, 0x31,
+  0x65, 0x34, 0x01, 0x6f
+  };
+
+//
+// Result for SHA-256 of the 448-bit message. (From the NIST examples of FIPS 180-2)
+//
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 Sha256LongDigest[SHA256_DIGEST_SIZE] = {
+  0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8, 0xe5, 0xc0, 0x26, 0x93, 0x0c, 0x3e, 0x60, 0x39,
+  0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67, 0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1
+  };
+
+//
+// Result for SHA-256 of one million 'a'. (From the NIST examples of FIPS 180-2)
+//
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 Sha256MillionDigest[SHA256_DIGEST_SIZE] = {
+  0xcd, 0xc7, 0x6e, 0x5c, 0x99, 0x14, 0xfb, 0x92, 0x81, 0xa1, 0xc7, 0xe2, 0x84, 0xd7, 0x3e, 0x67,
+  0xf1, 0x80, 0x9a, 0x48, 0xa4, 0x97, 0x20, 0x0e, 0x04, 0x6d, 0x39, 0xcc, 0xc7, 0x11, 0x2c, 0xd0
+  };
+
+//
+// Result for SHA-384 of the 896-bit message. (From the NIST examples of FIPS 180-2)
+//
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 Sha384LongDigest[SHA384_DIGEST_SIZE] = {
+  0x09, 0x33, 0x0c, 0x33, 0xf7, 0x11, 0x47, 0xe8, 0x3d, 0x19, 0x2f, 0xc7, 0x82, 0xcd, 0x1b, 0x47,
+  0x53, 0x11, 0x1b, 0x17, 0x3b, 0x3b, 0x05, 0xd2, 0x2f, 0xa0, 0x80, 0x86, 0xe3, 0xb0, 0xf7, 0x12,
+  0xfc, 0xc7, 0xc7, 0x1a, 0x55, 0x7e, 0x2d, 0xb9, 0x66, 0xc3, 0xe9, 0xfa, 0x91, 0x74, 0x60, 0x39
+  };
+
+//
+// Result for SHA-384 of one million 'a'. (From the NIST examples of FIPS 180-2)
+//
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 Sha384MillionDigest[SHA384_DIGEST_SIZE] = {
+  0x9d, 0x0e, 0x18, 0x09, 0x71, 0x64, 0x74, 0xcb, 0x08, 0x6e, 0x83, 0x4e, 0x31, 0x0a, 0x4a, 0x1c,
+  0xed, 0x14, 0x9e, 0x9c, 0x00, 0xf2, 0x48, 0x52, 0x79, 0x72, 0xce, 0xc5, 0x70, 0x4c, 0x2a, 0x5b,
+  0x07, 0xb8, 0xb3, 0xdc, 0x38, 0xec, 0xc4, 0xeb, 0xae, 0x97, 0xdd, 0xd8, 0x7f, 0x3d, 0x89, 0x85
+  };
+
+//
+// Result for SHA-512 of the 896-bit message. (From the NIST examples of FIPS 180-2)
+//
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 Sha512LongDigest[SHA512_DIGEST_SIZE] = {
+  0x8e, 0x95, 0x9b, 0x75, 0xda, 0xe3, 0x13, 0xda, 0x8c, 0xf4, 0xf7, 0x28, 0x14, 0xfc, 0x14, 0x3f,
+  0x8f, 0x77, 0x79, 0xc6, 0xeb, 0x9f, 0x7f, 0xa1, 0x72, 0x99, 0xae, 0xad, 0xb6, 0x88, 0x90, 0x18,
+  0x50, 0x1d, 0x28, 0x9e, 0x49, 0x00, 0xf7, 0xe4, 0x33, 0x1b, 0x99, 0xde, 0xc4, 0xb5, 0x43, 0x3a,
+  0xc7, 0xd3, 0x29, 0xee, 0xb6, 0xdd, 0x26, 0x54, 0x5e, 0x96, 0xe5, 0x5b, 0x87, 0x4b, 0xe9, 0x09
+  };
+
+//
+// Result for SHA-512 of one million 'a'. (From the NIST examples of FIPS 180-2)
+//
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8 Sha512MillionDigest[SHA512_DIGEST_SIZE] = {
+  0xe7, 0x18, 0x48, 0x3d, 0x0c, 0xe7, 0x69, 0x64, 0x4e, 0x2e, 0x42, 0xc7, 0xbc, 0x15, 0xb4, 0x63,
+  0x8e, 0x1f, 0x98, 0xb1, 0x3b, 0x20, 0x44, 0x28, 0x56, 0x32, 0xa8, 0x03, 0xaf, 0xa9, 0x73, 0xeb,
+  0xde, 0x0f, 0xf2, 0x44, 0x87, 0x7e, 0xa6, 0x0a, 0x4c, 0xb0, 0x43, 0x2c, 0xe5, 0x77, 0xc3, 0x1b,
+  0xeb, 0x00, 0x9c, 0x5c, 0x2c, 0x49, 0xaa, 0x2e, 0x4e, 0xad, 0xb2, 0x17, 0xad, 0x8c, 0xc0, 0x9b
+  };
+
+//
+// Chunk sizes the one million 'a' are digested with, to exercise partial and
+// whole blocks on each side of the block boundaries.
+//
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINTN MillionAChunkSizes[] = {
+  1, 55, 64, 65, 127, 128, 129, 1000, 4095
+  };
+
+typedef
+UINTN
+(EFIAPI *HASH_GET_CONTEXT_SIZE) (
+  VOID
+  );
+
+typedef
+BOOLEAN
+(EFIAPI *HASH_INIT) (
+  OUT  VOID  *HashContext
+  );
+
+typedef
+BOOLEAN
+(EFIAPI *HASH_UPDATE) (
+  IN OUT  VOID        *HashContext,
+  IN      CONST VOID  *Data,
+  IN      UINTN       DataSize
+  );
+
+typedef
+BOOLEAN
+(EFIAPI *HASH_FINAL) (
+  IN OUT  VOID   *HashContext,
+  OUT     UINT8  *HashValue
+  );
+
+typedef
+BOOLEAN
+(EFIAPI *HASH_ALL) (
+  IN   CONST VOID  *Data,
+  IN   UINTN       DataSize,
+  OUT  UINT8       *HashValue
+  );
+
+typedef struct {
+  CHAR16                 *Name;
+  UINTN                  DigestSize;
+  HASH_GET_CONTEXT_SIZE  GetContextSize;
+  HASH_INIT              Init;
+  HASH_UPDATE            Update;
+  HASH_FINAL             Final;
+  HASH_ALL               HashAll;
+  CONST CHAR8            **LongData;
+  CONST UINT8            *LongDigest;
+  CONST UINT8            *MillionDigest;
+} MULTI_BLOCK_HASH_TEST;
+
+GLOBAL_REMOVE_IF_UNREFERENCED MULTI_BLOCK_HASH_TEST mMultiBlockHashTests[] = {
+  { L"SHA1:  ", SHA1_DIGEST_SIZE,   Sha1GetContextSize,   Sha1Init,   Sha1Update,   Sha1Final,   Sha1HashAll,   &HashData448, Sha1LongDigest,   Sha1MillionDigest   },
+  { L"SHA256:", SHA256_DIGEST_SIZE, Sha256GetContextSize, Sha256Init, Sha256Update, Sha256Final, Sha256HashAll, &HashData448, Sha256LongDigest, Sha256MillionDigest },
+  { L"SHA384:", SHA384_DIGEST_SIZE, Sha384GetContextSize, Sha384Init, Sha384Update, Sha384Final, Sha384HashAll, &HashData896, Sha384LongDigest, Sha384MillionDigest },
+  { L"SHA512:", SHA512_DIGEST_SIZE, Sha512GetContextSize, Sha512Init, Sha512Update, Sha512Final, Sha512HashAll, &HashData896, Sha512LongDigest, Sha512MillionDigest }
+};
+
+/**
+  Validate the UEFI-OpenSSL Digest Interfaces on multi-block messages.
+
+  The two-block messages are digested at once, and one million 'a' are digested
+  in chunks of varying sizes, so that the whole blocks are digested both by the
+  block functions and from partial blocks.
+
+  @param[in]  Test  The digest functions and the expected results.
+
+  @retval  EFI_SUCCESS  Validation succeeded.
+  @retval  EFI_ABORTED  Validation failed.
+
+**/
+EFI_STATUS
+ValidateCryptDigestMultiBlock (
+  IN MULTI_BLOCK_HASH_TEST  *Test
+  )
+{
+  VOID     *HashCtx;
+  UINT8    *Data;
+  UINTN    DataSize;
+  UINTN    ChunkSize;
+  UINTN    Index;
+  UINT8    Digest[MAX_DIGEST_SIZE];
+  BOOLEAN  Status;
+
+  Print (L"Long Message... ");
+  ZeroMem (Digest, MAX_DIGEST_SIZE);
+  Status = Test->HashAll (*Test->LongData, AsciiStrLen (*Test->LongData), Digest);
+  if (!Status || CompareMem (Digest, Test->LongDigest, Test->DigestSize) != 0) {
+    Print (L"[Fail]");
+    return EFI_ABORTED;
+  }
+
+  Print (L"Million a... ");
+  HashCtx = AllocatePool (Test->GetContextSize ());
+  Data    = AllocatePool (MillionAChunkSizes[ARRAY_SIZE (MillionAChunkSizes) - 1]);
+  if (HashCtx == NULL || Data == NULL) {
+    Print (L"[Fail]");
+    return EFI_ABORTED;
+  }
+  SetMem (Data, MillionAChunkSizes[ARRAY_SIZE (MillionAChunkSizes) - 1], 'a');
+
+  ZeroMem (Digest, MAX_DIGEST_SIZE);
+  Status = Test->Init (HashCtx);
+  for (DataSize = 0, Index = 0; Status && DataSize < MILLION_A_SIZE; DataSize += ChunkSize, Index++) {
+    ChunkSize = MIN (MillionAChunkSizes[Index % ARRAY_SIZE (MillionAChunkSizes)], MILLION_A_SIZE - DataSize);
+    Status    = Test->Update (HashCtx, Data, ChunkSize);
+  }
+  if (Status) {
+    Status = Test->Final (HashCtx, Digest);
+  }
+
+  FreePool (Data);
+  FreePool (HashCtx);
+
+  if (!Status || CompareMem (Digest, Test->MillionDigest, Test->DigestSize) != 0) {
+    Print (L"[Fail]");
+    return EFI_ABORTED;
+  }
+
+  Print (L"[Pass]\n");
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Measure the throughput of the UEFI-OpenSSL Digest Interfaces.
+
+  The throughput is not printed when the performance counter does not advance,
+  for example with the NULL instance of TimerLib.
+
+  @param[in]  Test  The digest functions to measure.
+
+**/
+VOID
+MeasureCryptDigestThroughput (
+  IN MULTI_BLOCK_HASH_TEST  *Test
+  )
+{
+  VOID    *HashCtx;
+  UINT8   *Data;
+  UINT8   Digest[MAX_DIGEST_SIZE];
+  UINTN   Index;
+  UINT64  StartValue;
+  UINT64  EndValue;
+  UINT64  Start;
+  UINT64  End;
+  UINT64  Ticks;
+  UINT64  Nanoseconds;
+
+  HashCtx = AllocatePool (Test->GetContextSize ());
+  Data    = AllocateZeroPool (THROUGHPUT_DATA_SIZE);
+  if (HashCtx == NULL || Data == NULL) {
+    goto Exit;
+  }
+
+  GetPerformanceCounterProperties (&StartValue, &EndValue);
+
+  Start = GetPerformanceCounter ();
+  Test->Init (HashCtx);
+  for (Index = 0; Index < THROUGHPUT_LOOPS; Index++) {
+    Test->Update (HashCtx, Data, THROUGHPUT_DATA_SIZE);
+  }
+  Test->Final (HashCtx, Digest);
+  End = GetPerformanceCounter ();
+
+  Ticks       = (StartValue <= EndValue) ? End - Start : Start - End;
+  Nanoseconds = GetTimeInNanoSecond (Ticks);
+  if (Nanoseconds != 0) {
+    Print (
+      L"- %s %ld MB/s\n",
+      Test->Name,
+      DivU64x64Remainder (MultU64x32 (THROUGHPUT_LOOPS, 1000000000), Nanoseconds, NULL) * (THROUGHPUT_DATA_SIZE / SIZE_1MB)
+      );
+  }
+
+Exit:
+  if (Data != NULL) {
+    FreePool (Data);
+  }
+  if (HashCtx != NULL) {
+    FreePool (HashCtx);
+  }
+}
+
 /**
   Validate UEFI-OpenSSL Digest Interfaces.
 
@@ -90,6 +368,7 @@ ValidateCryptDigest (
   UINTN    DataSize;
   UINT8    Digest[MAX_DIGEST_SIZE];
   BOOLEAN  Status;
+  UINTN    Index;
 
   Print (L" UEFI-OpenSSL Hash Engine Testing:\n");
   DataSize = AsciiStrLen (HashData);
@@ -406,5 +685,18 @@ ValidateCryptDigest (
 
   Print (L"[Pass]\n");
 
+  Print (L"\n UEFI-OpenSSL Hash Engine Multi-Block Testing:\n");
+  for (Index = 0; Index < ARRAY_SIZE (mMultiBlockHashTests); Index++) {
+    Print (L"- %s ", mMultiBlockHashTests[Index].Name);
+    if (EFI_ERROR (ValidateCryptDigestMultiBlock (&mMultiBlockHashTests[Index]))) {
+      return EFI_ABORTED;
+    }
+  }
+
+  Print (L"\n UEFI-OpenSSL Hash Engine Throughput:\n");
+  for (Index = 0; Index < ARRAY_SIZE (mMultiBlockHashTests); Index++) {
+    MeasureCryptDigestThroughput (&mMultiBlockHashTests[Index]);
+  }
+
   return EFI_SUCCESS;
 }
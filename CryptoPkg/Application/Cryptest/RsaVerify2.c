@@ -1,7 +1,7 @@
 /** @file  
   Application for RSA Key Retrieving (from PEM and X509) & Signature Validation.
 
-Copyright (c) 2010 - 2011, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2010 - 2017, Intel Corporation. All rights reserved.<BR>
 This program and the accompanying materials
 are licensed and made available under the terms and conditions of the BSD License
 which accompanies this distribution.  The full text of the license may be found at
@@ -309,6 +309,73 @@ ValidateCryptRsa2 (
   return EFI_SUCCESS;
 }
 
+//
+// Number of verifications timed by MeasurePkcs7VerifyTime()
+//
+#define PKCS7_VERIFY_LOOPS  100
+
+/**
+  Measure the average time of repeated verifications of a PKCS#7 signedData,
+  with Pkcs7Verify() or with a PKCS#7 verification context.
+
+  @param[in]  P7SignedData      Pointer to the PKCS#7 signedData.
+  @param[in]  P7SignedDataSize  Size of the PKCS#7 signedData in bytes.
+  @param[in]  VerifyContext     PKCS#7 verification context, or NULL to verify
+                                with Pkcs7Verify() and TestCACert.
+
+**/
+VOID
+MeasurePkcs7VerifyTime (
+  IN CONST UINT8  *P7SignedData,
+  IN UINTN        P7SignedDataSize,
+  IN VOID         *VerifyContext  OPTIONAL
+  )
+{
+  UINTN   Index;
+  UINT64  StartValue;
+  UINT64  EndValue;
+  UINT64  Start;
+  UINT64  End;
+  UINT64  Ticks;
+  UINT64  Nanoseconds;
+
+  GetPerformanceCounterProperties (&StartValue, &EndValue);
+
+  Start = GetPerformanceCounter ();
+  for (Index = 0; Index < PKCS7_VERIFY_LOOPS; Index++) {
+    if (VerifyContext == NULL) {
+      Pkcs7Verify (
+        P7SignedData,
+        P7SignedDataSize,
+        TestCACert,
+        sizeof (TestCACert),
+        (UINT8 *) Payload,
+        AsciiStrLen (Payload)
+        );
+    } else {
+      Pkcs7VerifyWithContext (
+        VerifyContext,
+        P7SignedData,
+        P7SignedDataSize,
+        (UINT8 *) Payload,
+        AsciiStrLen (Payload),
+        NULL
+        );
+    }
+  }
+  End = GetPerformanceCounter ();
+
+  Ticks       = (StartValue <= EndValue) ? End - Start : Start - End;
+  Nanoseconds = GetTimeInNanoSecond (Ticks);
+  if (Nanoseconds != 0) {
+    Print (
+      L"\n- %a %ld us per verification",
+      (VerifyContext == NULL) ? "Pkcs7Verify" : "Pkcs7VerifyWithContext",
+      DivU64x32 (Nanoseconds, PKCS7_VERIFY_LOOPS * 1000)
+      );
+  }
+}
+
 /**
   Validate UEFI-OpenSSL PKCS#7 Signing & Verification Interfaces.
 
@@ -325,9 +392,12 @@ ValidateCryptPkcs7 (
   UINT8    *P7SignedData;
   UINTN    P7SignedDataSize;
   UINT8    *SignCert;
+  VOID     *VerifyContext;
+  UINTN    CertIndex;
 
-  P7SignedData = NULL;
-  SignCert     = NULL;
+  P7SignedData  = NULL;
+  SignCert      = NULL;
+  VerifyContext = NULL;
 
   Print (L"\nUEFI-OpenSSL PKCS#7 Signing & Verification Testing: ");
 
@@ -382,7 +452,41 @@ ValidateCryptPkcs7 (
     Print (L"[Pass]");
   }
 
+  Print (L"\n- Verify PKCS#7 signedData with context ...");
+
+  //
+  // The trusted certificate is parsed once, when it is added to the context.
+  //
+  VerifyContext = Pkcs7VerifyContextNew ();
+  if (VerifyContext == NULL ||
+      !Pkcs7VerifyContextAddCert (VerifyContext, TestCACert, sizeof (TestCACert))) {
+    Print (L"[Fail]");
+    goto _Exit;
+  }
+
+  CertIndex = MAX_UINTN;
+  Status = Pkcs7VerifyWithContext (
+             VerifyContext,
+             P7SignedData,
+             P7SignedDataSize,
+             (UINT8 *) Payload,
+             AsciiStrLen (Payload),
+             &CertIndex
+             );
+  if (!Status || CertIndex != 0) {
+    Print (L"[Fail]");
+    goto _Exit;
+  } else {
+    Print (L"[Pass]");
+  }
+
+  MeasurePkcs7VerifyTime (P7SignedData, P7SignedDataSize, NULL);
+  MeasurePkcs7VerifyTime (P7SignedData, P7SignedDataSize, VerifyContext);
+
 _Exit:
+  if (VerifyContext != NULL) {
+    Pkcs7VerifyContextFree (VerifyContext);
+  }
   if (P7SignedData != NULL) {
     FreePool (P7SignedData);
   }
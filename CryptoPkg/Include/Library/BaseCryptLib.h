@@ -1733,6 +1733,48 @@ AesCbcDecrypt (
   OUT  UINT8        *Output
   );
 
+/**
+  Performs AES encryption or decryption on a data buffer of the specified size
+  in CTR mode.
+
+  This function performs AES encryption on data buffer pointed by Input, of specified
+  size of InputSize, in CTR mode. As CTR mode XORs the data with a key stream,
+  the same function decrypts data encrypted in CTR mode.
+  InputSize may be of any size. The counter block is incremented as a 128-bit
+  big endian integer for each 16-byte block.
+  Initialization vector should be one block size (16 bytes), the counter block
+  of the first block.
+  AesContext should be already correctly initialized by AesInit(). Behavior with
+  invalid AES context is undefined.
+
+  If AesContext is NULL, then return FALSE.
+  If Input is NULL, then return FALSE.
+  If Ivec is NULL, then return FALSE.
+  If Output is NULL, then return FALSE.
+  If this interface is not supported, then return FALSE.
+
+  @param[in]   AesContext  Pointer to the AES context.
+  @param[in]   Input       Pointer to the buffer containing the data to be encrypted
+                           or decrypted.
+  @param[in]   InputSize   Size of the Input buffer in bytes.
+  @param[in]   Ivec        Pointer to initialization vector.
+  @param[out]  Output      Pointer to a buffer that receives the AES CTR output.
+
+  @retval TRUE   AES CTR encryption succeeded.
+  @retval FALSE  AES CTR encryption failed.
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+AesCtrEncrypt (
+  IN   VOID         *AesContext,
+  IN   CONST UINT8  *Input,
+  IN   UINTN        InputSize,
+  IN   CONST UINT8  *Ivec,
+  OUT  UINT8        *Output
+  );
+
 /**
   Retrieves the size, in bytes, of the context buffer required for ARC4 operations.
 
@@ -1865,6 +1907,98 @@ Arc4Reset (
   IN OUT  VOID  *Arc4Context
   );
 
+//=====================================================================================
+//    Authenticated Encryption with Associated Data (AEAD) Cryptography Primitive
+//=====================================================================================
+
+/**
+  Performs AEAD AES-GCM authenticated encryption on a data buffer and additional authenticated data (AAD).
+
+  IvSize must be 12, otherwise FALSE is returned.
+  KeySize must be 16, 24 or 32, otherwise FALSE is returned.
+  TagSize must be 12, 13, 14, 15, 16, otherwise FALSE is returned.
+  If DataOutSize is not NULL and is smaller than DataInSize, FALSE is returned.
+  If this interface is not supported, then return FALSE.
+
+  @param[in]   Key         Pointer to the encryption key.
+  @param[in]   KeySize     Size of the encryption key in bytes.
+  @param[in]   Iv          Pointer to the IV value.
+  @param[in]   IvSize      Size of the IV value in bytes.
+  @param[in]   AData       Pointer to the additional authenticated data (AAD).
+  @param[in]   ADataSize   Size of the additional authenticated data (AAD) in bytes.
+  @param[in]   DataIn      Pointer to the input data buffer to be encrypted.
+  @param[in]   DataInSize  Size of the input data buffer in bytes.
+  @param[out]  TagOut      Pointer to a buffer that receives the authentication tag output.
+  @param[in]   TagSize     Size of the authentication tag in bytes.
+  @param[out]  DataOut     Pointer to a buffer that receives the encryption output.
+  @param[out]  DataOutSize Size of the output data buffer in bytes.
+
+  @retval TRUE   AEAD AES-GCM authenticated encryption succeeded.
+  @retval FALSE  AEAD AES-GCM authenticated encryption failed.
+
+**/
+BOOLEAN
+EFIAPI
+AeadAesGcmEncrypt (
+  IN   CONST UINT8  *Key,
+  IN   UINTN        KeySize,
+  IN   CONST UINT8  *Iv,
+  IN   UINTN        IvSize,
+  IN   CONST UINT8  *AData,
+  IN   UINTN        ADataSize,
+  IN   CONST UINT8  *DataIn,
+  IN   UINTN        DataInSize,
+  OUT  UINT8        *TagOut,
+  IN   UINTN        TagSize,
+  OUT  UINT8        *DataOut,
+  OUT  UINTN        *DataOutSize
+  );
+
+/**
+  Performs AEAD AES-GCM authenticated decryption on a data buffer and additional authenticated data (AAD).
+
+  IvSize must be 12, otherwise FALSE is returned.
+  KeySize must be 16, 24 or 32, otherwise FALSE is returned.
+  TagSize must be 12, 13, 14, 15, 16, otherwise FALSE is returned.
+  If DataOutSize is not NULL and is smaller than DataInSize, FALSE is returned.
+  If the authentication tag does not match, FALSE is returned and DataOut does
+  not hold any plaintext.
+  If this interface is not supported, then return FALSE.
+
+  @param[in]   Key         Pointer to the encryption key.
+  @param[in]   KeySize     Size of the encryption key in bytes.
+  @param[in]   Iv          Pointer to the IV value.
+  @param[in]   IvSize      Size of the IV value in bytes.
+  @param[in]   AData       Pointer to the additional authenticated data (AAD).
+  @param[in]   ADataSize   Size of the additional authenticated data (AAD) in bytes.
+  @param[in]   DataIn      Pointer to the input data buffer to be decrypted.
+  @param[in]   DataInSize  Size of the input data buffer in bytes.
+  @param[in]   Tag         Pointer to a buffer that contains the authentication tag.
+  @param[in]   TagSize     Size of the authentication tag in bytes.
+  @param[out]  DataOut     Pointer to a buffer that receives the decryption output.
+  @param[out]  DataOutSize Size of the output data buffer in bytes.
+
+  @retval TRUE   AEAD AES-GCM authenticated decryption succeeded.
+  @retval FALSE  AEAD AES-GCM authenticated decryption failed.
+
+**/
+BOOLEAN
+EFIAPI
+AeadAesGcmDecrypt (
+  IN   CONST UINT8  *Key,
+  IN   UINTN        KeySize,
+  IN   CONST UINT8  *Iv,
+  IN   UINTN        IvSize,
+  IN   CONST UINT8  *AData,
+  IN   UINTN        ADataSize,
+  IN   CONST UINT8  *DataIn,
+  IN   UINTN        DataInSize,
+  IN   CONST UINT8  *Tag,
+  IN   UINTN        TagSize,
+  OUT  UINT8        *DataOut,
+  OUT  UINTN        *DataOutSize
+  );
+
 //=====================================================================================
 //    Asymmetric Cryptography Primitive
 //=====================================================================================
@@ -2492,6 +2626,101 @@ Pkcs7Verify (
   IN  UINTN        DataLength
   );
 
+/**
+  Allocates and initializes a PKCS#7 verification context, which holds trusted
+  certificates parsed once for many Pkcs7VerifyWithContext() and
+  AuthenticodeVerifyWithContext() calls.
+
+  If this interface is not supported, then return NULL.
+
+  @return  Pointer to the PKCS#7 verification context that has been initialized.
+           If the allocations fails, Pkcs7VerifyContextNew() returns NULL.
+  @retval  NULL  This interface is not supported.
+
+**/
+VOID *
+EFIAPI
+Pkcs7VerifyContextNew (
+  VOID
+  );
+
+/**
+  Release the specified PKCS#7 verification context.
+
+  If the interface is not supported, then ASSERT().
+
+  @param[in]  Pkcs7VerifyContext  Pointer to the PKCS#7 verification context to be released.
+
+**/
+VOID
+EFIAPI
+Pkcs7VerifyContextFree (
+  IN  VOID         *Pkcs7VerifyContext
+  );
+
+/**
+  Adds a trusted certificate to a PKCS#7 verification context. The certificates
+  are numbered from 0 in the order they are added.
+
+  If Pkcs7VerifyContext or TrustedCert is NULL, then return FALSE.
+  If CertLength overflow, then return FALSE.
+  If this interface is not supported, then return FALSE.
+
+  @param[in, out]  Pkcs7VerifyContext  Pointer to the PKCS#7 verification context.
+  @param[in]       TrustedCert         Pointer to a trusted/root certificate encoded in
+                                       DER, which is used for certificate chain verification.
+  @param[in]       CertLength          Length of the trusted certificate in bytes.
+
+  @retval  TRUE   The certificate is added to the context.
+  @retval  FALSE  The certificate is not correctly formatted, or there is not enough memory.
+  @retval  FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+Pkcs7VerifyContextAddCert (
+  IN OUT  VOID         *Pkcs7VerifyContext,
+  IN      CONST UINT8  *TrustedCert,
+  IN      UINTN        CertLength
+  );
+
+/**
+  Verifies the validity of a PKCS#7 signed data as described in "PKCS #7:
+  Cryptographic Message Syntax Standard" with the trusted certificates of a
+  PKCS#7 verification context. The input signed data could be wrapped in a
+  ContentInfo structure.
+
+  The result is the same as calling Pkcs7Verify() with each trusted certificate
+  of the context in turn, but the signed data is parsed only once.
+
+  If Pkcs7VerifyContext, P7Data or InData is NULL, then return FALSE.
+  If P7Length or DataLength overflow, then return FALSE.
+  If this interface is not supported, then return FALSE.
+
+  @param[in]   Pkcs7VerifyContext  Pointer to the PKCS#7 verification context.
+  @param[in]   P7Data              Pointer to the PKCS#7 message to verify.
+  @param[in]   P7Length            Length of the PKCS#7 message in bytes.
+  @param[in]   InData              Pointer to the content to be verified.
+  @param[in]   DataLength          Length of InData in bytes.
+  @param[out]  CertIndex           Number of the first trusted certificate which
+                                   verifies the signed data. It is optional.
+
+  @retval  TRUE  The specified PKCS#7 signed data is valid.
+  @retval  FALSE Invalid PKCS#7 signed data.
+  @retval  FALSE This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+Pkcs7VerifyWithContext (
+  IN  VOID         *Pkcs7VerifyContext,
+  IN  CONST UINT8  *P7Data,
+  IN  UINTN        P7Length,
+  IN  CONST UINT8  *InData,
+  IN  UINTN        DataLength,
+  OUT UINTN        *CertIndex  OPTIONAL
+  );
+
 /**
   Extracts the attached content from a PKCS#7 signed data if existed. The input signed
   data could be wrapped in a ContentInfo structure.
@@ -2556,6 +2785,44 @@ AuthenticodeVerify (
   IN  UINTN        HashSize
   );
 
+/**
+  Verifies the validity of a PE/COFF Authenticode Signature as described in "Windows
+  Authenticode Portable Executable Signature Format" with the trusted certificates
+  of a PKCS#7 verification context.
+
+  The result is the same as calling AuthenticodeVerify() with each trusted
+  certificate of the context in turn, but the signature is parsed only once.
+
+  If Pkcs7VerifyContext, AuthData or ImageHash is NULL, then return FALSE.
+  If this interface is not supported, then return FALSE.
+
+  @param[in]   Pkcs7VerifyContext  Pointer to the PKCS#7 verification context.
+  @param[in]   AuthData            Pointer to the Authenticode Signature retrieved from signed
+                                   PE/COFF image to be verified.
+  @param[in]   DataSize            Size of the Authenticode Signature in bytes.
+  @param[in]   ImageHash           Pointer to the original image file hash value. The procedure
+                                   for calculating the image hash value is described in Authenticode
+                                   specification.
+  @param[in]   HashSize            Size of Image hash value in bytes.
+  @param[out]  CertIndex           Number of the first trusted certificate which
+                                   verifies the signature. It is optional.
+
+  @retval  TRUE   The specified Authenticode Signature is valid.
+  @retval  FALSE  Invalid Authenticode Signature.
+  @retval  FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+AuthenticodeVerifyWithContext (
+  IN  VOID         *Pkcs7VerifyContext,
+  IN  CONST UINT8  *AuthData,
+  IN  UINTN        DataSize,
+  IN  CONST UINT8  *ImageHash,
+  IN  UINTN        HashSize,
+  OUT UINTN        *CertIndex  OPTIONAL
+  );
+
 /**
   Verifies the validity of a RFC3161 Timestamp CounterSignature embedded in PE/COFF Authenticode
   signature.
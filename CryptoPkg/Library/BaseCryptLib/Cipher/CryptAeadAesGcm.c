@@ -0,0 +1,460 @@
+/** @file
+  AEAD (AES-GCM) Wrapper Implementation over OpenSSL.
+
+  The AES-CTR and GHASH parts of AES-GCM run on the accelerated AES and GHASH
+  functions when the CPU supports them, and on the OpenSSL GCM128 functions
+  otherwise.
+
+Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+This program and the accompanying materials
+are licensed and made available under the terms and conditions of the BSD License
+which accompanies this distribution.  The full text of the license may be found at
+http://opensource.org/licenses/bsd-license.php
+
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "InternalCryptLib.h"
+#include <openssl/aes.h>
+#include <openssl/modes.h>
+
+#define AES_GCM_IV_SIZE       12
+#define AES_GCM_MIN_TAG_SIZE  12
+#define AES_GCM_MAX_TAG_SIZE  16
+
+//
+// Number of bytes encrypted before they are digested, so that GHASH reads the
+// ciphertext while it is still in the cache. It is a multiple of the block size.
+//
+#define AES_GCM_CHUNK_SIZE    SIZE_4KB
+
+/**
+  Checks the parameters common to AES-GCM encryption and decryption, and
+  initializes the OpenSSL encryption key schedule.
+
+  @param[in]   Key          Pointer to the encryption key.
+  @param[in]   KeySize      Size of the encryption key in bytes.
+  @param[in]   Iv           Pointer to the IV value.
+  @param[in]   IvSize       Size of the IV value in bytes.
+  @param[in]   AData        Pointer to the additional authenticated data (AAD).
+  @param[in]   ADataSize    Size of the additional authenticated data (AAD) in bytes.
+  @param[in]   DataIn       Pointer to the input data buffer.
+  @param[in]   DataInSize   Size of the input data buffer in bytes.
+  @param[in]   Tag          Pointer to the authentication tag buffer.
+  @param[in]   TagSize      Size of the authentication tag in bytes.
+  @param[in]   DataOut      Pointer to the output data buffer.
+  @param[in]   DataOutSize  Size of the output data buffer in bytes.
+  @param[out]  AesKey       The OpenSSL encryption key schedule.
+
+  @retval TRUE   The parameters are valid and AesKey is initialized.
+  @retval FALSE  A parameter is invalid.
+
+**/
+STATIC
+BOOLEAN
+AesGcmInit (
+  IN   CONST UINT8  *Key,
+  IN   UINTN        KeySize,
+  IN   CONST UINT8  *Iv,
+  IN   UINTN        IvSize,
+  IN   CONST UINT8  *AData,
+  IN   UINTN        ADataSize,
+  IN   CONST UINT8  *DataIn,
+  IN   UINTN        DataInSize,
+  IN   CONST UINT8  *Tag,
+  IN   UINTN        TagSize,
+  IN   CONST UINT8  *DataOut,
+  IN   CONST UINTN  *DataOutSize,
+  OUT  AES_KEY      *AesKey
+  )
+{
+  if (Key == NULL || Iv == NULL || Tag == NULL) {
+    return FALSE;
+  }
+  if ((AData == NULL && ADataSize != 0) || ADataSize > INT_MAX) {
+    return FALSE;
+  }
+  if ((DataIn == NULL || DataOut == NULL) && DataInSize != 0) {
+    return FALSE;
+  }
+  if (DataInSize > INT_MAX) {
+    return FALSE;
+  }
+  if (KeySize != 16 && KeySize != 24 && KeySize != 32) {
+    return FALSE;
+  }
+  if (IvSize != AES_GCM_IV_SIZE) {
+    return FALSE;
+  }
+  if (TagSize < AES_GCM_MIN_TAG_SIZE || TagSize > AES_GCM_MAX_TAG_SIZE) {
+    return FALSE;
+  }
+  if (DataOutSize != NULL && *DataOutSize < DataInSize) {
+    return FALSE;
+  }
+
+  if (AES_set_encrypt_key (Key, (UINT32) (KeySize * 8), AesKey) != 0) {
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/**
+  Digests data into a GHASH value with the accelerated GHASH function, padding
+  the partial last block with zeros.
+
+  @param[in, out]  Hash      The 16-byte GHASH value.
+  @param[in]       HashKey   The 16-byte GHASH key.
+  @param[in]       Data      Pointer to the data to digest.
+  @param[in]       DataSize  Size of the data in bytes.
+
+**/
+STATIC
+VOID
+AesGcmAccelGhash (
+  IN OUT UINT8        *Hash,
+  IN     CONST UINT8  *HashKey,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        DataSize
+  )
+{
+  UINT8  Block[AES_BLOCK_SIZE];
+
+  InternalGhashAccelBlocks (Hash, HashKey, Data, DataSize / AES_BLOCK_SIZE);
+  if ((DataSize % AES_BLOCK_SIZE) != 0) {
+    ZeroMem (Block, sizeof (Block));
+    CopyMem (Block, Data + DataSize - DataSize % AES_BLOCK_SIZE, DataSize % AES_BLOCK_SIZE);
+    InternalGhashAccelBlocks (Hash, HashKey, Block, 1);
+  }
+}
+
+/**
+  Encrypts or decrypts data in the CTR mode of AES-GCM with the accelerated AES
+  functions.
+
+  @param[in]       AccelKey  The accelerated AES key schedule.
+  @param[in, out]  Counter   The counter block of the first block, updated with
+                             the counter block following the last one.
+  @param[in]       Input     Pointer to the data to encrypt or decrypt.
+  @param[in]       Size      Size of the data in bytes.
+  @param[out]      Output    Pointer to a buffer that receives the result.
+
+**/
+STATIC
+VOID
+AesGcmAccelCtr (
+  IN     CONST AES_ACCEL_KEY  *AccelKey,
+  IN OUT UINT8                *Counter,
+  IN     CONST UINT8          *Input,
+  IN     UINTN                Size,
+  OUT    UINT8                *Output
+  )
+{
+  UINT8  Block[AES_BLOCK_SIZE];
+  UINTN  Offset;
+
+  InternalAesAccelCtr32Encrypt (AccelKey, Input, Size / AES_BLOCK_SIZE, Counter, Output);
+  if ((Size % AES_BLOCK_SIZE) != 0) {
+    Offset = Size - Size % AES_BLOCK_SIZE;
+    ZeroMem (Block, sizeof (Block));
+    CopyMem (Block, Input + Offset, Size % AES_BLOCK_SIZE);
+    InternalAesAccelCtr32Encrypt (AccelKey, Block, 1, Counter, Block);
+    CopyMem (Output + Offset, Block, Size % AES_BLOCK_SIZE);
+    ZeroMem (Block, sizeof (Block));
+  }
+}
+
+/**
+  Starts AES-GCM with the accelerated AES and GHASH functions: derives the hash
+  key and the pre-counter block and digests the additional authenticated data.
+
+  @param[out]  AccelKey   The accelerated AES key schedule.
+  @param[in]   AesKey     The OpenSSL encryption key schedule.
+  @param[in]   Iv         Pointer to the 12-byte IV value.
+  @param[in]   AData      Pointer to the additional authenticated data (AAD).
+  @param[in]   ADataSize  Size of the additional authenticated data (AAD) in bytes.
+  @param[out]  HashKey    The 16-byte GHASH key.
+  @param[out]  PreCounter The 16-byte pre-counter block J0.
+  @param[out]  Hash       The 16-byte GHASH value of the AAD.
+
+  @retval TRUE   AES-GCM is started.
+  @retval FALSE  No accelerated AES function is supported.
+
+**/
+STATIC
+BOOLEAN
+AesGcmAccelStart (
+  OUT AES_ACCEL_KEY  *AccelKey,
+  IN  CONST AES_KEY  *AesKey,
+  IN  CONST UINT8    *Iv,
+  IN  CONST UINT8    *AData,
+  IN  UINTN          ADataSize,
+  OUT UINT8          *HashKey,
+  OUT UINT8          *PreCounter,
+  OUT UINT8          *Hash
+  )
+{
+  if (!InternalAesAccelInit (AccelKey, AesKey->rd_key, NULL, (UINTN) AesKey->rounds)) {
+    return FALSE;
+  }
+
+  ZeroMem (HashKey, AES_BLOCK_SIZE);
+  InternalAesAccelEcbEncrypt (AccelKey, HashKey, 1, HashKey);
+
+  CopyMem (PreCounter, Iv, AES_GCM_IV_SIZE);
+  WriteUnaligned32 ((UINT32 *) (PreCounter + AES_GCM_IV_SIZE), SwapBytes32 (1));
+
+  ZeroMem (Hash, AES_BLOCK_SIZE);
+  AesGcmAccelGhash (Hash, HashKey, AData, ADataSize);
+  return TRUE;
+}
+
+/**
+  Finishes AES-GCM with the accelerated AES and GHASH functions: digests the
+  lengths block and computes the full authentication tag.
+
+  @param[in]       AccelKey    The accelerated AES key schedule.
+  @param[in]       HashKey     The 16-byte GHASH key.
+  @param[in]       PreCounter  The 16-byte pre-counter block J0.
+  @param[in, out]  Hash        The 16-byte GHASH value of the AAD and the
+                               ciphertext.
+  @param[in]       ADataSize   Size of the additional authenticated data in bytes.
+  @param[in]       DataSize    Size of the ciphertext in bytes.
+  @param[out]      Tag         The 16-byte authentication tag.
+
+**/
+STATIC
+VOID
+AesGcmAccelFinish (
+  IN     CONST AES_ACCEL_KEY  *AccelKey,
+  IN     CONST UINT8          *HashKey,
+  IN     CONST UINT8          *PreCounter,
+  IN OUT UINT8                *Hash,
+  IN     UINTN                ADataSize,
+  IN     UINTN                DataSize,
+  OUT    UINT8                *Tag
+  )
+{
+  UINT8  Block[AES_BLOCK_SIZE];
+  UINTN  Index;
+
+  WriteUnaligned64 ((UINT64 *) Block, SwapBytes64 (MultU64x32 (ADataSize, 8)));
+  WriteUnaligned64 ((UINT64 *) (Block + 8), SwapBytes64 (MultU64x32 (DataSize, 8)));
+  InternalGhashAccelBlocks (Hash, HashKey, Block, 1);
+
+  InternalAesAccelEcbEncrypt (AccelKey, PreCounter, 1, Tag);
+  for (Index = 0; Index < AES_BLOCK_SIZE; Index++) {
+    Tag[Index] ^= Hash[Index];
+  }
+}
+
+/**
+  Performs AEAD AES-GCM authenticated encryption on a data buffer and additional authenticated data (AAD).
+
+  IvSize must be 12, otherwise FALSE is returned.
+  KeySize must be 16, 24 or 32, otherwise FALSE is returned.
+  TagSize must be 12, 13, 14, 15, 16, otherwise FALSE is returned.
+
+  @param[in]   Key         Pointer to the encryption key.
+  @param[in]   KeySize     Size of the encryption key in bytes.
+  @param[in]   Iv          Pointer to the IV value.
+  @param[in]   IvSize      Size of the IV value in bytes.
+  @param[in]   AData       Pointer to the additional authenticated data (AAD).
+  @param[in]   ADataSize   Size of the additional authenticated data (AAD) in bytes.
+  @param[in]   DataIn      Pointer to the input data buffer to be encrypted.
+  @param[in]   DataInSize  Size of the input data buffer in bytes.
+  @param[out]  TagOut      Pointer to a buffer that receives the authentication tag output.
+  @param[in]   TagSize     Size of the authentication tag in bytes.
+  @param[out]  DataOut     Pointer to a buffer that receives the encryption output.
+  @param[out]  DataOutSize Size of the output data buffer in bytes.
+
+  @retval TRUE   AEAD AES-GCM authenticated encryption succeeded.
+  @retval FALSE  AEAD AES-GCM authenticated encryption failed.
+
+**/
+BOOLEAN
+EFIAPI
+AeadAesGcmEncrypt (
+  IN   CONST UINT8  *Key,
+  IN   UINTN        KeySize,
+  IN   CONST UINT8  *Iv,
+  IN   UINTN        IvSize,
+  IN   CONST UINT8  *AData,
+  IN   UINTN        ADataSize,
+  IN   CONST UINT8  *DataIn,
+  IN   UINTN        DataInSize,
+  OUT  UINT8        *TagOut,
+  IN   UINTN        TagSize,
+  OUT  UINT8        *DataOut,
+  OUT  UINTN        *DataOutSize
+  )
+{
+  AES_KEY        AesKey;
+  AES_ACCEL_KEY  AccelKey;
+  GCM128_CONTEXT *Gcm;
+  UINT8          HashKey[AES_BLOCK_SIZE];
+  UINT8          PreCounter[AES_BLOCK_SIZE];
+  UINT8          Counter[AES_BLOCK_SIZE];
+  UINT8          Hash[AES_BLOCK_SIZE];
+  UINT8          FullTag[AES_BLOCK_SIZE];
+  UINTN          Offset;
+  UINTN          Size;
+  BOOLEAN        Result;
+
+  if (!AesGcmInit (Key, KeySize, Iv, IvSize, AData, ADataSize, DataIn, DataInSize, TagOut, TagSize, DataOut, DataOutSize, &AesKey)) {
+    return FALSE;
+  }
+
+  if (AesGcmAccelStart (&AccelKey, &AesKey, Iv, AData, ADataSize, HashKey, PreCounter, Hash)) {
+    //
+    // Encrypt with the counter blocks following J0 and digest the ciphertext,
+    // one chunk at a time.
+    //
+    CopyMem (Counter, PreCounter, AES_BLOCK_SIZE);
+    WriteUnaligned32 ((UINT32 *) (Counter + AES_GCM_IV_SIZE), SwapBytes32 (2));
+    for (Offset = 0; Offset < DataInSize; Offset += Size) {
+      Size = MIN (DataInSize - Offset, AES_GCM_CHUNK_SIZE);
+      AesGcmAccelCtr (&AccelKey, Counter, DataIn + Offset, Size, DataOut + Offset);
+      AesGcmAccelGhash (Hash, HashKey, DataOut + Offset, Size);
+    }
+
+    AesGcmAccelFinish (&AccelKey, HashKey, PreCounter, Hash, ADataSize, DataInSize, FullTag);
+    CopyMem (TagOut, FullTag, TagSize);
+
+    ZeroMem (&AccelKey, sizeof (AccelKey));
+    ZeroMem (HashKey, sizeof (HashKey));
+    ZeroMem (FullTag, sizeof (FullTag));
+    Result = TRUE;
+  } else {
+    Gcm = CRYPTO_gcm128_new (&AesKey, (block128_f) AES_encrypt);
+    if (Gcm == NULL) {
+      ZeroMem (&AesKey, sizeof (AesKey));
+      return FALSE;
+    }
+
+    CRYPTO_gcm128_setiv (Gcm, Iv, IvSize);
+    Result = (BOOLEAN) (CRYPTO_gcm128_aad (Gcm, AData, ADataSize) == 0 &&
+                        CRYPTO_gcm128_encrypt (Gcm, DataIn, DataOut, DataInSize) == 0);
+    if (Result) {
+      CRYPTO_gcm128_tag (Gcm, TagOut, TagSize);
+    }
+    CRYPTO_gcm128_release (Gcm);
+  }
+
+  ZeroMem (&AesKey, sizeof (AesKey));
+
+  if (Result && DataOutSize != NULL) {
+    *DataOutSize = DataInSize;
+  }
+  return Result;
+}
+
+/**
+  Performs AEAD AES-GCM authenticated decryption on a data buffer and additional authenticated data (AAD).
+
+  IvSize must be 12, otherwise FALSE is returned.
+  KeySize must be 16, 24 or 32, otherwise FALSE is returned.
+  TagSize must be 12, 13, 14, 15, 16, otherwise FALSE is returned.
+  If additional authenticated data verification fails, FALSE is returned.
+
+  @param[in]   Key         Pointer to the encryption key.
+  @param[in]   KeySize     Size of the encryption key in bytes.
+  @param[in]   Iv          Pointer to the IV value.
+  @param[in]   IvSize      Size of the IV value in bytes.
+  @param[in]   AData       Pointer to the additional authenticated data (AAD).
+  @param[in]   ADataSize   Size of the additional authenticated data (AAD) in bytes.
+  @param[in]   DataIn      Pointer to the input data buffer to be decrypted.
+  @param[in]   DataInSize  Size of the input data buffer in bytes.
+  @param[in]   Tag         Pointer to a buffer that contains the authentication tag.
+  @param[in]   TagSize     Size of the authentication tag in bytes.
+  @param[out]  DataOut     Pointer to a buffer that receives the decryption output.
+  @param[out]  DataOutSize Size of the output data buffer in bytes.
+
+  @retval TRUE   AEAD AES-GCM authenticated decryption succeeded.
+  @retval FALSE  AEAD AES-GCM authenticated decryption failed.
+
+**/
+BOOLEAN
+EFIAPI
+AeadAesGcmDecrypt (
+  IN   CONST UINT8  *Key,
+  IN   UINTN        KeySize,
+  IN   CONST UINT8  *Iv,
+  IN   UINTN        IvSize,
+  IN   CONST UINT8  *AData,
+  IN   UINTN        ADataSize,
+  IN   CONST UINT8  *DataIn,
+  IN   UINTN        DataInSize,
+  IN   CONST UINT8  *Tag,
+  IN   UINTN        TagSize,
+  OUT  UINT8        *DataOut,
+  OUT  UINTN        *DataOutSize
+  )
+{
+  AES_KEY        AesKey;
+  AES_ACCEL_KEY  AccelKey;
+  GCM128_CONTEXT *Gcm;
+  UINT8          HashKey[AES_BLOCK_SIZE];
+  UINT8          PreCounter[AES_BLOCK_SIZE];
+  UINT8          Counter[AES_BLOCK_SIZE];
+  UINT8          Hash[AES_BLOCK_SIZE];
+  UINT8          FullTag[AES_BLOCK_SIZE];
+  UINT8          Difference;
+  UINTN          Index;
+  BOOLEAN        Result;
+
+  if (!AesGcmInit (Key, KeySize, Iv, IvSize, AData, ADataSize, DataIn, DataInSize, Tag, TagSize, DataOut, DataOutSize, &AesKey)) {
+    return FALSE;
+  }
+
+  if (AesGcmAccelStart (&AccelKey, &AesKey, Iv, AData, ADataSize, HashKey, PreCounter, Hash)) {
+    //
+    // Authenticate the ciphertext before decrypting it, so that nothing is
+    // written to DataOut when the tag does not match.
+    //
+    AesGcmAccelGhash (Hash, HashKey, DataIn, DataInSize);
+    AesGcmAccelFinish (&AccelKey, HashKey, PreCounter, Hash, ADataSize, DataInSize, FullTag);
+
+    Difference = 0;
+    for (Index = 0; Index < TagSize; Index++) {
+      Difference |= (UINT8) (FullTag[Index] ^ Tag[Index]);
+    }
+    Result = (BOOLEAN) (Difference == 0);
+
+    if (Result) {
+      CopyMem (Counter, PreCounter, AES_BLOCK_SIZE);
+      WriteUnaligned32 ((UINT32 *) (Counter + AES_GCM_IV_SIZE), SwapBytes32 (2));
+      AesGcmAccelCtr (&AccelKey, Counter, DataIn, DataInSize, DataOut);
+    }
+
+    ZeroMem (&AccelKey, sizeof (AccelKey));
+    ZeroMem (HashKey, sizeof (HashKey));
+    ZeroMem (FullTag, sizeof (FullTag));
+  } else {
+    Gcm = CRYPTO_gcm128_new (&AesKey, (block128_f) AES_encrypt);
+    if (Gcm == NULL) {
+      ZeroMem (&AesKey, sizeof (AesKey));
+      return FALSE;
+    }
+
+    CRYPTO_gcm128_setiv (Gcm, Iv, IvSize);
+    Result = (BOOLEAN) (CRYPTO_gcm128_aad (Gcm, AData, ADataSize) == 0 &&
+                        CRYPTO_gcm128_decrypt (Gcm, DataIn, DataOut, DataInSize) == 0 &&
+                        CRYPTO_gcm128_finish (Gcm, Tag, TagSize) == 0);
+    CRYPTO_gcm128_release (Gcm);
+
+    if (!Result && DataInSize != 0) {
+      ZeroMem (DataOut, DataInSize);
+    }
+  }
+
+  ZeroMem (&AesKey, sizeof (AesKey));
+
+  if (Result && DataOutSize != NULL) {
+    *DataOutSize = DataInSize;
+  }
+  return Result;
+}
@@ -1,7 +1,7 @@
 /** @file
   AES Wrapper Implementation over OpenSSL.
 
-Copyright (c) 2010 - 2012, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2010 - 2017, Intel Corporation. All rights reserved.<BR>
 This program and the accompanying materials
 are licensed and made available under the terms and conditions of the BSD License
 which accompanies this distribution.  The full text of the license may be found at
@@ -14,6 +14,17 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 
 #include "InternalCryptLib.h"
 #include <openssl/aes.h>
+#include <openssl/modes.h>
+
+//
+// AES context: the OpenSSL key schedules for encryption and decryption, and the
+// same key schedules for the accelerated AES functions when they are supported.
+//
+typedef struct {
+  AES_KEY        EncryptKey;
+  AES_KEY        DecryptKey;
+  AES_ACCEL_KEY  AccelKey;
+} AES_CONTEXT;
 
 /**
   Retrieves the size, in bytes, of the context buffer required for AES operations.
@@ -29,9 +40,9 @@ AesGetContextSize (
 {
   //
   // AES uses different key contexts for encryption and decryption, so here memory
-  // for 2 copies of AES_KEY is allocated.
+  // for 2 copies of AES_KEY is allocated, along with the accelerated key schedule.
   //
-  return (UINTN) (2 * sizeof (AES_KEY));
+  return (UINTN) sizeof (AES_CONTEXT);
 }
 
 /**
@@ -62,7 +73,7 @@ AesInit (
   IN   UINTN        KeyLength
   )
 {
-  AES_KEY  *AesKey;
+  AES_CONTEXT  *Context;
 
   //
   // Check input parameters.
@@ -74,13 +85,25 @@ AesInit (
   //
   // Initialize AES encryption & decryption key schedule.
   //
-  AesKey = (AES_KEY *) AesContext;
-  if (AES_set_encrypt_key (Key, (UINT32) KeyLength, AesKey) != 0) {
+  Context = (AES_CONTEXT *) AesContext;
+  if (AES_set_encrypt_key (Key, (UINT32) KeyLength, &Context->EncryptKey) != 0) {
     return FALSE;
   }
-  if (AES_set_decrypt_key (Key, (UINT32) KeyLength, AesKey + 1) != 0) {
+  if (AES_set_decrypt_key (Key, (UINT32) KeyLength, &Context->DecryptKey) != 0) {
     return FALSE;
   }
+
+  //
+  // Convert the key schedules for the accelerated AES functions, if the CPU
+  // supports them.
+  //
+  InternalAesAccelInit (
+    &Context->AccelKey,
+    Context->EncryptKey.rd_key,
+    Context->DecryptKey.rd_key,
+    (UINTN) Context->EncryptKey.rounds
+    );
+
   return TRUE;
 }
 
@@ -117,7 +140,7 @@ AesEcbEncrypt (
   OUT  UINT8        *Output
   )
 {
-  AES_KEY  *AesKey;
+  AES_CONTEXT  *Context;
 
   //
   // Check input parameters.
@@ -125,14 +148,18 @@ AesEcbEncrypt (
   if (AesContext == NULL || Input == NULL || (InputSize % AES_BLOCK_SIZE) != 0 || Output == NULL) {
     return FALSE;
   }
-  
-  AesKey = (AES_KEY *) AesContext;
+
+  Context = (AES_CONTEXT *) AesContext;
+
+  if (InternalAesAccelEcbEncrypt (&Context->AccelKey, Input, InputSize / AES_BLOCK_SIZE, Output)) {
+    return TRUE;
+  }
 
   //
   // Perform AES data encryption with ECB mode (block-by-block)
   //
   while (InputSize > 0) {
-    AES_ecb_encrypt (Input, Output, AesKey, AES_ENCRYPT);
+    AES_ecb_encrypt (Input, Output, &Context->EncryptKey, AES_ENCRYPT);
     Input     += AES_BLOCK_SIZE;
     Output    += AES_BLOCK_SIZE;
     InputSize -= AES_BLOCK_SIZE;
@@ -174,7 +201,7 @@ AesEcbDecrypt (
   OUT  UINT8        *Output
   )
 {
-  AES_KEY  *AesKey;
+  AES_CONTEXT  *Context;
 
   //
   // Check input parameters.
@@ -183,13 +210,17 @@ AesEcbDecrypt (
     return FALSE;
   }
 
-  AesKey = (AES_KEY *) AesContext;
+  Context = (AES_CONTEXT *) AesContext;
+
+  if (InternalAesAccelEcbDecrypt (&Context->AccelKey, Input, InputSize / AES_BLOCK_SIZE, Output)) {
+    return TRUE;
+  }
 
   //
   // Perform AES data decryption with ECB mode (block-by-block)
   //
   while (InputSize > 0) {
-    AES_ecb_encrypt (Input, Output, AesKey + 1, AES_DECRYPT);
+    AES_ecb_encrypt (Input, Output, &Context->DecryptKey, AES_DECRYPT);
     Input     += AES_BLOCK_SIZE;
     Output    += AES_BLOCK_SIZE;
     InputSize -= AES_BLOCK_SIZE;
@@ -235,8 +266,8 @@ AesCbcEncrypt (
   OUT  UINT8        *Output
   )
 {
-  AES_KEY  *AesKey;
-  UINT8    IvecBuffer[AES_BLOCK_SIZE];
+  AES_CONTEXT  *Context;
+  UINT8        IvecBuffer[AES_BLOCK_SIZE];
 
   //
   // Check input parameters.
@@ -249,13 +280,17 @@ AesCbcEncrypt (
     return FALSE;
   }
 
-  AesKey = (AES_KEY *) AesContext;
+  Context = (AES_CONTEXT *) AesContext;
   CopyMem (IvecBuffer, Ivec, AES_BLOCK_SIZE);
 
+  if (InternalAesAccelCbcEncrypt (&Context->AccelKey, Input, InputSize / AES_BLOCK_SIZE, IvecBuffer, Output)) {
+    return TRUE;
+  }
+
   //
   // Perform AES data encryption with CBC mode
   //
-  AES_cbc_encrypt (Input, Output, (UINT32) InputSize, AesKey, IvecBuffer, AES_ENCRYPT);
+  AES_cbc_encrypt (Input, Output, (UINT32) InputSize, &Context->EncryptKey, IvecBuffer, AES_ENCRYPT);
 
   return TRUE;
 }
@@ -297,8 +332,8 @@ AesCbcDecrypt (
   OUT  UINT8        *Output
   )
 {
-  AES_KEY  *AesKey;
-  UINT8    IvecBuffer[AES_BLOCK_SIZE];
+  AES_CONTEXT  *Context;
+  UINT8        IvecBuffer[AES_BLOCK_SIZE];
 
   //
   // Check input parameters.
@@ -311,13 +346,137 @@ AesCbcDecrypt (
     return FALSE;
   }
 
-  AesKey = (AES_KEY *) AesContext;
+  Context = (AES_CONTEXT *) AesContext;
   CopyMem (IvecBuffer, Ivec, AES_BLOCK_SIZE);
 
+  if (InternalAesAccelCbcDecrypt (&Context->AccelKey, Input, InputSize / AES_BLOCK_SIZE, IvecBuffer, Output)) {
+    return TRUE;
+  }
+
   //
   // Perform AES data decryption with CBC mode
   //
-  AES_cbc_encrypt (Input, Output, (UINT32) InputSize, AesKey + 1, IvecBuffer, AES_DECRYPT);
+  AES_cbc_encrypt (Input, Output, (UINT32) InputSize, &Context->DecryptKey, IvecBuffer, AES_DECRYPT);
+
+  return TRUE;
+}
+
+/**
+  Performs AES encryption or decryption on a data buffer of the specified size
+  in CTR mode.
+
+  This function performs AES encryption on data buffer pointed by Input, of specified
+  size of InputSize, in CTR mode. As CTR mode XORs the data with a key stream,
+  the same function decrypts data encrypted in CTR mode.
+  InputSize may be of any size. The counter block is incremented as a 128-bit
+  big endian integer for each 16-byte block.
+  Initialization vector should be one block size (16 bytes), the counter block
+  of the first block.
+  AesContext should be already correctly initialized by AesInit(). Behavior with
+  invalid AES context is undefined.
+
+  If AesContext is NULL, then return FALSE.
+  If Input is NULL, then return FALSE.
+  If Ivec is NULL, then return FALSE.
+  If Output is NULL, then return FALSE.
+
+  @param[in]   AesContext  Pointer to the AES context.
+  @param[in]   Input       Pointer to the buffer containing the data to be encrypted
+                           or decrypted.
+  @param[in]   InputSize   Size of the Input buffer in bytes.
+  @param[in]   Ivec        Pointer to initialization vector.
+  @param[out]  Output      Pointer to a buffer that receives the AES CTR output.
+
+  @retval TRUE   AES CTR encryption succeeded.
+  @retval FALSE  AES CTR encryption failed.
+
+**/
+BOOLEAN
+EFIAPI
+AesCtrEncrypt (
+  IN   VOID         *AesContext,
+  IN   CONST UINT8  *Input,
+  IN   UINTN        InputSize,
+  IN   CONST UINT8  *Ivec,
+  OUT  UINT8        *Output
+  )
+{
+  AES_CONTEXT  *Context;
+  UINT8        Counter[AES_BLOCK_SIZE];
+  UINT8        KeyStream[AES_BLOCK_SIZE];
+  UINTN        BlockCount;
+  UINTN        ChunkCount;
+  UINT32       Counter32;
+  UINTN        Index;
+  UINT32       Num;
+
+  //
+  // Check input parameters.
+  //
+  if (AesContext == NULL || Input == NULL || Ivec == NULL || Output == NULL) {
+    return FALSE;
+  }
+
+  Context = (AES_CONTEXT *) AesContext;
+  CopyMem (Counter, Ivec, AES_BLOCK_SIZE);
+
+  if (Context->AccelKey.Rounds == 0) {
+    //
+    // Perform AES data encryption with CTR mode
+    //
+    Num = 0;
+    CRYPTO_ctr128_encrypt (
+      Input,
+      Output,
+      InputSize,
+      &Context->EncryptKey,
+      Counter,
+      KeyStream,
+      &Num,
+      (block128_f) AES_encrypt
+      );
+    ZeroMem (KeyStream, sizeof (KeyStream));
+    return TRUE;
+  }
+
+  //
+  // The accelerated function increments the last 32 bits of the counter block,
+  // so the blocks are split where those wrap around and the carry is propagated
+  // to the first 96 bits here.
+  //
+  BlockCount = InputSize / AES_BLOCK_SIZE;
+  while (BlockCount > 0) {
+    Counter32  = SwapBytes32 (ReadUnaligned32 ((UINT32 *) (Counter + 12)));
+    ChunkCount = BlockCount;
+    if ((UINT64) ChunkCount > (BIT32 - (UINT64) Counter32)) {
+      ChunkCount = (UINTN) (BIT32 - (UINT64) Counter32);
+    }
+
+    InternalAesAccelCtr32Encrypt (&Context->AccelKey, Input, ChunkCount, Counter, Output);
+    Input      += ChunkCount * AES_BLOCK_SIZE;
+    Output     += ChunkCount * AES_BLOCK_SIZE;
+    BlockCount -= ChunkCount;
+
+    if (ReadUnaligned32 ((UINT32 *) (Counter + 12)) == 0) {
+      for (Index = 12; Index > 0; Index--) {
+        if (++Counter[Index - 1] != 0) {
+          break;
+        }
+      }
+    }
+  }
+
+  //
+  // Encrypt the counter block of the partial last block, if any.
+  //
+  InputSize %= AES_BLOCK_SIZE;
+  if (InputSize > 0) {
+    InternalAesAccelEcbEncrypt (&Context->AccelKey, Counter, 1, KeyStream);
+    for (Index = 0; Index < InputSize; Index++) {
+      Output[Index] = (UINT8) (Input[Index] ^ KeyStream[Index]);
+    }
+  }
 
+  ZeroMem (KeyStream, sizeof (KeyStream));
   return TRUE;
 }
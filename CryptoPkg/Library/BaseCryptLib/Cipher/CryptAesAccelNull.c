@@ -0,0 +1,194 @@
+/** @file
+  Accelerated AES and GHASH functions Wrapper Implementation which does not
+  provide real capabilities, for the architectures without accelerated AES
+  functions.
+
+Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+This program and the accompanying materials
+are licensed and made available under the terms and conditions of the BSD License
+which accompanies this distribution.  The full text of the license may be found at
+http://opensource.org/licenses/bsd-license.php
+
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "InternalCryptLib.h"
+
+/**
+  Initializes an accelerated AES key schedule.
+
+  Return FALSE to indicate this interface is not supported.
+
+  @param[out]  AccelKey           The accelerated AES key schedule to initialize.
+  @param[in]   EncryptRoundKeys   The round key words of the OpenSSL encryption
+                                  key schedule.
+  @param[in]   DecryptRoundKeys   The round key words of the OpenSSL decryption
+                                  key schedule, or NULL.
+  @param[in]   Rounds             Number of AES rounds, 10, 12 or 14.
+
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+InternalAesAccelInit (
+  OUT AES_ACCEL_KEY  *AccelKey,
+  IN  CONST UINT32   *EncryptRoundKeys,
+  IN  CONST UINT32   *DecryptRoundKeys,  OPTIONAL
+  IN  UINTN          Rounds
+  )
+{
+  AccelKey->Rounds = 0;
+  return FALSE;
+}
+
+/**
+  Encrypts whole 16-byte blocks in ECB mode.
+
+  Return FALSE to indicate this interface is not supported.
+
+  @param[in]   AccelKey    The accelerated AES key schedule.
+  @param[in]   Input       Pointer to the blocks to encrypt.
+  @param[in]   BlockCount  Number of 16-byte blocks at Input.
+  @param[out]  Output      Pointer to a buffer that receives the encrypted blocks.
+
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+InternalAesAccelEcbEncrypt (
+  IN  CONST AES_ACCEL_KEY  *AccelKey,
+  IN  CONST UINT8          *Input,
+  IN  UINTN                BlockCount,
+  OUT UINT8                *Output
+  )
+{
+  return FALSE;
+}
+
+/**
+  Decrypts whole 16-byte blocks in ECB mode.
+
+  Return FALSE to indicate this interface is not supported.
+
+  @param[in]   AccelKey    The accelerated AES key schedule.
+  @param[in]   Input       Pointer to the blocks to decrypt.
+  @param[in]   BlockCount  Number of 16-byte blocks at Input.
+  @param[out]  Output      Pointer to a buffer that receives the decrypted blocks.
+
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+InternalAesAccelEcbDecrypt (
+  IN  CONST AES_ACCEL_KEY  *AccelKey,
+  IN  CONST UINT8          *Input,
+  IN  UINTN                BlockCount,
+  OUT UINT8                *Output
+  )
+{
+  return FALSE;
+}
+
+/**
+  Encrypts whole 16-byte blocks in CBC mode.
+
+  Return FALSE to indicate this interface is not supported.
+
+  @param[in]       AccelKey    The accelerated AES key schedule.
+  @param[in]       Input       Pointer to the blocks to encrypt.
+  @param[in]       BlockCount  Number of 16-byte blocks at Input.
+  @param[in, out]  Ivec        The initialization vector.
+  @param[out]      Output      Pointer to a buffer that receives the encrypted blocks.
+
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+InternalAesAccelCbcEncrypt (
+  IN     CONST AES_ACCEL_KEY  *AccelKey,
+  IN     CONST UINT8          *Input,
+  IN     UINTN                BlockCount,
+  IN OUT UINT8                *Ivec,
+  OUT    UINT8                *Output
+  )
+{
+  return FALSE;
+}
+
+/**
+  Decrypts whole 16-byte blocks in CBC mode.
+
+  Return FALSE to indicate this interface is not supported.
+
+  @param[in]       AccelKey    The accelerated AES key schedule.
+  @param[in]       Input       Pointer to the blocks to decrypt.
+  @param[in]       BlockCount  Number of 16-byte blocks at Input.
+  @param[in, out]  Ivec        The initialization vector.
+  @param[out]      Output      Pointer to a buffer that receives the decrypted blocks.
+
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+InternalAesAccelCbcDecrypt (
+  IN     CONST AES_ACCEL_KEY  *AccelKey,
+  IN     CONST UINT8          *Input,
+  IN     UINTN                BlockCount,
+  IN OUT UINT8                *Ivec,
+  OUT    UINT8                *Output
+  )
+{
+  return FALSE;
+}
+
+/**
+  Encrypts or decrypts whole 16-byte blocks in CTR mode.
+
+  Return FALSE to indicate this interface is not supported.
+
+  @param[in]       AccelKey    The accelerated AES key schedule.
+  @param[in]       Input       Pointer to the blocks to encrypt or decrypt.
+  @param[in]       BlockCount  Number of 16-byte blocks at Input.
+  @param[in, out]  Counter     The counter block of the first block.
+  @param[out]      Output      Pointer to a buffer that receives the result.
+
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+InternalAesAccelCtr32Encrypt (
+  IN     CONST AES_ACCEL_KEY  *AccelKey,
+  IN     CONST UINT8          *Input,
+  IN     UINTN                BlockCount,
+  IN OUT UINT8                *Counter,
+  OUT    UINT8                *Output
+  )
+{
+  return FALSE;
+}
+
+/**
+  Digests whole 16-byte blocks into a GHASH value.
+
+  Return FALSE to indicate this interface is not supported.
+
+  @param[in, out]  Hash        The 16-byte GHASH value.
+  @param[in]       HashKey     The 16-byte GHASH key.
+  @param[in]       Data        Pointer to the blocks to digest.
+  @param[in]       BlockCount  Number of 16-byte blocks at Data.
+
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+InternalGhashAccelBlocks (
+  IN OUT UINT8        *Hash,
+  IN     CONST UINT8  *HashKey,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  )
+{
+  return FALSE;
+}
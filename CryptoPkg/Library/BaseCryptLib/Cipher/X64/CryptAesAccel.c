@@ -0,0 +1,318 @@
+/** @file
+  AES ECB, CBC and CTR and GHASH functions dispatched on the CPU features.
+
+Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+This program and the accompanying materials
+are licensed and made available under the terms and conditions of the BSD License
+which accompanies this distribution.  The full text of the license may be found at
+http://opensource.org/licenses/bsd-license.php
+
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "CryptAesAccel.h"
+
+#define CPUID_VERSION_INFO              0x01
+
+#define CPUID_VERSION_INFO_ECX_PCLMULQDQ  BIT1
+#define CPUID_VERSION_INFO_ECX_SSSE3      BIT9
+#define CPUID_VERSION_INFO_ECX_SSE4_1     BIT19
+#define CPUID_VERSION_INFO_ECX_AESNI      BIT25
+
+#define CPUID_AES_ACCEL_ECX  (CPUID_VERSION_INFO_ECX_PCLMULQDQ | \
+                              CPUID_VERSION_INFO_ECX_SSSE3 | \
+                              CPUID_VERSION_INFO_ECX_SSE4_1 | \
+                              CPUID_VERSION_INFO_ECX_AESNI)
+
+UINT32  mAesAccelFeatures = 0;
+
+/**
+  Returns the CPU features used by the accelerated AES and GHASH functions.
+
+  The features are detected on the first call and cached. Only the library
+  instances that can write global variables provide AES.
+
+  @return  A combination of AES_ACCEL_FEATURE_* bits.
+
+**/
+UINT32
+InternalAesAccelGetFeatures (
+  VOID
+  )
+{
+  UINT32  VersionEcx;
+  UINT32  Features;
+
+  if (mAesAccelFeatures == 0) {
+    Features = AES_ACCEL_FEATURE_DETECTED;
+    AsmCpuid (CPUID_VERSION_INFO, NULL, NULL, &VersionEcx, NULL);
+    if ((VersionEcx & CPUID_AES_ACCEL_ECX) == CPUID_AES_ACCEL_ECX) {
+      Features |= AES_ACCEL_FEATURE_AES_NI;
+    }
+    mAesAccelFeatures = Features;
+  }
+
+  return mAesAccelFeatures;
+}
+
+/**
+  Copies round keys of an OpenSSL key schedule, storing each round key word in
+  big endian byte order as the AES instructions expect.
+
+  @param[out]  Destination  The round keys in the byte order of the state.
+  @param[in]   RoundKeys    The round key words of the OpenSSL key schedule.
+  @param[in]   Rounds       Number of AES rounds.
+
+**/
+STATIC
+VOID
+AesAccelCopyRoundKeys (
+  OUT UINT8         *Destination,
+  IN  CONST UINT32  *RoundKeys,
+  IN  UINTN         Rounds
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < (Rounds + 1) * 4; Index++) {
+    WriteUnaligned32 ((UINT32 *) (Destination + Index * 4), SwapBytes32 (RoundKeys[Index]));
+  }
+}
+
+/**
+  Initializes an accelerated AES key schedule from the OpenSSL key schedules.
+
+  OpenSSL applies InvMixColumns to the inner decryption round keys, which is
+  the key schedule of the Equivalent Inverse Cipher AESDEC uses.
+
+  @param[out]  AccelKey           The accelerated AES key schedule to initialize.
+  @param[in]   EncryptRoundKeys   The round key words of the OpenSSL encryption
+                                  key schedule.
+  @param[in]   DecryptRoundKeys   The round key words of the OpenSSL decryption
+                                  key schedule, or NULL if AccelKey is only used
+                                  for encryption.
+  @param[in]   Rounds             Number of AES rounds, 10, 12 or 14.
+
+  @retval TRUE   AccelKey was initialized.
+  @retval FALSE  No accelerated AES function is supported, AccelKey->Rounds is
+                 zero.
+
+**/
+BOOLEAN
+InternalAesAccelInit (
+  OUT AES_ACCEL_KEY  *AccelKey,
+  IN  CONST UINT32   *EncryptRoundKeys,
+  IN  CONST UINT32   *DecryptRoundKeys,  OPTIONAL
+  IN  UINTN          Rounds
+  )
+{
+  ASSERT (Rounds <= AES_ACCEL_MAX_ROUNDS);
+
+  AccelKey->Rounds = 0;
+  if ((InternalAesAccelGetFeatures () & AES_ACCEL_FEATURE_AES_NI) == 0) {
+    return FALSE;
+  }
+
+  AesAccelCopyRoundKeys (AccelKey->EncryptKey, EncryptRoundKeys, Rounds);
+  if (DecryptRoundKeys != NULL) {
+    AesAccelCopyRoundKeys (AccelKey->DecryptKey, DecryptRoundKeys, Rounds);
+  } else {
+    ZeroMem (AccelKey->DecryptKey, sizeof (AccelKey->DecryptKey));
+  }
+  AccelKey->Rounds = Rounds;
+
+  return TRUE;
+}
+
+/**
+  Encrypts whole 16-byte blocks in ECB mode with the accelerated AES functions.
+
+  @param[in]   AccelKey    The accelerated AES key schedule.
+  @param[in]   Input       Pointer to the blocks to encrypt.
+  @param[in]   BlockCount  Number of 16-byte blocks at Input.
+  @param[out]  Output      Pointer to a buffer that receives the encrypted blocks.
+
+  @retval TRUE   The blocks were encrypted.
+  @retval FALSE  No accelerated AES function is supported, Output is unchanged.
+
+**/
+BOOLEAN
+InternalAesAccelEcbEncrypt (
+  IN  CONST AES_ACCEL_KEY  *AccelKey,
+  IN  CONST UINT8          *Input,
+  IN  UINTN                BlockCount,
+  OUT UINT8                *Output
+  )
+{
+  if (AccelKey->Rounds == 0) {
+    return FALSE;
+  }
+
+  InternalAesNiEcbEncrypt (AccelKey->EncryptKey, AccelKey->Rounds, Input, Output, BlockCount);
+  return TRUE;
+}
+
+/**
+  Decrypts whole 16-byte blocks in ECB mode with the accelerated AES functions.
+
+  @param[in]   AccelKey    The accelerated AES key schedule.
+  @param[in]   Input       Pointer to the blocks to decrypt.
+  @param[in]   BlockCount  Number of 16-byte blocks at Input.
+  @param[out]  Output      Pointer to a buffer that receives the decrypted blocks.
+
+  @retval TRUE   The blocks were decrypted.
+  @retval FALSE  No accelerated AES function is supported, Output is unchanged.
+
+**/
+BOOLEAN
+InternalAesAccelEcbDecrypt (
+  IN  CONST AES_ACCEL_KEY  *AccelKey,
+  IN  CONST UINT8          *Input,
+  IN  UINTN                BlockCount,
+  OUT UINT8                *Output
+  )
+{
+  if (AccelKey->Rounds == 0) {
+    return FALSE;
+  }
+
+  InternalAesNiEcbDecrypt (AccelKey->DecryptKey, AccelKey->Rounds, Input, Output, BlockCount);
+  return TRUE;
+}
+
+/**
+  Encrypts whole 16-byte blocks in CBC mode with the accelerated AES functions.
+
+  @param[in]       AccelKey    The accelerated AES key schedule.
+  @param[in]       Input       Pointer to the blocks to encrypt.
+  @param[in]       BlockCount  Number of 16-byte blocks at Input.
+  @param[in, out]  Ivec        The initialization vector, updated with the last
+                               encrypted block.
+  @param[out]      Output      Pointer to a buffer that receives the encrypted blocks.
+
+  @retval TRUE   The blocks were encrypted.
+  @retval FALSE  No accelerated AES function is supported, Ivec and Output are
+                 unchanged.
+
+**/
+BOOLEAN
+InternalAesAccelCbcEncrypt (
+  IN     CONST AES_ACCEL_KEY  *AccelKey,
+  IN     CONST UINT8          *Input,
+  IN     UINTN                BlockCount,
+  IN OUT UINT8                *Ivec,
+  OUT    UINT8                *Output
+  )
+{
+  if (AccelKey->Rounds == 0) {
+    return FALSE;
+  }
+
+  InternalAesNiCbcEncrypt (AccelKey->EncryptKey, AccelKey->Rounds, Input, Output, BlockCount, Ivec);
+  return TRUE;
+}
+
+/**
+  Decrypts whole 16-byte blocks in CBC mode with the accelerated AES functions.
+
+  Input and Output may be the same buffer.
+
+  @param[in]       AccelKey    The accelerated AES key schedule.
+  @param[in]       Input       Pointer to the blocks to decrypt.
+  @param[in]       BlockCount  Number of 16-byte blocks at Input.
+  @param[in, out]  Ivec        The initialization vector, updated with the last
+                               block of Input.
+  @param[out]      Output      Pointer to a buffer that receives the decrypted blocks.
+
+  @retval TRUE   The blocks were decrypted.
+  @retval FALSE  No accelerated AES function is supported, Ivec and Output are
+                 unchanged.
+
+**/
+BOOLEAN
+InternalAesAccelCbcDecrypt (
+  IN     CONST AES_ACCEL_KEY  *AccelKey,
+  IN     CONST UINT8          *Input,
+  IN     UINTN                BlockCount,
+  IN OUT UINT8                *Ivec,
+  OUT    UINT8                *Output
+  )
+{
+  if (AccelKey->Rounds == 0) {
+    return FALSE;
+  }
+
+  InternalAesNiCbcDecrypt (AccelKey->DecryptKey, AccelKey->Rounds, Input, Output, BlockCount, Ivec);
+  return TRUE;
+}
+
+/**
+  Encrypts or decrypts whole 16-byte blocks in CTR mode with the accelerated
+  AES functions, incrementing only the last 32 bits of the counter block.
+
+  @param[in]       AccelKey    The accelerated AES key schedule.
+  @param[in]       Input       Pointer to the blocks to encrypt or decrypt.
+  @param[in]       BlockCount  Number of 16-byte blocks at Input.
+  @param[in, out]  Counter     The counter block of the first block, updated
+                               with the counter block following the last one.
+                               Its last four bytes are a big endian counter,
+                               incremented modulo 2^32.
+  @param[out]      Output      Pointer to a buffer that receives the result.
+
+  @retval TRUE   The blocks were processed.
+  @retval FALSE  No accelerated AES function is supported, Counter and Output
+                 are unchanged.
+
+**/
+BOOLEAN
+InternalAesAccelCtr32Encrypt (
+  IN     CONST AES_ACCEL_KEY  *AccelKey,
+  IN     CONST UINT8          *Input,
+  IN     UINTN                BlockCount,
+  IN OUT UINT8                *Counter,
+  OUT    UINT8                *Output
+  )
+{
+  if (AccelKey->Rounds == 0) {
+    return FALSE;
+  }
+
+  InternalAesNiCtr32Encrypt (AccelKey->EncryptKey, AccelKey->Rounds, Input, Output, BlockCount, Counter);
+  return TRUE;
+}
+
+/**
+  Digests whole 16-byte blocks into a GHASH value with the accelerated GHASH
+  function.
+
+  The accelerated GHASH function is supported whenever InternalAesAccelInit()
+  succeeds.
+
+  @param[in, out]  Hash        The 16-byte GHASH value.
+  @param[in]       HashKey     The 16-byte GHASH key, the encryption of the
+                               zero block.
+  @param[in]       Data        Pointer to the blocks to digest.
+  @param[in]       BlockCount  Number of 16-byte blocks at Data.
+
+  @retval TRUE   The blocks were digested.
+  @retval FALSE  The accelerated GHASH function is not supported, Hash is
+                 unchanged.
+
+**/
+BOOLEAN
+InternalGhashAccelBlocks (
+  IN OUT UINT8        *Hash,
+  IN     CONST UINT8  *HashKey,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  )
+{
+  if ((InternalAesAccelGetFeatures () & AES_ACCEL_FEATURE_AES_NI) == 0) {
+    return FALSE;
+  }
+
+  InternalGhashPclmul (Hash, HashKey, Data, BlockCount);
+  return TRUE;
+}
@@ -0,0 +1,156 @@
+/** @file
+  Internal include file for the accelerated AES and GHASH functions.
+
+Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+This program and the accompanying materials
+are licensed and made available under the terms and conditions of the BSD License
+which accompanies this distribution.  The full text of the license may be found at
+http://opensource.org/licenses/bsd-license.php
+
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#ifndef __CRYPT_AES_ACCEL_H__
+#define __CRYPT_AES_ACCEL_H__
+
+#include "InternalCryptLib.h"
+
+//
+// CPU features the accelerated AES and GHASH functions depend on.
+// AES_ACCEL_FEATURE_AES_NI is set when the AES instructions, PCLMULQDQ, SSSE3
+// and SSE4.1 are supported.
+//
+#define AES_ACCEL_FEATURE_AES_NI    BIT0
+#define AES_ACCEL_FEATURE_DETECTED  BIT31
+
+/**
+  Encrypts whole 16-byte blocks in ECB mode using the AES instructions.
+
+  @param[in]   RoundKeys   The Rounds + 1 encryption round keys.
+  @param[in]   Rounds      Number of AES rounds.
+  @param[in]   Input       Pointer to the blocks to encrypt.
+  @param[out]  Output      Pointer to a buffer that receives the encrypted blocks.
+  @param[in]   BlockCount  Number of 16-byte blocks at Input.
+
+**/
+VOID
+EFIAPI
+InternalAesNiEcbEncrypt (
+  IN  CONST UINT8  *RoundKeys,
+  IN  UINTN        Rounds,
+  IN  CONST UINT8  *Input,
+  OUT UINT8        *Output,
+  IN  UINTN        BlockCount
+  );
+
+/**
+  Decrypts whole 16-byte blocks in ECB mode using the AES instructions.
+
+  @param[in]   RoundKeys   The Rounds + 1 decryption round keys.
+  @param[in]   Rounds      Number of AES rounds.
+  @param[in]   Input       Pointer to the blocks to decrypt.
+  @param[out]  Output      Pointer to a buffer that receives the decrypted blocks.
+  @param[in]   BlockCount  Number of 16-byte blocks at Input.
+
+**/
+VOID
+EFIAPI
+InternalAesNiEcbDecrypt (
+  IN  CONST UINT8  *RoundKeys,
+  IN  UINTN        Rounds,
+  IN  CONST UINT8  *Input,
+  OUT UINT8        *Output,
+  IN  UINTN        BlockCount
+  );
+
+/**
+  Encrypts whole 16-byte blocks in CBC mode using the AES instructions.
+
+  @param[in]       RoundKeys   The Rounds + 1 encryption round keys.
+  @param[in]       Rounds      Number of AES rounds.
+  @param[in]       Input       Pointer to the blocks to encrypt.
+  @param[out]      Output      Pointer to a buffer that receives the encrypted blocks.
+  @param[in]       BlockCount  Number of 16-byte blocks at Input.
+  @param[in, out]  Ivec        The initialization vector, updated with the last
+                               encrypted block.
+
+**/
+VOID
+EFIAPI
+InternalAesNiCbcEncrypt (
+  IN     CONST UINT8  *RoundKeys,
+  IN     UINTN        Rounds,
+  IN     CONST UINT8  *Input,
+  OUT    UINT8        *Output,
+  IN     UINTN        BlockCount,
+  IN OUT UINT8        *Ivec
+  );
+
+/**
+  Decrypts whole 16-byte blocks in CBC mode using the AES instructions.
+
+  @param[in]       RoundKeys   The Rounds + 1 decryption round keys.
+  @param[in]       Rounds      Number of AES rounds.
+  @param[in]       Input       Pointer to the blocks to decrypt.
+  @param[out]      Output      Pointer to a buffer that receives the decrypted blocks.
+  @param[in]       BlockCount  Number of 16-byte blocks at Input.
+  @param[in, out]  Ivec        The initialization vector, updated with the last
+                               block of Input.
+
+**/
+VOID
+EFIAPI
+InternalAesNiCbcDecrypt (
+  IN     CONST UINT8  *RoundKeys,
+  IN     UINTN        Rounds,
+  IN     CONST UINT8  *Input,
+  OUT    UINT8        *Output,
+  IN     UINTN        BlockCount,
+  IN OUT UINT8        *Ivec
+  );
+
+/**
+  Encrypts or decrypts whole 16-byte blocks in CTR mode using the AES
+  instructions, incrementing the last 32 bits of the counter block.
+
+  @param[in]       RoundKeys   The Rounds + 1 encryption round keys.
+  @param[in]       Rounds      Number of AES rounds.
+  @param[in]       Input       Pointer to the blocks to encrypt or decrypt.
+  @param[out]      Output      Pointer to a buffer that receives the result.
+  @param[in]       BlockCount  Number of 16-byte blocks at Input.
+  @param[in, out]  Counter     The counter block of the first block, updated
+                               with the counter block following the last one.
+
+**/
+VOID
+EFIAPI
+InternalAesNiCtr32Encrypt (
+  IN     CONST UINT8  *RoundKeys,
+  IN     UINTN        Rounds,
+  IN     CONST UINT8  *Input,
+  OUT    UINT8        *Output,
+  IN     UINTN        BlockCount,
+  IN OUT UINT8        *Counter
+  );
+
+/**
+  Digests whole 16-byte blocks into a GHASH value using PCLMULQDQ.
+
+  @param[in, out]  Hash        The 16-byte GHASH value.
+  @param[in]       HashKey     The 16-byte GHASH key.
+  @param[in]       Data        Pointer to the blocks to digest.
+  @param[in]       BlockCount  Number of 16-byte blocks at Data.
+
+**/
+VOID
+EFIAPI
+InternalGhashPclmul (
+  IN OUT UINT8        *Hash,
+  IN     CONST UINT8  *HashKey,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  );
+
+#endif
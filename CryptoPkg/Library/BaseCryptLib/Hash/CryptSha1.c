@@ -1,7 +1,7 @@
 /** @file
   SHA-1 Digest Wrapper Implementation over OpenSSL.
 
-Copyright (c) 2009 - 2016, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2009 - 2017, Intel Corporation. All rights reserved.<BR>
 This program and the accompanying materials
 are licensed and made available under the terms and conditions of the BSD License
 which accompanies this distribution.  The full text of the license may be found at
@@ -15,6 +15,61 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include "InternalCryptLib.h"
 #include <openssl/sha.h>
 
+/**
+  Digests the input data into an OpenSSL SHA-1 context.
+
+  A partial block left by the previous update is completed by OpenSSL. The whole
+  blocks that follow are digested by the accelerated block function when the
+  CPU supports one, and the remaining bytes are left to OpenSSL.
+
+  @param[in, out]  Context   Pointer to the OpenSSL SHA-1 context.
+  @param[in]       Data      Pointer to the buffer containing the data to be hashed.
+  @param[in]       DataSize  Size of Data buffer in bytes.
+
+  @retval TRUE   SHA-1 data digest succeeded.
+  @retval FALSE  SHA-1 data digest failed.
+
+**/
+STATIC
+BOOLEAN
+Sha1UpdateContext (
+  IN OUT  SHA_CTX      *Context,
+  IN      CONST UINT8  *Data,
+  IN      UINTN        DataSize
+  )
+{
+  UINTN    Fill;
+  UINTN    BlockCount;
+  UINTN    BlockSize;
+  UINT32   BitCount;
+
+  if (Context->num != 0) {
+    Fill = MIN (DataSize, SHA_CBLOCK - Context->num);
+    if (!SHA1_Update (Context, Data, Fill)) {
+      return FALSE;
+    }
+    Data     += Fill;
+    DataSize -= Fill;
+  }
+
+  BlockCount = DataSize / SHA_CBLOCK;
+  if (BlockCount != 0 && InternalSha1AccelBlocks (&Context->h0, Data, BlockCount)) {
+    BlockSize = BlockCount * SHA_CBLOCK;
+    //
+    // Update the message length in bits as SHA1_Update() does.
+    //
+    BitCount = (UINT32) (Context->Nl + ((UINT32) BlockSize << 3));
+    if (BitCount < Context->Nl) {
+      Context->Nh++;
+    }
+    Context->Nh += (UINT32) (BlockSize >> 29);
+    Context->Nl  = BitCount;
+    Data        += BlockSize;
+    DataSize    -= BlockSize;
+  }
+
+  return (BOOLEAN) (SHA1_Update (Context, Data, DataSize));
+}
 
 /**
   Retrieves the size, in bytes, of the context buffer required for SHA-1 hash operations.
@@ -140,7 +195,7 @@ Sha1Update (
   //
   // OpenSSL SHA-1 Hash Update
   //
-  return (BOOLEAN) (SHA1_Update ((SHA_CTX *) Sha1Context, Data, DataSize));
+  return Sha1UpdateContext ((SHA_CTX *) Sha1Context, Data, DataSize);
 }
 
 /**
@@ -209,6 +264,9 @@ Sha1HashAll (
   OUT  UINT8       *HashValue
   )
 {
+  SHA_CTX  Context;
+  BOOLEAN  Status;
+
   //
   // Check input parameters.
   //
@@ -222,9 +280,11 @@ Sha1HashAll (
   //
   // OpenSSL SHA-1 Hash Computation.
   //
-  if (SHA1 (Data, DataSize, HashValue) == NULL) {
+  if (!SHA1_Init (&Context) || !Sha1UpdateContext (&Context, Data, DataSize)) {
     return FALSE;
-  } else {
-    return TRUE;
   }
+  Status = (BOOLEAN) (SHA1_Final (HashValue, &Context));
+  ZeroMem (&Context, sizeof (Context));
+
+  return Status;
 }
@@ -1,7 +1,7 @@
 /** @file
   SHA-256 Digest Wrapper Implementation over OpenSSL.
 
-Copyright (c) 2009 - 2016, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2009 - 2017, Intel Corporation. All rights reserved.<BR>
 This program and the accompanying materials
 are licensed and made available under the terms and conditions of the BSD License
 which accompanies this distribution.  The full text of the license may be found at
@@ -15,6 +15,62 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include "InternalCryptLib.h"
 #include <openssl/sha.h>
 
+/**
+  Digests the input data into an OpenSSL SHA-256 context.
+
+  A partial block left by the previous update is completed by OpenSSL. The whole
+  blocks that follow are digested by the accelerated block function when the
+  CPU supports one, and the remaining bytes are left to OpenSSL.
+
+  @param[in, out]  Context   Pointer to the OpenSSL SHA-256 context.
+  @param[in]       Data      Pointer to the buffer containing the data to be hashed.
+  @param[in]       DataSize  Size of Data buffer in bytes.
+
+  @retval TRUE   SHA-256 data digest succeeded.
+  @retval FALSE  SHA-256 data digest failed.
+
+**/
+STATIC
+BOOLEAN
+Sha256UpdateContext (
+  IN OUT  SHA256_CTX   *Context,
+  IN      CONST UINT8  *Data,
+  IN      UINTN        DataSize
+  )
+{
+  UINTN    Fill;
+  UINTN    BlockCount;
+  UINTN    BlockSize;
+  UINT32   BitCount;
+
+  if (Context->num != 0) {
+    Fill = MIN (DataSize, SHA256_CBLOCK - Context->num);
+    if (!SHA256_Update (Context, Data, Fill)) {
+      return FALSE;
+    }
+    Data     += Fill;
+    DataSize -= Fill;
+  }
+
+  BlockCount = DataSize / SHA256_CBLOCK;
+  if (BlockCount != 0 && InternalSha256AccelBlocks (Context->h, Data, BlockCount)) {
+    BlockSize = BlockCount * SHA256_CBLOCK;
+    //
+    // Update the message length in bits as SHA256_Update() does.
+    //
+    BitCount = (UINT32) (Context->Nl + ((UINT32) BlockSize << 3));
+    if (BitCount < Context->Nl) {
+      Context->Nh++;
+    }
+    Context->Nh += (UINT32) (BlockSize >> 29);
+    Context->Nl  = BitCount;
+    Data        += BlockSize;
+    DataSize    -= BlockSize;
+  }
+
+  return (BOOLEAN) (SHA256_Update (Context, Data, DataSize));
+}
+
 /**
   Retrieves the size, in bytes, of the context buffer required for SHA-256 hash operations.
 
@@ -139,7 +195,7 @@ Sha256Update (
   //
   // OpenSSL SHA-256 Hash Update
   //
-  return (BOOLEAN) (SHA256_Update ((SHA256_CTX *) Sha256Context, Data, DataSize));
+  return Sha256UpdateContext ((SHA256_CTX *) Sha256Context, Data, DataSize);
 }
 
 /**
@@ -208,6 +264,9 @@ Sha256HashAll (
   OUT  UINT8       *HashValue
   )
 {
+  SHA256_CTX  Context;
+  BOOLEAN     Status;
+
   //
   // Check input parameters.
   //
@@ -221,9 +280,11 @@ Sha256HashAll (
   //
   // OpenSSL SHA-256 Hash Computation.
   //
-  if (SHA256 (Data, DataSize, HashValue) == NULL) {
+  if (!SHA256_Init (&Context) || !Sha256UpdateContext (&Context, Data, DataSize)) {
     return FALSE;
-  } else {
-    return TRUE;
   }
+  Status = (BOOLEAN) (SHA256_Final (HashValue, &Context));
+  ZeroMem (&Context, sizeof (Context));
+
+  return Status;
 }
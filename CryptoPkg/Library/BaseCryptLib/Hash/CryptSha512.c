@@ -1,7 +1,7 @@
 /** @file
   SHA-384 and SHA-512 Digest Wrapper Implementations over OpenSSL.
 
-Copyright (c) 2014 - 2016, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2014 - 2017, Intel Corporation. All rights reserved.<BR>
 This program and the accompanying materials
 are licensed and made available under the terms and conditions of the BSD License
 which accompanies this distribution.  The full text of the license may be found at
@@ -15,6 +15,62 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include "InternalCryptLib.h"
 #include <openssl/sha.h>
 
+/**
+  Digests the input data into an OpenSSL SHA-384 or SHA-512 context.
+
+  A partial block left by the previous update is completed by OpenSSL. The whole
+  blocks that follow are digested by the accelerated block function when the
+  CPU supports one, and the remaining bytes are left to OpenSSL.
+
+  @param[in, out]  Context   Pointer to the OpenSSL SHA-384 or SHA-512 context.
+  @param[in]       Data      Pointer to the buffer containing the data to be hashed.
+  @param[in]       DataSize  Size of Data buffer in bytes.
+
+  @retval TRUE   SHA-384 or SHA-512 data digest succeeded.
+  @retval FALSE  SHA-384 or SHA-512 data digest failed.
+
+**/
+STATIC
+BOOLEAN
+Sha512UpdateContext (
+  IN OUT  SHA512_CTX   *Context,
+  IN      CONST UINT8  *Data,
+  IN      UINTN        DataSize
+  )
+{
+  UINTN    Fill;
+  UINTN    BlockCount;
+  UINTN    BlockSize;
+  UINT64   BitCount;
+
+  if (Context->num != 0) {
+    Fill = MIN (DataSize, SHA512_CBLOCK - Context->num);
+    if (!SHA512_Update (Context, Data, Fill)) {
+      return FALSE;
+    }
+    Data     += Fill;
+    DataSize -= Fill;
+  }
+
+  BlockCount = DataSize / SHA512_CBLOCK;
+  if (BlockCount != 0 && InternalSha512AccelBlocks (Context->h, Data, BlockCount)) {
+    BlockSize = BlockCount * SHA512_CBLOCK;
+    //
+    // Update the message length in bits as SHA512_Update() does.
+    //
+    BitCount = Context->Nl + ((UINT64) BlockSize << 3);
+    if (BitCount < Context->Nl) {
+      Context->Nh++;
+    }
+    Context->Nh += (UINT64) BlockSize >> 61;
+    Context->Nl  = BitCount;
+    Data        += BlockSize;
+    DataSize    -= BlockSize;
+  }
+
+  return (BOOLEAN) (SHA512_Update (Context, Data, DataSize));
+}
+
 /**
   Retrieves the size, in bytes, of the context buffer required for SHA-384 hash operations.
 
@@ -141,7 +197,7 @@ Sha384Update (
   //
   // OpenSSL SHA-384 Hash Update
   //
-  return (BOOLEAN) (SHA384_Update ((SHA512_CTX *) Sha384Context, Data, DataSize));
+  return Sha512UpdateContext ((SHA512_CTX *) Sha384Context, Data, DataSize);
 }
 
 /**
@@ -210,6 +266,9 @@ Sha384HashAll (
   OUT  UINT8       *HashValue
   )
 {
+  SHA512_CTX  Context;
+  BOOLEAN     Status;
+
   //
   // Check input parameters.
   //
@@ -223,11 +282,13 @@ Sha384HashAll (
   //
   // OpenSSL SHA-384 Hash Computation.
   //
-  if (SHA384 (Data, DataSize, HashValue) == NULL) {
+  if (!SHA384_Init (&Context) || !Sha512UpdateContext (&Context, Data, DataSize)) {
     return FALSE;
-  } else {
-    return TRUE;
   }
+  Status = (BOOLEAN) (SHA384_Final (HashValue, &Context));
+  ZeroMem (&Context, sizeof (Context));
+
+  return Status;
 }
 
 /**
@@ -356,7 +417,7 @@ Sha512Update (
   //
   // OpenSSL SHA-512 Hash Update
   //
-  return (BOOLEAN) (SHA512_Update ((SHA512_CTX *) Sha512Context, Data, DataSize));
+  return Sha512UpdateContext ((SHA512_CTX *) Sha512Context, Data, DataSize);
 }
 
 /**
@@ -425,6 +486,9 @@ Sha512HashAll (
   OUT  UINT8       *HashValue
   )
 {
+  SHA512_CTX  Context;
+  BOOLEAN     Status;
+
   //
   // Check input parameters.
   //
@@ -438,9 +502,11 @@ Sha512HashAll (
   //
   // OpenSSL SHA-512 Hash Computation.
   //
-  if (SHA512 (Data, DataSize, HashValue) == NULL) {
+  if (!SHA512_Init (&Context) || !Sha512UpdateContext (&Context, Data, DataSize)) {
     return FALSE;
-  } else {
-    return TRUE;
   }
+  Status = (BOOLEAN) (SHA512_Final (HashValue, &Context));
+  ZeroMem (&Context, sizeof (Context));
+
+  return Status;
 }
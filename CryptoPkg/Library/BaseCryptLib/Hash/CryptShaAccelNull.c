@@ -0,0 +1,82 @@
+/** @file
+  Accelerated SHA block functions Wrapper Implementation which does not provide
+  real capabilities, for the architectures without accelerated block functions.
+
+Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+This program and the accompanying materials
+are licensed and made available under the terms and conditions of the BSD License
+which accompanies this distribution.  The full text of the license may be found at
+http://opensource.org/licenses/bsd-license.php
+
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "InternalCryptLib.h"
+
+/**
+  Digests whole 64-byte blocks into a SHA-1 state.
+
+  Return FALSE to indicate this interface is not supported.
+
+  @param[in, out]  State       The five SHA-1 state words.
+  @param[in]       Data        Pointer to the blocks to digest.
+  @param[in]       BlockCount  Number of 64-byte blocks at Data.
+
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+InternalSha1AccelBlocks (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  )
+{
+  return FALSE;
+}
+
+/**
+  Digests whole 64-byte blocks into a SHA-256 state.
+
+  Return FALSE to indicate this interface is not supported.
+
+  @param[in, out]  State       The eight SHA-256 state words.
+  @param[in]       Data        Pointer to the blocks to digest.
+  @param[in]       BlockCount  Number of 64-byte blocks at Data.
+
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+InternalSha256AccelBlocks (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  )
+{
+  return FALSE;
+}
+
+/**
+  Digests whole 128-byte blocks into a SHA-512 state.
+
+  Return FALSE to indicate this interface is not supported.
+
+  @param[in, out]  State       The eight SHA-512 state words.
+  @param[in]       Data        Pointer to the blocks to digest.
+  @param[in]       BlockCount  Number of 128-byte blocks at Data.
+
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+InternalSha512AccelBlocks (
+  IN OUT UINT64       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  )
+{
+  return FALSE;
+}
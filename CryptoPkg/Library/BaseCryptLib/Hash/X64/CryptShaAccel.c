@@ -0,0 +1,152 @@
+/** @file
+  SHA-1, SHA-256 and SHA-512 block functions dispatched on the CPU features.
+
+Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+This program and the accompanying materials
+are licensed and made available under the terms and conditions of the BSD License
+which accompanies this distribution.  The full text of the license may be found at
+http://opensource.org/licenses/bsd-license.php
+
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "CryptShaAccel.h"
+
+#define CPUID_SIGNATURE                 0x00
+#define CPUID_VERSION_INFO              0x01
+#define CPUID_STRUCTURED_EXTENDED_FLAGS 0x07
+
+#define CPUID_VERSION_INFO_ECX_SSSE3    BIT9
+#define CPUID_VERSION_INFO_ECX_SSE4_1   BIT19
+#define CPUID_EXTENDED_FLAGS_EBX_BMI1   BIT3
+#define CPUID_EXTENDED_FLAGS_EBX_BMI2   BIT8
+#define CPUID_EXTENDED_FLAGS_EBX_SHA    BIT29
+
+/**
+  Detects the CPU features used by the accelerated SHA block functions.
+
+  @return  A combination of SHA_ACCEL_FEATURE_* bits, always including
+           SHA_ACCEL_FEATURE_DETECTED.
+
+**/
+UINT32
+InternalShaAccelDetectFeatures (
+  VOID
+  )
+{
+  UINT32  MaxLeaf;
+  UINT32  VersionEcx;
+  UINT32  ExtendedEbx;
+  UINT32  Features;
+
+  Features = SHA_ACCEL_FEATURE_DETECTED;
+
+  AsmCpuid (CPUID_SIGNATURE, &MaxLeaf, NULL, NULL, NULL);
+  if (MaxLeaf < CPUID_STRUCTURED_EXTENDED_FLAGS) {
+    return Features;
+  }
+  AsmCpuid (CPUID_VERSION_INFO, NULL, NULL, &VersionEcx, NULL);
+  AsmCpuidEx (CPUID_STRUCTURED_EXTENDED_FLAGS, 0, NULL, &ExtendedEbx, NULL, NULL);
+
+  if ((ExtendedEbx & CPUID_EXTENDED_FLAGS_EBX_SHA) != 0 &&
+      (VersionEcx & CPUID_VERSION_INFO_ECX_SSSE3) != 0 &&
+      (VersionEcx & CPUID_VERSION_INFO_ECX_SSE4_1) != 0) {
+    Features |= SHA_ACCEL_FEATURE_SHA_NI;
+  }
+  if ((ExtendedEbx & CPUID_EXTENDED_FLAGS_EBX_BMI1) != 0 &&
+      (ExtendedEbx & CPUID_EXTENDED_FLAGS_EBX_BMI2) != 0) {
+    Features |= SHA_ACCEL_FEATURE_BMI;
+  }
+
+  return Features;
+}
+
+/**
+  Digests whole 64-byte blocks into a SHA-1 state with the fastest block
+  function supported by the CPU.
+
+  @param[in, out]  State       The five SHA-1 state words.
+  @param[in]       Data        Pointer to the blocks to digest.
+  @param[in]       BlockCount  Number of 64-byte blocks at Data.
+
+  @retval TRUE   The blocks were digested.
+  @retval FALSE  No accelerated block function is supported, State is unchanged.
+
+**/
+BOOLEAN
+InternalSha1AccelBlocks (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  )
+{
+  if ((InternalShaAccelGetFeatures () & SHA_ACCEL_FEATURE_SHA_NI) != 0) {
+    InternalSha1BlocksShaNi (State, Data, BlockCount);
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+/**
+  Digests whole 64-byte blocks into a SHA-256 state with the fastest block
+  function supported by the CPU.
+
+  @param[in, out]  State       The eight SHA-256 state words.
+  @param[in]       Data        Pointer to the blocks to digest.
+  @param[in]       BlockCount  Number of 64-byte blocks at Data.
+
+  @retval TRUE   The blocks were digested.
+  @retval FALSE  No accelerated block function is supported, State is unchanged.
+
+**/
+BOOLEAN
+InternalSha256AccelBlocks (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  )
+{
+  UINT32  Features;
+
+  Features = InternalShaAccelGetFeatures ();
+  if ((Features & SHA_ACCEL_FEATURE_SHA_NI) != 0) {
+    InternalSha256BlocksShaNi (State, Data, BlockCount);
+    return TRUE;
+  }
+  if ((Features & SHA_ACCEL_FEATURE_BMI) != 0) {
+    InternalSha256BlocksBmi2 (State, Data, BlockCount);
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+/**
+  Digests whole 128-byte blocks into a SHA-512 state with the fastest block
+  function supported by the CPU.
+
+  @param[in, out]  State       The eight SHA-512 state words.
+  @param[in]       Data        Pointer to the blocks to digest.
+  @param[in]       BlockCount  Number of 128-byte blocks at Data.
+
+  @retval TRUE   The blocks were digested.
+  @retval FALSE  No accelerated block function is supported, State is unchanged.
+
+**/
+BOOLEAN
+InternalSha512AccelBlocks (
+  IN OUT UINT64       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  )
+{
+  if ((InternalShaAccelGetFeatures () & SHA_ACCEL_FEATURE_BMI) != 0) {
+    InternalSha512BlocksBmi2 (State, Data, BlockCount);
+    return TRUE;
+  }
+
+  return FALSE;
+}
@@ -0,0 +1,119 @@
+/** @file
+  Internal include file for the accelerated SHA block functions.
+
+Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+This program and the accompanying materials
+are licensed and made available under the terms and conditions of the BSD License
+which accompanies this distribution.  The full text of the license may be found at
+http://opensource.org/licenses/bsd-license.php
+
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#ifndef __CRYPT_SHA_ACCEL_H__
+#define __CRYPT_SHA_ACCEL_H__
+
+#include "InternalCryptLib.h"
+
+//
+// CPU features the accelerated block functions depend on.
+// SHA_ACCEL_FEATURE_SHA_NI is set when the SHA extensions, SSSE3 and SSE4.1
+// are supported, SHA_ACCEL_FEATURE_BMI when BMI1 and BMI2 are supported.
+//
+#define SHA_ACCEL_FEATURE_SHA_NI    BIT0
+#define SHA_ACCEL_FEATURE_BMI       BIT1
+#define SHA_ACCEL_FEATURE_DETECTED  BIT31
+
+/**
+  Detects the CPU features used by the accelerated SHA block functions.
+
+  @return  A combination of SHA_ACCEL_FEATURE_* bits, always including
+           SHA_ACCEL_FEATURE_DETECTED.
+
+**/
+UINT32
+InternalShaAccelDetectFeatures (
+  VOID
+  );
+
+/**
+  Returns the CPU features used by the accelerated SHA block functions.
+
+  Depending on the library instance, the result of InternalShaAccelDetectFeatures()
+  is cached or the detection is done on each call.
+
+  @return  A combination of SHA_ACCEL_FEATURE_* bits.
+
+**/
+UINT32
+InternalShaAccelGetFeatures (
+  VOID
+  );
+
+/**
+  Digests whole 64-byte blocks into a SHA-1 state using the SHA extensions.
+
+  @param[in, out]  State       The five SHA-1 state words.
+  @param[in]       Data        Pointer to the blocks to digest.
+  @param[in]       BlockCount  Number of 64-byte blocks at Data.
+
+**/
+VOID
+EFIAPI
+InternalSha1BlocksShaNi (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  );
+
+/**
+  Digests whole 64-byte blocks into a SHA-256 state using the SHA extensions.
+
+  @param[in, out]  State       The eight SHA-256 state words.
+  @param[in]       Data        Pointer to the blocks to digest.
+  @param[in]       BlockCount  Number of 64-byte blocks at Data.
+
+**/
+VOID
+EFIAPI
+InternalSha256BlocksShaNi (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  );
+
+/**
+  Digests whole 64-byte blocks into a SHA-256 state using BMI1 and BMI2.
+
+  @param[in, out]  State       The eight SHA-256 state words.
+  @param[in]       Data        Pointer to the blocks to digest.
+  @param[in]       BlockCount  Number of 64-byte blocks at Data.
+
+**/
+VOID
+EFIAPI
+InternalSha256BlocksBmi2 (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  );
+
+/**
+  Digests whole 128-byte blocks into a SHA-512 state using BMI1 and BMI2.
+
+  @param[in, out]  State       The eight SHA-512 state words.
+  @param[in]       Data        Pointer to the blocks to digest.
+  @param[in]       BlockCount  Number of 128-byte blocks at Data.
+
+**/
+VOID
+EFIAPI
+InternalSha512BlocksBmi2 (
+  IN OUT UINT64       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  );
+
+#endif
@@ -0,0 +1,38 @@
+/** @file
+  CPU feature cache of the accelerated SHA block functions, for the library
+  instances that can write global variables.
+
+Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+This program and the accompanying materials
+are licensed and made available under the terms and conditions of the BSD License
+which accompanies this distribution.  The full text of the license may be found at
+http://opensource.org/licenses/bsd-license.php
+
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "CryptShaAccel.h"
+
+UINT32  mShaAccelFeatures = 0;
+
+/**
+  Returns the CPU features used by the accelerated SHA block functions.
+
+  The features are detected on the first call and cached.
+
+  @return  A combination of SHA_ACCEL_FEATURE_* bits.
+
+**/
+UINT32
+InternalShaAccelGetFeatures (
+  VOID
+  )
+{
+  if (mShaAccelFeatures == 0) {
+    mShaAccelFeatures = InternalShaAccelDetectFeatures ();
+  }
+
+  return mShaAccelFeatures;
+}
@@ -0,0 +1,32 @@
+/** @file
+  CPU feature detection of the accelerated SHA block functions, for the PEI
+  library instance that may run from flash and cannot cache the result.
+
+Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+This program and the accompanying materials
+are licensed and made available under the terms and conditions of the BSD License
+which accompanies this distribution.  The full text of the license may be found at
+http://opensource.org/licenses/bsd-license.php
+
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "CryptShaAccel.h"
+
+/**
+  Returns the CPU features used by the accelerated SHA block functions.
+
+  The features are detected on each call.
+
+  @return  A combination of SHA_ACCEL_FEATURE_* bits.
+
+**/
+UINT32
+InternalShaAccelGetFeatures (
+  VOID
+  )
+{
+  return InternalShaAccelDetectFeatures ();
+}
@@ -33,4 +33,245 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #define OBJ_length(o) ((o)->length)
 #endif
 
+/**
+  Digests whole 64-byte blocks into a SHA-1 state with the fastest block
+  function supported by the CPU.
+
+  @param[in, out]  State       The five SHA-1 state words.
+  @param[in]       Data        Pointer to the blocks to digest.
+  @param[in]       BlockCount  Number of 64-byte blocks at Data.
+
+  @retval TRUE   The blocks were digested.
+  @retval FALSE  No accelerated block function is supported, State is unchanged.
+
+**/
+BOOLEAN
+InternalSha1AccelBlocks (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  );
+
+/**
+  Digests whole 64-byte blocks into a SHA-256 state with the fastest block
+  function supported by the CPU.
+
+  @param[in, out]  State       The eight SHA-256 state words.
+  @param[in]       Data        Pointer to the blocks to digest.
+  @param[in]       BlockCount  Number of 64-byte blocks at Data.
+
+  @retval TRUE   The blocks were digested.
+  @retval FALSE  No accelerated block function is supported, State is unchanged.
+
+**/
+BOOLEAN
+InternalSha256AccelBlocks (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  );
+
+/**
+  Digests whole 128-byte blocks into a SHA-512 state with the fastest block
+  function supported by the CPU.
+
+  @param[in, out]  State       The eight SHA-512 state words.
+  @param[in]       Data        Pointer to the blocks to digest.
+  @param[in]       BlockCount  Number of 128-byte blocks at Data.
+
+  @retval TRUE   The blocks were digested.
+  @retval FALSE  No accelerated block function is supported, State is unchanged.
+
+**/
+BOOLEAN
+InternalSha512AccelBlocks (
+  IN OUT UINT64       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  );
+
+//
+// Maximum number of AES rounds, for 256-bit keys.
+//
+#define AES_ACCEL_MAX_ROUNDS  14
+
+//
+// AES key schedule in the layout of the accelerated AES functions: Rounds + 1
+// encryption round keys, and Rounds + 1 decryption round keys for the
+// Equivalent Inverse Cipher, each round key in the byte order of the state.
+// Rounds is zero when no accelerated AES function is supported.
+//
+typedef struct {
+  UINTN  Rounds;
+  UINT8  EncryptKey[(AES_ACCEL_MAX_ROUNDS + 1) * 16];
+  UINT8  DecryptKey[(AES_ACCEL_MAX_ROUNDS + 1) * 16];
+} AES_ACCEL_KEY;
+
+/**
+  Initializes an accelerated AES key schedule from the OpenSSL key schedules.
+
+  @param[out]  AccelKey           The accelerated AES key schedule to initialize.
+  @param[in]   EncryptRoundKeys   The round key words of the OpenSSL encryption
+                                  key schedule.
+  @param[in]   DecryptRoundKeys   The round key words of the OpenSSL decryption
+                                  key schedule, or NULL if AccelKey is only used
+                                  for encryption.
+  @param[in]   Rounds             Number of AES rounds, 10, 12 or 14.
+
+  @retval TRUE   AccelKey was initialized.
+  @retval FALSE  No accelerated AES function is supported, AccelKey->Rounds is
+                 zero.
+
+**/
+BOOLEAN
+InternalAesAccelInit (
+  OUT AES_ACCEL_KEY  *AccelKey,
+  IN  CONST UINT32   *EncryptRoundKeys,
+  IN  CONST UINT32   *DecryptRoundKeys,  OPTIONAL
+  IN  UINTN          Rounds
+  );
+
+/**
+  Encrypts whole 16-byte blocks in ECB mode with the accelerated AES functions.
+
+  @param[in]   AccelKey    The accelerated AES key schedule.
+  @param[in]   Input       Pointer to the blocks to encrypt.
+  @param[in]   BlockCount  Number of 16-byte blocks at Input.
+  @param[out]  Output      Pointer to a buffer that receives the encrypted blocks.
+
+  @retval TRUE   The blocks were encrypted.
+  @retval FALSE  No accelerated AES function is supported, Output is unchanged.
+
+**/
+BOOLEAN
+InternalAesAccelEcbEncrypt (
+  IN  CONST AES_ACCEL_KEY  *AccelKey,
+  IN  CONST UINT8          *Input,
+  IN  UINTN                BlockCount,
+  OUT UINT8                *Output
+  );
+
+/**
+  Decrypts whole 16-byte blocks in ECB mode with the accelerated AES functions.
+
+  @param[in]   AccelKey    The accelerated AES key schedule.
+  @param[in]   Input       Pointer to the blocks to decrypt.
+  @param[in]   BlockCount  Number of 16-byte blocks at Input.
+  @param[out]  Output      Pointer to a buffer that receives the decrypted blocks.
+
+  @retval TRUE   The blocks were decrypted.
+  @retval FALSE  No accelerated AES function is supported, Output is unchanged.
+
+**/
+BOOLEAN
+InternalAesAccelEcbDecrypt (
+  IN  CONST AES_ACCEL_KEY  *AccelKey,
+  IN  CONST UINT8          *Input,
+  IN  UINTN                BlockCount,
+  OUT UINT8                *Output
+  );
+
+/**
+  Encrypts whole 16-byte blocks in CBC mode with the accelerated AES functions.
+
+  @param[in]       AccelKey    The accelerated AES key schedule.
+  @param[in]       Input       Pointer to the blocks to encrypt.
+  @param[in]       BlockCount  Number of 16-byte blocks at Input.
+  @param[in, out]  Ivec        The initialization vector, updated with the last
+                               encrypted block.
+  @param[out]      Output      Pointer to a buffer that receives the encrypted blocks.
+
+  @retval TRUE   The blocks were encrypted.
+  @retval FALSE  No accelerated AES function is supported, Ivec and Output are
+                 unchanged.
+
+**/
+BOOLEAN
+InternalAesAccelCbcEncrypt (
+  IN     CONST AES_ACCEL_KEY  *AccelKey,
+  IN     CONST UINT8          *Input,
+  IN     UINTN                BlockCount,
+  IN OUT UINT8                *Ivec,
+  OUT    UINT8                *Output
+  );
+
+/**
+  Decrypts whole 16-byte blocks in CBC mode with the accelerated AES functions.
+
+  Input and Output may be the same buffer.
+
+  @param[in]       AccelKey    The accelerated AES key schedule.
+  @param[in]       Input       Pointer to the blocks to decrypt.
+  @param[in]       BlockCount  Number of 16-byte blocks at Input.
+  @param[in, out]  Ivec        The initialization vector, updated with the last
+                               block of Input.
+  @param[out]      Output      Pointer to a buffer that receives the decrypted blocks.
+
+  @retval TRUE   The blocks were decrypted.
+  @retval FALSE  No accelerated AES function is supported, Ivec and Output are
+                 unchanged.
+
+**/
+BOOLEAN
+InternalAesAccelCbcDecrypt (
+  IN     CONST AES_ACCEL_KEY  *AccelKey,
+  IN     CONST UINT8          *Input,
+  IN     UINTN                BlockCount,
+  IN OUT UINT8                *Ivec,
+  OUT    UINT8                *Output
+  );
+
+/**
+  Encrypts or decrypts whole 16-byte blocks in CTR mode with the accelerated
+  AES functions, incrementing only the last 32 bits of the counter block.
+
+  @param[in]       AccelKey    The accelerated AES key schedule.
+  @param[in]       Input       Pointer to the blocks to encrypt or decrypt.
+  @param[in]       BlockCount  Number of 16-byte blocks at Input.
+  @param[in, out]  Counter     The counter block of the first block, updated
+                               with the counter block following the last one.
+                               Its last four bytes are a big endian counter,
+                               incremented modulo 2^32.
+  @param[out]      Output      Pointer to a buffer that receives the result.
+
+  @retval TRUE   The blocks were processed.
+  @retval FALSE  No accelerated AES function is supported, Counter and Output
+                 are unchanged.
+
+**/
+BOOLEAN
+InternalAesAccelCtr32Encrypt (
+  IN     CONST AES_ACCEL_KEY  *AccelKey,
+  IN     CONST UINT8          *Input,
+  IN     UINTN                BlockCount,
+  IN OUT UINT8                *Counter,
+  OUT    UINT8                *Output
+  );
+
+/**
+  Digests whole 16-byte blocks into a GHASH value with the accelerated GHASH
+  function.
+
+  The accelerated GHASH function is supported whenever InternalAesAccelInit()
+  succeeds.
+
+  @param[in, out]  Hash        The 16-byte GHASH value.
+  @param[in]       HashKey     The 16-byte GHASH key, the encryption of the
+                               zero block.
+  @param[in]       Data        Pointer to the blocks to digest.
+  @param[in]       BlockCount  Number of 16-byte blocks at Data.
+
+  @retval TRUE   The blocks were digested.
+  @retval FALSE  The accelerated GHASH function is not supported, Hash is
+                 unchanged.
+
+**/
+BOOLEAN
+InternalGhashAccelBlocks (
+  IN OUT UINT8        *Hash,
+  IN     CONST UINT8  *HashKey,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  );
+
 #endif
@@ -6,10 +6,10 @@
   This external input must be validated carefully to avoid security issue like
   buffer overflow, integer overflow.
 
-  AuthenticodeVerify() will get PE/COFF Authenticode and will do basic check for
-  data structure.
+  AuthenticodeVerify() and AuthenticodeVerifyWithContext() will get PE/COFF
+  Authenticode and will do basic check for data structure.
 
-Copyright (c) 2011 - 2015, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2011 - 2017, Intel Corporation. All rights reserved.<BR>
 This program and the accompanying materials
 are licensed and made available under the terms and conditions of the BSD License
 which accompanies this distribution.  The full text of the license may be found at
@@ -34,80 +34,59 @@ UINT8 mSpcIndirectOidValue[] = {
   };
 
 /**
-  Verifies the validity of a PE/COFF Authenticode Signature as described in "Windows
-  Authenticode Portable Executable Signature Format".
-
-  If AuthData is NULL, then return FALSE.
-  If ImageHash is NULL, then return FALSE.
+  Retrieves the SpcIndirectDataContent of a PE/COFF Authenticode Signature and
+  checks the image hash value it holds.
 
   Caution: This function may receive untrusted input.
   PE/COFF Authenticode is external input, so this function will do basic check for
   Authenticode data structure.
 
-  @param[in]  AuthData     Pointer to the Authenticode Signature retrieved from signed
-                           PE/COFF image to be verified.
-  @param[in]  DataSize     Size of the Authenticode Signature in bytes.
-  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER, which
-                           is used for certificate chain verification.
-  @param[in]  CertSize     Size of the trusted certificate in bytes.
-  @param[in]  ImageHash    Pointer to the original image file hash value. The procedure
-                           for calculating the image hash value is described in Authenticode
-                           specification.
-  @param[in]  HashSize     Size of Image hash value in bytes.
+  @param[in]   AuthData     Pointer to the Authenticode Signature retrieved from signed
+                            PE/COFF image to be verified.
+  @param[in]   DataSize     Size of the Authenticode Signature in bytes.
+  @param[in]   ImageHash    Pointer to the original image file hash value.
+  @param[in]   HashSize     Size of Image hash value in bytes.
+  @param[out]  Pkcs7        The parsed PKCS#7 signed data, which holds the
+                            SpcIndirectDataContent. It must be released with
+                            PKCS7_free(), also when the function fails.
+  @param[out]  Content      Pointer to the SpcIndirectDataContent.
+  @param[out]  ContentSize  Size of the SpcIndirectDataContent in bytes.
 
-  @retval  TRUE   The specified Authenticode Signature is valid.
-  @retval  FALSE  Invalid Authenticode Signature.
+  @retval  TRUE   The image hash value matches the Authenticode Signature.
+  @retval  FALSE  Invalid Authenticode Signature, or un-matched image hash value.
 
 **/
+STATIC
 BOOLEAN
-EFIAPI
-AuthenticodeVerify (
+AuthenticodeGetSpcIndirectData (
   IN  CONST UINT8  *AuthData,
   IN  UINTN        DataSize,
-  IN  CONST UINT8  *TrustedCert,
-  IN  UINTN        CertSize,
   IN  CONST UINT8  *ImageHash,
-  IN  UINTN        HashSize
+  IN  UINTN        HashSize,
+  OUT PKCS7        **Pkcs7,
+  OUT UINT8        **Content,
+  OUT UINTN        *ContentSize
   )
 {
-  BOOLEAN      Status;
-  PKCS7        *Pkcs7;
   CONST UINT8  *Temp;
-  CONST UINT8  *OrigAuthData;
   UINT8        *SpcIndirectDataContent;
   UINT8        Asn1Byte;
-  UINTN        ContentSize;
   CONST UINT8  *SpcIndirectDataOid;
 
-  //
-  // Check input parameters.
-  //
-  if ((AuthData == NULL) || (TrustedCert == NULL) || (ImageHash == NULL)) {
-    return FALSE;
-  }
-
-  if ((DataSize > INT_MAX) || (CertSize > INT_MAX) || (HashSize > INT_MAX)) {
-    return FALSE;
-  }
-
-  Status       = FALSE;
-  Pkcs7        = NULL;
-  OrigAuthData = AuthData;
-
   //
   // Retrieve & Parse PKCS#7 Data (DER encoding) from Authenticode Signature
   //
-  Temp  = AuthData;
-  Pkcs7 = d2i_PKCS7 (NULL, &Temp, (int)DataSize);
-  if (Pkcs7 == NULL) {
-    goto _Exit;
+  Temp   = AuthData;
+  *Pkcs7 = d2i_PKCS7 (NULL, &Temp, (int)DataSize);
+  if (*Pkcs7 == NULL) {
+    return FALSE;
   }
 
   //
   // Check if it's PKCS#7 Signed Data (for Authenticode Scenario)
   //
-  if (!PKCS7_type_is_signed (Pkcs7)) {
-    goto _Exit;
+  if (!PKCS7_type_is_signed (*Pkcs7)) {
+    return FALSE;
   }
 
   //
@@ -115,8 +94,8 @@ AuthenticodeVerify (
   //       some authenticode-specific structure. Use opaque ASN.1 string to retrieve
   //       PKCS#7 ContentInfo here.
   //
-  SpcIndirectDataOid = OBJ_get0_data(Pkcs7->d.sign->contents->type);
-  if (OBJ_length(Pkcs7->d.sign->contents->type) != sizeof(mSpcIndirectOidValue) ||
+  SpcIndirectDataOid = OBJ_get0_data((*Pkcs7)->d.sign->contents->type);
+  if (OBJ_length((*Pkcs7)->d.sign->contents->type) != sizeof(mSpcIndirectOidValue) ||
       CompareMem (
         SpcIndirectDataOid,
         mSpcIndirectOidValue,
@@ -125,11 +104,11 @@ AuthenticodeVerify (
     //
     // Un-matched SPC_INDIRECT_DATA_OBJID.
     //
-    goto _Exit;
+    return FALSE;
   }
 
 
-  SpcIndirectDataContent = (UINT8 *)(Pkcs7->d.sign->contents->d.other->value.asn1_string->data);
+  SpcIndirectDataContent = (UINT8 *)((*Pkcs7)->d.sign->contents->d.other->value.asn1_string->data);
 
   //
   // Retrieve the SEQUENCE data size from ASN.1-encoded SpcIndirectDataContent.
@@ -140,7 +119,7 @@ AuthenticodeVerify (
     //
     // Short Form of Length Encoding (Length < 128)
     //
-    ContentSize = (UINTN) (Asn1Byte & 0x7F);
+    *ContentSize = (UINTN) (Asn1Byte & 0x7F);
     //
     // Skip the SEQUENCE Tag;
     //
@@ -150,7 +129,7 @@ AuthenticodeVerify (
     //
     // Long Form of Length Encoding (128 <= Length < 255, Single Octet)
     //
-    ContentSize = (UINTN) (*(UINT8 *)(SpcIndirectDataContent + 2));
+    *ContentSize = (UINTN) (*(UINT8 *)(SpcIndirectDataContent + 2));
     //
     // Skip the SEQUENCE Tag;
     //
@@ -160,15 +139,15 @@ AuthenticodeVerify (
     //
     // Long Form of Length Encoding (Length > 255, Two Octet)
     //
-    ContentSize = (UINTN) (*(UINT8 *)(SpcIndirectDataContent + 2));
-    ContentSize = (ContentSize << 8) + (UINTN)(*(UINT8 *)(SpcIndirectDataContent + 3));
+    *ContentSize = (UINTN) (*(UINT8 *)(SpcIndirectDataContent + 2));
+    *ContentSize = (*ContentSize << 8) + (UINTN)(*(UINT8 *)(SpcIndirectDataContent + 3));
     //
     // Skip the SEQUENCE Tag;
     //
     SpcIndirectDataContent += 4;
 
   } else {
-    goto _Exit;
+    return FALSE;
   }
 
   //
@@ -176,19 +155,80 @@ AuthenticodeVerify (
   // defined in Authenticode
   // NOTE: Need to double-check HashLength here!
   //
-  if (CompareMem (SpcIndirectDataContent + ContentSize - HashSize, ImageHash, HashSize) != 0) {
+  if (CompareMem (SpcIndirectDataContent + *ContentSize - HashSize, ImageHash, HashSize) != 0) {
     //
     // Un-matched PE/COFF Hash Value
     //
-    goto _Exit;
+    return FALSE;
   }
 
+  *Content = SpcIndirectDataContent;
+  return TRUE;
+}
+
+/**
+  Verifies the validity of a PE/COFF Authenticode Signature as described in "Windows
+  Authenticode Portable Executable Signature Format".
+
+  If AuthData is NULL, then return FALSE.
+  If ImageHash is NULL, then return FALSE.
+
+  Caution: This function may receive untrusted input.
+  PE/COFF Authenticode is external input, so this function will do basic check for
+  Authenticode data structure.
+
+  @param[in]  AuthData     Pointer to the Authenticode Signature retrieved from signed
+                           PE/COFF image to be verified.
+  @param[in]  DataSize     Size of the Authenticode Signature in bytes.
+  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER, which
+                           is used for certificate chain verification.
+  @param[in]  CertSize     Size of the trusted certificate in bytes.
+  @param[in]  ImageHash    Pointer to the original image file hash value. The procedure
+                           for calculating the image hash value is described in Authenticode
+                           specification.
+  @param[in]  HashSize     Size of Image hash value in bytes.
+
+  @retval  TRUE   The specified Authenticode Signature is valid.
+  @retval  FALSE  Invalid Authenticode Signature.
+
+**/
+BOOLEAN
+EFIAPI
+AuthenticodeVerify (
+  IN  CONST UINT8  *AuthData,
+  IN  UINTN        DataSize,
+  IN  CONST UINT8  *TrustedCert,
+  IN  UINTN        CertSize,
+  IN  CONST UINT8  *ImageHash,
+  IN  UINTN        HashSize
+  )
+{
+  BOOLEAN      Status;
+  PKCS7        *Pkcs7;
+  UINT8        *SpcIndirectDataContent;
+  UINTN        ContentSize;
+
   //
-  // Verifies the PKCS#7 Signed Data in PE/COFF Authenticode Signature
+  // Check input parameters.
   //
-  Status = (BOOLEAN) Pkcs7Verify (OrigAuthData, DataSize, TrustedCert, CertSize, SpcIndirectDataContent, ContentSize);
+  if ((AuthData == NULL) || (TrustedCert == NULL) || (ImageHash == NULL)) {
+    return FALSE;
+  }
+
+  if ((DataSize > INT_MAX) || (CertSize > INT_MAX) || (HashSize > INT_MAX)) {
+    return FALSE;
+  }
+
+  Status = FALSE;
+  Pkcs7  = NULL;
+
+  if (AuthenticodeGetSpcIndirectData (AuthData, DataSize, ImageHash, HashSize, &Pkcs7, &SpcIndirectDataContent, &ContentSize)) {
+    //
+    // Verifies the PKCS#7 Signed Data in PE/COFF Authenticode Signature
+    //
+    Status = (BOOLEAN) Pkcs7Verify (AuthData, DataSize, TrustedCert, CertSize, SpcIndirectDataContent, ContentSize);
+  }
 
-_Exit:
   //
   // Release Resources
   //
@@ -196,3 +236,76 @@ _Exit:
 
   return Status;
 }
+
+/**
+  Verifies the validity of a PE/COFF Authenticode Signature as described in "Windows
+  Authenticode Portable Executable Signature Format", with the trusted certificates
+  of a PKCS#7 verification context.
+
+  The result is the same as calling AuthenticodeVerify() with each trusted
+  certificate of the context in turn, but the signature is parsed only once.
+
+  If Pkcs7VerifyContext, AuthData or ImageHash is NULL, then return FALSE.
+
+  Caution: This function may receive untrusted input.
+  PE/COFF Authenticode is external input, so this function will do basic check for
+  Authenticode data structure.
+
+  @param[in]   Pkcs7VerifyContext  Pointer to the PKCS#7 verification context.
+  @param[in]   AuthData            Pointer to the Authenticode Signature retrieved from
+                                   signed PE/COFF image to be verified.
+  @param[in]   DataSize            Size of the Authenticode Signature in bytes.
+  @param[in]   ImageHash           Pointer to the original image file hash value.
+  @param[in]   HashSize            Size of Image hash value in bytes.
+  @param[out]  CertIndex           Number of the first trusted certificate which
+                                   verifies the signature. It is optional.
+
+  @retval  TRUE   The specified Authenticode Signature is valid.
+  @retval  FALSE  Invalid Authenticode Signature.
+
+**/
+BOOLEAN
+EFIAPI
+AuthenticodeVerifyWithContext (
+  IN  VOID         *Pkcs7VerifyContext,
+  IN  CONST UINT8  *AuthData,
+  IN  UINTN        DataSize,
+  IN  CONST UINT8  *ImageHash,
+  IN  UINTN        HashSize,
+  OUT UINTN        *CertIndex  OPTIONAL
+  )
+{
+  BOOLEAN      Status;
+  PKCS7        *Pkcs7;
+  UINT8        *SpcIndirectDataContent;
+  UINTN        ContentSize;
+
+  //
+  // Check input parameters.
+  //
+  if ((Pkcs7VerifyContext == NULL) || (AuthData == NULL) || (ImageHash == NULL)) {
+    return FALSE;
+  }
+
+  if ((DataSize > INT_MAX) || (HashSize > INT_MAX)) {
+    return FALSE;
+  }
+
+  Status = FALSE;
+  Pkcs7  = NULL;
+
+  if (AuthenticodeGetSpcIndirectData (AuthData, DataSize, ImageHash, HashSize, &Pkcs7, &SpcIndirectDataContent, &ContentSize)) {
+    Status = Pkcs7VerifyWithContext (
+               Pkcs7VerifyContext,
+               AuthData,
+               DataSize,
+               SpcIndirectDataContent,
+               ContentSize,
+               CertIndex
+               );
+  }
+
+  PKCS7_free (Pkcs7);
+
+  return Status;
+}
@@ -2,7 +2,7 @@
   Authenticode Portable Executable Signature Verification which does not provide
   real capabilities.
 
-Copyright (c) 2012, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2012 - 2017, Intel Corporation. All rights reserved.<BR>
 This program and the accompanying materials
 are licensed and made available under the terms and conditions of the BSD License
 which accompanies this distribution.  The full text of the license may be found at
@@ -49,3 +49,36 @@ AuthenticodeVerify (
   ASSERT (FALSE);
   return FALSE;
 }
+
+/**
+  Verifies the validity of a PE/COFF Authenticode Signature with the trusted
+  certificates of a PKCS#7 verification context.
+
+  Return FALSE to indicate this interface is not supported.
+
+  @param[in]   Pkcs7VerifyContext  Pointer to the PKCS#7 verification context.
+  @param[in]   AuthData            Pointer to the Authenticode Signature retrieved from
+                                   signed PE/COFF image to be verified.
+  @param[in]   DataSize            Size of the Authenticode Signature in bytes.
+  @param[in]   ImageHash           Pointer to the original image file hash value.
+  @param[in]   HashSize            Size of Image hash value in bytes.
+  @param[out]  CertIndex           Number of the first trusted certificate which
+                                   verifies the signature. It is optional.
+
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+AuthenticodeVerifyWithContext (
+  IN  VOID         *Pkcs7VerifyContext,
+  IN  CONST UINT8  *AuthData,
+  IN  UINTN        DataSize,
+  IN  CONST UINT8  *ImageHash,
+  IN  UINTN        HashSize,
+  OUT UINTN        *CertIndex  OPTIONAL
+  )
+{
+  ASSERT (FALSE);
+  return FALSE;
+}
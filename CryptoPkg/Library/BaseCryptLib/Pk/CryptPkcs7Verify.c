@@ -27,6 +27,7 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include <openssl/x509.h>
 #include <openssl/x509v3.h>
 #include <openssl/pkcs7.h>
+#include <openssl/err.h>
 
 UINT8 mOidValue[9] = { 0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x07, 0x02 };
 
@@ -735,67 +736,28 @@ _Error:
   return Status;
 }
 
-/**
-  Verifies the validity of a PKCS#7 signed data as described in "PKCS #7:
-  Cryptographic Message Syntax Standard". The input signed data could be wrapped
-  in a ContentInfo structure.
-
-  If P7Data, TrustedCert or InData is NULL, then return FALSE.
-  If P7Length, CertLength or DataLength overflow, then return FALSE.
-
-  Caution: This function may receive untrusted input.
-  UEFI Authenticated Variable is external input, so this function will do basic
-  check for PKCS#7 data structure.
+//
+// Trusted certificates of a PKCS#7 verification context. Each certificate is in
+// its own X509 store, so that the signed data is verified with each certificate
+// on its own, as Pkcs7Verify() does.
+//
+typedef struct {
+  UINTN       CertCount;
+  X509_STORE  **CertStores;
+} PKCS7_VERIFY_CONTEXT;
 
-  @param[in]  P7Data       Pointer to the PKCS#7 message to verify.
-  @param[in]  P7Length     Length of the PKCS#7 message in bytes.
-  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER, which
-                           is used for certificate chain verification.
-  @param[in]  CertLength   Length of the trusted certificate in bytes.
-  @param[in]  InData       Pointer to the content to be verified.
-  @param[in]  DataLength   Length of InData in bytes.
+/**
+  Register & Initialize necessary digest algorithms for PKCS#7 Handling.
 
-  @retval  TRUE  The specified PKCS#7 signed data is valid.
-  @retval  FALSE Invalid PKCS#7 signed data.
+  @retval  TRUE   The digest algorithms are registered.
+  @retval  FALSE  The registration failed.
 
 **/
 BOOLEAN
-EFIAPI
-Pkcs7Verify (
-  IN  CONST UINT8  *P7Data,
-  IN  UINTN        P7Length,
-  IN  CONST UINT8  *TrustedCert,
-  IN  UINTN        CertLength,
-  IN  CONST UINT8  *InData,
-  IN  UINTN        DataLength
+Pkcs7AddDigests (
+  VOID
   )
 {
-  PKCS7       *Pkcs7;
-  BIO         *DataBio;
-  BOOLEAN     Status;
-  X509        *Cert;
-  X509_STORE  *CertStore;
-  UINT8       *SignedData;
-  CONST UINT8 *Temp;
-  UINTN       SignedDataSize;
-  BOOLEAN     Wrapped;
-
-  //
-  // Check input parameters.
-  //
-  if (P7Data == NULL || TrustedCert == NULL || InData == NULL ||
-    P7Length > INT_MAX || CertLength > INT_MAX || DataLength > INT_MAX) {
-    return FALSE;
-  }
-
-  Pkcs7     = NULL;
-  DataBio   = NULL;
-  Cert      = NULL;
-  CertStore = NULL;
-
-  //
-  // Register & Initialize necessary digest algorithms for PKCS#7 Handling
-  //
   if (EVP_add_digest (EVP_md5 ()) == 0) {
     return FALSE;
   }
@@ -815,12 +777,40 @@ Pkcs7Verify (
     return FALSE;
   }
 
-  Status = WrapPkcs7Data (P7Data, P7Length, &Wrapped, &SignedData, &SignedDataSize);
-  if (!Status) {
-    return Status;
+  return TRUE;
+}
+
+/**
+  Construct a PKCS#7 signed data from its DER encoding. The input signed data
+  could be wrapped in a ContentInfo structure.
+
+  Caution: This function may receive untrusted input.
+  UEFI Authenticated Variable is external input, so this function will do basic
+  check for PKCS#7 data structure.
+
+  @param[in]  P7Data       Pointer to the PKCS#7 message.
+  @param[in]  P7Length     Length of the PKCS#7 message in bytes.
+
+  @return  The PKCS#7 signed data, or NULL if P7Data is not a signed data.
+
+**/
+PKCS7 *
+Pkcs7ParseSignedData (
+  IN  CONST UINT8  *P7Data,
+  IN  UINTN        P7Length
+  )
+{
+  PKCS7        *Pkcs7;
+  UINT8        *SignedData;
+  CONST UINT8  *Temp;
+  UINTN        SignedDataSize;
+  BOOLEAN      Wrapped;
+
+  if (!WrapPkcs7Data (P7Data, P7Length, &Wrapped, &SignedData, &SignedDataSize)) {
+    return NULL;
   }
 
-  Status = FALSE;
+  Pkcs7 = NULL;
 
   //
   // Retrieve PKCS#7 Data (DER encoding)
@@ -839,74 +829,382 @@ Pkcs7Verify (
   // Check if it's PKCS#7 Signed Data (for Authenticode Scenario)
   //
   if (!PKCS7_type_is_signed (Pkcs7)) {
-    goto _Exit;
+    PKCS7_free (Pkcs7);
+    Pkcs7 = NULL;
+  }
+
+_Exit:
+  if (!Wrapped) {
+    OPENSSL_free (SignedData);
   }
 
+  return Pkcs7;
+}
+
+/**
+  Construct a X509 store holding one trusted certificate.
+
+  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER.
+  @param[in]  CertLength   Length of the trusted certificate in bytes.
+
+  @return  The X509 store, or NULL if the certificate cannot be parsed.
+
+**/
+X509_STORE *
+Pkcs7NewCertStore (
+  IN  CONST UINT8  *TrustedCert,
+  IN  UINTN        CertLength
+  )
+{
+  X509         *Cert;
+  X509_STORE   *CertStore;
+  CONST UINT8  *Temp;
+
   //
   // Read DER-encoded root certificate and Construct X509 Certificate
   //
   Temp = TrustedCert;
   Cert = d2i_X509 (NULL, &Temp, (long) CertLength);
   if (Cert == NULL) {
-    goto _Exit;
+    return NULL;
   }
 
   //
   // Setup X509 Store for trusted certificate
   //
   CertStore = X509_STORE_new ();
-  if (CertStore == NULL) {
-    goto _Exit;
-  }
-  if (!(X509_STORE_add_cert (CertStore, Cert))) {
-    goto _Exit;
+  if (CertStore != NULL) {
+    if (!(X509_STORE_add_cert (CertStore, Cert))) {
+      X509_STORE_free (CertStore);
+      CertStore = NULL;
+    } else {
+      //
+      // Allow partial certificate chains, terminated by a non-self-signed but
+      // still trusted intermediate certificate. Also disable time checks.
+      //
+      X509_STORE_set_flags (CertStore,
+                            X509_V_FLAG_PARTIAL_CHAIN | X509_V_FLAG_NO_CHECK_TIME);
+
+      //
+      // OpenSSL PKCS7 Verification by default checks for SMIME (email signing) and
+      // doesn't support the extended key usage for Authenticode Code Signing.
+      // Bypass the certificate purpose checking by enabling any purposes setting.
+      //
+      X509_STORE_set_purpose (CertStore, X509_PURPOSE_ANY);
+    }
   }
 
+  //
+  // The store holds its own reference to the certificate.
+  //
+  X509_free (Cert);
+  return CertStore;
+}
+
+/**
+  Verifies a PKCS#7 signed data with the trusted certificate of a X509 store.
+
+  @param[in]  Pkcs7        The PKCS#7 signed data.
+  @param[in]  CertStore    The X509 store of the trusted certificate.
+  @param[in]  InData       Pointer to the content to be verified.
+  @param[in]  DataLength   Length of InData in bytes.
+
+  @retval  TRUE  The specified PKCS#7 signed data is valid.
+  @retval  FALSE Invalid PKCS#7 signed data.
+
+**/
+BOOLEAN
+Pkcs7VerifyWithCertStore (
+  IN  PKCS7        *Pkcs7,
+  IN  X509_STORE   *CertStore,
+  IN  CONST UINT8  *InData,
+  IN  UINTN        DataLength
+  )
+{
+  BIO          *DataBio;
+  BOOLEAN      Status;
+
   //
   // For generic PKCS#7 handling, InData may be NULL if the content is present
   // in PKCS#7 structure. So ignore NULL checking here.
   //
   DataBio = BIO_new (BIO_s_mem ());
   if (DataBio == NULL) {
-    goto _Exit;
+    return FALSE;
   }
 
-  if (BIO_write (DataBio, InData, (int) DataLength) <= 0) {
-    goto _Exit;
+  Status = FALSE;
+  if (BIO_write (DataBio, InData, (int) DataLength) > 0) {
+    //
+    // Verifies the PKCS#7 signedData structure
+    //
+    Status = (BOOLEAN) PKCS7_verify (Pkcs7, NULL, CertStore, DataBio, NULL, PKCS7_BINARY);
   }
 
-  //
-  // Allow partial certificate chains, terminated by a non-self-signed but
-  // still trusted intermediate certificate. Also disable time checks.
-  //
-  X509_STORE_set_flags (CertStore,
-                        X509_V_FLAG_PARTIAL_CHAIN | X509_V_FLAG_NO_CHECK_TIME);
+  BIO_free (DataBio);
+  return Status;
+}
 
-  //
-  // OpenSSL PKCS7 Verification by default checks for SMIME (email signing) and
-  // doesn't support the extended key usage for Authenticode Code Signing.
-  // Bypass the certificate purpose checking by enabling any purposes setting.
-  //
-  X509_STORE_set_purpose (CertStore, X509_PURPOSE_ANY);
+/**
+  Verifies the validity of a PKCS#7 signed data as described in "PKCS #7:
+  Cryptographic Message Syntax Standard". The input signed data could be wrapped
+  in a ContentInfo structure.
+
+  If P7Data, TrustedCert or InData is NULL, then return FALSE.
+  If P7Length, CertLength or DataLength overflow, then return FALSE.
+
+  Caution: This function may receive untrusted input.
+  UEFI Authenticated Variable is external input, so this function will do basic
+  check for PKCS#7 data structure.
+
+  @param[in]  P7Data       Pointer to the PKCS#7 message to verify.
+  @param[in]  P7Length     Length of the PKCS#7 message in bytes.
+  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER, which
+                           is used for certificate chain verification.
+  @param[in]  CertLength   Length of the trusted certificate in bytes.
+  @param[in]  InData       Pointer to the content to be verified.
+  @param[in]  DataLength   Length of InData in bytes.
+
+  @retval  TRUE  The specified PKCS#7 signed data is valid.
+  @retval  FALSE Invalid PKCS#7 signed data.
+
+**/
+BOOLEAN
+EFIAPI
+Pkcs7Verify (
+  IN  CONST UINT8  *P7Data,
+  IN  UINTN        P7Length,
+  IN  CONST UINT8  *TrustedCert,
+  IN  UINTN        CertLength,
+  IN  CONST UINT8  *InData,
+  IN  UINTN        DataLength
+  )
+{
+  PKCS7       *Pkcs7;
+  BOOLEAN     Status;
+  X509_STORE  *CertStore;
 
   //
-  // Verifies the PKCS#7 signedData structure
+  // Check input parameters.
   //
-  Status = (BOOLEAN) PKCS7_verify (Pkcs7, NULL, CertStore, DataBio, NULL, PKCS7_BINARY);
+  if (P7Data == NULL || TrustedCert == NULL || InData == NULL ||
+    P7Length > INT_MAX || CertLength > INT_MAX || DataLength > INT_MAX) {
+    return FALSE;
+  }
+
+  if (!Pkcs7AddDigests ()) {
+    return FALSE;
+  }
+
+  Pkcs7 = Pkcs7ParseSignedData (P7Data, P7Length);
+  if (Pkcs7 == NULL) {
+    return FALSE;
+  }
+
+  Status    = FALSE;
+  CertStore = Pkcs7NewCertStore (TrustedCert, CertLength);
+  if (CertStore != NULL) {
+    Status = Pkcs7VerifyWithCertStore (Pkcs7, CertStore, InData, DataLength);
+  }
 
-_Exit:
   //
   // Release Resources
   //
-  BIO_free (DataBio);
-  X509_free (Cert);
   X509_STORE_free (CertStore);
   PKCS7_free (Pkcs7);
 
-  if (!Wrapped) {
-    OPENSSL_free (SignedData);
+  return Status;
+}
+
+/**
+  Allocates and initializes a PKCS#7 verification context, which holds trusted
+  certificates parsed once for many Pkcs7VerifyWithContext() and
+  AuthenticodeVerifyWithContext() calls.
+
+  @return  Pointer to the PKCS#7 verification context that has been initialized.
+           If the allocations fails, Pkcs7VerifyContextNew() returns NULL.
+
+**/
+VOID *
+EFIAPI
+Pkcs7VerifyContextNew (
+  VOID
+  )
+{
+  PKCS7_VERIFY_CONTEXT  *Context;
+
+  Context = malloc (sizeof (PKCS7_VERIFY_CONTEXT));
+  if (Context != NULL) {
+    Context->CertCount  = 0;
+    Context->CertStores = NULL;
+  }
+
+  return (VOID *) Context;
+}
+
+/**
+  Release the specified PKCS#7 verification context.
+
+  @param[in]  Pkcs7VerifyContext  Pointer to the PKCS#7 verification context to be released.
+
+**/
+VOID
+EFIAPI
+Pkcs7VerifyContextFree (
+  IN  VOID         *Pkcs7VerifyContext
+  )
+{
+  PKCS7_VERIFY_CONTEXT  *Context;
+  UINTN                 Index;
+
+  Context = (PKCS7_VERIFY_CONTEXT *) Pkcs7VerifyContext;
+  if (Context == NULL) {
+    return;
+  }
+
+  for (Index = 0; Index < Context->CertCount; Index++) {
+    X509_STORE_free (Context->CertStores[Index]);
   }
+  if (Context->CertStores != NULL) {
+    free (Context->CertStores);
+  }
+  free (Context);
+}
+
+/**
+  Adds a trusted certificate to a PKCS#7 verification context. The certificates
+  are numbered from 0 in the order they are added.
 
+  If Pkcs7VerifyContext or TrustedCert is NULL, then return FALSE.
+  If CertLength overflow, then return FALSE.
+
+  @param[in, out]  Pkcs7VerifyContext  Pointer to the PKCS#7 verification context.
+  @param[in]       TrustedCert         Pointer to a trusted/root certificate encoded in
+                                       DER, which is used for certificate chain verification.
+  @param[in]       CertLength          Length of the trusted certificate in bytes.
+
+  @retval  TRUE   The certificate is added to the context.
+  @retval  FALSE  The certificate is not correctly formatted, or there is not enough memory.
+
+**/
+BOOLEAN
+EFIAPI
+Pkcs7VerifyContextAddCert (
+  IN OUT  VOID         *Pkcs7VerifyContext,
+  IN      CONST UINT8  *TrustedCert,
+  IN      UINTN        CertLength
+  )
+{
+  PKCS7_VERIFY_CONTEXT  *Context;
+  X509_STORE            *CertStore;
+  X509_STORE            **CertStores;
+
+  Context = (PKCS7_VERIFY_CONTEXT *) Pkcs7VerifyContext;
+  if (Context == NULL || TrustedCert == NULL || CertLength > INT_MAX) {
+    return FALSE;
+  }
+
+  CertStore = Pkcs7NewCertStore (TrustedCert, CertLength);
+  if (CertStore == NULL) {
+    return FALSE;
+  }
+
+  CertStores = realloc (Context->CertStores, (Context->CertCount + 1) * sizeof (X509_STORE *));
+  if (CertStores == NULL) {
+    X509_STORE_free (CertStore);
+    return FALSE;
+  }
+
+  CertStores[Context->CertCount] = CertStore;
+  Context->CertStores = CertStores;
+  Context->CertCount++;
+
+  return TRUE;
+}
+
+/**
+  Verifies the validity of a PKCS#7 signed data as described in "PKCS #7:
+  Cryptographic Message Syntax Standard" with the trusted certificates of a
+  PKCS#7 verification context. The input signed data could be wrapped in a
+  ContentInfo structure.
+
+  The result is the same as calling Pkcs7Verify() with each trusted certificate
+  of the context in turn, but the signed data is parsed only once.
+
+  If Pkcs7VerifyContext, P7Data or InData is NULL, then return FALSE.
+  If P7Length or DataLength overflow, then return FALSE.
+
+  Caution: This function may receive untrusted input.
+  UEFI Authenticated Variable is external input, so this function will do basic
+  check for PKCS#7 data structure.
+
+  @param[in]   Pkcs7VerifyContext  Pointer to the PKCS#7 verification context.
+  @param[in]   P7Data              Pointer to the PKCS#7 message to verify.
+  @param[in]   P7Length            Length of the PKCS#7 message in bytes.
+  @param[in]   InData              Pointer to the content to be verified.
+  @param[in]   DataLength          Length of InData in bytes.
+  @param[out]  CertIndex           Number of the first trusted certificate which
+                                   verifies the signed data. It is optional.
+
+  @retval  TRUE  The specified PKCS#7 signed data is valid.
+  @retval  FALSE Invalid PKCS#7 signed data.
+
+**/
+BOOLEAN
+EFIAPI
+Pkcs7VerifyWithContext (
+  IN  VOID         *Pkcs7VerifyContext,
+  IN  CONST UINT8  *P7Data,
+  IN  UINTN        P7Length,
+  IN  CONST UINT8  *InData,
+  IN  UINTN        DataLength,
+  OUT UINTN        *CertIndex  OPTIONAL
+  )
+{
+  PKCS7_VERIFY_CONTEXT  *Context;
+  PKCS7                 *Pkcs7;
+  BOOLEAN               Status;
+  UINTN                 Index;
+
+  //
+  // Check input parameters.
+  //
+  Context = (PKCS7_VERIFY_CONTEXT *) Pkcs7VerifyContext;
+  if (Context == NULL || P7Data == NULL || InData == NULL ||
+    P7Length > INT_MAX || DataLength > INT_MAX) {
+    return FALSE;
+  }
+
+  if (Context->CertCount == 0) {
+    return FALSE;
+  }
+
+  if (!Pkcs7AddDigests ()) {
+    return FALSE;
+  }
+
+  Pkcs7 = Pkcs7ParseSignedData (P7Data, P7Length);
+  if (Pkcs7 == NULL) {
+    return FALSE;
+  }
+
+  Status = FALSE;
+  for (Index = 0; Index < Context->CertCount; Index++) {
+    if (Pkcs7VerifyWithCertStore (Pkcs7, Context->CertStores[Index], InData, DataLength)) {
+      if (CertIndex != NULL) {
+        *CertIndex = Index;
+      }
+      Status = TRUE;
+      break;
+    }
+  }
+
+  //
+  // The failed attempts with the other certificates leave errors behind.
+  //
+  ERR_clear_error ();
+
+  PKCS7_free (Pkcs7);
   return Status;
 }
 
@@ -2,7 +2,7 @@
   PKCS#7 SignedData Verification Wrapper Implementation which does not provide
   real capabilities.
 
-Copyright (c) 2012 - 2015, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2012 - 2017, Intel Corporation. All rights reserved.<BR>
 This program and the accompanying materials
 are licensed and made available under the terms and conditions of the BSD License
 which accompanies this distribution.  The full text of the license may be found at
@@ -133,6 +133,97 @@ Pkcs7Verify (
   return FALSE;
 }
 
+/**
+  Allocates and initializes a PKCS#7 verification context.
+
+  Return NULL to indicate this interface is not supported.
+
+  @retval NULL  This interface is not supported.
+
+**/
+VOID *
+EFIAPI
+Pkcs7VerifyContextNew (
+  VOID
+  )
+{
+  ASSERT (FALSE);
+  return NULL;
+}
+
+/**
+  Release the specified PKCS#7 verification context.
+
+  If the interface is not supported, then ASSERT().
+
+  @param[in]  Pkcs7VerifyContext  Pointer to the PKCS#7 verification context to be released.
+
+**/
+VOID
+EFIAPI
+Pkcs7VerifyContextFree (
+  IN  VOID         *Pkcs7VerifyContext
+  )
+{
+  ASSERT (FALSE);
+}
+
+/**
+  Adds a trusted certificate to a PKCS#7 verification context.
+
+  Return FALSE to indicate this interface is not supported.
+
+  @param[in, out]  Pkcs7VerifyContext  Pointer to the PKCS#7 verification context.
+  @param[in]       TrustedCert         Pointer to a trusted/root certificate encoded in DER.
+  @param[in]       CertLength          Length of the trusted certificate in bytes.
+
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+Pkcs7VerifyContextAddCert (
+  IN OUT  VOID         *Pkcs7VerifyContext,
+  IN      CONST UINT8  *TrustedCert,
+  IN      UINTN        CertLength
+  )
+{
+  ASSERT (FALSE);
+  return FALSE;
+}
+
+/**
+  Verifies the validity of a PKCS#7 signed data with the trusted certificates
+  of a PKCS#7 verification context.
+
+  Return FALSE to indicate this interface is not supported.
+
+  @param[in]   Pkcs7VerifyContext  Pointer to the PKCS#7 verification context.
+  @param[in]   P7Data              Pointer to the PKCS#7 message to verify.
+  @param[in]   P7Length            Length of the PKCS#7 message in bytes.
+  @param[in]   InData              Pointer to the content to be verified.
+  @param[in]   DataLength          Length of InData in bytes.
+  @param[out]  CertIndex           Number of the first trusted certificate which
+                                   verifies the signed data. It is optional.
+
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+Pkcs7VerifyWithContext (
+  IN  VOID         *Pkcs7VerifyContext,
+  IN  CONST UINT8  *P7Data,
+  IN  UINTN        P7Length,
+  IN  CONST UINT8  *InData,
+  IN  UINTN        DataLength,
+  OUT UINTN        *CertIndex  OPTIONAL
+  )
+{
+  ASSERT (FALSE);
+  return FALSE;
+}
+
 /**
   Extracts the attached content from a PKCS#7 signed data if existed. The input signed
   data could be wrapped in a ContentInfo structure.
@@ -0,0 +1,342 @@
+/** @file
+  Tests and benchmarks of the string, list, math and checksum functions of BaseLib.
+
+  Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "HostBench.h"
+
+#define STRING_LENGTH    1024
+#define CHECKSUM_SIZE    SIZE_4KB
+#define LIST_NODE_COUNT  256
+
+typedef struct {
+  LIST_ENTRY  Link;
+  UINTN       Value;
+} TEST_NODE;
+
+CHAR8       *mAsciiString;
+CHAR8       *mAsciiString2;
+CHAR16      *mUnicodeString;
+CHAR16      *mUnicodeBuffer;
+UINT8       *mChecksumBuffer;
+TEST_NODE   *mNodes;
+
+BOOLEAN
+BaseLibSetup (
+  VOID
+  )
+{
+  UINTN  Index;
+
+  mAsciiString    = AllocatePool (STRING_LENGTH + 1);
+  mAsciiString2   = AllocatePool (STRING_LENGTH + 1);
+  mUnicodeString  = AllocatePool ((STRING_LENGTH + 1) * sizeof (CHAR16));
+  mUnicodeBuffer  = AllocatePool ((STRING_LENGTH + 1) * sizeof (CHAR16));
+  mChecksumBuffer = AllocatePool (CHECKSUM_SIZE);
+  mNodes          = AllocatePool (LIST_NODE_COUNT * sizeof (TEST_NODE));
+  if (mAsciiString == NULL || mAsciiString2 == NULL || mUnicodeString == NULL ||
+      mUnicodeBuffer == NULL || mChecksumBuffer == NULL || mNodes == NULL) {
+    return FALSE;
+  }
+
+  for (Index = 0; Index < STRING_LENGTH; Index++) {
+    mAsciiString[Index]   = (CHAR8)('a' + Index % 26);
+    mUnicodeString[Index] = (CHAR16)('a' + Index % 26);
+  }
+  mAsciiString[STRING_LENGTH]   = '\0';
+  mUnicodeString[STRING_LENGTH] = L'\0';
+  CopyMem (mAsciiString2, mAsciiString, STRING_LENGTH + 1);
+
+  for (Index = 0; Index < CHECKSUM_SIZE; Index++) {
+    mChecksumBuffer[Index] = (UINT8)(Index * 7);
+  }
+  return TRUE;
+}
+
+BOOLEAN
+TestStringLength (
+  VOID
+  )
+{
+  HOST_CHECK (AsciiStrLen ("") == 0);
+  HOST_CHECK (AsciiStrLen ("EDK II") == 6);
+  HOST_CHECK (StrLen (L"EDK II") == 6);
+  HOST_CHECK (AsciiStrLen (mAsciiString) == STRING_LENGTH);
+  HOST_CHECK (StrLen (mUnicodeString) == STRING_LENGTH);
+  HOST_CHECK (StrSize (L"EDK") == 4 * sizeof (CHAR16));
+  HOST_CHECK (AsciiStrnLenS ("EDK II", 3) == 3);
+  return TRUE;
+}
+
+BOOLEAN
+TestStringCompare (
+  VOID
+  )
+{
+  HOST_CHECK (AsciiStrCmp ("abc", "abc") == 0);
+  HOST_CHECK (AsciiStrCmp ("abc", "abd") < 0);
+  HOST_CHECK (AsciiStrCmp ("abd", "abc") > 0);
+  HOST_CHECK (AsciiStrCmp ("ab", "abc") < 0);
+  HOST_CHECK (StrCmp (L"abc", L"abc") == 0);
+  HOST_CHECK (StrnCmp (L"abcx", L"abcy", 3) == 0);
+  HOST_CHECK (AsciiStriCmp ("EDK", "edk") == 0);
+  HOST_CHECK (AsciiStrCmp (mAsciiString, mAsciiString2) == 0);
+  HOST_CHECK (AsciiStrStr ("firmware volume", "vol") != NULL);
+  HOST_CHECK (AsciiStrStr ("firmware volume", "file") == NULL);
+  HOST_CHECK (StrStr (L"firmware volume", L"ware") != NULL);
+  return TRUE;
+}
+
+BOOLEAN
+TestSafeString (
+  VOID
+  )
+{
+  CHAR16  Buffer[16];
+  CHAR8   AsciiBuffer[16];
+
+  HOST_CHECK (StrCpyS (Buffer, ARRAY_SIZE (Buffer), L"EDK") == RETURN_SUCCESS);
+  HOST_CHECK (StrCatS (Buffer, ARRAY_SIZE (Buffer), L" II") == RETURN_SUCCESS);
+  HOST_CHECK (StrCmp (Buffer, L"EDK II") == 0);
+  HOST_CHECK (StrCatS (Buffer, ARRAY_SIZE (Buffer), L" is too long") == RETURN_BUFFER_TOO_SMALL);
+  HOST_CHECK (AsciiStrCpyS (AsciiBuffer, ARRAY_SIZE (AsciiBuffer), "EDK") == RETURN_SUCCESS);
+  HOST_CHECK (AsciiStrnCatS (AsciiBuffer, ARRAY_SIZE (AsciiBuffer), " II and more", 3) == RETURN_SUCCESS);
+  HOST_CHECK (AsciiStrCmp (AsciiBuffer, "EDK II") == 0);
+  HOST_CHECK (UnicodeStrToAsciiStrS (L"Unicode", AsciiBuffer, ARRAY_SIZE (AsciiBuffer)) == RETURN_SUCCESS);
+  HOST_CHECK (AsciiStrCmp (AsciiBuffer, "Unicode") == 0);
+  return TRUE;
+}
+
+BOOLEAN
+TestStringConversion (
+  VOID
+  )
+{
+  HOST_CHECK (AsciiStrDecimalToUintn ("12345") == 12345);
+  HOST_CHECK (AsciiStrHexToUint64 ("0x1234ABCDef") == 0x1234ABCDEFULL);
+  HOST_CHECK (StrDecimalToUint64 (L"18446744073709551615") == MAX_UINT64);
+  HOST_CHECK (StrHexToUintn (L"  ff") == 0xFF);
+  return TRUE;
+}
+
+BOOLEAN
+TestLinkedList (
+  VOID
+  )
+{
+  LIST_ENTRY  List;
+  LIST_ENTRY  *Link;
+  UINTN       Index;
+
+  InitializeListHead (&List);
+  HOST_CHECK (IsListEmpty (&List));
+  for (Index = 0; Index < LIST_NODE_COUNT; Index++) {
+    mNodes[Index].Value = Index;
+    InsertTailList (&List, &mNodes[Index].Link);
+  }
+  HOST_CHECK (!IsListEmpty (&List));
+
+  Index = 0;
+  for (Link = GetFirstNode (&List); !IsNull (&List, Link); Link = GetNextNode (&List, Link)) {
+    HOST_CHECK (BASE_CR (Link, TEST_NODE, Link)->Value == Index);
+    Index++;
+  }
+  HOST_CHECK (Index == LIST_NODE_COUNT);
+  HOST_CHECK (IsNodeAtEnd (&List, &mNodes[LIST_NODE_COUNT - 1].Link));
+
+  SwapListEntries (&mNodes[0].Link, &mNodes[1].Link);
+  HOST_CHECK (GetFirstNode (&List) == &mNodes[1].Link);
+
+  for (Index = 0; Index < LIST_NODE_COUNT; Index++) {
+    RemoveEntryList (&mNodes[Index].Link);
+  }
+  HOST_CHECK (IsListEmpty (&List));
+  return TRUE;
+}
+
+BOOLEAN
+TestMath (
+  VOID
+  )
+{
+  UINT32  Remainder32;
+  UINT64  Remainder64;
+
+  HOST_CHECK (MultU64x32 (0x100000000ULL, 3) == 0x300000000ULL);
+  HOST_CHECK (DivU64x32Remainder (1000000007ULL, 10, &Remainder32) == 100000000ULL && Remainder32 == 7);
+  HOST_CHECK (DivU64x64Remainder (0x123456789ABCDEFULL, 0x10000ULL, &Remainder64) == 0x123456789ABULL);
+  HOST_CHECK (Remainder64 == 0xCDEF);
+  HOST_CHECK (LShiftU64 (1, 63) == 0x8000000000000000ULL);
+  HOST_CHECK (RShiftU64 (0x8000000000000000ULL, 63) == 1);
+  HOST_CHECK (HighBitSet32 (0x80000001) == 31);
+  HOST_CHECK (LowBitSet64 (0x100) == 8);
+  HOST_CHECK (SwapBytes32 (0x12345678) == 0x78563412);
+  HOST_CHECK (SwapBytes64 (0x0102030405060708ULL) == 0x0807060504030201ULL);
+  return TRUE;
+}
+
+BOOLEAN
+TestChecksum (
+  VOID
+  )
+{
+  UINT8   Buffer8[4];
+  UINT32  Buffer32[4];
+
+  Buffer8[0] = 0x10;
+  Buffer8[1] = 0x20;
+  Buffer8[2] = 0x30;
+  Buffer8[3] = 0;
+  Buffer8[3] = CalculateCheckSum8 (Buffer8, sizeof (Buffer8));
+  HOST_CHECK (CalculateSum8 (Buffer8, sizeof (Buffer8)) == 0);
+
+  Buffer32[0] = 0x11111111;
+  Buffer32[1] = 0x22222222;
+  Buffer32[2] = 0xF0000000;
+  Buffer32[3] = 0;
+  Buffer32[3] = CalculateCheckSum32 (Buffer32, sizeof (Buffer32));
+  HOST_CHECK (CalculateSum32 (Buffer32, sizeof (Buffer32)) == 0);
+  return TRUE;
+}
+
+VOID
+BenchAsciiStrLen (
+  IN UINTN  Iterations
+  )
+{
+  while (Iterations-- > 0) {
+    gHostBenchSink += AsciiStrLen (mAsciiString);
+  }
+}
+
+VOID
+BenchStrLen (
+  IN UINTN  Iterations
+  )
+{
+  while (Iterations-- > 0) {
+    gHostBenchSink += StrLen (mUnicodeString);
+  }
+}
+
+VOID
+BenchAsciiStrCmp (
+  IN UINTN  Iterations
+  )
+{
+  while (Iterations-- > 0) {
+    gHostBenchSink += (UINTN)AsciiStrCmp (mAsciiString, mAsciiString2);
+  }
+}
+
+VOID
+BenchStrCpyS (
+  IN UINTN  Iterations
+  )
+{
+  while (Iterations-- > 0) {
+    gHostBenchSink += (UINTN)StrCpyS (mUnicodeBuffer, STRING_LENGTH + 1, mUnicodeString);
+  }
+}
+
+VOID
+BenchAsciiStrHexToUint64 (
+  IN UINTN  Iterations
+  )
+{
+  while (Iterations-- > 0) {
+    gHostBenchSink += (UINTN)AsciiStrHexToUint64 ("0x123456789ABCDEF0");
+  }
+}
+
+VOID
+BenchCalculateSum32 (
+  IN UINTN  Iterations
+  )
+{
+  while (Iterations-- > 0) {
+    gHostBenchSink += CalculateSum32 ((UINT32 *)mChecksumBuffer, CHECKSUM_SIZE);
+  }
+}
+
+VOID
+BenchCalculateSum8 (
+  IN UINTN  Iterations
+  )
+{
+  while (Iterations-- > 0) {
+    gHostBenchSink += CalculateSum8 (mChecksumBuffer, CHECKSUM_SIZE);
+  }
+}
+
+VOID
+BenchInsertRemoveList (
+  IN UINTN  Iterations
+  )
+{
+  LIST_ENTRY  List;
+  UINTN       Index;
+
+  InitializeListHead (&List);
+  while (Iterations-- > 0) {
+    for (Index = 0; Index < LIST_NODE_COUNT; Index++) {
+      InsertTailList (&List, &mNodes[Index].Link);
+    }
+    for (Index = 0; Index < LIST_NODE_COUNT; Index++) {
+      RemoveEntryList (&mNodes[Index].Link);
+    }
+  }
+  gHostBenchSink += (UINTN)IsListEmpty (&List);
+}
+
+VOID
+BenchDivU64x32Remainder (
+  IN UINTN  Iterations
+  )
+{
+  UINT32  Remainder;
+
+  while (Iterations-- > 0) {
+    gHostBenchSink += (UINTN)DivU64x32Remainder (0x123456789ABCDEFULL + Iterations, 1000, &Remainder) + Remainder;
+  }
+}
+
+CONST HOST_TEST  mBaseLibTests[] = {
+  { "StringLength",     TestStringLength     },
+  { "StringCompare",    TestStringCompare    },
+  { "SafeString",       TestSafeString       },
+  { "StringConversion", TestStringConversion },
+  { "LinkedList",       TestLinkedList       },
+  { "Math",             TestMath             },
+  { "Checksum",         TestChecksum         }
+};
+
+CONST HOST_BENCH  mBaseLibBenches[] = {
+  { "AsciiStrLen 1K",         STRING_LENGTH,                    BenchAsciiStrLen         },
+  { "StrLen 1K",              STRING_LENGTH * sizeof (CHAR16),  BenchStrLen              },
+  { "AsciiStrCmp 1K",         STRING_LENGTH,                    BenchAsciiStrCmp         },
+  { "StrCpyS 1K",             STRING_LENGTH * sizeof (CHAR16),  BenchStrCpyS             },
+  { "AsciiStrHexToUint64",    0,                                BenchAsciiStrHexToUint64 },
+  { "CalculateSum8 4K",       CHECKSUM_SIZE,                    BenchCalculateSum8       },
+  { "CalculateSum32 4K",      CHECKSUM_SIZE,                    BenchCalculateSum32      },
+  { "InsertRemoveList 256",   0,                                BenchInsertRemoveList    },
+  { "DivU64x32Remainder",     0,                                BenchDivU64x32Remainder  }
+};
+
+HOST_SUITE  gBaseLibSuite = {
+  "BaseLib",
+  BaseLibSetup,
+  mBaseLibTests,
+  ARRAY_SIZE (mBaseLibTests),
+  mBaseLibBenches,
+  ARRAY_SIZE (mBaseLibBenches)
+};
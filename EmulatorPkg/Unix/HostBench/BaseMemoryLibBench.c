@@ -0,0 +1,551 @@
+/** @file
+  Tests and benchmarks of BaseMemoryLib.
+
+  Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "HostBench.h"
+
+#define MEM_SMALL_SIZE  64
+#define MEM_PAGE_SIZE   SIZE_4KB
+#define MEM_LARGE_SIZE  SIZE_1MB
+//
+// Larger than most last level caches, so that the copies use non-temporal
+// stores in the instances that have them
+//
+#define MEM_HUGE_SIZE   SIZE_32MB
+//
+// The size tests cover all lengths below this one, at all alignments below
+// MEM_TEST_ALIGN, so that every small-size and loop tail path is taken
+//
+#define MEM_TEST_SIZE   320
+#define MEM_TEST_ALIGN  32
+
+UINT8  *mSource;
+UINT8  *mDestination;
+
+CONST GUID  mTestGuid = {
+  0x8863C0AD, 0x7724, 0xC84B, { 0x88, 0xE5, 0xA3, 0x3B, 0x11, 0x6D, 0x14, 0x85 }
+};
+
+BOOLEAN
+BaseMemoryLibSetup (
+  VOID
+  )
+{
+  UINTN  Index;
+
+  mSource      = AllocatePool (MEM_HUGE_SIZE);
+  mDestination = AllocatePool (MEM_HUGE_SIZE);
+  if (mSource == NULL || mDestination == NULL) {
+    return FALSE;
+  }
+  for (Index = 0; Index < MEM_HUGE_SIZE; Index++) {
+    mSource[Index] = (UINT8)(Index * 13 + (Index >> 8));
+  }
+  CopyMem (mDestination, mSource, MEM_HUGE_SIZE);
+  return TRUE;
+}
+
+BOOLEAN
+TestCopyMem (
+  VOID
+  )
+{
+  UINT8  Buffer[64];
+  UINTN  Index;
+
+  for (Index = 0; Index < sizeof (Buffer); Index++) {
+    Buffer[Index] = (UINT8)Index;
+  }
+  //
+  // Overlapping copies in both directions, at odd sizes and offsets
+  //
+  CopyMem (Buffer + 3, Buffer, 37);
+  for (Index = 0; Index < 37; Index++) {
+    HOST_CHECK (Buffer[Index + 3] == Index);
+  }
+  for (Index = 0; Index < sizeof (Buffer); Index++) {
+    Buffer[Index] = (UINT8)Index;
+  }
+  CopyMem (Buffer, Buffer + 5, 41);
+  for (Index = 0; Index < 41; Index++) {
+    HOST_CHECK (Buffer[Index] == Index + 5);
+  }
+  HOST_CHECK (Buffer[41] == 41);
+
+  CopyMem (mDestination + 1, mSource + 3, MEM_LARGE_SIZE - 3);
+  HOST_CHECK (CompareMem (mDestination + 1, mSource + 3, MEM_LARGE_SIZE - 3) == 0);
+  CopyMem (mDestination, mSource, MEM_LARGE_SIZE);
+  return TRUE;
+}
+
+/**
+  Copy Length bytes at Offset in mDestination to Offset + Delta, and check the
+  result against a byte by byte copy of mSource.
+
+  Only the bytes around the source and destination are checked, which are the
+  only ones the copy may change by mistake.
+
+  @retval TRUE   The copy is correct and no other byte has changed.
+  @retval FALSE  A byte is different.
+
+**/
+BOOLEAN
+CheckCopyMem (
+  IN UINTN  Offset,
+  IN INTN   Delta,
+  IN UINTN  Length
+  )
+{
+  UINTN  Index;
+  UINTN  Start;
+  UINTN  End;
+
+  Start = MIN (Offset, Offset + Delta) - MEM_TEST_ALIGN;
+  End   = MAX (Offset, Offset + Delta) + Length + MEM_TEST_ALIGN;
+  CopyMem (mDestination + Start, mSource + Start, End - Start);
+  CopyMem (mDestination + Offset + Delta, mDestination + Offset, Length);
+  for (Index = Start; Index < End; Index++) {
+    if (Index >= Offset + Delta && Index < Offset + Delta + Length) {
+      if (mDestination[Index] != mSource[Index - Delta]) {
+        return FALSE;
+      }
+    } else if (mDestination[Index] != mSource[Index]) {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+BOOLEAN
+TestCopyMemSizes (
+  VOID
+  )
+{
+  UINTN  Length;
+  UINTN  Align;
+  INTN   Delta;
+
+  for (Length = 1; Length < MEM_TEST_SIZE; Length++) {
+    for (Align = 0; Align < MEM_TEST_ALIGN; Align++) {
+      //
+      // Disjoint buffers, with the source and destination at different alignments
+      //
+      HOST_CHECK (CheckCopyMem (MEM_PAGE_SIZE / 2 + Align, MEM_PAGE_SIZE + 3, Length));
+    }
+    //
+    // Overlapping buffers in both directions
+    //
+    for (Delta = 1; Delta < MEM_TEST_ALIGN * 3; Delta++) {
+      HOST_CHECK (CheckCopyMem (MEM_PAGE_SIZE / 2, Delta, Length));
+      HOST_CHECK (CheckCopyMem (MEM_PAGE_SIZE / 2, -Delta, Length));
+    }
+  }
+  CopyMem (mDestination, mSource, MEM_LARGE_SIZE);
+  return TRUE;
+}
+
+BOOLEAN
+TestSetMem (
+  VOID
+  )
+{
+  UINT8   Buffer[67];
+  UINT32  Buffer32[9];
+  UINT64  Buffer64[5];
+  UINTN   Index;
+
+  SetMem (Buffer, sizeof (Buffer), 0x5A);
+  for (Index = 0; Index < sizeof (Buffer); Index++) {
+    HOST_CHECK (Buffer[Index] == 0x5A);
+  }
+  ZeroMem (Buffer + 1, sizeof (Buffer) - 2);
+  HOST_CHECK (Buffer[0] == 0x5A && Buffer[sizeof (Buffer) - 1] == 0x5A);
+  HOST_CHECK (IsZeroBuffer (Buffer + 1, sizeof (Buffer) - 2));
+  HOST_CHECK (!IsZeroBuffer (Buffer, sizeof (Buffer)));
+
+  SetMem32 (Buffer32, sizeof (Buffer32), 0x12345678);
+  for (Index = 0; Index < ARRAY_SIZE (Buffer32); Index++) {
+    HOST_CHECK (Buffer32[Index] == 0x12345678);
+  }
+  SetMem64 (Buffer64, sizeof (Buffer64), 0x0123456789ABCDEFULL);
+  for (Index = 0; Index < ARRAY_SIZE (Buffer64); Index++) {
+    HOST_CHECK (Buffer64[Index] == 0x0123456789ABCDEFULL);
+  }
+  return TRUE;
+}
+
+BOOLEAN
+TestSetMemSizes (
+  VOID
+  )
+{
+  UINTN  Length;
+  UINTN  Align;
+  UINTN  Index;
+  UINT8  *Buffer;
+
+  for (Length = 0; Length < MEM_TEST_SIZE; Length += sizeof (UINT64)) {
+    for (Align = 0; Align < MEM_TEST_ALIGN; Align += sizeof (UINT64)) {
+      Buffer = mDestination + MEM_TEST_ALIGN + Align;
+      SetMem (mDestination, MEM_TEST_SIZE + 3 * MEM_TEST_ALIGN, 0xEE);
+      SetMem64 (Buffer, Length, 0x0123456789ABCDEFULL);
+      for (Index = 0; Index < Length; Index += sizeof (UINT64)) {
+        HOST_CHECK (ReadUnaligned64 ((UINT64 *)(Buffer + Index)) == 0x0123456789ABCDEFULL);
+      }
+      HOST_CHECK (Buffer[-1] == 0xEE && Buffer[Length] == 0xEE);
+
+      SetMem (mDestination, MEM_TEST_SIZE + 3 * MEM_TEST_ALIGN, 0xEE);
+      SetMem32 (Buffer + 4, Length, 0x89ABCDEF);
+      for (Index = 0; Index < Length; Index += sizeof (UINT32)) {
+        HOST_CHECK (ReadUnaligned32 ((UINT32 *)(Buffer + 4 + Index)) == 0x89ABCDEF);
+      }
+      HOST_CHECK (Buffer[3] == 0xEE && Buffer[4 + Length] == 0xEE);
+
+      SetMem (mDestination, MEM_TEST_SIZE + 3 * MEM_TEST_ALIGN, 0xEE);
+      SetMem16 (Buffer + 6, Length, 0xCDEF);
+      for (Index = 0; Index < Length; Index += sizeof (UINT16)) {
+        HOST_CHECK (ReadUnaligned16 ((UINT16 *)(Buffer + 6 + Index)) == 0xCDEF);
+      }
+      HOST_CHECK (Buffer[5] == 0xEE && Buffer[6 + Length] == 0xEE);
+
+      SetMem (mDestination, MEM_TEST_SIZE + 3 * MEM_TEST_ALIGN, 0xEE);
+      ZeroMem (Buffer + 7, Length + 1);
+      HOST_CHECK (IsZeroBuffer (Buffer + 7, Length + 1));
+      HOST_CHECK (Buffer[6] == 0xEE && Buffer[8 + Length] == 0xEE);
+    }
+  }
+  CopyMem (mDestination, mSource, MEM_LARGE_SIZE);
+  return TRUE;
+}
+
+BOOLEAN
+TestCompareMem (
+  VOID
+  )
+{
+  UINT8  Left[40];
+  UINT8  Right[40];
+
+  SetMem (Left, sizeof (Left), 0x11);
+  SetMem (Right, sizeof (Right), 0x11);
+  HOST_CHECK (CompareMem (Left, Right, sizeof (Left)) == 0);
+  Right[33] = 0x12;
+  HOST_CHECK (CompareMem (Left, Right, sizeof (Left)) < 0);
+  HOST_CHECK (CompareMem (Right, Left, sizeof (Left)) > 0);
+  HOST_CHECK (CompareMem (Left, Right, 33) == 0);
+  HOST_CHECK (CompareGuid (&mTestGuid, &mTestGuid));
+  return TRUE;
+}
+
+BOOLEAN
+TestCompareMemSizes (
+  VOID
+  )
+{
+  UINTN  Length;
+  UINTN  Index;
+  UINT8  *Left;
+  UINT8  *Right;
+
+  Left  = mDestination + 1;
+  Right = mSource + 2;
+  for (Length = 1; Length < MEM_TEST_SIZE; Length++) {
+    CopyMem (Left, Right, Length);
+    HOST_CHECK (CompareMem (Left, Right, Length) == 0);
+    for (Index = 0; Index < Length; Index++) {
+      //
+      // The result is the difference of the first mismatched bytes, whatever
+      // follows them
+      //
+      Left[Index] ^= 0x5A;
+      HOST_CHECK (CompareMem (Left, Right, Length) == (INTN)Left[Index] - (INTN)Right[Index]);
+      Left[Length - 1] ^= 0x81;
+      HOST_CHECK (CompareMem (Right, Left, Length) == (INTN)Right[Index] - (INTN)Left[Index]);
+      Left[Length - 1] ^= 0x81;
+      Left[Index] ^= 0x5A;
+    }
+  }
+  CopyMem (mDestination, mSource, MEM_LARGE_SIZE);
+  return TRUE;
+}
+
+BOOLEAN
+TestScanMem (
+  VOID
+  )
+{
+  UINT8   Buffer[100];
+  UINT16  Buffer16[20];
+  UINT32  Buffer32[20];
+
+  ZeroMem (Buffer, sizeof (Buffer));
+  Buffer[77] = 0xAA;
+  HOST_CHECK (ScanMem8 (Buffer, sizeof (Buffer), 0xAA) == &Buffer[77]);
+  HOST_CHECK (ScanMem8 (Buffer, 77, 0xAA) == NULL);
+
+  ZeroMem (Buffer16, sizeof (Buffer16));
+  Buffer16[13] = 0xBEEF;
+  HOST_CHECK (ScanMem16 (Buffer16, sizeof (Buffer16), 0xBEEF) == &Buffer16[13]);
+
+  ZeroMem (Buffer32, sizeof (Buffer32));
+  Buffer32[19] = 0xDEADBEEF;
+  HOST_CHECK (ScanMem32 (Buffer32, sizeof (Buffer32), 0xDEADBEEF) == &Buffer32[19]);
+  return TRUE;
+}
+
+BOOLEAN
+TestScanMemSizes (
+  VOID
+  )
+{
+  UINTN   Length;
+  UINTN   Index;
+  UINT64  *Buffer;
+
+  Buffer = (UINT64 *)mDestination;
+  for (Length = 1; Length < MEM_TEST_SIZE / sizeof (UINT64); Length++) {
+    //
+    // Values that only differ from the one searched in their last byte
+    //
+    SetMem64 (Buffer, Length * sizeof (UINT64), 0x0807060504030201ULL);
+    HOST_CHECK (ScanMem8 (Buffer, Length * sizeof (UINT64), 0x09) == NULL);
+    HOST_CHECK (ScanMem16 (Buffer, Length * sizeof (UINT64), 0x0809) == NULL);
+    HOST_CHECK (ScanMem32 (Buffer, Length * sizeof (UINT64), 0x08070609) == NULL);
+    HOST_CHECK (ScanMem64 (Buffer, Length * sizeof (UINT64), 0x0907060504030201ULL) == NULL);
+    for (Index = 0; Index < Length; Index++) {
+      Buffer[Index] = 0x0907060504030209ULL;
+      HOST_CHECK (ScanMem8 (Buffer, Length * sizeof (UINT64), 0x09) == &Buffer[Index]);
+      HOST_CHECK (ScanMem16 (Buffer, Length * sizeof (UINT64), 0x0209) == &Buffer[Index]);
+      HOST_CHECK (ScanMem32 (Buffer, Length * sizeof (UINT64), 0x04030209) == &Buffer[Index]);
+      HOST_CHECK (ScanMem64 (Buffer, Length * sizeof (UINT64), 0x0907060504030209ULL) == &Buffer[Index]);
+      Buffer[Index] = 0x0807060504030201ULL;
+    }
+  }
+  CopyMem (mDestination, mSource, MEM_LARGE_SIZE);
+  return TRUE;
+}
+
+VOID
+BenchCopyMemTiny (
+  IN UINTN  Iterations
+  )
+{
+  while (Iterations-- > 0) {
+    gHostBenchSink += (UINTN)CopyMem (mDestination, mSource, 8);
+  }
+}
+
+VOID
+BenchCopyMemOdd (
+  IN UINTN  Iterations
+  )
+{
+  while (Iterations-- > 0) {
+    gHostBenchSink += (UINTN)CopyMem (mDestination + 1, mSource, 31);
+  }
+}
+
+VOID
+BenchCopyMemSmall (
+  IN UINTN  Iterations
+  )
+{
+  while (Iterations-- > 0) {
+    gHostBenchSink += (UINTN)CopyMem (mDestination, mSource, MEM_SMALL_SIZE);
+  }
+}
+
+VOID
+BenchCopyMemMedium (
+  IN UINTN  Iterations
+  )
+{
+  while (Iterations-- > 0) {
+    gHostBenchSink += (UINTN)CopyMem (mDestination, mSource, 256);
+  }
+}
+
+VOID
+BenchCopyMemPage (
+  IN UINTN  Iterations
+  )
+{
+  while (Iterations-- > 0) {
+    gHostBenchSink += (UINTN)CopyMem (mDestination, mSource, MEM_PAGE_SIZE);
+  }
+}
+
+VOID
+BenchCopyMemLarge (
+  IN UINTN  Iterations
+  )
+{
+  while (Iterations-- > 0) {
+    gHostBenchSink += (UINTN)CopyMem (mDestination, mSource, MEM_LARGE_SIZE);
+  }
+}
+
+VOID
+BenchCopyMemHuge (
+  IN UINTN  Iterations
+  )
+{
+  while (Iterations-- > 0) {
+    gHostBenchSink += (UINTN)CopyMem (mDestination, mSource, MEM_HUGE_SIZE);
+  }
+}
+
+VOID
+BenchCopyMemUnaligned (
+  IN UINTN  Iterations
+  )
+{
+  while (Iterations-- > 0) {
+    gHostBenchSink += (UINTN)CopyMem (mDestination + 1, mSource + 3, MEM_PAGE_SIZE);
+  }
+}
+
+VOID
+BenchCopyMemOverlap (
+  IN UINTN  Iterations
+  )
+{
+  while (Iterations-- > 0) {
+    gHostBenchSink += (UINTN)CopyMem (mDestination + 8, mDestination, MEM_PAGE_SIZE);
+  }
+}
+
+VOID
+BenchSetMemPage (
+  IN UINTN  Iterations
+  )
+{
+  while (Iterations-- > 0) {
+    gHostBenchSink += (UINTN)SetMem (mDestination, MEM_PAGE_SIZE, 0xAF);
+  }
+}
+
+VOID
+BenchSetMem64Page (
+  IN UINTN  Iterations
+  )
+{
+  while (Iterations-- > 0) {
+    gHostBenchSink += (UINTN)SetMem64 (mDestination, MEM_PAGE_SIZE, 0x0123456789ABCDEFULL);
+  }
+}
+
+VOID
+BenchZeroMemLarge (
+  IN UINTN  Iterations
+  )
+{
+  while (Iterations-- > 0) {
+    gHostBenchSink += (UINTN)ZeroMem (mDestination, MEM_LARGE_SIZE);
+  }
+}
+
+VOID
+BenchZeroMemHuge (
+  IN UINTN  Iterations
+  )
+{
+  while (Iterations-- > 0) {
+    gHostBenchSink += (UINTN)ZeroMem (mDestination, MEM_HUGE_SIZE);
+  }
+}
+
+VOID
+BenchCompareMemSmall (
+  IN UINTN  Iterations
+  )
+{
+  CopyMem (mDestination, mSource, MEM_SMALL_SIZE);
+  while (Iterations-- > 0) {
+    gHostBenchSink += (UINTN)CompareMem (mDestination, mSource, MEM_SMALL_SIZE);
+  }
+}
+
+VOID
+BenchCompareMemPage (
+  IN UINTN  Iterations
+  )
+{
+  CopyMem (mDestination, mSource, MEM_PAGE_SIZE);
+  while (Iterations-- > 0) {
+    gHostBenchSink += (UINTN)CompareMem (mDestination, mSource, MEM_PAGE_SIZE);
+  }
+}
+
+VOID
+BenchScanMem8Page (
+  IN UINTN  Iterations
+  )
+{
+  SetMem (mDestination, MEM_PAGE_SIZE, 0);
+  mDestination[MEM_PAGE_SIZE - 1] = 0xFF;
+  while (Iterations-- > 0) {
+    gHostBenchSink += (UINTN)ScanMem8 (mDestination, MEM_PAGE_SIZE, 0xFF);
+  }
+}
+
+VOID
+BenchIsZeroBufferPage (
+  IN UINTN  Iterations
+  )
+{
+  ZeroMem (mDestination, MEM_PAGE_SIZE);
+  while (Iterations-- > 0) {
+    gHostBenchSink += (UINTN)IsZeroBuffer (mDestination, MEM_PAGE_SIZE);
+  }
+}
+
+CONST HOST_TEST  mBaseMemoryLibTests[] = {
+  { "CopyMem",          TestCopyMem         },
+  { "CopyMem sizes",    TestCopyMemSizes    },
+  { "SetMem",           TestSetMem          },
+  { "SetMem sizes",     TestSetMemSizes     },
+  { "CompareMem",       TestCompareMem      },
+  { "CompareMem sizes", TestCompareMemSizes },
+  { "ScanMem",          TestScanMem         },
+  { "ScanMem sizes",    TestScanMemSizes    }
+};
+
+CONST HOST_BENCH  mBaseMemoryLibBenches[] = {
+  { "CopyMem 8",              8,              BenchCopyMemTiny      },
+  { "CopyMem 31 unaligned",   31,             BenchCopyMemOdd       },
+  { "CopyMem 64",             MEM_SMALL_SIZE, BenchCopyMemSmall     },
+  { "CopyMem 256",            256,            BenchCopyMemMedium    },
+  { "CopyMem 4K",             MEM_PAGE_SIZE,  BenchCopyMemPage      },
+  { "CopyMem 1M",             MEM_LARGE_SIZE, BenchCopyMemLarge     },
+  { "CopyMem 32M",            MEM_HUGE_SIZE,  BenchCopyMemHuge      },
+  { "CopyMem 4K unaligned",   MEM_PAGE_SIZE,  BenchCopyMemUnaligned },
+  { "CopyMem 4K overlapping", MEM_PAGE_SIZE,  BenchCopyMemOverlap   },
+  { "SetMem 4K",              MEM_PAGE_SIZE,  BenchSetMemPage       },
+  { "SetMem64 4K",            MEM_PAGE_SIZE,  BenchSetMem64Page     },
+  { "ZeroMem 1M",             MEM_LARGE_SIZE, BenchZeroMemLarge     },
+  { "ZeroMem 32M",            MEM_HUGE_SIZE,  BenchZeroMemHuge      },
+  { "CompareMem 64",          MEM_SMALL_SIZE, BenchCompareMemSmall  },
+  { "CompareMem 4K",          MEM_PAGE_SIZE,  BenchCompareMemPage   },
+  { "ScanMem8 4K",            MEM_PAGE_SIZE,  BenchScanMem8Page     },
+  { "IsZeroBuffer 4K",        MEM_PAGE_SIZE,  BenchIsZeroBufferPage }
+};
+
+HOST_SUITE  gBaseMemoryLibSuite = {
+  "BaseMemoryLib",
+  BaseMemoryLibSetup,
+  mBaseMemoryLibTests,
+  ARRAY_SIZE (mBaseMemoryLibTests),
+  mBaseMemoryLibBenches,
+  ARRAY_SIZE (mBaseMemoryLibBenches)
+};
@@ -0,0 +1,314 @@
+/** @file
+  Host test and benchmark runner for MdePkg and MdeModulePkg libraries.
+
+  The library instances are built by the EDK II build for the host, the same
+  way as for the Unix Host emulator, and linked into a native executable.
+  Every suite first runs its tests. The benchmarks of a suite then run each
+  operation for at least the minimum time and report the time per operation.
+
+  Usage: HostBench [-t|--test-only] [-b|--bench-only] [-l|--list]
+                   [-m|--min-time MS] [FILTER...]
+
+  Only the tests and benchmarks whose "Suite.Name" contains one of the
+  FILTER strings are run. The exit code is the number of failed tests.
+
+  Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "HostBench.h"
+
+#define DEFAULT_MIN_TIME_MS  200
+
+volatile UINTN  gHostBenchSink;
+
+HOST_SUITE  *mSuites[] = {
+  &gBaseLibSuite,
+  &gBaseMemoryLibSuite,
+  &gPrintLibSuite,
+  &gSortLibSuite,
+  &gDecompressLibSuite
+};
+
+CHAR8   **mFilters;
+UINTN   mFilterCount;
+
+/**
+  Report a failed check.
+
+  @param[in] File        Source file of the check.
+  @param[in] Line        Line of the check.
+  @param[in] Expression  Text of the expression that was FALSE.
+
+**/
+VOID
+HostCheckFailed (
+  IN CONST CHAR8  *File,
+  IN UINTN        Line,
+  IN CONST CHAR8  *Expression
+  )
+{
+  printf ("    %s(%u): check failed: %s\n", File, (unsigned int)Line, Expression);
+}
+
+/**
+  Get the monotonic time.
+
+  @return Time in nanoseconds.
+
+**/
+UINT64
+GetTimeNs (
+  VOID
+  )
+{
+  struct timespec  Time;
+
+  clock_gettime (CLOCK_MONOTONIC, &Time);
+  return (UINT64)Time.tv_sec * 1000000000ULL + (UINT64)Time.tv_nsec;
+}
+
+/**
+  Check if a test or benchmark is selected by the filters.
+
+  @param[in] Suite  Suite of the test or benchmark.
+  @param[in] Name   Name of the test or benchmark.
+
+  @retval TRUE   It is selected.
+  @retval FALSE  It is not selected.
+
+**/
+BOOLEAN
+IsSelected (
+  IN CONST HOST_SUITE  *Suite,
+  IN CONST CHAR8       *Name
+  )
+{
+  CHAR8  FullName[128];
+  UINTN  Index;
+
+  if (mFilterCount == 0) {
+    return TRUE;
+  }
+  snprintf (FullName, sizeof (FullName), "%s.%s", Suite->Name, Name);
+  for (Index = 0; Index < mFilterCount; Index++) {
+    if (strstr (FullName, mFilters[Index]) != NULL) {
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+/**
+  Run the selected tests of a suite.
+
+  @param[in] Suite  The suite.
+
+  @return Number of failed tests.
+
+**/
+UINTN
+RunTests (
+  IN CONST HOST_SUITE  *Suite
+  )
+{
+  UINTN  Index;
+  UINTN  Failed;
+
+  Failed = 0;
+  for (Index = 0; Index < Suite->TestCount; Index++) {
+    if (!IsSelected (Suite, Suite->Tests[Index].Name)) {
+      continue;
+    }
+    if (Suite->Tests[Index].Function ()) {
+      printf ("  PASS  %s.%s\n", Suite->Name, Suite->Tests[Index].Name);
+    } else {
+      printf ("  FAIL  %s.%s\n", Suite->Name, Suite->Tests[Index].Name);
+      Failed++;
+    }
+  }
+  return Failed;
+}
+
+/**
+  Run the selected benchmarks of a suite and report ns/op.
+
+  The iteration count is doubled until a run takes at least MinTimeNs, and
+  the time of that run is reported.
+
+  @param[in] Suite      The suite.
+  @param[in] MinTimeNs  Minimum time of the reported run in nanoseconds.
+
+**/
+VOID
+RunBenches (
+  IN CONST HOST_SUITE  *Suite,
+  IN UINT64            MinTimeNs
+  )
+{
+  CONST HOST_BENCH  *Bench;
+  UINTN             Index;
+  UINTN             Iterations;
+  UINT64            Start;
+  UINT64            Elapsed;
+  double            NsPerOp;
+
+  for (Index = 0; Index < Suite->BenchCount; Index++) {
+    Bench = &Suite->Benches[Index];
+    if (!IsSelected (Suite, Bench->Name)) {
+      continue;
+    }
+
+    Iterations = 1;
+    for (;;) {
+      Start = GetTimeNs ();
+      Bench->Function (Iterations);
+      Elapsed = GetTimeNs () - Start;
+      if (Elapsed >= MinTimeNs || Iterations >= (MAX_UINTN >> 1)) {
+        break;
+      }
+      Iterations <<= 1;
+    }
+
+    NsPerOp = (double)Elapsed / (double)Iterations;
+    if (Bench->BytesPerOp != 0) {
+      printf (
+        "  %-40s %12lu ops %14.1f ns/op %10.1f MB/s\n",
+        Bench->Name,
+        (unsigned long)Iterations,
+        NsPerOp,
+        (double)Bench->BytesPerOp * 1000.0 / NsPerOp
+        );
+    } else {
+      printf ("  %-40s %12lu ops %14.1f ns/op\n", Bench->Name, (unsigned long)Iterations, NsPerOp);
+    }
+  }
+}
+
+/**
+  Check if a suite has a selected test or benchmark.
+
+  @param[in] Suite      The suite.
+  @param[in] RunTest    TRUE if the tests are run.
+  @param[in] RunBench   TRUE if the benchmarks are run.
+
+  @retval TRUE   The suite has something to run.
+  @retval FALSE  The suite can be skipped.
+
+**/
+BOOLEAN
+IsSuiteSelected (
+  IN CONST HOST_SUITE  *Suite,
+  IN BOOLEAN           RunTest,
+  IN BOOLEAN           RunBench
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; RunTest && Index < Suite->TestCount; Index++) {
+    if (IsSelected (Suite, Suite->Tests[Index].Name)) {
+      return TRUE;
+    }
+  }
+  for (Index = 0; RunBench && Index < Suite->BenchCount; Index++) {
+    if (IsSelected (Suite, Suite->Benches[Index].Name)) {
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+/**
+  Print the names of all tests and benchmarks.
+
+**/
+VOID
+ListAll (
+  VOID
+  )
+{
+  UINTN  SuiteIndex;
+  UINTN  Index;
+
+  for (SuiteIndex = 0; SuiteIndex < ARRAY_SIZE (mSuites); SuiteIndex++) {
+    for (Index = 0; Index < mSuites[SuiteIndex]->TestCount; Index++) {
+      printf ("test   %s.%s\n", mSuites[SuiteIndex]->Name, mSuites[SuiteIndex]->Tests[Index].Name);
+    }
+    for (Index = 0; Index < mSuites[SuiteIndex]->BenchCount; Index++) {
+      printf ("bench  %s.%s\n", mSuites[SuiteIndex]->Name, mSuites[SuiteIndex]->Benches[Index].Name);
+    }
+  }
+}
+
+int
+main (
+  IN  int   Argc,
+  IN  char  **Argv
+  )
+{
+  BOOLEAN     RunTest;
+  BOOLEAN     RunBench;
+  UINT64      MinTimeNs;
+  UINTN       Index;
+  UINTN       Failed;
+  HOST_SUITE  *Suite;
+
+  RunTest   = TRUE;
+  RunBench  = TRUE;
+  MinTimeNs = DEFAULT_MIN_TIME_MS * 1000000ULL;
+  mFilters  = (CHAR8 **)calloc (Argc, sizeof (CHAR8 *));
+  if (mFilters == NULL) {
+    return 1;
+  }
+
+  for (Index = 1; Index < (UINTN)Argc; Index++) {
+    if (strcmp (Argv[Index], "-t") == 0 || strcmp (Argv[Index], "--test-only") == 0) {
+      RunBench = FALSE;
+    } else if (strcmp (Argv[Index], "-b") == 0 || strcmp (Argv[Index], "--bench-only") == 0) {
+      RunTest = FALSE;
+    } else if (strcmp (Argv[Index], "-l") == 0 || strcmp (Argv[Index], "--list") == 0) {
+      ListAll ();
+      return 0;
+    } else if ((strcmp (Argv[Index], "-m") == 0 || strcmp (Argv[Index], "--min-time") == 0) &&
+               Index + 1 < (UINTN)Argc) {
+      MinTimeNs = strtoull (Argv[++Index], NULL, 0) * 1000000ULL;
+    } else if (Argv[Index][0] == '-') {
+      printf ("Usage: %s [-t|--test-only] [-b|--bench-only] [-l|--list] [-m|--min-time MS] [FILTER...]\n", Argv[0]);
+      return 1;
+    } else {
+      mFilters[mFilterCount++] = Argv[Index];
+    }
+  }
+
+  Failed = 0;
+  for (Index = 0; Index < ARRAY_SIZE (mSuites); Index++) {
+    Suite = mSuites[Index];
+    if (!IsSuiteSelected (Suite, RunTest, RunBench)) {
+      continue;
+    }
+    printf ("%s\n", Suite->Name);
+    if (Suite->Setup != NULL && !Suite->Setup ()) {
+      printf ("  FAIL  %s setup\n", Suite->Name);
+      Failed++;
+      continue;
+    }
+    if (RunTest) {
+      Failed += RunTests (Suite);
+    }
+    if (RunBench) {
+      RunBenches (Suite, MinTimeNs);
+    }
+  }
+
+  if (RunTest) {
+    printf ("%u failed\n", (unsigned int)Failed);
+  }
+  return (int)MIN (Failed, 125);
+}
@@ -0,0 +1,129 @@
+/** @file
+  Definitions shared by the host test and benchmark runner and its suites.
+
+  Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#ifndef _HOST_BENCH_H_
+#define _HOST_BENCH_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PrintLib.h>
+#include <Library/DebugLib.h>
+
+/**
+  Run the checks of one test.
+
+  @retval TRUE   All checks passed.
+  @retval FALSE  A check failed. It has been reported by HostCheckFailed().
+
+**/
+typedef
+BOOLEAN
+(*HOST_TEST_FUNCTION) (
+  VOID
+  );
+
+/**
+  Run the operation of one benchmark a number of times.
+
+  @param[in] Iterations  Number of times to run the operation.
+
+**/
+typedef
+VOID
+(*HOST_BENCH_FUNCTION) (
+  IN UINTN  Iterations
+  );
+
+/**
+  Prepare the buffers used by the benchmarks of a suite.
+
+  @retval TRUE   The suite is ready.
+  @retval FALSE  Out of memory.
+
+**/
+typedef
+BOOLEAN
+(*HOST_SUITE_SETUP) (
+  VOID
+  );
+
+typedef struct {
+  CONST CHAR8          *Name;
+  HOST_TEST_FUNCTION   Function;
+} HOST_TEST;
+
+typedef struct {
+  CONST CHAR8          *Name;
+  //
+  // Bytes processed by one operation, used to report MB/s, or 0
+  //
+  UINTN                BytesPerOp;
+  HOST_BENCH_FUNCTION  Function;
+} HOST_BENCH;
+
+typedef struct {
+  CONST CHAR8          *Name;
+  HOST_SUITE_SETUP     Setup;
+  CONST HOST_TEST      *Tests;
+  UINTN                TestCount;
+  CONST HOST_BENCH     *Benches;
+  UINTN                BenchCount;
+} HOST_SUITE;
+
+/**
+  Report a failed check.
+
+  @param[in] File        Source file of the check.
+  @param[in] Line        Line of the check.
+  @param[in] Expression  Text of the expression that was FALSE.
+
+**/
+VOID
+HostCheckFailed (
+  IN CONST CHAR8  *File,
+  IN UINTN        Line,
+  IN CONST CHAR8  *Expression
+  );
+
+///
+/// Fail the current test if Expression is FALSE.
+///
+#define HOST_CHECK(Expression)                                  \
+  do {                                                          \
+    if (!(Expression)) {                                        \
+      HostCheckFailed (__FILE__, __LINE__, #Expression);        \
+      return FALSE;                                             \
+    }                                                           \
+  } while (FALSE)
+
+///
+/// Results of the benchmarked calls are folded into this variable, so that
+/// the calls cannot be optimized away.
+///
+extern volatile UINTN  gHostBenchSink;
+
+extern HOST_SUITE  gBaseLibSuite;
+extern HOST_SUITE  gBaseMemoryLibSuite;
+extern HOST_SUITE  gPrintLibSuite;
+extern HOST_SUITE  gSortLibSuite;
+extern HOST_SUITE  gDecompressLibSuite;
+
+#endif
@@ -0,0 +1,149 @@
+/** @file
+  Tests and benchmarks of PrintLib.
+
+  Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "HostBench.h"
+
+CONST GUID  mPrintGuid = {
+  0x8863C0AD, 0x7724, 0xC84B, { 0x88, 0xE5, 0xA3, 0x3B, 0x11, 0x6D, 0x14, 0x85 }
+};
+
+BOOLEAN
+TestAsciiSPrint (
+  VOID
+  )
+{
+  CHAR8  Buffer[128];
+  UINTN  Length;
+
+  Length = AsciiSPrint (Buffer, sizeof (Buffer), "%d %x %X %a %s", -12, 0xABCD, 0xABCD, "ascii", L"unicode");
+  HOST_CHECK (AsciiStrCmp (Buffer, "-12 ABCD ABCD ascii unicode") == 0);
+  HOST_CHECK (Length == AsciiStrLen (Buffer));
+
+  AsciiSPrint (Buffer, sizeof (Buffer), "[%5d][%-5d][%05d][%,d]", 42, 42, 42, 1234567);
+  HOST_CHECK (AsciiStrCmp (Buffer, "[   42][42   ][00042][1,234,567]") == 0);
+
+  AsciiSPrint (Buffer, sizeof (Buffer), "%lx %016lX %ld", 0x123456789ULL, 0xABCDULL, -5LL);
+  HOST_CHECK (AsciiStrCmp (Buffer, "123456789 000000000000ABCD -5") == 0);
+
+  AsciiSPrint (Buffer, sizeof (Buffer), "%g", &mPrintGuid);
+  HOST_CHECK (AsciiStrCmp (Buffer, "8863C0AD-7724-C84B-88E5-A33B116D1485") == 0);
+
+  AsciiSPrint (Buffer, sizeof (Buffer), "%r", RETURN_NOT_FOUND);
+  HOST_CHECK (AsciiStrCmp (Buffer, "Not Found") == 0);
+
+  AsciiSPrint (Buffer, 8, "%a", "truncated string");
+  HOST_CHECK (AsciiStrCmp (Buffer, "truncat") == 0);
+  return TRUE;
+}
+
+BOOLEAN
+TestUnicodeSPrint (
+  VOID
+  )
+{
+  CHAR16  Buffer[128];
+
+  UnicodeSPrint (Buffer, sizeof (Buffer), L"%d-%x-%s-%a", 7, 0x1F, L"wide", "narrow");
+  HOST_CHECK (StrCmp (Buffer, L"7-1F-wide-narrow") == 0);
+
+  UnicodeSPrintAsciiFormat (Buffer, sizeof (Buffer), "%08x", 0xBEEF);
+  HOST_CHECK (StrCmp (Buffer, L"0000BEEF") == 0);
+  return TRUE;
+}
+
+BOOLEAN
+TestValueToString (
+  VOID
+  )
+{
+  CHAR8  Buffer[32];
+
+  HOST_CHECK (AsciiValueToStringS (Buffer, sizeof (Buffer), 0, -123456, 0) == RETURN_SUCCESS);
+  HOST_CHECK (AsciiStrCmp (Buffer, "-123456") == 0);
+  HOST_CHECK (AsciiValueToStringS (Buffer, sizeof (Buffer), COMMA_TYPE, 9876543, 0) == RETURN_SUCCESS);
+  HOST_CHECK (AsciiStrCmp (Buffer, "9,876,543") == 0);
+  HOST_CHECK (AsciiValueToStringS (Buffer, sizeof (Buffer), PREFIX_ZERO | RADIX_HEX, 0xAB, 6) == RETURN_SUCCESS);
+  HOST_CHECK (AsciiStrCmp (Buffer, "0000AB") == 0);
+  return TRUE;
+}
+
+VOID
+BenchAsciiSPrintMixed (
+  IN UINTN  Iterations
+  )
+{
+  CHAR8  Buffer[128];
+
+  while (Iterations-- > 0) {
+    gHostBenchSink += AsciiSPrint (Buffer, sizeof (Buffer), "%a: %d %08x %s", "Module", (UINT32)Iterations, 0xFEED, L"Loaded");
+  }
+}
+
+VOID
+BenchAsciiSPrintHex64 (
+  IN UINTN  Iterations
+  )
+{
+  CHAR8  Buffer[64];
+
+  while (Iterations-- > 0) {
+    gHostBenchSink += AsciiSPrint (Buffer, sizeof (Buffer), "0x%016lx", (UINT64)Iterations * 0x9E3779B97F4A7C15ULL);
+  }
+}
+
+VOID
+BenchAsciiSPrintGuid (
+  IN UINTN  Iterations
+  )
+{
+  CHAR8  Buffer[64];
+
+  while (Iterations-- > 0) {
+    gHostBenchSink += AsciiSPrint (Buffer, sizeof (Buffer), "%g", &mPrintGuid);
+  }
+}
+
+VOID
+BenchUnicodeSPrintMixed (
+  IN UINTN  Iterations
+  )
+{
+  CHAR16  Buffer[128];
+
+  while (Iterations-- > 0) {
+    gHostBenchSink += UnicodeSPrint (Buffer, sizeof (Buffer), L"%s: %d %08x %a", L"Module", (UINT32)Iterations, 0xFEED, "Loaded");
+  }
+}
+
+CONST HOST_TEST  mPrintLibTests[] = {
+  { "AsciiSPrint",     TestAsciiSPrint   },
+  { "UnicodeSPrint",   TestUnicodeSPrint },
+  { "ValueToString",   TestValueToString }
+};
+
+CONST HOST_BENCH  mPrintLibBenches[] = {
+  { "AsciiSPrint %a %d %x %s",   0, BenchAsciiSPrintMixed   },
+  { "AsciiSPrint %016lx",        0, BenchAsciiSPrintHex64   },
+  { "AsciiSPrint %g",            0, BenchAsciiSPrintGuid    },
+  { "UnicodeSPrint %s %d %x %a", 0, BenchUnicodeSPrintMixed }
+};
+
+HOST_SUITE  gPrintLibSuite = {
+  "PrintLib",
+  NULL,
+  mPrintLibTests,
+  ARRAY_SIZE (mPrintLibTests),
+  mPrintLibBenches,
+  ARRAY_SIZE (mPrintLibBenches)
+};
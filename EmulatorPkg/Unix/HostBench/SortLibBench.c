@@ -0,0 +1,216 @@
+/** @file
+  Tests and benchmarks of SortLib.
+
+  Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "HostBench.h"
+#include <Library/SortLib.h>
+
+#define SORT_SMALL_COUNT   100
+#define SORT_LARGE_COUNT   10000
+//
+// PerformQuickSort() picks the last element as the pivot, so sorted input
+// takes quadratic time. Keep that case small.
+//
+#define SORT_SORTED_COUNT  1000
+
+typedef struct {
+  UINT32  Key;
+  UINT32  Payload[5];
+} SORT_RECORD;
+
+UINT32  *mUnsorted;
+UINT32  *mSortBuffer;
+
+/**
+  Compare two UINT32 values.
+
+  @param[in] Buffer1  Pointer to the first value.
+  @param[in] Buffer2  Pointer to the second value.
+
+  @retval 0     The values are equal.
+  @retval <0    The first value is smaller.
+  @retval >0    The first value is bigger.
+
+**/
+INTN
+EFIAPI
+CompareUint32 (
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  UINT32  Value1;
+  UINT32  Value2;
+
+  Value1 = *(CONST UINT32 *)Buffer1;
+  Value2 = *(CONST UINT32 *)Buffer2;
+  if (Value1 < Value2) {
+    return -1;
+  }
+  return Value1 > Value2 ? 1 : 0;
+}
+
+BOOLEAN
+SortLibSetup (
+  VOID
+  )
+{
+  UINTN   Index;
+  UINT32  Seed;
+
+  mUnsorted   = AllocatePool (SORT_LARGE_COUNT * sizeof (UINT32));
+  mSortBuffer = AllocatePool (SORT_LARGE_COUNT * sizeof (UINT32));
+  if (mUnsorted == NULL || mSortBuffer == NULL) {
+    return FALSE;
+  }
+  Seed = 1;
+  for (Index = 0; Index < SORT_LARGE_COUNT; Index++) {
+    Seed = Seed * 1103515245 + 12345;
+    mUnsorted[Index] = Seed >> 8;
+  }
+  return TRUE;
+}
+
+BOOLEAN
+TestQuickSort (
+  VOID
+  )
+{
+  UINTN   Index;
+  UINT32  Values[7];
+
+  CopyMem (mSortBuffer, mUnsorted, SORT_LARGE_COUNT * sizeof (UINT32));
+  PerformQuickSort (mSortBuffer, SORT_LARGE_COUNT, sizeof (UINT32), CompareUint32);
+  for (Index = 1; Index < SORT_LARGE_COUNT; Index++) {
+    HOST_CHECK (mSortBuffer[Index - 1] <= mSortBuffer[Index]);
+  }
+
+  //
+  // Duplicates, then already sorted and reversed input
+  //
+  Values[0] = 3;
+  Values[1] = 1;
+  Values[2] = 3;
+  Values[3] = 2;
+  Values[4] = 1;
+  Values[5] = 3;
+  Values[6] = 0;
+  PerformQuickSort (Values, ARRAY_SIZE (Values), sizeof (UINT32), CompareUint32);
+  HOST_CHECK (Values[0] == 0 && Values[1] == 1 && Values[2] == 1 && Values[3] == 2);
+  HOST_CHECK (Values[4] == 3 && Values[5] == 3 && Values[6] == 3);
+
+  PerformQuickSort (mSortBuffer, SORT_SORTED_COUNT, sizeof (UINT32), CompareUint32);
+  for (Index = 1; Index < SORT_SORTED_COUNT; Index++) {
+    HOST_CHECK (mSortBuffer[Index - 1] <= mSortBuffer[Index]);
+  }
+  for (Index = 0; Index < SORT_SMALL_COUNT; Index++) {
+    mSortBuffer[Index] = (UINT32)(SORT_SMALL_COUNT - Index);
+  }
+  PerformQuickSort (mSortBuffer, SORT_SMALL_COUNT, sizeof (UINT32), CompareUint32);
+  for (Index = 0; Index < SORT_SMALL_COUNT; Index++) {
+    HOST_CHECK (mSortBuffer[Index] == Index + 1);
+  }
+  return TRUE;
+}
+
+BOOLEAN
+TestSortRecords (
+  VOID
+  )
+{
+  SORT_RECORD  Records[5];
+  UINTN        Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (Records); Index++) {
+    Records[Index].Key = (UINT32)((Index * 3) % ARRAY_SIZE (Records));
+    Records[Index].Payload[0] = Records[Index].Key * 2;
+    Records[Index].Payload[4] = Records[Index].Key * 3;
+  }
+  PerformQuickSort (Records, ARRAY_SIZE (Records), sizeof (SORT_RECORD), CompareUint32);
+  for (Index = 0; Index < ARRAY_SIZE (Records); Index++) {
+    HOST_CHECK (Records[Index].Key == Index);
+    HOST_CHECK (Records[Index].Payload[0] == Index * 2 && Records[Index].Payload[4] == Index * 3);
+  }
+  return TRUE;
+}
+
+/**
+  Sort a copy of the first Count random values.
+
+  The time of the copy is included. It is small next to the sort.
+
+  @param[in] Iterations  Number of sorts.
+  @param[in] Count       Number of values to sort.
+
+**/
+VOID
+SortRandom (
+  IN UINTN  Iterations,
+  IN UINTN  Count
+  )
+{
+  while (Iterations-- > 0) {
+    CopyMem (mSortBuffer, mUnsorted, Count * sizeof (UINT32));
+    PerformQuickSort (mSortBuffer, Count, sizeof (UINT32), CompareUint32);
+    gHostBenchSink += mSortBuffer[0];
+  }
+}
+
+VOID
+BenchQuickSortSmall (
+  IN UINTN  Iterations
+  )
+{
+  SortRandom (Iterations, SORT_SMALL_COUNT);
+}
+
+VOID
+BenchQuickSortLarge (
+  IN UINTN  Iterations
+  )
+{
+  SortRandom (Iterations, SORT_LARGE_COUNT);
+}
+
+VOID
+BenchQuickSortSorted (
+  IN UINTN  Iterations
+  )
+{
+  CopyMem (mSortBuffer, mUnsorted, SORT_SORTED_COUNT * sizeof (UINT32));
+  PerformQuickSort (mSortBuffer, SORT_SORTED_COUNT, sizeof (UINT32), CompareUint32);
+  while (Iterations-- > 0) {
+    PerformQuickSort (mSortBuffer, SORT_SORTED_COUNT, sizeof (UINT32), CompareUint32);
+    gHostBenchSink += mSortBuffer[0];
+  }
+}
+
+CONST HOST_TEST  mSortLibTests[] = {
+  { "QuickSort",     TestQuickSort     },
+  { "SortRecords",   TestSortRecords   }
+};
+
+CONST HOST_BENCH  mSortLibBenches[] = {
+  { "PerformQuickSort 100 random",   0, BenchQuickSortSmall  },
+  { "PerformQuickSort 10000 random", 0, BenchQuickSortLarge  },
+  { "PerformQuickSort 1000 sorted", 0, BenchQuickSortSorted }
+};
+
+HOST_SUITE  gSortLibSuite = {
+  "SortLib",
+  SortLibSetup,
+  mSortLibTests,
+  ARRAY_SIZE (mSortLibTests),
+  mSortLibBenches,
+  ARRAY_SIZE (mSortLibBenches)
+};
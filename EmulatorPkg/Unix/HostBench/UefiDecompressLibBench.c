@@ -0,0 +1,370 @@
+/** @file
+  Tests and benchmarks of UefiDecompressLib.
+
+  The compressed sample is the output of the EfiCompress() function of
+  BaseTools for the text GenerateSample() produces.
+
+  Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "HostBench.h"
+#include <Library/UefiDecompressLib.h>
+
+#define SAMPLE_SIZE  0x4000
+
+CONST CHAR8  *mSampleWords[] = {
+  "firmware", "volume", "section", "driver", "protocol", "handle", "image", "memory",
+  "variable", "boot", "device", "path", "table", "event", "timer", "service"
+};
+
+CONST UINT8  mCompressedSample[] = {
+  0x5C, 0x0A, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x05, 0x50, 0x6C, 0xB2,
+  0xB1, 0xB6, 0xDB, 0x8F, 0xF9, 0xFB, 0x40, 0x2B, 0x45, 0x8E, 0xC8, 0xAD,
+  0x8F, 0x31, 0xB8, 0xAE, 0x28, 0x6B, 0xB9, 0x74, 0xE5, 0x61, 0x1C, 0x00,
+  0x1D, 0xDF, 0xFF, 0x00, 0x48, 0x48, 0xA7, 0x2B, 0x99, 0x67, 0x00, 0x3B,
+  0xB5, 0x92, 0x34, 0x9F, 0xF3, 0xD7, 0xA6, 0x9D, 0x3E, 0x5D, 0x3D, 0x39,
+  0x7B, 0x74, 0xF4, 0xFE, 0xBD, 0x79, 0xF2, 0xF3, 0xF5, 0xF2, 0xFE, 0x39,
+  0xF2, 0xA7, 0xCB, 0xA7, 0x9F, 0xAF, 0x3E, 0xBC, 0xBD, 0x79, 0xFA, 0xF4,
+  0xEB, 0xFE, 0x4F, 0xC2, 0xFD, 0xBA, 0x74, 0xD1, 0x34, 0xF2, 0xFD, 0xBD,
+  0x39, 0xF2, 0xF9, 0xF3, 0xF6, 0xF3, 0xF9, 0x73, 0xE5, 0xED, 0xE5, 0xD7,
+  0xCF, 0x5F, 0xFF, 0xE9, 0xE5, 0xF5, 0xF9, 0xFA, 0x4F, 0x04, 0x5F, 0x3A,
+  0x78, 0x5A, 0x7D, 0xB9, 0xFC, 0xB4, 0xF3, 0xE9, 0xF5, 0x9E, 0x1B, 0xF6,
+  0xE7, 0xD7, 0x5F, 0x72, 0x59, 0x14, 0xB0, 0xFA, 0x61, 0x1F, 0xBF, 0x9F,
+  0x5F, 0x5F, 0xEF, 0xCB, 0xAD, 0x32, 0x1F, 0xE7, 0xCB, 0x4F, 0xA2, 0xF9,
+  0x27, 0x06, 0xA6, 0xAA, 0x5F, 0x9D, 0x29, 0x97, 0x9C, 0x9E, 0xDE, 0x44,
+  0xBE, 0x09, 0xFE, 0xCF, 0x8F, 0x2D, 0x79, 0xCF, 0xDB, 0x9F, 0xD7, 0x4E,
+  0x5F, 0x3E, 0xBE, 0x7E, 0xDF, 0xEE, 0x65, 0xAE, 0x7B, 0x3F, 0xBE, 0x5F,
+  0x4A, 0xFA, 0x8B, 0xBC, 0x27, 0xF5, 0xAE, 0xAD, 0xFB, 0xF1, 0x08, 0xE3,
+  0xAA, 0x67, 0x94, 0xFE, 0x1F, 0x88, 0xD7, 0xC5, 0xA6, 0xF5, 0x9F, 0x38,
+  0x1E, 0x57, 0x5E, 0x24, 0x97, 0xA7, 0x1C, 0xF7, 0x4F, 0x72, 0x9F, 0x09,
+  0xD2, 0xB4, 0xCE, 0xA3, 0x26, 0xA7, 0xFF, 0x4F, 0xE2, 0x9E, 0x52, 0xE7,
+  0x0B, 0xC0, 0x12, 0xE7, 0x89, 0x6D, 0xDD, 0x72, 0x19, 0x70, 0x5B, 0xC1,
+  0xD2, 0xF1, 0xC4, 0xB3, 0x23, 0xC3, 0xCB, 0xFB, 0x49, 0x79, 0x33, 0xC3,
+  0xF5, 0xFF, 0x53, 0x5C, 0x8B, 0x5C, 0x6B, 0x5F, 0xC4, 0xF4, 0x52, 0xC3,
+  0x44, 0xFC, 0xB5, 0xCC, 0x27, 0xB8, 0x75, 0xF2, 0x97, 0x3E, 0x5C, 0xAE,
+  0x5B, 0x4D, 0x29, 0xB2, 0xA7, 0x02, 0xCB, 0xF3, 0xD7, 0x45, 0x4B, 0x10,
+  0x5D, 0x50, 0x78, 0xAA, 0x58, 0x92, 0x2F, 0x7F, 0x4F, 0xCB, 0xA7, 0x0A,
+  0xCB, 0x36, 0x3D, 0x38, 0xFE, 0xD5, 0x61, 0xD5, 0xB8, 0xE5, 0x71, 0x6D,
+  0x7D, 0xE5, 0xC6, 0xE9, 0x82, 0xCE, 0x4B, 0x6B, 0x1D, 0x1A, 0x6D, 0x8E,
+  0x8E, 0x07, 0x68, 0x6E, 0xAC, 0x98, 0xCF, 0x5A, 0x0D, 0xD0, 0x7A, 0x28,
+  0xC4, 0x3D, 0x38, 0x3B, 0x5F, 0x72, 0x7B, 0xE2, 0xA0, 0x0C, 0xDA, 0x8A,
+  0xDA, 0xA6, 0xFE, 0x41, 0xCF, 0x27, 0xB9, 0x25, 0xEC, 0x53, 0x51, 0x4B,
+  0xB1, 0x65, 0xB7, 0xF5, 0xDE, 0x0F, 0x2C, 0x0D, 0x0C, 0xE9, 0x2F, 0x2A,
+  0xFA, 0xD7, 0x5D, 0xE4, 0x74, 0xF3, 0xEA, 0x49, 0x72, 0x13, 0x65, 0x16,
+  0xE7, 0x54, 0xA7, 0x3A, 0xAE, 0xA0, 0xD7, 0xEB, 0x5E, 0x21, 0xAC, 0xA3,
+  0x80, 0xBF, 0x6C, 0x03, 0x94, 0x42, 0xF6, 0x39, 0xD4, 0x7E, 0xE3, 0xBB,
+  0x65, 0xA6, 0x20, 0x5F, 0x17, 0xB3, 0xE5, 0xFA, 0x4A, 0xC8, 0x66, 0x41,
+  0xEA, 0x26, 0xF0, 0xF7, 0x01, 0x02, 0x59, 0x64, 0x0F, 0x80, 0x53, 0x46,
+  0x4B, 0x8A, 0xD8, 0x5A, 0x75, 0xFC, 0x2F, 0x15, 0xE0, 0x0D, 0xAC, 0x1B,
+  0xDA, 0xE2, 0x08, 0xC0, 0x4B, 0x2E, 0x6C, 0x94, 0x2A, 0xCB, 0xC3, 0xA8,
+  0x7D, 0xEB, 0x8A, 0xF3, 0xB0, 0xB2, 0xCF, 0xBA, 0xAA, 0x0F, 0x1F, 0x7F,
+  0x09, 0xF7, 0x04, 0xC7, 0x19, 0xE4, 0x34, 0x94, 0xFA, 0xF4, 0xA3, 0xC8,
+  0xA3, 0xEF, 0x18, 0x88, 0x05, 0xF4, 0x25, 0xEE, 0xC7, 0x73, 0x9F, 0x31,
+  0x2C, 0x29, 0xF6, 0x0B, 0x0E, 0x5B, 0xE9, 0x79, 0x62, 0x13, 0x9B, 0x23,
+  0x05, 0x5A, 0x34, 0x38, 0xCB, 0x03, 0x7E, 0xF0, 0x1C, 0x34, 0xFB, 0x66,
+  0x34, 0xD8, 0x30, 0x95, 0xC2, 0xD7, 0xAB, 0xA8, 0x28, 0xEB, 0x87, 0x37,
+  0x48, 0x3F, 0xBC, 0x3D, 0x6C, 0xF2, 0x8C, 0xF8, 0x9D, 0xF7, 0xF1, 0x83,
+  0x7D, 0x72, 0xB9, 0x97, 0x33, 0x07, 0x69, 0x89, 0x0D, 0x7C, 0xD4, 0x5E,
+  0x72, 0xA0, 0x7A, 0xB8, 0xE4, 0xBF, 0x60, 0x5E, 0x6D, 0x67, 0x3C, 0xCD,
+  0x15, 0xB9, 0x9B, 0x85, 0xFF, 0xF8, 0x96, 0xC5, 0xF6, 0x9F, 0xAF, 0xCF,
+  0x97, 0xDC, 0x02, 0xA9, 0x90, 0xCB, 0x93, 0x62, 0x13, 0x9E, 0x21, 0x88,
+  0xB0, 0x30, 0x47, 0x89, 0x48, 0xD7, 0xAC, 0x29, 0x0D, 0x9E, 0x11, 0x9D,
+  0x73, 0x93, 0x02, 0x33, 0x3D, 0x80, 0x82, 0x3F, 0xB1, 0x2E, 0x5B, 0xCE,
+  0x2D, 0x37, 0xEB, 0xF0, 0x99, 0x9B, 0xDA, 0x6A, 0x29, 0x9E, 0x2D, 0xD2,
+  0xA1, 0x00, 0xAE, 0x79, 0x52, 0x24, 0x3D, 0x43, 0x99, 0x74, 0xEE, 0x11,
+  0x08, 0xE6, 0x84, 0xFD, 0xEA, 0x22, 0x3F, 0x4C, 0x64, 0x64, 0xEE, 0x23,
+  0xAB, 0x9F, 0x88, 0x80, 0x44, 0xD6, 0x37, 0x35, 0xE4, 0xDA, 0x91, 0x40,
+  0x37, 0xF2, 0x3D, 0xD1, 0x0E, 0x33, 0xCE, 0x0A, 0x19, 0x5A, 0x02, 0xA8,
+  0xA7, 0x56, 0xD8, 0x8F, 0x01, 0x73, 0xF5, 0x54, 0xB1, 0x1B, 0xD5, 0x04,
+  0x50, 0xAB, 0xB3, 0xA8, 0xD9, 0xAF, 0xA4, 0x11, 0x4D, 0xD9, 0x32, 0x47,
+  0xBE, 0x92, 0x01, 0xA6, 0xC3, 0xA7, 0x1D, 0x51, 0x4F, 0x6A, 0x7C, 0x82,
+  0x38, 0x2F, 0x7E, 0x5D, 0xD3, 0x10, 0xCB, 0x78, 0x45, 0x5D, 0x85, 0x0B,
+  0x38, 0xEE, 0x6C, 0x0C, 0x00, 0x17, 0x57, 0xC1, 0xEA, 0xD0, 0x32, 0xE0,
+  0xBD, 0x44, 0xD6, 0xCF, 0x97, 0xEC, 0x81, 0xD3, 0x19, 0x9B, 0x0A, 0xAD,
+  0x78, 0xEA, 0x73, 0x16, 0x03, 0x74, 0x31, 0x82, 0x7D, 0x92, 0x50, 0x31,
+  0xB4, 0x6A, 0x50, 0xC0, 0x75, 0x80, 0x1C, 0x73, 0xF1, 0x18, 0xF8, 0x9C,
+  0xC5, 0xF7, 0x5F, 0xA2, 0x10, 0x28, 0xCB, 0xF5, 0x39, 0x2C, 0x02, 0x12,
+  0xD2, 0x7A, 0xC0, 0xB9, 0xFB, 0xED, 0xD1, 0x72, 0x5D, 0xB2, 0x11, 0x0A,
+  0x79, 0xD1, 0x84, 0xC1, 0xBF, 0xD8, 0xCC, 0x4B, 0x3B, 0x59, 0x8B, 0x6D,
+  0xE1, 0x24, 0x08, 0x80, 0x59, 0xB8, 0x43, 0x03, 0xCA, 0xC4, 0x0F, 0x23,
+  0x98, 0x06, 0xAA, 0x83, 0x26, 0x37, 0x2F, 0x8F, 0x54, 0x93, 0x5D, 0x23,
+  0x4E, 0x33, 0x6F, 0xB9, 0x91, 0xE1, 0xF5, 0x66, 0xCF, 0x33, 0xEA, 0xF1,
+  0xFF, 0x91, 0xEC, 0xAA, 0x14, 0x99, 0x0D, 0xE5, 0xA3, 0x6F, 0xDE, 0xEE,
+  0xF9, 0x88, 0x87, 0x35, 0xD2, 0x50, 0xCE, 0x64, 0x08, 0x96, 0x2C, 0xFD,
+  0x5E, 0x2C, 0x60, 0x19, 0xC7, 0x07, 0x55, 0x49, 0x92, 0xD3, 0x8D, 0xBD,
+  0x5E, 0x70, 0x40, 0xC9, 0x43, 0xB6, 0x84, 0x95, 0xBA, 0xF9, 0xC8, 0xA3,
+  0x3F, 0x6C, 0xB6, 0xA3, 0x4B, 0x42, 0xB5, 0x46, 0x74, 0x01, 0x33, 0xB0,
+  0xCE, 0x4D, 0x82, 0x12, 0xE4, 0xE0, 0x8F, 0x14, 0x33, 0xCB, 0x37, 0x61,
+  0xAD, 0xF5, 0xE0, 0x42, 0xE7, 0x26, 0x11, 0x34, 0x26, 0xE7, 0x32, 0xEF,
+  0x68, 0x92, 0xD2, 0x25, 0xC4, 0x50, 0x68, 0xA2, 0x7F, 0x86, 0xD5, 0xAB,
+  0x13, 0x04, 0x36, 0x89, 0x26, 0x32, 0x5A, 0x96, 0x7F, 0x57, 0x76, 0x55,
+  0xE9, 0x09, 0xBD, 0x32, 0xA9, 0x4D, 0x94, 0xBA, 0x7F, 0x2E, 0xFB, 0x71,
+  0x46, 0x0F, 0xCE, 0x0C, 0xFA, 0x0E, 0xFE, 0x1F, 0x5C, 0xB0, 0x4B, 0x68,
+  0x91, 0xC9, 0x68, 0x4F, 0x06, 0x01, 0xFA, 0x07, 0x11, 0xFB, 0x17, 0x27,
+  0x65, 0x6C, 0xC0, 0x33, 0x8A, 0x1F, 0xA6, 0xF4, 0x26, 0x61, 0x4E, 0x10,
+  0xA6, 0xA8, 0x3F, 0xDB, 0xCB, 0x6A, 0x61, 0x78, 0x88, 0xCD, 0xBB, 0x2B,
+  0x7E, 0xE2, 0x51, 0x15, 0x88, 0x2E, 0xE2, 0xCC, 0x0C, 0x93, 0xD0, 0x15,
+  0x8A, 0x46, 0xE7, 0x6B, 0x81, 0xA6, 0x8E, 0xAA, 0xC2, 0x6A, 0xE6, 0x51,
+  0x7C, 0x53, 0x70, 0x7E, 0x81, 0x86, 0xFC, 0x0E, 0x68, 0x67, 0x40, 0x42,
+  0x0C, 0x5B, 0xEB, 0x58, 0x68, 0x29, 0x12, 0x74, 0xCE, 0x81, 0x22, 0xB8,
+  0x20, 0x80, 0xBB, 0xB2, 0x59, 0xCB, 0x79, 0xB6, 0x65, 0xEE, 0x41, 0x2D,
+  0x95, 0xB9, 0xD9, 0x01, 0x49, 0x00, 0xBF, 0x61, 0x44, 0x48, 0x02, 0x90,
+  0x8A, 0xA6, 0x16, 0xE8, 0xEE, 0x28, 0xE3, 0xB1, 0x57, 0x8E, 0x84, 0x25,
+  0x14, 0x33, 0x9A, 0x96, 0x44, 0x49, 0x64, 0x55, 0xE9, 0x42, 0x84, 0xEC,
+  0xB4, 0xD5, 0x20, 0xEC, 0x02, 0x03, 0x58, 0x15, 0x02, 0x46, 0xE4, 0xE4,
+  0xF8, 0x62, 0xA3, 0x53, 0x3F, 0x6E, 0x55, 0xFC, 0x4D, 0xA2, 0x1E, 0x59,
+  0xCD, 0x3D, 0xD3, 0x4F, 0x5B, 0x01, 0xBE, 0xF0, 0x3A, 0xEA, 0x76, 0x81,
+  0x02, 0x89, 0x98, 0x01, 0xEF, 0x9A, 0x14, 0x7D, 0xB7, 0x35, 0xD0, 0x87,
+  0xB9, 0x2C, 0xCE, 0xA7, 0xC0, 0x81, 0x44, 0x73, 0x7D, 0x86, 0xD4, 0x0C,
+  0x19, 0x90, 0x77, 0x38, 0x8C, 0x92, 0x81, 0x15, 0x8F, 0xEF, 0x45, 0x1A,
+  0x99, 0x3C, 0x44, 0xD7, 0x14, 0xC2, 0xA3, 0x6D, 0x7C, 0x53, 0x1A, 0x78,
+  0x49, 0x72, 0xE6, 0x66, 0xAD, 0xD9, 0xA2, 0x0E, 0x08, 0x97, 0x61, 0x06,
+  0x1B, 0xBC, 0x23, 0xBE, 0x3A, 0x8D, 0xD8, 0x3A, 0x10, 0xE6, 0x97, 0x75,
+  0xBA, 0x8C, 0xD1, 0xA2, 0xBF, 0x08, 0x7C, 0x6A, 0x72, 0x58, 0xC0, 0xD9,
+  0x12, 0x46, 0xA7, 0xE6, 0xE7, 0x8C, 0x4E, 0xA9, 0xA9, 0x4D, 0xA0, 0x19,
+  0x08, 0x26, 0x6D, 0x05, 0x84, 0x30, 0x81, 0x60, 0x2A, 0xF5, 0x43, 0x12,
+  0x9B, 0x0B, 0x8C, 0x54, 0x6D, 0xF2, 0x1E, 0xCE, 0x60, 0x90, 0xA3, 0x7E,
+  0xEC, 0xBA, 0x77, 0x5C, 0xA3, 0x0A, 0xFF, 0xBD, 0x8B, 0x0B, 0xAA, 0x2A,
+  0xF5, 0x1A, 0x9A, 0x2D, 0x52, 0xAB, 0xD3, 0x88, 0x97, 0x04, 0xFF, 0x54,
+  0xA3, 0x43, 0xA7, 0xE0, 0x44, 0xBF, 0xEB, 0x61, 0x5C, 0x52, 0xFF, 0x29,
+  0xFD, 0x23, 0x8F, 0xAE, 0x9E, 0x36, 0x1B, 0x07, 0x82, 0xC2, 0x59, 0x06,
+  0x0D, 0x5A, 0x4C, 0x2D, 0x5D, 0xAC, 0x15, 0xAA, 0x0D, 0xE7, 0x62, 0xDD,
+  0x0F, 0xB2, 0x10, 0x1C, 0x21, 0xB7, 0xC6, 0xAB, 0xBA, 0x5E, 0x1B, 0x94,
+  0x99, 0x08, 0x70, 0xE9, 0xCC, 0x61, 0x41, 0xF3, 0xCD, 0x2C, 0xF8, 0xB8,
+  0x71, 0x31, 0xE4, 0x60, 0x19, 0x31, 0x27, 0x79, 0xED, 0xB3, 0x6F, 0x85,
+  0x56, 0x92, 0xC6, 0x6A, 0x2A, 0x8D, 0xE3, 0xC9, 0x2C, 0x0F, 0x1B, 0xDC,
+  0x18, 0xCD, 0x0B, 0x22, 0x4B, 0xEA, 0x01, 0xF9, 0x06, 0x92, 0x01, 0x00,
+  0xEE, 0x0E, 0x92, 0x59, 0x33, 0x70, 0x1E, 0x25, 0x3C, 0xC9, 0x92, 0x1C,
+  0xE9, 0x6B, 0xBD, 0xFE, 0x22, 0x69, 0x82, 0x80, 0x1D, 0x29, 0xA3, 0x9E,
+  0x38, 0xC9, 0xD6, 0xAE, 0x54, 0x72, 0x22, 0x10, 0xEB, 0x3E, 0x78, 0x6D,
+  0x8A, 0x56, 0xBD, 0x4C, 0xA7, 0x32, 0x3A, 0xB6, 0xB5, 0x46, 0xC1, 0x3D,
+  0x26, 0x2E, 0x9D, 0xB3, 0xCB, 0x5B, 0xB1, 0xFE, 0x15, 0xB9, 0xEE, 0xF6,
+  0x20, 0x6B, 0xA0, 0xAA, 0xA0, 0x0A, 0x65, 0x30, 0x36, 0x65, 0xFA, 0xC0,
+  0x1F, 0x05, 0x77, 0xC5, 0xF5, 0x79, 0x60, 0xE7, 0xE4, 0xDE, 0xC8, 0xA0,
+  0x65, 0xCE, 0x0E, 0xDC, 0x22, 0x5C, 0xD3, 0xCF, 0xDD, 0xE7, 0x37, 0xAC,
+  0x31, 0x9A, 0x1B, 0x16, 0xE5, 0x04, 0xCA, 0x9E, 0xDA, 0x68, 0xDE, 0xF3,
+  0x98, 0x4E, 0x52, 0x77, 0xAB, 0x70, 0x67, 0xC6, 0x9F, 0xF1, 0xE7, 0x5E,
+  0xCB, 0x55, 0xB0, 0xC3, 0x69, 0x14, 0x9B, 0x51, 0xB5, 0xCD, 0xC0, 0xF1,
+  0x83, 0x35, 0x7C, 0xFD, 0x6E, 0x90, 0xB2, 0x66, 0x3B, 0x4D, 0x1C, 0x11,
+  0xCD, 0x94, 0x93, 0x40, 0x15, 0x76, 0xE9, 0x1D, 0x67, 0x9B, 0x48, 0x8C,
+  0x0C, 0x92, 0x44, 0x40, 0x97, 0x97, 0xE6, 0xBD, 0x77, 0x23, 0x29, 0x35,
+  0xBD, 0xD1, 0x10, 0xD6, 0x1D, 0xEE, 0xF2, 0x1B, 0x2E, 0x1F, 0x59, 0x8A,
+  0xC2, 0x34, 0x37, 0x4B, 0x75, 0x85, 0xBF, 0x64, 0xEC, 0x86, 0x0C, 0x08,
+  0x80, 0x2B, 0xDD, 0x0A, 0x2C, 0xAE, 0x20, 0x99, 0x27, 0x41, 0x56, 0x42,
+  0x13, 0xF7, 0x84, 0x21, 0x34, 0x0B, 0xF0, 0x0C, 0x79, 0xBB, 0x46, 0x61,
+  0xD1, 0x1F, 0x81, 0x20, 0xAE, 0x0D, 0x8A, 0xC2, 0x33, 0x1A, 0x6D, 0xCE,
+  0x2B, 0x0D, 0xD8, 0xBB, 0x0B, 0xB4, 0x05, 0x87, 0xFB, 0xD2, 0x47, 0x2F,
+  0x56, 0x8A, 0x0E, 0xEF, 0xAC, 0x51, 0xED, 0x0E, 0xB3, 0x6A, 0x81, 0xAF,
+  0x0B, 0x43, 0xAF, 0x1B, 0xA6, 0x30, 0x0E, 0x0F, 0x50, 0x26, 0xE3, 0x35,
+  0xA6, 0x2D, 0xCF, 0xBD, 0x10, 0x9A, 0xD4, 0x6B, 0x8E, 0x9B, 0x1D, 0xE6,
+  0x6C, 0xE0, 0x0A, 0x9E, 0x62, 0x95, 0x36, 0xD5, 0x13, 0x1D, 0x1F, 0x69,
+  0xC5, 0x16, 0xB8, 0x57, 0x73, 0x90, 0xA5, 0xD8, 0x15, 0x02, 0xE2, 0x06,
+  0xCF, 0x09, 0x68, 0xED, 0x4C, 0x4E, 0xDD, 0xFD, 0x4E, 0xCE, 0x40, 0x3C,
+  0x74, 0x32, 0x87, 0xA3, 0x65, 0x78, 0xF0, 0xF7, 0x77, 0x20, 0x5B, 0xAC,
+  0x3C, 0xE1, 0xEF, 0x28, 0x45, 0x75, 0x67, 0x35, 0x97, 0x35, 0x47, 0x25,
+  0xF7, 0xBE, 0x9C, 0xDD, 0x00, 0x96, 0xC8, 0xE2, 0x82, 0xC7, 0xE2, 0xCE,
+  0xFE, 0x6C, 0x1B, 0x77, 0x7B, 0x54, 0x58, 0xF5, 0xB2, 0x80, 0x09, 0x1E,
+  0x55, 0xB0, 0x3E, 0x2D, 0x9F, 0x8C, 0xA8, 0x85, 0x04, 0x23, 0xAD, 0xC3,
+  0x6E, 0xAD, 0x5F, 0x16, 0x10, 0x37, 0x97, 0x1B, 0x22, 0x88, 0xD7, 0x9F,
+  0xBC, 0x45, 0x3C, 0x63, 0x6E, 0x14, 0xB7, 0xD3, 0x7D, 0x82, 0x7C, 0x03,
+  0xDA, 0x8F, 0x3B, 0x56, 0x7D, 0xDC, 0x6B, 0xEC, 0x06, 0x58, 0xB5, 0x81,
+  0x8F, 0x86, 0x3A, 0x26, 0x1D, 0x2E, 0xE3, 0x7D, 0x34, 0x07, 0xC4, 0xAF,
+  0x41, 0x96, 0x9B, 0x0C, 0x7D, 0xAE, 0x33, 0x3D, 0xC1, 0x50, 0xBC, 0x3B,
+  0x19, 0x2F, 0x13, 0x73, 0xB7, 0x94, 0x23, 0x42, 0xCA, 0x16, 0x13, 0xCB,
+  0xC5, 0x07, 0x13, 0xDB, 0x7F, 0xA0, 0xA7, 0x4D, 0xE9, 0x95, 0x62, 0x0C,
+  0xD2, 0xD6, 0x05, 0x6E, 0xF9, 0xBB, 0x2E, 0x51, 0xCF, 0xD6, 0xD5, 0x41,
+  0x9D, 0x73, 0x95, 0x8A, 0xB2, 0xF9, 0x57, 0x19, 0xFD, 0xDB, 0xDD, 0x59,
+  0x66, 0x27, 0x40, 0x82, 0x1F, 0x0F, 0x65, 0x23, 0xE2, 0x2D, 0x72, 0x70,
+  0xF4, 0x3C, 0x0E, 0xB4, 0x12, 0xE0, 0xE2, 0x60, 0x92, 0x1E, 0xCD, 0xEB,
+  0x78, 0xF5, 0x9A, 0xDA, 0x98, 0xC7, 0x0D, 0x59, 0x73, 0x82, 0xFC, 0x50,
+  0xE1, 0x6B, 0x82, 0x87, 0xB1, 0xE1, 0xF9, 0xAF, 0x03, 0xBD, 0xF8, 0x91,
+  0xFC, 0x31, 0xA9, 0x08, 0x4A, 0xF6, 0xAD, 0x35, 0xB5, 0x9B, 0x10, 0x4F,
+  0x33, 0xE0, 0x5D, 0x92, 0x2C, 0x2D, 0x5C, 0x6D, 0x5D, 0x9A, 0x19, 0x9C,
+  0x8D, 0x40, 0xF7, 0xB8, 0x35, 0xDE, 0x48, 0xED, 0x6A, 0x7A, 0xD1, 0x9E,
+  0x4F, 0x68, 0x24, 0xC7, 0x83, 0xA9, 0x4C, 0xD1, 0xEE, 0x80, 0x87, 0x2E,
+  0xF6, 0x88, 0x5E, 0x6A, 0x53, 0x57, 0x24, 0xC0, 0x68, 0x64, 0xB0, 0x5B,
+  0x9A, 0xCD, 0x03, 0x3C, 0xB7, 0x04, 0x11, 0xBD, 0x8A, 0xA3, 0x0A, 0x04,
+  0xB0, 0x45, 0x8D, 0x4D, 0x5E, 0x31, 0x74, 0x4F, 0x13, 0x37, 0x36, 0xBD,
+  0x01, 0xB8, 0xDD, 0x6D, 0x00, 0x1C, 0x0D, 0x25, 0xDB, 0xCC, 0xA9, 0x56,
+  0xD9, 0xC8, 0xC0, 0x04, 0xEF, 0x54, 0x47, 0x35, 0x3B, 0xB1, 0x74, 0x4C,
+  0xF2, 0x81, 0x21, 0x03, 0xDF, 0x3D, 0xAC, 0xC5, 0x98, 0x53, 0xDF, 0xA9,
+  0xDA, 0x88, 0x1B, 0x8A, 0x4F, 0x62, 0x5B, 0x13, 0xF2, 0x24, 0x6F, 0x7B,
+  0xA1, 0x0D, 0x23, 0xF9, 0x6A, 0x63, 0xAB, 0xEA, 0xF7, 0x43, 0x2E, 0x9D,
+  0xC6, 0x87, 0x1B, 0xF8, 0x46, 0xAE, 0x14, 0x41, 0x7C, 0x04, 0x6C, 0x50,
+  0x0E, 0x85, 0x5C, 0xBE, 0xF8, 0xC5, 0x37, 0x62, 0xE2, 0xA1, 0x3B, 0xD7,
+  0x54, 0x63, 0x77, 0xD2, 0xA9, 0xAF, 0x34, 0x2A, 0x49, 0x16, 0x19, 0xBA,
+  0x16, 0x62, 0xF7, 0xB2, 0x27, 0x6A, 0x5F, 0x8D, 0x55, 0x74, 0x7B, 0x05,
+  0x3A, 0xF7, 0x1A, 0xE8, 0x30, 0xA3, 0x06, 0x7F, 0xFD, 0x61, 0x0D, 0x9E,
+  0x1A, 0xF0, 0xDA, 0xE5, 0x6E, 0xDA, 0x95, 0xF8, 0xEA, 0x8A, 0x41, 0x0E,
+  0xF0, 0x9D, 0x46, 0x32, 0x93, 0x61, 0xC8, 0xB0, 0x3A, 0x16, 0xB4, 0xA4,
+  0x01, 0xF7, 0xF2, 0xF1, 0x5A, 0x4F, 0xD7, 0xDE, 0x29, 0x3C, 0x27, 0x77,
+  0x0C, 0xA8, 0x3D, 0xEA, 0xF2, 0x16, 0x04, 0x2A, 0xBD, 0xBE, 0xDC, 0x26,
+  0x66, 0x05, 0xE5, 0xED, 0x1E, 0x73, 0x7B, 0xDB, 0x9C, 0x2C, 0xE2, 0x08,
+  0x47, 0xA7, 0xD9, 0x69, 0x45, 0x92, 0x61, 0x6F, 0x1C, 0x9C, 0x31, 0xE7,
+  0x35, 0x78, 0x3B, 0xA9, 0x92, 0xD6, 0x5E, 0x36, 0x42, 0x1D, 0xCC, 0x74,
+  0x9B, 0x46, 0xC5, 0x46, 0xF5, 0xEC, 0x4C, 0xD6, 0x4E, 0xEC, 0xE6, 0xF5,
+  0x11, 0x82, 0x8D, 0xBB, 0xB3, 0x31, 0xD8, 0xDE, 0x02, 0x8F, 0xAE, 0xD4,
+  0x15, 0x22, 0xD2, 0xAC, 0xA9, 0x23, 0x35, 0x68, 0x76, 0x59, 0xE3, 0x87,
+  0x63, 0x2A, 0x46, 0x9A, 0x57, 0x77, 0x4D, 0xDE, 0xF6, 0x7D, 0xF1, 0x2C,
+  0x35, 0x58, 0x88, 0xDB, 0xA6, 0x59, 0x36, 0x40, 0xC3, 0xF0, 0x48, 0x3B,
+  0x3E, 0x7B, 0xDF, 0x43, 0xF8, 0x64, 0x72, 0x18, 0x18, 0xD6, 0xD5, 0x36,
+  0x7A, 0xD6, 0x1D, 0x0E, 0x27, 0xA9, 0xB6, 0xB4, 0xB9, 0x62, 0xFC, 0x12,
+  0xD7, 0x01, 0xA3, 0x92, 0xF6, 0x79, 0xDD, 0xC6, 0x5A, 0x1C, 0x6C, 0xDC,
+  0x9C, 0x50, 0x87, 0x98, 0x45, 0xBD, 0xB9, 0xF6, 0x18, 0x56, 0x0D, 0xA6,
+  0xD9, 0x74, 0x0D, 0x96, 0xF3, 0x1B, 0xAD, 0xE2, 0x61, 0xE1, 0xA3, 0xCC,
+  0x41, 0x7A, 0x5E, 0xA1, 0x00, 0x50, 0x2F, 0x8B, 0x7D, 0x5A, 0x6F, 0x2D,
+  0xC4, 0xC8, 0xE7, 0x7C, 0xAC, 0x67, 0x26, 0x4E, 0x91, 0x84, 0x78, 0x83,
+  0x1A, 0x06, 0x43, 0xCA, 0x33, 0xF7, 0xA7, 0xFF, 0xDE, 0xA1, 0x54, 0x00,
+  0xB5, 0x8B, 0x7B, 0x8A, 0xCB, 0xDA, 0x7E, 0x5F, 0x3B, 0x51, 0xF7, 0x35,
+  0xFC, 0x48, 0xAF, 0x61, 0xD7, 0x99, 0xBD, 0x76, 0xB8, 0xA9, 0xEB, 0x73,
+  0x4C, 0x4B, 0x17, 0x27, 0xD2, 0xCA, 0x7C, 0x7D, 0xB4, 0xA0, 0xFE, 0x2A,
+  0xCB, 0xC3, 0x61, 0xAE, 0x91, 0x68, 0x47, 0xDB, 0x3D, 0x81, 0xCD, 0xEB,
+  0x74, 0xC4, 0xC6, 0xD2, 0xC6, 0xF9, 0x86, 0x3F, 0x76, 0xB4, 0x41, 0x8A,
+  0xED, 0x65, 0xA2, 0xF6, 0x89, 0xD4, 0xE3, 0xAB, 0xA3, 0x68, 0xC5, 0x1D,
+  0xEB, 0xF4, 0xF4, 0x2D, 0x37, 0x6A, 0x67, 0xF6, 0x42, 0xE6, 0xD4, 0xED,
+  0x90, 0x4D, 0x04, 0xC3, 0x0F, 0xF3, 0x54, 0x55, 0x2E, 0x00, 0x36, 0x47,
+  0xA5, 0x95, 0x48, 0x87, 0x4C, 0x06, 0xEF, 0x09, 0x33, 0x77, 0x92, 0x4C,
+  0x3A, 0x90, 0x2F, 0xB8, 0x42, 0x89, 0x0A, 0x10, 0xE7, 0x72, 0x2A, 0x50,
+  0x9B, 0xB1, 0x33, 0x0E, 0xD4, 0x56, 0x47, 0xB2, 0x39, 0x59, 0xDE, 0xF0,
+  0x4B, 0xDE, 0x9F, 0xDD, 0xCD, 0x8F, 0x05, 0x49, 0x86, 0xE8, 0x42, 0x4A,
+  0xFC, 0x3A, 0xEE, 0xE0, 0x40, 0x5B, 0x2A, 0xF4, 0xEE, 0x31, 0x3F, 0xA7,
+  0x4B, 0x5D, 0x3C, 0x4F, 0x42, 0x4F, 0x19, 0xEB, 0xF0, 0x01, 0x87, 0x2C,
+  0x80, 0xBC, 0x24, 0xAE, 0x2C, 0x4C, 0xDB, 0x0E, 0x95, 0xB6, 0xB1, 0x58,
+  0x32, 0x42, 0x37, 0x14, 0xD5, 0xA8, 0xBB, 0xE0, 0x60, 0xB0, 0x9A, 0xDB,
+  0xF1, 0x93, 0x75, 0x8E, 0x69, 0x73, 0x38, 0xE1, 0x3F, 0xF6, 0x22, 0xFB,
+  0xB5, 0x26, 0xB2, 0x4C, 0x49, 0x9A, 0x35, 0xB7, 0xE4, 0xA8, 0xE6, 0xBC,
+  0xBC, 0xFD, 0x84, 0x86, 0x00, 0x6B, 0x16, 0x8C, 0x9D, 0x38, 0x71, 0x03,
+  0x3B, 0x3B, 0xC3, 0x8D, 0x44, 0x24, 0x51, 0xD7, 0x7C, 0x30, 0xC7, 0x1B,
+  0xAB, 0x07, 0xC6, 0xF3, 0xA2, 0x2F, 0xAE, 0xF0, 0x0D, 0xB1, 0xC1, 0xCD,
+  0x48, 0x6E, 0x73, 0x48, 0x1F, 0xB6, 0xC8, 0x21, 0x76, 0x54, 0x11, 0x39,
+  0x15, 0xBC, 0xEE, 0x3D, 0x6D, 0x3C, 0xCE, 0x13, 0xAD, 0x56, 0x81, 0x41,
+  0x4F, 0xDD, 0x1F, 0xCC, 0xD5, 0xC3, 0x7A, 0xAD, 0x38, 0xB5, 0x6A, 0x67,
+  0x64, 0x9C, 0xD8, 0x12, 0x35, 0x1C, 0xA0, 0x00,
+};
+
+UINT8   *mSample;
+UINT8   *mDecompressed;
+VOID    *mScratch;
+UINT32  mScratchSize;
+
+/**
+  Generate the text that mCompressedSample holds.
+
+  @param[out] Buffer  Buffer of Size bytes that receives the text.
+  @param[in]  Size    Size of the text.
+
+**/
+VOID
+GenerateSample (
+  OUT UINT8  *Buffer,
+  IN  UINTN  Size
+  )
+{
+  UINT32       Seed;
+  UINTN        Index;
+  CONST CHAR8  *Word;
+
+  Seed  = 0x1234567;
+  Index = 0;
+  while (Index < Size) {
+    Seed = Seed * 1103515245 + 12345;
+    Word = mSampleWords[(Seed >> 16) % ARRAY_SIZE (mSampleWords)];
+    while (*Word != '\0' && Index < Size) {
+      Buffer[Index++] = (UINT8)*Word++;
+    }
+    if (Index < Size) {
+      Buffer[Index++] = ((Seed >> 8) % 11 == 0) ? '\n' : ' ';
+    }
+  }
+}
+
+BOOLEAN
+DecompressLibSetup (
+  VOID
+  )
+{
+  UINT32  DestinationSize;
+
+  mSample       = AllocatePool (SAMPLE_SIZE);
+  mDecompressed = AllocatePool (SAMPLE_SIZE);
+  if (mSample == NULL || mDecompressed == NULL) {
+    return FALSE;
+  }
+  GenerateSample (mSample, SAMPLE_SIZE);
+
+  if (RETURN_ERROR (UefiDecompressGetInfo (mCompressedSample, sizeof (mCompressedSample), &DestinationSize, &mScratchSize))) {
+    return FALSE;
+  }
+  mScratch = AllocatePool (mScratchSize);
+  return (BOOLEAN)(mScratch != NULL);
+}
+
+BOOLEAN
+TestUefiDecompress (
+  VOID
+  )
+{
+  UINT32  DestinationSize;
+  UINT32  ScratchSize;
+
+  HOST_CHECK (UefiDecompressGetInfo (mCompressedSample, sizeof (mCompressedSample), &DestinationSize, &ScratchSize) == RETURN_SUCCESS);
+  HOST_CHECK (DestinationSize == SAMPLE_SIZE);
+  HOST_CHECK (ScratchSize == mScratchSize);
+
+  ZeroMem (mDecompressed, SAMPLE_SIZE);
+  HOST_CHECK (UefiDecompress (mCompressedSample, mDecompressed, mScratch) == RETURN_SUCCESS);
+  HOST_CHECK (CompareMem (mDecompressed, mSample, SAMPLE_SIZE) == 0);
+  return TRUE;
+}
+
+BOOLEAN
+TestUefiDecompressTruncated (
+  VOID
+  )
+{
+  UINT32  DestinationSize;
+  UINT32  ScratchSize;
+
+  //
+  // The header holds the compressed size, so a short buffer is rejected
+  //
+  HOST_CHECK (UefiDecompressGetInfo (mCompressedSample, 7, &DestinationSize, &ScratchSize) == RETURN_INVALID_PARAMETER);
+  HOST_CHECK (UefiDecompressGetInfo (mCompressedSample, sizeof (mCompressedSample) - 1, &DestinationSize, &ScratchSize) == RETURN_INVALID_PARAMETER);
+  return TRUE;
+}
+
+VOID
+BenchUefiDecompress (
+  IN UINTN  Iterations
+  )
+{
+  while (Iterations-- > 0) {
+    gHostBenchSink += (UINTN)UefiDecompress (mCompressedSample, mDecompressed, mScratch);
+  }
+}
+
+CONST HOST_TEST  mDecompressLibTests[] = {
+  { "UefiDecompress",          TestUefiDecompress          },
+  { "UefiDecompressTruncated", TestUefiDecompressTruncated }
+};
+
+CONST HOST_BENCH  mDecompressLibBenches[] = {
+  { "UefiDecompress 16K text", SAMPLE_SIZE, BenchUefiDecompress }
+};
+
+HOST_SUITE  gDecompressLibSuite = {
+  "UefiDecompressLib",
+  DecompressLibSetup,
+  mDecompressLibTests,
+  ARRAY_SIZE (mDecompressLibTests),
+  mDecompressLibBenches,
+  ARRAY_SIZE (mDecompressLibBenches)
+};
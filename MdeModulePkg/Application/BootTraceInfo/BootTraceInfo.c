@@ -0,0 +1,269 @@
+/** @file
+  Shell application to dump the boot trace summary and to save the boot
+  trace stream to a file for BaseTools/Scripts/BootTraceDecode.py.
+
+  Usage: BootTraceInfo [FileName]
+
+  Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiLib.h>
+#include <Library/UefiApplicationEntryPoint.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/DebugLib.h>
+
+#include <Protocol/SimpleFileSystem.h>
+#include <Protocol/Shell.h>
+#include <Protocol/ShellParameters.h>
+
+#include <Guid/BootTrace.h>
+#include <Guid/FileInfo.h>
+
+CHAR8 *mRecordTypeString[] = {
+  "Unknown",
+  "Memory",
+  "PerfStart",
+  "PerfEnd",
+  "ImageLoad",
+  "ImageUnload",
+};
+
+/**
+  Write a buffer to a file through the shell protocol.
+
+  @param[in] FileName       The file to be written.
+  @param[in] BufferSize     The size of the buffer.
+  @param[in] Buffer         The buffer to be written.
+
+  @retval EFI_SUCCESS       The file is written successfully.
+  @retval EFI_NOT_FOUND     Shell protocol is not found.
+  @retval others            The file can not be written.
+
+**/
+EFI_STATUS
+WriteFileFromBuffer (
+  IN CHAR16                 *FileName,
+  IN UINTN                  BufferSize,
+  IN VOID                   *Buffer
+  )
+{
+  EFI_STATUS                Status;
+  EFI_SHELL_PROTOCOL        *ShellProtocol;
+  SHELL_FILE_HANDLE         Handle;
+  EFI_FILE_INFO             *FileInfo;
+  UINTN                     TempBufferSize;
+
+  Status = gBS->LocateProtocol (&gEfiShellProtocolGuid, NULL, (VOID **) &ShellProtocol);
+  if (EFI_ERROR (Status)) {
+    return EFI_NOT_FOUND;
+  }
+
+  Status = ShellProtocol->OpenFileByName (
+                            FileName,
+                            &Handle,
+                            EFI_FILE_MODE_READ | EFI_FILE_MODE_WRITE | EFI_FILE_MODE_CREATE
+                            );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Empty the file contents.
+  //
+  FileInfo = ShellProtocol->GetFileInfo (Handle);
+  if (FileInfo == NULL) {
+    ShellProtocol->CloseFile (Handle);
+    return EFI_DEVICE_ERROR;
+  }
+  if (FileInfo->FileSize != 0) {
+    FileInfo->FileSize = 0;
+    Status = ShellProtocol->SetFileInfo (Handle, FileInfo);
+    if (EFI_ERROR (Status)) {
+      FreePool (FileInfo);
+      ShellProtocol->CloseFile (Handle);
+      return Status;
+    }
+  }
+  FreePool (FileInfo);
+
+  TempBufferSize = BufferSize;
+  Status = ShellProtocol->WriteFile (Handle, &TempBufferSize, Buffer);
+  if (!EFI_ERROR (Status) && (TempBufferSize != BufferSize)) {
+    Status = EFI_DEVICE_ERROR;
+  }
+  ShellProtocol->CloseFile (Handle);
+
+  return Status;
+}
+
+/**
+  Get the boot trace data.
+
+  @param[out] TraceSize     The size of the boot trace data.
+  @param[out] TraceBuffer   The boot trace data, allocated by this function.
+
+  @retval EFI_SUCCESS       The boot trace data is returned.
+  @retval others            The boot trace is not available.
+
+**/
+EFI_STATUS
+GetBootTraceData (
+  OUT UINT64                *TraceSize,
+  OUT VOID                  **TraceBuffer
+  )
+{
+  EFI_STATUS                Status;
+  EDKII_BOOT_TRACE_PROTOCOL *BootTrace;
+  UINT64                    Size;
+  VOID                      *Buffer;
+
+  Status = gBS->LocateProtocol (&gEdkiiBootTraceGuid, NULL, (VOID **) &BootTrace);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((EFI_D_ERROR, "BootTraceInfo: Locate BootTrace protocol - %r\n", Status));
+    return Status;
+  }
+
+  Size = 0;
+  Buffer = NULL;
+  Status = BootTrace->GetData (BootTrace, &Size, NULL);
+  while (Status == EFI_BUFFER_TOO_SMALL) {
+    if (Buffer != NULL) {
+      FreePool (Buffer);
+    }
+    //
+    // Records may be appended until the data is retrieved, leave some room.
+    //
+    Size += EFI_PAGE_SIZE;
+    Buffer = AllocatePool ((UINTN) Size);
+    if (Buffer == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    Status = BootTrace->GetData (BootTrace, &Size, Buffer);
+  }
+
+  if (EFI_ERROR (Status)) {
+    if (Buffer != NULL) {
+      FreePool (Buffer);
+    }
+    return Status;
+  }
+
+  *TraceSize = Size;
+  *TraceBuffer = Buffer;
+  return EFI_SUCCESS;
+}
+
+/**
+  Dump the boot trace summary.
+
+  @param[in] TraceSize      The size of the boot trace data.
+  @param[in] TraceBuffer    The boot trace data.
+
+**/
+VOID
+DumpBootTraceSummary (
+  IN UINT64                 TraceSize,
+  IN VOID                   *TraceBuffer
+  )
+{
+  BOOT_TRACE_HEADER         *Header;
+  BOOT_TRACE_RECORD_HEADER  *Record;
+  UINT8                     *RecordEnd;
+  UINTN                     Count[ARRAY_SIZE (mRecordTypeString)];
+  UINTN                     Index;
+
+  Header = TraceBuffer;
+  if ((TraceSize < sizeof (BOOT_TRACE_HEADER)) ||
+      (Header->Signature != BOOT_TRACE_HEADER_SIGNATURE) ||
+      (Header->RecordSize > TraceSize - sizeof (BOOT_TRACE_HEADER))) {
+    Print (L"BootTraceInfo: invalid boot trace data\n");
+    return;
+  }
+
+  ZeroMem (Count, sizeof (Count));
+  Record = (BOOT_TRACE_RECORD_HEADER *) (Header + 1);
+  RecordEnd = (UINT8 *) Record + Header->RecordSize;
+  while ((UINT8 *) Record + sizeof (BOOT_TRACE_RECORD_HEADER) <= RecordEnd) {
+    if ((Record->Length < sizeof (BOOT_TRACE_RECORD_HEADER)) ||
+        (Record->Length > (UINTN) (RecordEnd - (UINT8 *) Record))) {
+      break;
+    }
+    Index = Record->Type;
+    if (Index >= ARRAY_SIZE (mRecordTypeString)) {
+      Index = 0;
+    }
+    Count[Index]++;
+    Record = (BOOT_TRACE_RECORD_HEADER *) ((UINT8 *) Record + Record->Length);
+  }
+
+  Print (L"==== BOOT TRACE ====\n");
+  Print (L"  Revision        - 0x%04x\n", Header->Revision);
+  Print (L"  Frequency       - %ld Hz\n", Header->Frequency);
+  Print (L"  TimerStartValue - 0x%016lx\n", Header->TimerStartValue);
+  Print (L"  TimerEndValue   - 0x%016lx\n", Header->TimerEndValue);
+  Print (L"  RecordSize      - 0x%016lx\n", Header->RecordSize);
+  Print (L"  RecordCount     - 0x%08x\n", Header->RecordCount);
+  Print (L"  LostRecordCount - 0x%08x\n", Header->LostRecordCount);
+  for (Index = 0; Index < ARRAY_SIZE (mRecordTypeString); Index++) {
+    if (Count[Index] != 0) {
+      Print (L"    %-12a - 0x%08x\n", mRecordTypeString[Index], Count[Index]);
+    }
+  }
+}
+
+/**
+  The user Entry Point for Application. The user code starts with this function
+  as the real entry point for the image goes into a library that calls this function.
+
+  @param[in] ImageHandle    The firmware allocated handle for the EFI image.
+  @param[in] SystemTable    A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS       The entry point is executed successfully.
+  @retval other             Some error occurs when executing this entry point.
+
+**/
+EFI_STATUS
+EFIAPI
+UefiMain (
+  IN EFI_HANDLE             ImageHandle,
+  IN EFI_SYSTEM_TABLE       *SystemTable
+  )
+{
+  EFI_STATUS                    Status;
+  EFI_SHELL_PARAMETERS_PROTOCOL *ShellParameters;
+  UINT64                        TraceSize;
+  VOID                          *TraceBuffer;
+
+  Status = GetBootTraceData (&TraceSize, &TraceBuffer);
+  if (EFI_ERROR (Status)) {
+    Print (L"BootTraceInfo: boot trace is not available - %r\n", Status);
+    return Status;
+  }
+
+  DumpBootTraceSummary (TraceSize, TraceBuffer);
+
+  Status = gBS->HandleProtocol (
+                  gImageHandle,
+                  &gEfiShellParametersProtocolGuid,
+                  (VOID **) &ShellParameters
+                  );
+  if (!EFI_ERROR (Status) && (ShellParameters->Argc > 1)) {
+    Status = WriteFileFromBuffer (ShellParameters->Argv[1], (UINTN) TraceSize, TraceBuffer);
+    Print (L"BootTraceInfo: write %s - %r\n", ShellParameters->Argv[1], Status);
+  }
+
+  FreePool (TraceBuffer);
+  return EFI_SUCCESS;
+}
@@ -3,7 +3,7 @@
   this utility will print out the statistics information. You can use console
   redirection to capture the data.
 
-  Copyright (c) 2006 - 2016, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2006 - 2017, Intel Corporation. All rights reserved.<BR>
   This program and the accompanying materials
   are licensed and made available under the terms and conditions of the BSD License
   which accompanies this distribution.  The full text of the license may be found at
@@ -24,6 +24,7 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include <Library/UefiBootServicesTableLib.h>
 
 #include <Guid/VariableFormat.h>
+#include <Guid/VariableAuthInfo.h>
 #include <Guid/SmmVariableCommon.h>
 #include <Guid/PiSmmCommunicationRegionTable.h>
 #include <Protocol/SmmCommunication.h>
@@ -38,6 +39,8 @@ EFI_SMM_COMMUNICATION_PROTOCOL  *mSmmCommunication = NULL;
                                        be passed into an SMM environment. In output, a pointer
                                        to a collection of data that comes from an SMM environment.
   @param[in, out] SmmCommunicateSize   The size of the SmmCommunicateHeader.
+  @param[in]      Function             SMM_VARIABLE_FUNCTION_GET_STATISTICS or
+                                       SMM_VARIABLE_FUNCTION_GET_AUTH_STATISTICS.
 
   @retval EFI_SUCCESS               Get the statistics data information.
   @retval EFI_NOT_FOUND             Not found.
@@ -48,7 +51,8 @@ EFI_STATUS
 EFIAPI
 GetVariableStatisticsData (
   IN OUT  EFI_SMM_COMMUNICATE_HEADER  *SmmCommunicateHeader,
-  IN OUT  UINTN                       *SmmCommunicateSize
+  IN OUT  UINTN                       *SmmCommunicateSize,
+  IN      UINTN                       Function
   )
 {
   EFI_STATUS                          Status;
@@ -58,7 +62,7 @@ GetVariableStatisticsData (
   SmmCommunicateHeader->MessageLength = *SmmCommunicateSize - OFFSET_OF (EFI_SMM_COMMUNICATE_HEADER, Data);
 
   SmmVariableFunctionHeader = (SMM_VARIABLE_COMMUNICATE_HEADER *) &SmmCommunicateHeader->Data[0];
-  SmmVariableFunctionHeader->Function = SMM_VARIABLE_FUNCTION_GET_STATISTICS;
+  SmmVariableFunctionHeader->Function = Function;
 
   Status = mSmmCommunication->Communicate (mSmmCommunication, SmmCommunicateHeader, SmmCommunicateSize);
   ASSERT_EFI_ERROR (Status);
@@ -82,6 +86,7 @@ PrintInfoFromSmm (
 {
   EFI_STATUS                                     Status;
   VARIABLE_INFO_ENTRY                            *VariableInfo;
+  VARIABLE_AUTH_INFO_ENTRY                       *AuthInfo;
   EFI_SMM_COMMUNICATE_HEADER                     *CommBuffer;
   UINTN                                          RealCommSize;
   UINTN                                          CommSize;
@@ -135,7 +140,7 @@ PrintInfoFromSmm (
   Print (L"Non-Volatile SMM Variables:\n");
   do {
     CommSize = RealCommSize;
-    Status = GetVariableStatisticsData (CommBuffer, &CommSize);
+    Status = GetVariableStatisticsData (CommBuffer, &CommSize, SMM_VARIABLE_FUNCTION_GET_STATISTICS);
     if (Status == EFI_BUFFER_TOO_SMALL) {
       Print (L"The generic SMM communication buffer provided by SmmCommunicationRegionTable is too small\n");
       return Status;
@@ -165,7 +170,7 @@ PrintInfoFromSmm (
   ZeroMem (CommBuffer, RealCommSize);
   do {
     CommSize = RealCommSize;
-    Status = GetVariableStatisticsData (CommBuffer, &CommSize);
+    Status = GetVariableStatisticsData (CommBuffer, &CommSize, SMM_VARIABLE_FUNCTION_GET_STATISTICS);
     if (Status == EFI_BUFFER_TOO_SMALL) {
       Print (L"The generic SMM communication buffer provided by SmmCommunicationRegionTable is too small\n");
       return Status;
@@ -191,6 +196,32 @@ PrintInfoFromSmm (
     }
   } while (TRUE);
 
+  //
+  // The SMM variable driver only returns authenticated write statistics if
+  // there was any authenticated write.
+  //
+  ZeroMem (CommBuffer, RealCommSize);
+  for (Index = 0; ; Index++) {
+    CommSize = RealCommSize;
+    if (EFI_ERROR (GetVariableStatisticsData (CommBuffer, &CommSize, SMM_VARIABLE_FUNCTION_GET_AUTH_STATISTICS)) ||
+        (CommSize <= SMM_COMMUNICATE_HEADER_SIZE + SMM_VARIABLE_COMMUNICATE_HEADER_SIZE)) {
+      break;
+    }
+
+    if (Index == 0) {
+      Print (L"Authenticated Writes of SMM Variables:\n");
+    }
+    FunctionHeader = (SMM_VARIABLE_COMMUNICATE_HEADER *) CommBuffer->Data;
+    AuthInfo       = (VARIABLE_AUTH_INFO_ENTRY *) FunctionHeader->Data;
+    Print (
+        L"%g A%03d %ldus:%s\n",
+        &AuthInfo->VendorGuid,
+        AuthInfo->AuthCount,
+        DivU64x32 (AuthInfo->AuthTime, 1000),
+        (CHAR16 *)(AuthInfo + 1)
+        );
+  }
+
   return Status;
 }
 
@@ -213,9 +244,10 @@ UefiMain (
   IN EFI_SYSTEM_TABLE  *SystemTable
   )
 {
-  EFI_STATUS            Status;
-  VARIABLE_INFO_ENTRY   *VariableInfo;
-  VARIABLE_INFO_ENTRY   *Entry;
+  EFI_STATUS                Status;
+  VARIABLE_INFO_ENTRY       *VariableInfo;
+  VARIABLE_INFO_ENTRY       *Entry;
+  VARIABLE_AUTH_INFO_ENTRY  *AuthInfo;
 
   Status = EfiGetSystemConfigurationTable (&gEfiVariableGuid, (VOID **)&Entry);
   if (EFI_ERROR (Status) || (Entry == NULL)) {
@@ -265,6 +297,21 @@ UefiMain (
       VariableInfo = VariableInfo->Next;
     } while (VariableInfo != NULL);
 
+    if (!EFI_ERROR (EfiGetSystemConfigurationTable (&gEdkiiVariableAuthInfoGuid, (VOID **)&AuthInfo)) &&
+        (AuthInfo != NULL)) {
+      Print (L"Authenticated Writes of EFI Variables:\n");
+      do {
+        Print (
+          L"%g A%03d %ldus:%s\n",
+          &AuthInfo->VendorGuid,
+          AuthInfo->AuthCount,
+          DivU64x32 (AuthInfo->AuthTime, 1000),
+          AuthInfo->Name
+          );
+        AuthInfo = AuthInfo->Next;
+      } while (AuthInfo != NULL);
+    }
+
   } else {
     Print (L"Warning: Variable Dxe/Smm driver doesn't enable the feature of statistical information!\n");
     Print (L"If you want to see this info, please:\n");
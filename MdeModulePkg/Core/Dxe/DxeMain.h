@@ -70,6 +70,7 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include <Guid/VectorHandoffTable.h>
 #include <Ppi/VectorHandoffInfo.h>
 #include <Guid/MemoryProfile.h>
+#include <Guid/BootTrace.h>
 
 #include <Library/DxeCoreEntryPoint.h>
 #include <Library/DebugLib.h>
@@ -2819,6 +2820,72 @@ CoreUpdateProfile (
   IN CHAR8                  *ActionString OPTIONAL
   );
 
+/**
+  Get the GUID file name from the file path.
+
+  @param FilePath  File path.
+
+  @return The GUID file name from the file path.
+
+**/
+EFI_GUID *
+GetFileNameFromFilePath (
+  IN EFI_DEVICE_PATH_PROTOCOL   *FilePath
+  );
+
+/**
+  Initialize the boot trace. The trace buffer is allocated as soon as the
+  memory services are available, so that it covers the allocations of the
+  DXE core itself.
+
+**/
+VOID
+CoreInitializeBootTrace (
+  VOID
+  );
+
+/**
+  Install the boot trace protocol, and record the DXE core image which is
+  not started through CoreStartImage().
+
+**/
+VOID
+CoreInstallBootTraceProtocol (
+  VOID
+  );
+
+/**
+  Record the start or the unload of an image in the boot trace.
+
+  @param Image      Image info.
+  @param Load       TRUE if the image is started, FALSE if it is unloaded.
+
+**/
+VOID
+CoreBootTraceImage (
+  IN LOADED_IMAGE_PRIVATE_DATA  *Image,
+  IN BOOLEAN                    Load
+  );
+
+/**
+  Record a memory allocation or free in the boot trace.
+
+  @param CallerAddress  Address of caller who call Allocate or Free.
+  @param Action         This Allocate or Free action.
+  @param MemoryType     Memory type.
+  @param Size           Buffer size, 0 for FreePool.
+  @param Buffer         Buffer address.
+
+**/
+VOID
+CoreBootTraceMemory (
+  IN PHYSICAL_ADDRESS       CallerAddress,
+  IN MEMORY_PROFILE_ACTION  Action,
+  IN EFI_MEMORY_TYPE        MemoryType,
+  IN UINTN                  Size,
+  IN VOID                   *Buffer
+  );
+
 /**
   Internal function.  Converts a memory range to use new attributes.
 
@@ -272,6 +272,7 @@ DxeMain (
   CoreInitializeMemoryServices (&HobStart, &MemoryBaseAddress, &MemoryLength);
 
   MemoryProfileInit (HobStart);
+  CoreInitializeBootTrace ();
 
   //
   // Allocate the EFI System Table and EFI Runtime Service Table from EfiRuntimeServicesData
@@ -395,6 +396,7 @@ DxeMain (
   ASSERT_EFI_ERROR (Status);
 
   MemoryProfileInstallProtocol ();
+  CoreInstallBootTraceProtocol ();
 
   CoreInitializePropertiesTable ();
   CoreInitializeMemoryAttributesTable ();
@@ -863,6 +863,7 @@ CoreUnloadAndCloseImage (
 
   if (Image->Started) {
     UnregisterMemoryProfileImage (Image);
+    CoreBootTraceImage (Image, FALSE);
   }
 
   UnprotectUefiImage (&Image->Info, Image->LoadedImageDevicePath);
@@ -1666,6 +1667,7 @@ CoreStartImage (
   //
   if (SetJumpFlag == 0) {
     RegisterMemoryProfileImage (Image, (Image->ImageContext.ImageType == EFI_IMAGE_SUBSYSTEM_EFI_APPLICATION ? EFI_FV_FILETYPE_APPLICATION : EFI_FV_FILETYPE_DRIVER));
+    CoreBootTraceImage (Image, TRUE);
     //
     // Call the image's entry point
     //
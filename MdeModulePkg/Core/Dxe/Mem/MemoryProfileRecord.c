@@ -1,7 +1,7 @@
 /** @file
   Support routines for UEFI memory profile.
 
-  Copyright (c) 2014 - 2016, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2014 - 2017, Intel Corporation. All rights reserved.<BR>
   This program and the accompanying materials
   are licensed and made available under the terms and conditions of the BSD License
   which accompanies this distribution.  The full text of the license may be found at
@@ -1376,6 +1376,12 @@ CoreUpdateProfile (
   MEMORY_PROFILE_CONTEXT_DATA   *ContextData;
   MEMORY_PROFILE_ACTION         BasicAction;
 
+  //
+  // The boot trace records every event, independent of the memory profile
+  // filters below.
+  //
+  CoreBootTraceMemory (CallerAddress, Action, MemoryType, Size, Buffer);
+
   if (!IS_UEFI_MEMORY_PROFILE_ENABLED) {
     return EFI_UNSUPPORTED;
   }
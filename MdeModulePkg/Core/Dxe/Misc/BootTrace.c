@@ -0,0 +1,406 @@
+/** @file
+  Support routines for the boot trace.
+
+  The boot trace is a pre-allocated buffer of time stamped records. Memory
+  allocation events are recorded by the DXE core itself, performance
+  measurements are appended by DxeCorePerformanceLib through
+  EDKII_BOOT_TRACE_PROTOCOL. Both use the performance counter of the DXE core,
+  so that the records share one time base.
+
+Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+This program and the accompanying materials
+are licensed and made available under the terms and conditions of the BSD License
+which accompanies this distribution.  The full text of the license may be found at
+http://opensource.org/licenses/bsd-license.php
+
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "DxeMain.h"
+
+//
+// Maximum size of the PDB file name kept in an image record.
+//
+#define BOOT_TRACE_MAX_PDB_SIZE  256
+
+//
+// Boot trace buffer, the header followed by the records.
+//
+GLOBAL_REMOVE_IF_UNREFERENCED BOOT_TRACE_HEADER  *mBootTraceHeader = NULL;
+GLOBAL_REMOVE_IF_UNREFERENCED UINTN              mBootTraceBufferSize = 0;
+
+/**
+  Get boot trace data.
+
+  @param[in]      This              The EDKII_BOOT_TRACE_PROTOCOL instance.
+  @param[in, out] TraceSize         On entry, points to the size in bytes of the TraceBuffer.
+                                    On return, points to the size of the data returned in TraceBuffer.
+  @param[out]     TraceBuffer       Trace buffer.
+
+  @return EFI_SUCCESS               Get the boot trace data successfully.
+  @return EFI_INVALID_PARAMETER     TraceSize is NULL.
+  @return EFI_BUFFER_TOO_SMALL      The TraceSize is too small for the resulting data.
+                                    TraceSize is updated with the size required.
+
+**/
+EFI_STATUS
+EFIAPI
+BootTraceProtocolGetData (
+  IN     EDKII_BOOT_TRACE_PROTOCOL      *This,
+  IN OUT UINT64                         *TraceSize,
+     OUT VOID                           *TraceBuffer
+  );
+
+/**
+  Append a record to the boot trace.
+
+  @param[in] This               The EDKII_BOOT_TRACE_PROTOCOL instance.
+  @param[in] Record             Record to append. If its TimeStamp is 0,
+                                the current performance counter value is used.
+
+  @return EFI_SUCCESS           The record is appended.
+  @return EFI_INVALID_PARAMETER Record is NULL, or its Length is invalid.
+  @return EFI_OUT_OF_RESOURCES  The trace buffer is full. The record is counted as lost.
+
+**/
+EFI_STATUS
+EFIAPI
+BootTraceProtocolAppend (
+  IN EDKII_BOOT_TRACE_PROTOCOL          *This,
+  IN BOOT_TRACE_RECORD_HEADER           *Record
+  );
+
+GLOBAL_REMOVE_IF_UNREFERENCED EDKII_BOOT_TRACE_PROTOCOL mBootTraceProtocol = {
+  BootTraceProtocolGetData,
+  BootTraceProtocolAppend
+};
+
+/**
+  Append a record to the boot trace.
+
+  Records are appended at TPL_HIGH_LEVEL so that an allocation or measurement
+  done from an interrupting event can not tear a record apart. Records are
+  never moved once appended, and RecordSize only grows after the copy.
+
+  @param[in] Record             Record to append. If its TimeStamp is 0,
+                                the current performance counter value is used.
+
+  @return EFI_SUCCESS           The record is appended.
+  @return EFI_UNSUPPORTED       The boot trace is not enabled.
+  @return EFI_INVALID_PARAMETER Record is NULL, or its Length is invalid.
+  @return EFI_OUT_OF_RESOURCES  The trace buffer is full. The record is counted as lost.
+
+**/
+EFI_STATUS
+CoreAppendBootTraceRecord (
+  IN BOOT_TRACE_RECORD_HEADER           *Record
+  )
+{
+  BOOT_TRACE_RECORD_HEADER  *NewRecord;
+  EFI_TPL                   OldTpl;
+  EFI_STATUS                Status;
+
+  if (mBootTraceHeader == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if ((Record == NULL) ||
+      (Record->Length < sizeof (BOOT_TRACE_RECORD_HEADER)) ||
+      ((Record->Length & (sizeof (UINT64) - 1)) != 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OldTpl = CoreRaiseTpl (TPL_HIGH_LEVEL);
+  if (Record->Length > mBootTraceBufferSize - sizeof (BOOT_TRACE_HEADER) - (UINTN) mBootTraceHeader->RecordSize) {
+    mBootTraceHeader->LostRecordCount++;
+    Status = EFI_OUT_OF_RESOURCES;
+  } else {
+    NewRecord = (BOOT_TRACE_RECORD_HEADER *) ((UINT8 *) (mBootTraceHeader + 1) + (UINTN) mBootTraceHeader->RecordSize);
+    CopyMem (NewRecord, Record, Record->Length);
+    if (NewRecord->TimeStamp == 0) {
+      NewRecord->TimeStamp = GetPerformanceCounter ();
+    }
+    mBootTraceHeader->RecordSize += Record->Length;
+    mBootTraceHeader->RecordCount++;
+    Status = EFI_SUCCESS;
+  }
+  CoreRestoreTpl (OldTpl);
+
+  return Status;
+}
+
+/**
+  Get boot trace data.
+
+  @param[in]      This              The EDKII_BOOT_TRACE_PROTOCOL instance.
+  @param[in, out] TraceSize         On entry, points to the size in bytes of the TraceBuffer.
+                                    On return, points to the size of the data returned in TraceBuffer.
+  @param[out]     TraceBuffer       Trace buffer.
+
+  @return EFI_SUCCESS               Get the boot trace data successfully.
+  @return EFI_INVALID_PARAMETER     TraceSize is NULL.
+  @return EFI_BUFFER_TOO_SMALL      The TraceSize is too small for the resulting data.
+                                    TraceSize is updated with the size required.
+
+**/
+EFI_STATUS
+EFIAPI
+BootTraceProtocolGetData (
+  IN     EDKII_BOOT_TRACE_PROTOCOL      *This,
+  IN OUT UINT64                         *TraceSize,
+     OUT VOID                           *TraceBuffer
+  )
+{
+  BOOT_TRACE_HEADER     Header;
+  EFI_TPL               OldTpl;
+
+  if (TraceSize == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Take a consistent copy of the header. The records it covers do not
+  // change any more, so they are copied at the caller's TPL.
+  //
+  OldTpl = CoreRaiseTpl (TPL_HIGH_LEVEL);
+  CopyMem (&Header, mBootTraceHeader, sizeof (Header));
+  CoreRestoreTpl (OldTpl);
+
+  if ((*TraceSize < sizeof (Header) + Header.RecordSize) || (TraceBuffer == NULL)) {
+    *TraceSize = sizeof (Header) + Header.RecordSize;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  CopyMem (TraceBuffer, &Header, sizeof (Header));
+  CopyMem ((BOOT_TRACE_HEADER *) TraceBuffer + 1, mBootTraceHeader + 1, (UINTN) Header.RecordSize);
+  *TraceSize = sizeof (Header) + Header.RecordSize;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Append a record to the boot trace.
+
+  @param[in] This               The EDKII_BOOT_TRACE_PROTOCOL instance.
+  @param[in] Record             Record to append. If its TimeStamp is 0,
+                                the current performance counter value is used.
+
+  @return EFI_SUCCESS           The record is appended.
+  @return EFI_INVALID_PARAMETER Record is NULL, or its Length is invalid.
+  @return EFI_OUT_OF_RESOURCES  The trace buffer is full. The record is counted as lost.
+
+**/
+EFI_STATUS
+EFIAPI
+BootTraceProtocolAppend (
+  IN EDKII_BOOT_TRACE_PROTOCOL          *This,
+  IN BOOT_TRACE_RECORD_HEADER           *Record
+  )
+{
+  return CoreAppendBootTraceRecord (Record);
+}
+
+/**
+  Append an image record to the boot trace.
+
+  @param Type         BOOT_TRACE_RECORD_TYPE_IMAGE_LOAD or BOOT_TRACE_RECORD_TYPE_IMAGE_UNLOAD.
+  @param FileName     File name of the image, or NULL if it is unknown.
+  @param ImageBase    Image base address.
+  @param ImageSize    Image size.
+  @param EntryPoint   Entry point of the image.
+  @param PdbString    PDB file name of the image, or NULL if it is unknown.
+
+**/
+VOID
+AppendBootTraceImageRecord (
+  IN UINT16             Type,
+  IN EFI_GUID           *FileName,
+  IN PHYSICAL_ADDRESS   ImageBase,
+  IN UINT64             ImageSize,
+  IN PHYSICAL_ADDRESS   EntryPoint,
+  IN CHAR8              *PdbString
+  )
+{
+  UINT64                    Buffer[(sizeof (BOOT_TRACE_IMAGE_RECORD) + BOOT_TRACE_MAX_PDB_SIZE) / sizeof (UINT64)];
+  BOOT_TRACE_IMAGE_RECORD   *Record;
+  UINTN                     PdbSize;
+
+  ZeroMem (Buffer, sizeof (Buffer));
+  Record = (BOOT_TRACE_IMAGE_RECORD *) Buffer;
+
+  PdbSize = 0;
+  if (PdbString != NULL) {
+    //
+    // Keep the end of a long path, which holds the file name a decoder uses.
+    //
+    PdbSize = AsciiStrSize (PdbString);
+    if (PdbSize > BOOT_TRACE_MAX_PDB_SIZE) {
+      PdbString += PdbSize - BOOT_TRACE_MAX_PDB_SIZE;
+      PdbSize    = BOOT_TRACE_MAX_PDB_SIZE;
+    }
+    CopyMem (Record + 1, PdbString, PdbSize);
+  }
+  PdbSize = ALIGN_VALUE (PdbSize, sizeof (UINT64));
+
+  Record->Header.Type   = Type;
+  Record->Header.Length = (UINT16) (sizeof (BOOT_TRACE_IMAGE_RECORD) + PdbSize);
+  if (FileName != NULL) {
+    CopyGuid (&Record->FileName, FileName);
+  }
+  Record->ImageBase  = ImageBase;
+  Record->ImageSize  = ImageSize;
+  Record->EntryPoint = EntryPoint;
+
+  CoreAppendBootTraceRecord (&Record->Header);
+}
+
+/**
+  Initialize the boot trace. The trace buffer is allocated as soon as the
+  memory services are available, so that it covers the allocations of the
+  DXE core itself.
+
+**/
+VOID
+CoreInitializeBootTrace (
+  VOID
+  )
+{
+  UINTN                 BufferSize;
+  BOOT_TRACE_HEADER     *Header;
+
+  BufferSize = PcdGet32 (PcdBootTraceBufferSize);
+  if (BufferSize <= sizeof (BOOT_TRACE_HEADER)) {
+    return;
+  }
+
+  Header = AllocateZeroPool (BufferSize);
+  if (Header == NULL) {
+    DEBUG ((DEBUG_ERROR, "Boot trace buffer (0x%x bytes) can not be allocated\n", BufferSize));
+    return;
+  }
+
+  Header->Signature = BOOT_TRACE_HEADER_SIGNATURE;
+  Header->Length    = sizeof (BOOT_TRACE_HEADER);
+  Header->Revision  = BOOT_TRACE_HEADER_REVISION;
+  Header->Frequency = GetPerformanceCounterProperties (
+                        &Header->TimerStartValue,
+                        &Header->TimerEndValue
+                        );
+
+  mBootTraceBufferSize = BufferSize;
+  mBootTraceHeader     = Header;
+
+  DEBUG ((DEBUG_INFO, "CoreInitializeBootTrace BootTraceHeader - 0x%x\n", mBootTraceHeader));
+}
+
+/**
+  Install the boot trace protocol, and record the DXE core image which is
+  not started through CoreStartImage().
+
+**/
+VOID
+CoreInstallBootTraceProtocol (
+  VOID
+  )
+{
+  EFI_HANDLE    Handle;
+  EFI_STATUS    Status;
+  VOID          *EntryPoint;
+
+  if (mBootTraceHeader == NULL) {
+    return;
+  }
+
+  Status = PeCoffLoaderGetEntryPoint (gDxeCoreLoadedImage->ImageBase, &EntryPoint);
+  if (EFI_ERROR (Status)) {
+    EntryPoint = NULL;
+  }
+  AppendBootTraceImageRecord (
+    BOOT_TRACE_RECORD_TYPE_IMAGE_LOAD,
+    gDxeCoreFileName,
+    (PHYSICAL_ADDRESS) (UINTN) gDxeCoreLoadedImage->ImageBase,
+    gDxeCoreLoadedImage->ImageSize,
+    (PHYSICAL_ADDRESS) (UINTN) EntryPoint,
+    PeCoffLoaderGetPdbPointer (gDxeCoreLoadedImage->ImageBase)
+    );
+
+  Handle = NULL;
+  Status = CoreInstallMultipleProtocolInterfaces (
+             &Handle,
+             &gEdkiiBootTraceGuid,
+             &mBootTraceProtocol,
+             NULL
+             );
+  ASSERT_EFI_ERROR (Status);
+}
+
+/**
+  Record the start or the unload of an image in the boot trace.
+
+  @param Image      Image info.
+  @param Load       TRUE if the image is started, FALSE if it is unloaded.
+
+**/
+VOID
+CoreBootTraceImage (
+  IN LOADED_IMAGE_PRIVATE_DATA  *Image,
+  IN BOOLEAN                    Load
+  )
+{
+  if (mBootTraceHeader == NULL) {
+    return;
+  }
+
+  AppendBootTraceImageRecord (
+    Load ? BOOT_TRACE_RECORD_TYPE_IMAGE_LOAD : BOOT_TRACE_RECORD_TYPE_IMAGE_UNLOAD,
+    GetFileNameFromFilePath (Image->Info.FilePath),
+    Image->ImageContext.ImageAddress,
+    Image->ImageContext.ImageSize,
+    Image->ImageContext.EntryPoint,
+    Image->ImageContext.PdbPointer
+    );
+}
+
+/**
+  Record a memory allocation or free in the boot trace.
+
+  @param CallerAddress  Address of caller who call Allocate or Free.
+  @param Action         This Allocate or Free action.
+  @param MemoryType     Memory type.
+  @param Size           Buffer size, 0 for FreePool.
+  @param Buffer         Buffer address.
+
+**/
+VOID
+CoreBootTraceMemory (
+  IN PHYSICAL_ADDRESS       CallerAddress,
+  IN MEMORY_PROFILE_ACTION  Action,
+  IN EFI_MEMORY_TYPE        MemoryType,
+  IN UINTN                  Size,
+  IN VOID                   *Buffer
+  )
+{
+  BOOT_TRACE_MEMORY_RECORD  Record;
+
+  if (mBootTraceHeader == NULL) {
+    return;
+  }
+
+  Record.Header.Type        = BOOT_TRACE_RECORD_TYPE_MEMORY;
+  Record.Header.Length      = sizeof (Record);
+  ZeroMem (Record.Header.Reserved, sizeof (Record.Header.Reserved));
+  //
+  // Time stamped by CoreAppendBootTraceRecord() at TPL_HIGH_LEVEL, so that the
+  // records are in time order.
+  //
+  Record.Header.TimeStamp   = 0;
+  Record.CallerAddress      = CallerAddress;
+  Record.Buffer             = (PHYSICAL_ADDRESS) (UINTN) Buffer;
+  Record.Size               = Size;
+  Record.Action             = Action;
+  Record.MemoryType         = MemoryType;
+
+  CoreAppendBootTraceRecord (&Record.Header);
+}
@@ -0,0 +1,428 @@
+/** @file
+  Extraction of chunked GUIDed sections.
+
+  The chunks of a section with gEdkiiChunkedSectionGuid are independent GUIDed
+  sections. When the MP Services PPI is available and every chunk is an LZMA
+  section, they are decoded on all enabled application processors while the BSP
+  waits in the blocking StartupAllAPs(). Otherwise they are decoded one after
+  another on the BSP.
+
+Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+This program and the accompanying materials
+are licensed and made available under the terms and conditions of the BSD License
+which accompanies this distribution.  The full text of the license may be found at
+http://opensource.org/licenses/bsd-license.php
+
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "DxeIpl.h"
+
+typedef struct {
+  CONST VOID                             *Section;
+  VOID                                   *Output;
+  VOID                                   *Scratch;
+  UINT32                                 OutputSize;
+  EXTRACT_GUIDED_SECTION_DECODE_HANDLER  Decode;
+  RETURN_STATUS                          Status;
+} CHUNK_DECODE_JOB;
+
+typedef struct {
+  CHUNK_DECODE_JOB                       *Jobs;
+  UINT32                                 JobCount;
+  volatile UINT32                        NextJob;
+} CHUNK_DECODE_CONTEXT;
+
+/**
+  Locate the data of a chunked GUIDed section and validate its header.
+
+  @param[in]  InputSection  A pointer to a chunked GUIDed section.
+  @param[out] Header        Returns the chunked section header.
+  @param[out] DataSize      Returns the size of the section data.
+  @param[out] Attributes    Returns the attributes of the GUIDed section.
+
+  @retval RETURN_SUCCESS            The section header is valid.
+  @retval RETURN_INVALID_PARAMETER  The section is not a valid chunked section.
+**/
+RETURN_STATUS
+GetChunkedSectionHeader (
+  IN  CONST VOID              *InputSection,
+  OUT CHUNKED_SECTION_HEADER  **Header,
+  OUT UINT32                  *DataSize,
+  OUT UINT16                  *Attributes
+  )
+{
+  CONST EFI_GUID  *SectionGuid;
+  UINT32          DataOffset;
+  UINT32          SectionSize;
+
+  if (IS_SECTION2 (InputSection)) {
+    SectionGuid = &((EFI_GUID_DEFINED_SECTION2 *) InputSection)->SectionDefinitionGuid;
+    DataOffset  = ((EFI_GUID_DEFINED_SECTION2 *) InputSection)->DataOffset;
+    *Attributes = ((EFI_GUID_DEFINED_SECTION2 *) InputSection)->Attributes;
+    SectionSize = SECTION2_SIZE (InputSection);
+  } else {
+    SectionGuid = &((EFI_GUID_DEFINED_SECTION *) InputSection)->SectionDefinitionGuid;
+    DataOffset  = ((EFI_GUID_DEFINED_SECTION *) InputSection)->DataOffset;
+    *Attributes = ((EFI_GUID_DEFINED_SECTION *) InputSection)->Attributes;
+    SectionSize = SECTION_SIZE (InputSection);
+  }
+
+  if (!CompareGuid (&gEdkiiChunkedSectionGuid, SectionGuid) || (DataOffset > SectionSize)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  *Header   = (CHUNKED_SECTION_HEADER *) ((UINT8 *) InputSection + DataOffset);
+  *DataSize = SectionSize - DataOffset;
+
+  if ((*DataSize < sizeof (CHUNKED_SECTION_HEADER)) ||
+      ((*Header)->Signature != CHUNKED_SECTION_SIGNATURE) ||
+      ((*Header)->ChunkCount == 0) ||
+      ((*Header)->ChunkCount > (*DataSize - sizeof (CHUNKED_SECTION_HEADER)) / sizeof (CHUNKED_SECTION_ENTRY))) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Locate one chunk of a chunked section and retrieve its decoding information.
+
+  @param[in]  Header            The chunked section header.
+  @param[in]  DataSize          The size of the chunked section data.
+  @param[in]  Index             The index of the chunk.
+  @param[out] Chunk             Returns the GUIDed section holding the chunk.
+  @param[out] OutputSize        Returns the decoded size of the chunk.
+  @param[out] ScratchSize       Returns the scratch size required by the chunk,
+                                rounded up to keep the next chunk aligned.
+
+  @retval RETURN_SUCCESS            The chunk is valid.
+  @retval RETURN_INVALID_PARAMETER  The chunk is not valid.
+**/
+RETURN_STATUS
+GetChunkInfo (
+  IN  CHUNKED_SECTION_HEADER  *Header,
+  IN  UINT32                  DataSize,
+  IN  UINT32                  Index,
+  OUT CONST VOID              **Chunk,
+  OUT UINT32                  *OutputSize,
+  OUT UINT32                  *ScratchSize
+  )
+{
+  CHUNKED_SECTION_ENTRY  *Entry;
+  RETURN_STATUS          Status;
+  UINT16                 ChunkAttributes;
+
+  Entry = (CHUNKED_SECTION_ENTRY *) (Header + 1) + Index;
+  if ((Entry->SectionOffset > DataSize - sizeof (EFI_GUID_DEFINED_SECTION)) ||
+      ((Entry->SectionOffset & 0x3) != 0)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  *Chunk = (UINT8 *) Header + Entry->SectionOffset;
+  if (IS_SECTION2 (*Chunk) ||
+      (SECTION_SIZE (*Chunk) > DataSize - Entry->SectionOffset) ||
+      (((EFI_COMMON_SECTION_HEADER *) *Chunk)->Type != EFI_SECTION_GUID_DEFINED)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Status = ExtractGuidedSectionGetInfo (*Chunk, OutputSize, ScratchSize, &ChunkAttributes);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Chunks are decoded in place into the output buffer, so they have to be
+  // processed sections that fit in the decoded data of the whole section.
+  //
+  if (((ChunkAttributes & EFI_GUIDED_SECTION_PROCESSING_REQUIRED) == 0) ||
+      (Entry->OutputOffset > Header->DecodedSize) ||
+      (*OutputSize > Header->DecodedSize - Entry->OutputOffset)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  *ScratchSize = ALIGN_VALUE (*ScratchSize, sizeof (UINT64));
+  return RETURN_SUCCESS;
+}
+
+/**
+  Check that the chunks are decoded into disjoint ranges of the output, so
+  that processors decoding different chunks never write the same bytes.
+
+  @param[in] Jobs      The resolved chunks.
+  @param[in] JobCount  The number of chunks.
+
+  @retval TRUE   The output ranges of the chunks do not overlap.
+  @retval FALSE  At least two chunks are decoded into overlapping ranges.
+**/
+BOOLEAN
+ChunkOutputsAreDisjoint (
+  IN CHUNK_DECODE_JOB  *Jobs,
+  IN UINT32            JobCount
+  )
+{
+  UINT32  Index;
+  UINT32  Other;
+  UINT8   *Start;
+  UINT8   *OtherStart;
+
+  for (Index = 0; Index < JobCount; Index++) {
+    Start = (UINT8 *) Jobs[Index].Output;
+    for (Other = Index + 1; Other < JobCount; Other++) {
+      OtherStart = (UINT8 *) Jobs[Other].Output;
+      if ((Start < OtherStart + Jobs[Other].OutputSize) &&
+          (OtherStart < Start + Jobs[Index].OutputSize)) {
+        return FALSE;
+      }
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Check whether a chunk may be decoded on an AP.
+
+  Only the LZMA decoders are used on the APs. They work entirely in the output
+  and scratch buffers prepared by the BSP, and do not call PEI services,
+  DebugLib or ReportStatusCodeLib, none of which may be used from an AP.
+
+  @param[in] Chunk  The GUIDed section holding the chunk.
+
+  @retval TRUE   The chunk may be decoded on an AP.
+  @retval FALSE  The chunk has to be decoded on the BSP.
+**/
+BOOLEAN
+IsChunkApSafe (
+  IN CONST VOID  *Chunk
+  )
+{
+  CONST EFI_GUID  *ChunkGuid;
+
+  ChunkGuid = &((EFI_GUID_DEFINED_SECTION *) Chunk)->SectionDefinitionGuid;
+  return (BOOLEAN) (CompareGuid (ChunkGuid, &gLzmaCustomDecompressGuid) ||
+                    CompareGuid (ChunkGuid, &gLzmaF86CustomDecompressGuid));
+}
+
+/**
+  Decode chunks until all of them have been taken by a processor.
+
+  This function first runs on the APs through the blocking StartupAllAPs()
+  of the PEI MP Services PPI, where every AP takes the next pending chunk so
+  the work is balanced even if the chunks take different time to decode.
+  It then runs on the BSP, which decodes any chunk left over, or all of them
+  when no AP was started. It must not ASSERT, print or call PEI services,
+  because that is not allowed on an AP; the result of each chunk is recorded
+  in its job and reported by the BSP.
+
+  @param[in] Buffer  The CHUNK_DECODE_CONTEXT shared by all processors.
+**/
+VOID
+EFIAPI
+DecodeChunks (
+  IN VOID  *Buffer
+  )
+{
+  CHUNK_DECODE_CONTEXT  *Context;
+  CHUNK_DECODE_JOB      *Job;
+  UINT32                Index;
+  UINT32                AuthenticationStatus;
+  VOID                  *Output;
+
+  Context = (CHUNK_DECODE_CONTEXT *) Buffer;
+  while (TRUE) {
+    Index = InterlockedIncrement (&Context->NextJob) - 1;
+    if (Index >= Context->JobCount) {
+      break;
+    }
+
+    Job    = &Context->Jobs[Index];
+    Output = Job->Output;
+    Job->Status = Job->Decode (Job->Section, &Output, Job->Scratch, &AuthenticationStatus);
+  }
+}
+
+/**
+  Examines a chunked GUIDed section and returns the size of the decoded buffer
+  and the size of the scratch buffer required to decode all of its chunks.
+
+  @param[in]  InputSection       A pointer to a GUIDed section of an FFS formatted file.
+  @param[out] OutputBufferSize   A pointer to the size, in bytes, of an output buffer required
+                                 if the buffer specified by InputSection were decoded.
+  @param[out] ScratchBufferSize  A pointer to the size, in bytes, required as scratch space
+                                 if the buffer specified by InputSection were decoded.
+  @param[out] SectionAttribute   A pointer to the attributes of the GUIDed section. See the Attributes
+                                 field of EFI_GUID_DEFINED_SECTION in the PI Specification.
+
+  @retval  RETURN_SUCCESS            The information about InputSection was returned.
+  @retval  RETURN_INVALID_PARAMETER  The information can not be retrieved from the section specified by InputSection.
+
+**/
+RETURN_STATUS
+EFIAPI
+ChunkedSectionGetInfo (
+  IN  CONST VOID  *InputSection,
+  OUT UINT32      *OutputBufferSize,
+  OUT UINT32      *ScratchBufferSize,
+  OUT UINT16      *SectionAttribute
+  )
+{
+  RETURN_STATUS           Status;
+  CHUNKED_SECTION_HEADER  *Header;
+  UINT32                  DataSize;
+  UINT32                  Index;
+  CONST VOID              *Chunk;
+  UINT32                  ChunkOutputSize;
+  UINT32                  ChunkScratchSize;
+  UINT64                  TotalScratchSize;
+
+  Status = GetChunkedSectionHeader (InputSection, &Header, &DataSize, SectionAttribute);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  TotalScratchSize = ALIGN_VALUE (Header->ChunkCount * sizeof (CHUNK_DECODE_JOB), sizeof (UINT64));
+  for (Index = 0; Index < Header->ChunkCount; Index++) {
+    Status = GetChunkInfo (Header, DataSize, Index, &Chunk, &ChunkOutputSize, &ChunkScratchSize);
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+    TotalScratchSize += ChunkScratchSize;
+  }
+
+  if (TotalScratchSize > MAX_UINT32) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  *OutputBufferSize  = Header->DecodedSize;
+  *ScratchBufferSize = (UINT32) TotalScratchSize;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decode a chunked GUIDed section into a caller allocated output buffer.
+
+  The chunks are decoded on all enabled APs when the MP Services PPI is
+  available and every chunk is an LZMA section, and one after another on the
+  BSP otherwise.
+
+  @param[in]  InputSection  A pointer to a GUIDed section of an FFS formatted file.
+  @param[out] OutputBuffer  A pointer to a buffer that contains the result of a decode operation.
+  @param[out] ScratchBuffer A caller allocated buffer that may be required by this function
+                            as a scratch buffer to perform the decode operation.
+  @param[out] AuthenticationStatus
+                            A pointer to the authentication status of the decoded output buffer.
+
+  @retval  RETURN_SUCCESS            The buffer specified by InputSection was decoded.
+  @retval  RETURN_INVALID_PARAMETER  The section specified by InputSection can not be decoded,
+                                     or the outputs of its chunks overlap.
+
+**/
+RETURN_STATUS
+EFIAPI
+ChunkedSectionExtraction (
+  IN CONST  VOID    *InputSection,
+  OUT       VOID    **OutputBuffer,
+  OUT       VOID    *ScratchBuffer,        OPTIONAL
+  OUT       UINT32  *AuthenticationStatus
+  )
+{
+  RETURN_STATUS            Status;
+  EFI_STATUS               MpStatus;
+  CHUNKED_SECTION_HEADER   *Header;
+  CHUNKED_SECTION_ENTRY    *Entry;
+  UINT32                   DataSize;
+  UINT16                   Attributes;
+  UINT32                   Index;
+  UINT32                   ChunkScratchSize;
+  UINT8                    *Scratch;
+  BOOLEAN                  ApSafe;
+  CHUNK_DECODE_CONTEXT     Context;
+  EFI_PEI_MP_SERVICES_PPI  *MpServices;
+
+  ASSERT (OutputBuffer != NULL);
+  ASSERT (InputSection != NULL);
+
+  Status = GetChunkedSectionHeader (InputSection, &Header, &DataSize, &Attributes);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Resolve every chunk on the BSP, so the APs only run the decoders.
+  //
+  Context.Jobs     = (CHUNK_DECODE_JOB *) ScratchBuffer;
+  Context.JobCount = Header->ChunkCount;
+  Context.NextJob  = 0;
+  Scratch = (UINT8 *) ScratchBuffer + ALIGN_VALUE (Header->ChunkCount * sizeof (CHUNK_DECODE_JOB), sizeof (UINT64));
+  Entry   = (CHUNKED_SECTION_ENTRY *) (Header + 1);
+  ApSafe  = TRUE;
+  for (Index = 0; Index < Header->ChunkCount; Index++) {
+    Status = GetChunkInfo (
+               Header,
+               DataSize,
+               Index,
+               &Context.Jobs[Index].Section,
+               &Context.Jobs[Index].OutputSize,
+               &ChunkScratchSize
+               );
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+    if (!IsChunkApSafe (Context.Jobs[Index].Section)) {
+      ApSafe = FALSE;
+    }
+    Status = ExtractGuidedSectionGetHandlers (
+               &((EFI_GUID_DEFINED_SECTION *) Context.Jobs[Index].Section)->SectionDefinitionGuid,
+               NULL,
+               &Context.Jobs[Index].Decode
+               );
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+    Context.Jobs[Index].Output  = (UINT8 *) *OutputBuffer + Entry[Index].OutputOffset;
+    Context.Jobs[Index].Scratch = Scratch;
+    Context.Jobs[Index].Status  = RETURN_NOT_STARTED;
+    Scratch += ChunkScratchSize;
+  }
+
+  if (!ChunkOutputsAreDisjoint (Context.Jobs, Context.JobCount)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  //
+  // The PEI MP Services PPI has no non-blocking mode, so the BSP waits here
+  // while the APs decode.
+  //
+  if ((Header->ChunkCount > 1) && ApSafe) {
+    MpStatus = PeiServicesLocatePpi (&gEfiPeiMpServicesPpiGuid, 0, NULL, (VOID **) &MpServices);
+    if (!EFI_ERROR (MpStatus)) {
+      MpStatus = MpServices->StartupAllAPs (
+                               GetPeiServicesTablePointer (),
+                               MpServices,
+                               DecodeChunks,
+                               FALSE,
+                               0,
+                               &Context
+                               );
+      DEBUG ((DEBUG_INFO, "Chunked section decoded on APs - %r\n", MpStatus));
+    }
+  }
+
+  //
+  // Decode the chunks left by the APs, or all of them if no AP is available.
+  //
+  DecodeChunks (&Context);
+
+  for (Index = 0; Index < Header->ChunkCount; Index++) {
+    if (RETURN_ERROR (Context.Jobs[Index].Status)) {
+      DEBUG ((DEBUG_ERROR, "Chunk %d of chunked section failed - %r\n", Index, Context.Jobs[Index].Status));
+      return Context.Jobs[Index].Status;
+    }
+  }
+
+  *AuthenticationStatus = 0;
+  return RETURN_SUCCESS;
+}
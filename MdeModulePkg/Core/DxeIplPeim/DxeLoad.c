@@ -159,6 +159,17 @@ InstallIplPermanentMemoryPpis (
   UINTN                         ExtractHandlerNumber;
   EFI_PEI_PPI_DESCRIPTOR        *GuidPpi;
 
+  //
+  // Register the chunked section handler, so that its guided section
+  // extraction PPI is installed together with the other handlers.
+  //
+  Status = ExtractGuidedSectionRegisterHandlers (
+             &gEdkiiChunkedSectionGuid,
+             ChunkedSectionGetInfo,
+             ChunkedSectionExtraction
+             );
+  ASSERT_EFI_ERROR (Status);
+
   //
   // Get custom extract guided section method guid list 
   //
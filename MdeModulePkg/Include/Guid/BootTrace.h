@@ -0,0 +1,168 @@
+/** @file
+  Boot trace data structure.
+
+  The boot trace is a stream of time stamped records which carries both the
+  memory allocation events of the DXE core and the performance measurements
+  of DxeCorePerformanceLib on the same performance counter, so that both can
+  be correlated by a host-side decoder (BaseTools/Scripts/BootTraceDecode.py).
+
+  Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#ifndef _BOOT_TRACE_H_
+#define _BOOT_TRACE_H_
+
+#include <Guid/MemoryProfile.h>
+
+#define EDKII_BOOT_TRACE_GUID \
+  { \
+    0x96f1af41, 0xd26f, 0x4c3d, { 0x92, 0xe1, 0x4a, 0x4b, 0xaf, 0xb8, 0x20, 0x04 } \
+  }
+
+#define BOOT_TRACE_HEADER_SIGNATURE SIGNATURE_32 ('B','T','H','D')
+#define BOOT_TRACE_HEADER_REVISION  0x0001
+
+typedef struct {
+  UINT32                        Signature;
+  UINT16                        Length;
+  UINT16                        Revision;
+  UINT64                        Frequency;          ///< Frequency of the performance counter in Hz.
+  UINT64                        TimerStartValue;    ///< Value the performance counter starts with.
+  UINT64                        TimerEndValue;      ///< Value the performance counter ends with.
+  UINT64                        RecordSize;         ///< Size in bytes of the records following the header.
+  UINT32                        RecordCount;        ///< Number of the records following the header.
+  UINT32                        LostRecordCount;    ///< Number of the records dropped because the buffer was full.
+} BOOT_TRACE_HEADER;
+
+//
+// Record types.
+//
+#define BOOT_TRACE_RECORD_TYPE_MEMORY         0x0001
+#define BOOT_TRACE_RECORD_TYPE_PERF_START     0x0002
+#define BOOT_TRACE_RECORD_TYPE_PERF_END       0x0003
+#define BOOT_TRACE_RECORD_TYPE_IMAGE_LOAD     0x0004
+#define BOOT_TRACE_RECORD_TYPE_IMAGE_UNLOAD   0x0005
+
+//
+// Every record starts with this header. Length covers the whole record and
+// is a multiple of 8 bytes, so a decoder skips record types it does not know.
+//
+typedef struct {
+  UINT16                        Type;
+  UINT16                        Length;
+  UINT8                         Reserved[4];
+  UINT64                        TimeStamp;          ///< Performance counter value of the event.
+} BOOT_TRACE_RECORD_HEADER;
+
+//
+// Allocation or free of memory, see MEMORY_PROFILE_ACTION.
+// Size is 0 for the free of a pool.
+//
+typedef struct {
+  BOOT_TRACE_RECORD_HEADER      Header;
+  PHYSICAL_ADDRESS              CallerAddress;
+  PHYSICAL_ADDRESS              Buffer;
+  UINT64                        Size;
+  MEMORY_PROFILE_ACTION         Action;
+  EFI_MEMORY_TYPE               MemoryType;
+} BOOT_TRACE_MEMORY_RECORD;
+
+#define BOOT_TRACE_STRING_SIZE  32
+
+//
+// Start or end of a performance measurement. GaugeIndex pairs the end with
+// its start.
+//
+typedef struct {
+  BOOT_TRACE_RECORD_HEADER      Header;
+  PHYSICAL_ADDRESS              Handle;
+  UINT32                        GaugeIndex;
+  UINT32                        Identifier;
+  CHAR8                         Token[BOOT_TRACE_STRING_SIZE];
+  CHAR8                         Module[BOOT_TRACE_STRING_SIZE];
+} BOOT_TRACE_PERF_RECORD;
+
+//
+// Start or unload of an image, used to map caller addresses to images.
+//
+typedef struct {
+  BOOT_TRACE_RECORD_HEADER      Header;
+  EFI_GUID                      FileName;
+  PHYSICAL_ADDRESS              ImageBase;
+  UINT64                        ImageSize;
+  PHYSICAL_ADDRESS              EntryPoint;
+//CHAR8                         PdbString[];
+} BOOT_TRACE_IMAGE_RECORD;
+
+//
+// Boot trace layout:
+// +--------------------------------+
+// | HEADER                         |
+// +--------------------------------+
+// | RECORD(1)                      |
+// +--------------------------------+
+// | ......                         |
+// +--------------------------------+
+// | RECORD(RecordCount)            |
+// +--------------------------------+
+//
+
+typedef struct _EDKII_BOOT_TRACE_PROTOCOL EDKII_BOOT_TRACE_PROTOCOL;
+
+/**
+  Get boot trace data.
+
+  @param[in]      This              The EDKII_BOOT_TRACE_PROTOCOL instance.
+  @param[in, out] TraceSize         On entry, points to the size in bytes of the TraceBuffer.
+                                    On return, points to the size of the data returned in TraceBuffer.
+  @param[out]     TraceBuffer       Trace buffer.
+
+  @return EFI_SUCCESS               Get the boot trace data successfully.
+  @return EFI_INVALID_PARAMETER     TraceSize is NULL.
+  @return EFI_BUFFER_TOO_SMALL      The TraceSize is too small for the resulting data.
+                                    TraceSize is updated with the size required.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_BOOT_TRACE_GET_DATA)(
+  IN     EDKII_BOOT_TRACE_PROTOCOL      *This,
+  IN OUT UINT64                         *TraceSize,
+     OUT VOID                           *TraceBuffer
+  );
+
+/**
+  Append a record to the boot trace.
+
+  @param[in] This               The EDKII_BOOT_TRACE_PROTOCOL instance.
+  @param[in] Record             Record to append. If its TimeStamp is 0,
+                                the current performance counter value is used.
+
+  @return EFI_SUCCESS           The record is appended.
+  @return EFI_INVALID_PARAMETER Record is NULL, or its Length is invalid.
+  @return EFI_OUT_OF_RESOURCES  The trace buffer is full. The record is counted as lost.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_BOOT_TRACE_APPEND)(
+  IN EDKII_BOOT_TRACE_PROTOCOL          *This,
+  IN BOOT_TRACE_RECORD_HEADER           *Record
+  );
+
+struct _EDKII_BOOT_TRACE_PROTOCOL {
+  EDKII_BOOT_TRACE_GET_DATA             GetData;
+  EDKII_BOOT_TRACE_APPEND               Append;
+};
+
+extern EFI_GUID gEdkiiBootTraceGuid;
+
+#endif
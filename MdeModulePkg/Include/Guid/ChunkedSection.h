@@ -0,0 +1,65 @@
+/** @file
+  Chunked GUIDed section definition.
+
+  The data of a GUIDed section with this GUID is split into chunks that are
+  encoded independently, so the chunks can be decoded in any order and on
+  several processors at the same time.
+
+  The section data starts with CHUNKED_SECTION_HEADER, followed by ChunkCount
+  CHUNKED_SECTION_ENTRY structures. Each entry locates one chunk, which is a
+  complete GUIDed section (for example an LZMA compressed section) aligned on
+  a 4-byte boundary. The decoded data of the chunk is placed at OutputOffset
+  of the decoded data of the whole section.
+
+Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+This program and the accompanying materials
+are licensed and made available under the terms and conditions of the BSD License
+which accompanies this distribution.  The full text of the license may be found at
+http://opensource.org/licenses/bsd-license.php
+
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#ifndef __CHUNKED_SECTION_GUID_H__
+#define __CHUNKED_SECTION_GUID_H__
+
+///
+/// The Global ID used to identify a section of an FFS file of type
+/// EFI_SECTION_GUID_DEFINED, whose contents are independently encoded chunks.
+///
+#define EDKII_CHUNKED_SECTION_GUID  \
+  { 0x7896e3de, 0xb311, 0x427b, { 0x80, 0x23, 0x3c, 0x6c, 0xdc, 0xe8, 0x27, 0xa9 } }
+
+#define CHUNKED_SECTION_SIGNATURE  SIGNATURE_32 ('C', 'H', 'N', 'K')
+
+typedef struct {
+  UINT32  Signature;
+  ///
+  /// Number of CHUNKED_SECTION_ENTRY structures following this header.
+  ///
+  UINT32  ChunkCount;
+  ///
+  /// Size of the decoded data of the whole section.
+  ///
+  UINT32  DecodedSize;
+  UINT32  Reserved;
+} CHUNKED_SECTION_HEADER;
+
+typedef struct {
+  ///
+  /// Offset of the GUIDed section holding the chunk, from the start of
+  /// CHUNKED_SECTION_HEADER.
+  ///
+  UINT32  SectionOffset;
+  ///
+  /// Offset of the decoded data of the chunk in the decoded data of the
+  /// whole section.
+  ///
+  UINT32  OutputOffset;
+} CHUNKED_SECTION_ENTRY;
+
+extern EFI_GUID gEdkiiChunkedSectionGuid;
+
+#endif
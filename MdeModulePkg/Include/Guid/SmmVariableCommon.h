@@ -1,7 +1,7 @@
 /** @file
   The file defined some common structures used for communicating between SMM variable module and SMM variable wrapper module.
 
-Copyright (c) 2011 - 2015, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2011 - 2017, Intel Corporation. All rights reserved.<BR>
 This program and the accompanying materials are licensed and made available under
 the terms and conditions of the BSD License that accompanies this distribution.
 The full text of the license may be found at
@@ -72,6 +72,11 @@ typedef struct {
 #define SMM_VARIABLE_FUNCTION_VAR_CHECK_VARIABLE_PROPERTY_GET  10
 
 #define SMM_VARIABLE_FUNCTION_GET_PAYLOAD_SIZE        11
+//
+// The payload for this function is VARIABLE_AUTH_INFO_ENTRY, followed by the
+// variable name as for SMM_VARIABLE_FUNCTION_GET_STATISTICS.
+//
+#define SMM_VARIABLE_FUNCTION_GET_AUTH_STATISTICS     12
 
 ///
 /// Size of SMM communicate header, without including the payload.
@@ -0,0 +1,44 @@
+/** @file
+  The time the EDK II variable driver spends authenticating the writes of each
+  variable, collected with the variable statistics when PcdVariableCollectStatistics
+  is TRUE.
+
+  The list of VARIABLE_AUTH_INFO_ENTRY is put in the EFI system table with
+  gEdkiiVariableAuthInfoGuid by the variable driver, or returned one entry at a
+  time by the SMM variable driver with SMM_VARIABLE_FUNCTION_GET_AUTH_STATISTICS.
+
+Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+This program and the accompanying materials are licensed and made available under
+the terms and conditions of the BSD License that accompanies this distribution.
+The full text of the license may be found at
+http://opensource.org/licenses/bsd-license.php.
+
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#ifndef __VARIABLE_AUTH_INFO_H__
+#define __VARIABLE_AUTH_INFO_H__
+
+#define EDKII_VARIABLE_AUTH_INFO_GUID \
+  { 0x88359f54, 0x7dbc, 0x44c0, { 0xbb, 0x67, 0xac, 0xb4, 0xe0, 0xf8, 0x76, 0xd7 } }
+
+extern EFI_GUID gEdkiiVariableAuthInfoGuid;
+
+typedef struct _VARIABLE_AUTH_INFO_ENTRY  VARIABLE_AUTH_INFO_ENTRY;
+
+///
+/// This structure contains the authenticated writes of a variable done at boot
+/// service time.
+///
+struct _VARIABLE_AUTH_INFO_ENTRY {
+  VARIABLE_AUTH_INFO_ENTRY  *Next;       ///< Pointer to next entry.
+  EFI_GUID                  VendorGuid;  ///< Guid of Variable.
+  CHAR16                    *Name;       ///< Name of Variable.
+  BOOLEAN                   Volatile;    ///< TRUE if volatile, FALSE if non-volatile.
+  UINT32                    AuthCount;   ///< Number of authenticated writes of this variable.
+  UINT64                    AuthTime;    ///< Time in nanoseconds spent authenticating these writes.
+};
+
+#endif // __VARIABLE_AUTH_INFO_H__
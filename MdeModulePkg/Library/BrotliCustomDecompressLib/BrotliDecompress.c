@@ -94,6 +94,11 @@ BrFree (
   specified by Source is not in a valid compressed data format,
   then EFI_INVALID_PARAMETER is returned.
 
+  The compressed data is fed to the decoder directly from Source and decoded
+  directly into Destination, so the scratch buffer only has to hold the decoder
+  state and its ring buffer, whose size is bounded by the window used at
+  compression time.
+
   @param  Source      The source buffer containing the compressed data.
   @param  SourceSize  The size of source buffer.
   @param  Destination The destination buffer to store the decompressed data.
@@ -115,8 +120,6 @@ BrotliDecompress (
   IN VOID *       BuffInfo
   )
 {
-  UINT8 *        Input;
-  UINT8 *        Output;
   const UINT8 *  NextIn;
   UINT8 *        NextOut;
   size_t         TotalOut;
@@ -124,68 +127,37 @@ BrotliDecompress (
   size_t         AvailableOut;
   BrotliResult   Result;
   BrotliState *  BroState;
-  VOID *         Temp;
 
   TotalOut = 0;
-  AvailableOut = FILE_BUFFER_SIZE;
-  Result = BROTLI_RESULT_ERROR;
   BroState = BrotliCreateState(BrAlloc, BrFree, BuffInfo);
-  Temp = Destination;
-
   if (BroState == NULL) {
     return EFI_INVALID_PARAMETER;
   }
-  Input = (UINT8 *)BrAlloc(BuffInfo, FILE_BUFFER_SIZE);
-  Output = (UINT8 *)BrAlloc(BuffInfo, FILE_BUFFER_SIZE);
-  if ((Input==NULL) || (Output==NULL)) {
-    BrFree(BuffInfo, Input);
-    BrFree(BuffInfo, Output);
-    BrotliDestroyState(BroState);
-    return EFI_INVALID_PARAMETER;
-  }
-  NextOut = Output;
-  Result = BROTLI_RESULT_NEEDS_MORE_INPUT;
-  while (1) {
-    if (Result == BROTLI_RESULT_NEEDS_MORE_INPUT) {
-      if (SourceSize == 0) {
-        break;
-      }
-      if (SourceSize >= FILE_BUFFER_SIZE) {
-        AvailableIn = FILE_BUFFER_SIZE;
-      }else{
-        AvailableIn = SourceSize;
-      }
-      CopyMem(Input, Source, AvailableIn);
-      Source = (VOID *)((UINT8 *)Source + AvailableIn);
-      SourceSize -= AvailableIn;
-      NextIn = Input;
-    } else if (Result == BROTLI_RESULT_NEEDS_MORE_OUTPUT) {
-      CopyMem(Temp, Output, FILE_BUFFER_SIZE);
-      AvailableOut = FILE_BUFFER_SIZE;
-      Temp = (VOID *)((UINT8 *)Temp +FILE_BUFFER_SIZE);
-      NextOut = Output;
-    } else {
-      break; /* Error or success. */
-    }
-    Result = BrotliDecompressStream(
-                          &AvailableIn,
-                          &NextIn,
-                          &AvailableOut,
-                          &NextOut,
-                          &TotalOut,
-                          BroState
-                          );
-  }
-  if (NextOut != Output) {
-    CopyMem(Temp, Output, (size_t)(NextOut - Output));
-  }
 
-  DestSize = TotalOut;
+  NextIn       = (CONST UINT8 *)Source;
+  AvailableIn  = SourceSize;
+  NextOut      = (UINT8 *)Destination;
+  AvailableOut = DestSize;
+
+  Result = BrotliDecompressStream(
+                        &AvailableIn,
+                        &NextIn,
+                        &AvailableOut,
+                        &NextOut,
+                        &TotalOut,
+                        BroState
+                        );
 
-  BrFree(BuffInfo, Input);
-  BrFree(BuffInfo, Output);
   BrotliDestroyState(BroState);
-  return (Result == BROTLI_RESULT_SUCCESS) ? EFI_SUCCESS : EFI_INVALID_PARAMETER;
+  //
+  // BROTLI_RESULT_NEEDS_MORE_OUTPUT means the stream decodes to more data
+  // than the header claims, and BROTLI_RESULT_NEEDS_MORE_INPUT means the
+  // stream is truncated. Both are reported as corrupted source data.
+  //
+  if ((Result != BROTLI_RESULT_SUCCESS) || (TotalOut != DestSize)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  return EFI_SUCCESS;
 }
 
 /**
@@ -298,12 +270,20 @@ BrotliUefiDecompress (
   IN OUT VOID *     Scratch
   )
 {
-  UINTN          DestSize = 0;
+  UINTN          DestSize;
   EFI_STATUS     Status;
   BROTLI_BUFF    BroBuff;
   UINT64         GetSize;
   UINT8          MaxOffset;
 
+  if (SourceSize < BROTLI_SCRATCH_MAX) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  MaxOffset = BROTLI_DECODE_MAX;
+  GetSize = GetDecodedSizeOfBuf((UINT8 *)Source, MaxOffset - BROTLI_INFO_SIZE, MaxOffset);
+  DestSize = (UINTN)GetSize;
+
   MaxOffset = BROTLI_SCRATCH_MAX;
   GetSize = GetDecodedSizeOfBuf((UINT8 *)Source, MaxOffset - BROTLI_INFO_SIZE, MaxOffset);
 
@@ -31,7 +31,6 @@ typedef struct
   UINTN    BuffSize;
 } BROTLI_BUFF;
 
-#define FILE_BUFFER_SIZE     65536
 #define BROTLI_INFO_SIZE     8
 #define BROTLI_DECODE_MAX    8
 #define BROTLI_SCRATCH_MAX   16
@@ -63,6 +63,101 @@ PERFORMANCE_EX_PROTOCOL mPerformanceExInterface = {
 
 PERFORMANCE_PROPERTY  mPerformanceProperty;
 
+//
+// Boot trace protocol, located once DxeCore has installed it.
+//
+EDKII_BOOT_TRACE_PROTOCOL  *mBootTrace = NULL;
+
+/**
+  Appends the start or the end of a gauge entry to the boot trace.
+
+  @param  Index                   Index of the gauge entry.
+  @param  Start                   TRUE for the start of the measurement, FALSE for its end.
+
+**/
+VOID
+InternalAppendBootTraceRecord (
+  IN UINT32       Index,
+  IN BOOLEAN      Start
+  )
+{
+  GAUGE_DATA_ENTRY_EX       *GaugeEntryExArray;
+  BOOT_TRACE_PERF_RECORD    Record;
+
+  GaugeEntryExArray = (GAUGE_DATA_ENTRY_EX *) (mGaugeData + 1);
+
+  ZeroMem (&Record, sizeof (Record));
+  Record.Header.Type      = Start ? BOOT_TRACE_RECORD_TYPE_PERF_START : BOOT_TRACE_RECORD_TYPE_PERF_END;
+  Record.Header.Length    = sizeof (Record);
+  Record.Header.TimeStamp = Start ? GaugeEntryExArray[Index].StartTimeStamp : GaugeEntryExArray[Index].EndTimeStamp;
+  Record.Handle           = GaugeEntryExArray[Index].Handle;
+  Record.GaugeIndex       = Index;
+  Record.Identifier       = GaugeEntryExArray[Index].Identifier;
+  CopyMem (Record.Token, GaugeEntryExArray[Index].Token, MIN (sizeof (Record.Token), DXE_PERFORMANCE_STRING_SIZE));
+  CopyMem (Record.Module, GaugeEntryExArray[Index].Module, MIN (sizeof (Record.Module), DXE_PERFORMANCE_STRING_SIZE));
+  Record.Token[sizeof (Record.Token) - 1]   = 0;
+  Record.Module[sizeof (Record.Module) - 1] = 0;
+
+  mBootTrace->Append (mBootTrace, &Record.Header);
+}
+
+/**
+  Records the start or the end of a gauge entry in the boot trace.
+
+  The boot trace protocol is installed by DxeCore after this library has been
+  constructed. When it is found for the first time, all measurements logged
+  so far, including the current one, are replayed into the boot trace.
+
+  @param  Index                   Index of the gauge entry.
+  @param  Start                   TRUE for the start of the measurement, FALSE for its end.
+
+**/
+VOID
+InternalBootTraceGauge (
+  IN UINT32       Index,
+  IN BOOLEAN      Start
+  )
+{
+  EFI_STATUS                Status;
+  GAUGE_DATA_ENTRY_EX       *GaugeEntryExArray;
+  UINT32                    EntryIndex;
+
+  if (PcdGet32 (PcdBootTraceBufferSize) == 0) {
+    return;
+  }
+
+  if (mBootTrace != NULL) {
+    InternalAppendBootTraceRecord (Index, Start);
+    return;
+  }
+
+  //
+  // LocateProtocol() can not be used above TPL_NOTIFY.
+  //
+  if (EfiGetCurrentTpl () > TPL_NOTIFY) {
+    return;
+  }
+  Status = gBS->LocateProtocol (&gEdkiiBootTraceGuid, NULL, (VOID **) &mBootTrace);
+  if (EFI_ERROR (Status)) {
+    mBootTrace = NULL;
+    return;
+  }
+
+  GaugeEntryExArray = (GAUGE_DATA_ENTRY_EX *) (mGaugeData + 1);
+  for (EntryIndex = 0; EntryIndex < mGaugeData->NumberOfEntries; EntryIndex++) {
+    //
+    // A zero time stamp would be replaced by the current time, so such an
+    // entry can not be replayed.
+    //
+    if (GaugeEntryExArray[EntryIndex].StartTimeStamp != 0) {
+      InternalAppendBootTraceRecord (EntryIndex, TRUE);
+      if (GaugeEntryExArray[EntryIndex].EndTimeStamp != 0) {
+        InternalAppendBootTraceRecord (EntryIndex, FALSE);
+      }
+    }
+  }
+}
+
 /**
   Searches in the gauge array with keyword Handle, Token, Module and Identifier.
 
@@ -209,6 +304,8 @@ StartGaugeEx (
 
   mGaugeData->NumberOfEntries++;
 
+  InternalBootTraceGauge (Index, TRUE);
+
   return EFI_SUCCESS;
 }
 
@@ -262,6 +359,8 @@ EndGaugeEx (
   GaugeEntryExArray = (GAUGE_DATA_ENTRY_EX *) (mGaugeData + 1);
   GaugeEntryExArray[Index].EndTimeStamp = TimeStamp;
 
+  InternalBootTraceGauge (Index, FALSE);
+
   return EFI_SUCCESS;
 }
 
@@ -22,6 +22,7 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include <PiDxe.h>
 
 #include <Guid/Performance.h>
+#include <Guid/BootTrace.h>
 
 #include <Library/PerformanceLib.h>
 #include <Library/DebugLib.h>
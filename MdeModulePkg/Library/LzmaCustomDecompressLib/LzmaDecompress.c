@@ -1,7 +1,7 @@
 /** @file
   LZMA Decompress interfaces
 
-  Copyright (c) 2009 - 2016, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2009 - 2017, Intel Corporation. All rights reserved.<BR>
   This program and the accompanying materials
   are licensed and made available under the terms and conditions of the BSD License
   which accompanies this distribution.  The full text of the license may be found at
@@ -17,7 +17,14 @@
 #include "Sdk/C/7zVersion.h"
 #include "Sdk/C/LzmaDec.h"
 
-#define SCRATCH_BUFFER_REQUEST_SIZE SIZE_64KB
+//
+// Size of the literal/match probability model, must match LzmaDec.c.
+// LzmaDecode() uses the destination buffer as the dictionary, so the
+// probability model is the only scratch memory needed for decoding.
+//
+#define LZMA_BASE_SIZE 1846
+#define LZMA_LIT_SIZE  0x300
+#define LZMA_NUM_PROBS(Props) (LZMA_BASE_SIZE + ((UINT32) LZMA_LIT_SIZE << ((Props)->lc + (Props)->lp)))
 
 typedef struct
 {
@@ -51,7 +58,11 @@ SzAlloc (
     Private->BufferSize -= Size;
     return Addr;
   } else {
-    ASSERT (FALSE);
+    //
+    // The scratch buffer is sized from the same LZMA properties, so this is
+    // not expected. Fail the decode instead of asserting, because the decoder
+    // may run on an AP where DebugLib can not be used.
+    //
     return NULL;
   }
 }
@@ -100,6 +111,32 @@ GetDecodedSizeOfBuf(
   return DecodedSize;
 }
 
+/**
+  Get the size of the scratch buffer required to decode the compressed data,
+  which is the size of the probability model described by the LZMA properties.
+
+  @param EncodedData  Pointer to the compressed data.
+  @param ScratchSize  Pointer to the size of the scratch buffer.
+
+  @retval RETURN_SUCCESS            The scratch buffer size is returned.
+  @retval RETURN_INVALID_PARAMETER  The LZMA properties in the header are invalid.
+**/
+RETURN_STATUS
+GetScratchSizeOfBuf (
+  IN  UINT8   *EncodedData,
+  OUT UINT32  *ScratchSize
+  )
+{
+  CLzmaProps  Props;
+
+  if (LzmaProps_Decode (&Props, EncodedData, LZMA_PROPS_SIZE) != SZ_OK) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  *ScratchSize = LZMA_NUM_PROBS (&Props) * sizeof (CLzmaProb);
+  return RETURN_SUCCESS;
+}
+
 //
 // LZMA functions and data as defined in local LzmaDecompressLibInternal.h
 //
@@ -132,6 +169,9 @@ GetDecodedSizeOfBuf(
   @retval  RETURN_SUCCESS The size of the uncompressed data was returned 
                           in DestinationSize and the size of the scratch 
                           buffer was returned in ScratchSize.
+  @retval  RETURN_INVALID_PARAMETER
+                          The LZMA properties in the header of Source are
+                          not valid.
 
 **/
 RETURN_STATUS
@@ -150,8 +190,7 @@ LzmaUefiDecompressGetInfo (
   DecodedSize = GetDecodedSizeOfBuf((UINT8*)Source);
 
   *DestinationSize = (UINT32)DecodedSize;
-  *ScratchSize = SCRATCH_BUFFER_REQUEST_SIZE;
-  return RETURN_SUCCESS;
+  return GetScratchSizeOfBuf ((UINT8*)Source, ScratchSize);
 }
 
 /**
@@ -190,11 +229,16 @@ LzmaUefiDecompress (
   SizeT             DecodedBufSize;
   SizeT             EncodedDataSize;
   ISzAllocWithData  AllocFuncs;
+  UINT32            ScratchSize;
+
+  if (GetScratchSizeOfBuf ((UINT8*)Source, &ScratchSize) != RETURN_SUCCESS) {
+    return RETURN_INVALID_PARAMETER;
+  }
 
   AllocFuncs.Functions.Alloc  = SzAlloc;
   AllocFuncs.Functions.Free   = SzFree;
   AllocFuncs.Buffer           = Scratch;
-  AllocFuncs.BufferSize       = SCRATCH_BUFFER_REQUEST_SIZE;
+  AllocFuncs.BufferSize       = ScratchSize;
   
   DecodedBufSize = (SizeT)GetDecodedSizeOfBuf((UINT8*)Source);
   EncodedDataSize = (SizeT) (SourceSize - LZMA_HEADER_SIZE);
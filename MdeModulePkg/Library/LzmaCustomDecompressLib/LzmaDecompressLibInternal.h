@@ -50,6 +50,9 @@
   @retval  RETURN_SUCCESS The size of the uncompressed data was returned 
                           in DestinationSize and the size of the scratch 
                           buffer was returned in ScratchSize.
+  @retval  RETURN_INVALID_PARAMETER
+                          The LZMA properties in the header of Source are
+                          not valid.
 
 **/
 RETURN_STATUS
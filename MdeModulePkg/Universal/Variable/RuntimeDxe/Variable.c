@@ -47,6 +47,11 @@ EFI_FIRMWARE_VOLUME_HEADER *mNvFvHeaderCache  = NULL;
 ///
 VARIABLE_INFO_ENTRY    *gVariableInfo         = NULL;
 
+///
+/// The memory entry used for the statistics of the authenticated writes.
+///
+VARIABLE_AUTH_INFO_ENTRY  *gVariableAuthInfo  = NULL;
+
 ///
 /// The flag to indicate whether the platform has left the DXE phase of execution.
 ///
@@ -243,6 +248,76 @@ UpdateVariableInfo (
   }
 }
 
+/**
+  Routine used to track the time spent authenticating writes of a variable.
+  The data is kept apart from the one of UpdateVariableInfo(), in the list
+  pointed by gVariableAuthInfo. Like UpdateVariableInfo(), only Boot Services
+  variable accesses are tracked and the PcdVariableCollectStatistics build flag
+  controls if this feature is enabled.
+
+  @param[in] VariableName   Name of the Variable to track.
+  @param[in] VendorGuid     Guid of the Variable to track.
+  @param[in] Volatile       TRUE if volatile FALSE if non-volatile.
+  @param[in] StartTick      Performance counter value before the authentication.
+  @param[in] EndTick        Performance counter value after the authentication.
+
+**/
+VOID
+UpdateVariableAuthInfo (
+  IN  CHAR16                  *VariableName,
+  IN  EFI_GUID                *VendorGuid,
+  IN  BOOLEAN                 Volatile,
+  IN  UINT64                  StartTick,
+  IN  UINT64                  EndTick
+  )
+{
+  VARIABLE_AUTH_INFO_ENTRY  **Link;
+  VARIABLE_AUTH_INFO_ENTRY  *Entry;
+  UINT64                    StartValue;
+  UINT64                    EndValue;
+
+  if (FeaturePcdGet (PcdVariableCollectStatistics)) {
+
+    if (AtRuntime ()) {
+      // Don't collect statistics at runtime.
+      return;
+    }
+
+    for (Link = &gVariableAuthInfo; *Link != NULL; Link = &(*Link)->Next) {
+      if (CompareGuid (VendorGuid, &(*Link)->VendorGuid) &&
+          (StrCmp (VariableName, (*Link)->Name) == 0)) {
+        break;
+      }
+    }
+
+    if (*Link == NULL) {
+      //
+      // If the entry is not in the table add it. On the first call this places
+      // the head of the list in gVariableAuthInfo.
+      //
+      Entry = AllocateZeroPool (sizeof (VARIABLE_AUTH_INFO_ENTRY));
+      ASSERT (Entry != NULL);
+      if (Entry == NULL) {
+        return;
+      }
+      CopyGuid (&Entry->VendorGuid, VendorGuid);
+      Entry->Name = AllocateCopyPool (StrSize (VariableName), VariableName);
+      ASSERT (Entry->Name != NULL);
+      if (Entry->Name == NULL) {
+        FreePool (Entry);
+        return;
+      }
+      Entry->Volatile = Volatile;
+      *Link = Entry;
+    }
+    Entry = *Link;
+
+    GetPerformanceCounterProperties (&StartValue, &EndValue);
+    Entry->AuthCount++;
+    Entry->AuthTime += GetTimeInNanoSecond ((StartValue <= EndValue) ? EndTick - StartTick : StartTick - EndTick);
+  }
+}
+
 
 /**
 
@@ -3170,6 +3245,7 @@ VariableServiceSetVariable (
   VARIABLE_HEADER                     *NextVariable;
   EFI_PHYSICAL_ADDRESS                Point;
   UINTN                               PayloadSize;
+  UINT64                              StartTick;
 
   //
   // Check input parameters.
@@ -3346,7 +3422,21 @@ VariableServiceSetVariable (
   }
 
   if (mVariableModuleGlobal->VariableGlobal.AuthSupport) {
+    StartTick = 0;
+    if (FeaturePcdGet (PcdVariableCollectStatistics) && !AtRuntime ()) {
+      StartTick = GetPerformanceCounter ();
+    }
     Status = AuthVariableLibProcessVariable (VariableName, VendorGuid, Data, DataSize, Attributes);
+    if (FeaturePcdGet (PcdVariableCollectStatistics) && !AtRuntime () &&
+        ((Attributes & (EFI_VARIABLE_AUTHENTICATED_WRITE_ACCESS | EFI_VARIABLE_TIME_BASED_AUTHENTICATED_WRITE_ACCESS)) != 0)) {
+      UpdateVariableAuthInfo (
+        VariableName,
+        VendorGuid,
+        (BOOLEAN) ((Attributes & EFI_VARIABLE_NON_VOLATILE) == 0),
+        StartTick,
+        GetPerformanceCounter ()
+        );
+    }
   } else {
     Status = UpdateVariable (VariableName, VendorGuid, Data, DataSize, Attributes, 0, 0, &Variable, NULL);
   }
@@ -20,6 +20,7 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 extern VARIABLE_STORE_HEADER        *mNvVariableCache;
 extern EFI_FIRMWARE_VOLUME_HEADER   *mNvFvHeaderCache;
 extern VARIABLE_INFO_ENTRY          *gVariableInfo;
+extern VARIABLE_AUTH_INFO_ENTRY     *gVariableAuthInfo;
 EFI_HANDLE                          mHandle                    = NULL;
 EFI_EVENT                           mVirtualAddressChangeEvent = NULL;
 EFI_EVENT                           mFtwRegistration           = NULL;
@@ -308,6 +309,9 @@ OnReadyToBoot (
     } else {
       gBS->InstallConfigurationTable (&gEfiVariableGuid, gVariableInfo);
     }
+    if (gVariableAuthInfo != NULL) {
+      gBS->InstallConfigurationTable (&gEdkiiVariableAuthInfoGuid, gVariableAuthInfo);
+    }
   }
 
   gBS->CloseEvent (Event);
@@ -14,7 +14,7 @@
   VariableServiceSetVariable(), VariableServiceQueryVariableInfo(), ReclaimForOS(),
   SmmVariableGetStatistics() should also do validation based on its own knowledge.
 
-Copyright (c) 2010 - 2016, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2010 - 2017, Intel Corporation. All rights reserved.<BR>
 This program and the accompanying materials
 are licensed and made available under the terms and conditions of the BSD License
 which accompanies this distribution.  The full text of the license may be found at
@@ -38,6 +38,7 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include "Variable.h"
 
 extern VARIABLE_INFO_ENTRY                           *gVariableInfo;
+extern VARIABLE_AUTH_INFO_ENTRY                      *gVariableAuthInfo;
 EFI_HANDLE                                           mSmmVariableHandle      = NULL;
 EFI_HANDLE                                           mVariableHandle         = NULL;
 BOOLEAN                                              mAtRuntime              = FALSE;
@@ -432,6 +433,95 @@ SmmVariableGetStatistics (
 }
 
 
+/**
+  Get the authenticated write statistics of a variable from the list pointed by
+  gVariableAuthInfo.
+
+  Caution: This function may be invoked at SMM runtime.
+  InfoEntry and InfoSize are external input. Care must be taken to make sure not security issue at runtime.
+
+  @param[in, out]  InfoEntry    A pointer to the buffer of the statistics entry, followed
+                                by the variable name. On input, point to the entry returned
+                                last time. If InfoEntry->VendorGuid is zero, return the first
+                                entry. On output, point to the next entry.
+  @param[in, out]  InfoSize     On input, the size of the buffer.
+                                On output, the returned entry size.
+
+  @retval EFI_SUCCESS           The entry is found and returned successfully, or InfoSize is
+                                0 if there is no next entry.
+  @retval EFI_UNSUPPORTED       No authenticated write was tracked by the variable driver.
+  @retval EFI_BUFFER_TOO_SMALL  The buffer is too small to hold the next entry.
+  @retval EFI_INVALID_PARAMETER Input parameter is invalid.
+
+**/
+EFI_STATUS
+SmmVariableGetAuthStatistics (
+  IN OUT VARIABLE_AUTH_INFO_ENTRY                      *InfoEntry,
+  IN OUT UINTN                                         *InfoSize
+  )
+{
+  VARIABLE_AUTH_INFO_ENTRY                             *AuthInfo;
+  UINTN                                                NameSize;
+  UINTN                                                StatisticsInfoSize;
+  CHAR16                                               *InfoName;
+  UINTN                                                InfoNameMaxSize;
+  EFI_GUID                                             VendorGuid;
+
+  if (InfoEntry == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  AuthInfo = gVariableAuthInfo;
+  if (AuthInfo == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  StatisticsInfoSize = sizeof (VARIABLE_AUTH_INFO_ENTRY);
+  if (*InfoSize < StatisticsInfoSize) {
+    *InfoSize = StatisticsInfoSize;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+  InfoName = (CHAR16 *)(InfoEntry + 1);
+  InfoNameMaxSize = (*InfoSize - sizeof (VARIABLE_AUTH_INFO_ENTRY));
+
+  CopyGuid (&VendorGuid, &InfoEntry->VendorGuid);
+
+  if (!IsZeroGuid (&VendorGuid)) {
+    //
+    // Get the entry after the one returned last time
+    //
+    while (AuthInfo != NULL) {
+      if (CompareGuid (&AuthInfo->VendorGuid, &VendorGuid)) {
+        NameSize = StrSize (AuthInfo->Name);
+        if ((NameSize <= InfoNameMaxSize) && (CompareMem (AuthInfo->Name, InfoName, NameSize) == 0)) {
+          AuthInfo = AuthInfo->Next;
+          break;
+        }
+      }
+      AuthInfo = AuthInfo->Next;
+    }
+
+    if (AuthInfo == NULL) {
+      *InfoSize = 0;
+      return EFI_SUCCESS;
+    }
+  }
+
+  NameSize = StrSize (AuthInfo->Name);
+  StatisticsInfoSize = sizeof (VARIABLE_AUTH_INFO_ENTRY) + NameSize;
+  if (*InfoSize < StatisticsInfoSize) {
+    *InfoSize = StatisticsInfoSize;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  CopyMem (InfoEntry, AuthInfo, sizeof (VARIABLE_AUTH_INFO_ENTRY));
+  CopyMem (InfoName, AuthInfo->Name, NameSize);
+  *InfoSize = StatisticsInfoSize;
+
+  return EFI_SUCCESS;
+}
+
+
 /**
   Communication service SMI Handler entry.
 
@@ -713,6 +803,15 @@ SmmVariableHandler (
       *CommBufferSize = InfoSize + SMM_VARIABLE_COMMUNICATE_HEADER_SIZE;
       break;
 
+    case SMM_VARIABLE_FUNCTION_GET_AUTH_STATISTICS:
+      //
+      // The buffer is checked as for SMM_VARIABLE_FUNCTION_GET_STATISTICS.
+      //
+      InfoSize = TempCommBufferSize - SMM_VARIABLE_COMMUNICATE_HEADER_SIZE;
+      Status = SmmVariableGetAuthStatistics ((VARIABLE_AUTH_INFO_ENTRY *) SmmVariableFunctionHeader->Data, &InfoSize);
+      *CommBufferSize = InfoSize + SMM_VARIABLE_COMMUNICATE_HEADER_SIZE;
+      break;
+
     case SMM_VARIABLE_FUNCTION_LOCK_VARIABLE:
       if (mEndOfDxe) {
         Status = EFI_ACCESS_DENIED;
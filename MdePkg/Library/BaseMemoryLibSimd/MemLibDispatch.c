@@ -0,0 +1,345 @@
+/** @file
+  Selects the SSE2 or AVX2 implementation of the copy, fill and compare
+  functions, and the size above which copies and fills bypass the caches.
+
+  Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php.
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "MemLibInternals.h"
+
+//
+// CPUID leaves used to detect AVX2 and the cache sizes
+//
+#define MEM_CPUID_SIGNATURE                 0x00000000
+#define MEM_CPUID_VERSION_INFO              0x00000001
+#define MEM_CPUID_CACHE_PARAMS              0x00000004
+#define MEM_CPUID_EXTENDED_FEATURE_FLAGS    0x00000007
+#define MEM_CPUID_EXTENDED_FUNCTION         0x80000000
+#define MEM_CPUID_EXTENDED_CACHE_INFO       0x80000006
+
+//
+// CPUID.01H:ECX.OSXSAVE and CPUID.01H:ECX.AVX
+//
+#define MEM_CPUID_OSXSAVE_AVX               (BIT27 | BIT28)
+//
+// CPUID.07H.00H:EBX.AVX2
+//
+#define MEM_CPUID_AVX2                      BIT5
+//
+// XCR0.SSE and XCR0.AVX: the OS saves the XMM and YMM registers
+//
+#define MEM_XCR0_SSE_AVX                    (BIT1 | BIT2)
+
+//
+// Upper bound of the sub-leaves of CPUID leaf 4, in case a virtual processor
+// never reports a null cache type
+//
+#define MEM_CPUID_CACHE_PARAMS_MAX_INDEX    16
+
+UINTN  mMemLibSimdLevel = MEM_SIMD_LEVEL_UNKNOWN;
+UINTN  mMemLibNonTemporalThreshold;
+
+/**
+  Returns the size of the largest data or unified cache of the processor.
+
+  @return The size in bytes, or 0 if CPUID does not report the cache sizes.
+
+**/
+UINTN
+InternalMemGetLargestCacheSize (
+  VOID
+  )
+{
+  UINT32  MaxLeaf;
+  UINT32  Eax;
+  UINT32  Ebx;
+  UINT32  Ecx;
+  UINT32  Edx;
+  UINT32  Index;
+  UINTN   CacheSize;
+  UINTN   LargestCacheSize;
+
+  LargestCacheSize = 0;
+
+  AsmCpuid (MEM_CPUID_SIGNATURE, &MaxLeaf, NULL, NULL, NULL);
+  if (MaxLeaf >= MEM_CPUID_CACHE_PARAMS) {
+    for (Index = 0; Index < MEM_CPUID_CACHE_PARAMS_MAX_INDEX; Index++) {
+      AsmCpuidEx (MEM_CPUID_CACHE_PARAMS, Index, &Eax, &Ebx, &Ecx, NULL);
+      //
+      // Cache type: 0 - no more caches, 1 - data, 2 - instruction, 3 - unified
+      //
+      if ((Eax & 0x1F) == 0) {
+        break;
+      }
+      if ((Eax & 0x1F) == 2) {
+        continue;
+      }
+      //
+      // Ways * Partitions * Line Size * Sets
+      //
+      CacheSize = (UINTN) (((Ebx >> 22) & 0x3FF) + 1) *
+                  (((Ebx >> 12) & 0x3FF) + 1) *
+                  ((Ebx & 0xFFF) + 1) *
+                  ((UINTN) Ecx + 1);
+      LargestCacheSize = MAX (LargestCacheSize, CacheSize);
+    }
+  }
+
+  if (LargestCacheSize == 0) {
+    //
+    // Processors without leaf 4 report the L2 size in KB in ECX[31:16] and
+    // the L3 size in 512 KB units in EDX[31:18] of leaf 80000006H.
+    //
+    AsmCpuid (MEM_CPUID_EXTENDED_FUNCTION, &MaxLeaf, NULL, NULL, NULL);
+    if (MaxLeaf >= MEM_CPUID_EXTENDED_CACHE_INFO) {
+      AsmCpuid (MEM_CPUID_EXTENDED_CACHE_INFO, NULL, NULL, &Ecx, &Edx);
+      LargestCacheSize = MAX ((UINTN) (Ecx >> 16) * SIZE_1KB, (UINTN) (Edx >> 18) * SIZE_512KB);
+    }
+  }
+
+  return LargestCacheSize;
+}
+
+/**
+  Detects the instruction set and the non-temporal store threshold on the
+  first call, and returns the instruction set.
+
+  AVX2 is only selected if PcdMemoryLibAvx2Enable is TRUE, the processor
+  supports it and the YMM state has been enabled in XCR0.
+
+  @return MEM_SIMD_LEVEL_SSE2 or MEM_SIMD_LEVEL_AVX2.
+
+**/
+UINTN
+InternalMemGetSimdLevel (
+  VOID
+  )
+{
+  UINT32  MaxLeaf;
+  UINT32  Ebx;
+  UINT32  Ecx;
+  UINTN   SimdLevel;
+  UINTN   Threshold;
+
+  if (mMemLibSimdLevel != MEM_SIMD_LEVEL_UNKNOWN) {
+    return mMemLibSimdLevel;
+  }
+
+  //
+  // SSE2 is part of the X64 architecture.
+  //
+  SimdLevel = MEM_SIMD_LEVEL_SSE2;
+  if (FeaturePcdGet (PcdMemoryLibAvx2Enable)) {
+    AsmCpuid (MEM_CPUID_SIGNATURE, &MaxLeaf, NULL, NULL, NULL);
+    AsmCpuid (MEM_CPUID_VERSION_INFO, NULL, NULL, &Ecx, NULL);
+    if (MaxLeaf >= MEM_CPUID_EXTENDED_FEATURE_FLAGS &&
+        (Ecx & MEM_CPUID_OSXSAVE_AVX) == MEM_CPUID_OSXSAVE_AVX &&
+        (InternalMemXGetBv (0) & MEM_XCR0_SSE_AVX) == MEM_XCR0_SSE_AVX) {
+      AsmCpuidEx (MEM_CPUID_EXTENDED_FEATURE_FLAGS, 0, NULL, &Ebx, NULL, NULL);
+      if ((Ebx & MEM_CPUID_AVX2) != 0) {
+        SimdLevel = MEM_SIMD_LEVEL_AVX2;
+      }
+    }
+  }
+
+  //
+  // Copies larger than the last level cache would evict all of it, so they
+  // are written around the caches.
+  //
+  Threshold = PcdGet32 (PcdMemoryLibNonTemporalThreshold);
+  if (Threshold == 0) {
+    Threshold = InternalMemGetLargestCacheSize ();
+    if (Threshold == 0) {
+      Threshold = MAX_UINTN;
+    }
+  }
+
+  mMemLibNonTemporalThreshold = Threshold;
+  mMemLibSimdLevel            = SimdLevel;
+  return SimdLevel;
+}
+
+/**
+  Copy Length bytes from Source to Destination.
+
+  @param  DestinationBuffer The target of the copy request.
+  @param  SourceBuffer      The place to copy from.
+  @param  Length            The number of bytes to copy.
+
+  @return Destination
+
+**/
+VOID *
+EFIAPI
+InternalMemCopyMem (
+  OUT     VOID                      *DestinationBuffer,
+  IN      CONST VOID                *SourceBuffer,
+  IN      UINTN                     Length
+  )
+{
+  if (InternalMemGetSimdLevel () == MEM_SIMD_LEVEL_AVX2 && FeaturePcdGet (PcdMemoryLibAvx2Enable)) {
+    return InternalMemCopyMemAvx2 (DestinationBuffer, SourceBuffer, Length, mMemLibNonTemporalThreshold);
+  }
+  return InternalMemCopyMemSse2 (DestinationBuffer, SourceBuffer, Length, mMemLibNonTemporalThreshold);
+}
+
+/**
+  Fills Length bytes of Buffer with a repeated 64-bit pattern.
+
+  @param  Buffer   The memory to set.
+  @param  Length   The number of bytes to set.
+  @param  Pattern  The 64-bit pattern.
+
+  @return Buffer
+
+**/
+VOID *
+InternalMemFill (
+  OUT     VOID                      *Buffer,
+  IN      UINTN                     Length,
+  IN      UINT64                    Pattern
+  )
+{
+  if (InternalMemGetSimdLevel () == MEM_SIMD_LEVEL_AVX2 && FeaturePcdGet (PcdMemoryLibAvx2Enable)) {
+    return InternalMemFillAvx2 (Buffer, Length, Pattern, mMemLibNonTemporalThreshold);
+  }
+  return InternalMemFillSse2 (Buffer, Length, Pattern, mMemLibNonTemporalThreshold);
+}
+
+/**
+  Set Buffer to Value for Size bytes.
+
+  @param  Buffer   The memory to set.
+  @param  Length   The number of bytes to set.
+  @param  Value    The value of the set operation.
+
+  @return Buffer
+
+**/
+VOID *
+EFIAPI
+InternalMemSetMem (
+  OUT     VOID                      *Buffer,
+  IN      UINTN                     Length,
+  IN      UINT8                     Value
+  )
+{
+  return InternalMemFill (Buffer, Length, 0x0101010101010101ULL * Value);
+}
+
+/**
+  Fills a target buffer with a 16-bit value, and returns the target buffer.
+
+  @param  Buffer  The pointer to the target buffer to fill.
+  @param  Length  The count of 16-bit value to fill.
+  @param  Value   The value with which to fill Length bytes of Buffer.
+
+  @return Buffer
+
+**/
+VOID *
+EFIAPI
+InternalMemSetMem16 (
+  OUT     VOID                      *Buffer,
+  IN      UINTN                     Length,
+  IN      UINT16                    Value
+  )
+{
+  return InternalMemFill (Buffer, Length * sizeof (Value), 0x0001000100010001ULL * Value);
+}
+
+/**
+  Fills a target buffer with a 32-bit value, and returns the target buffer.
+
+  @param  Buffer  The pointer to the target buffer to fill.
+  @param  Length  The count of 32-bit value to fill.
+  @param  Value   The value with which to fill Length bytes of Buffer.
+
+  @return Buffer
+
+**/
+VOID *
+EFIAPI
+InternalMemSetMem32 (
+  OUT     VOID                      *Buffer,
+  IN      UINTN                     Length,
+  IN      UINT32                    Value
+  )
+{
+  return InternalMemFill (Buffer, Length * sizeof (Value), ((UINT64) Value << 32) | Value);
+}
+
+/**
+  Fills a target buffer with a 64-bit value, and returns the target buffer.
+
+  @param  Buffer  The pointer to the target buffer to fill.
+  @param  Length  The count of 64-bit value to fill.
+  @param  Value   The value with which to fill Length bytes of Buffer.
+
+  @return Buffer
+
+**/
+VOID *
+EFIAPI
+InternalMemSetMem64 (
+  OUT     VOID                      *Buffer,
+  IN      UINTN                     Length,
+  IN      UINT64                    Value
+  )
+{
+  return InternalMemFill (Buffer, Length * sizeof (Value), Value);
+}
+
+/**
+  Set Buffer to 0 for Size bytes.
+
+  @param  Buffer Memory to set.
+  @param  Length The number of bytes to set
+
+  @return Buffer
+
+**/
+VOID *
+EFIAPI
+InternalMemZeroMem (
+  OUT     VOID                      *Buffer,
+  IN      UINTN                     Length
+  )
+{
+  return InternalMemFill (Buffer, Length, 0);
+}
+
+/**
+  Compares two memory buffers of a given length.
+
+  @param  DestinationBuffer The first memory buffer.
+  @param  SourceBuffer      The second memory buffer.
+  @param  Length            The length of DestinationBuffer and SourceBuffer memory
+                            regions to compare. Must be non-zero.
+
+  @return 0                 All Length bytes of the two buffers are identical.
+  @retval Non-zero          The first mismatched byte in SourceBuffer subtracted from the first
+                            mismatched byte in DestinationBuffer.
+
+**/
+INTN
+EFIAPI
+InternalMemCompareMem (
+  IN      CONST VOID                *DestinationBuffer,
+  IN      CONST VOID                *SourceBuffer,
+  IN      UINTN                     Length
+  )
+{
+  if (InternalMemGetSimdLevel () == MEM_SIMD_LEVEL_AVX2 && FeaturePcdGet (PcdMemoryLibAvx2Enable)) {
+    return InternalMemCompareMemAvx2 (DestinationBuffer, SourceBuffer, Length);
+  }
+  return InternalMemCompareMemSse2 (DestinationBuffer, SourceBuffer, Length);
+}
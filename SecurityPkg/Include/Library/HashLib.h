@@ -3,7 +3,7 @@
   The platform can choose multiply hash, while caller just need invoke these API.
   Then all hash value will be returned and/or extended.
 
-Copyright (c) 2013 - 2016, Intel Corporation. All rights reserved. <BR>
+Copyright (c) 2013 - 2017, Intel Corporation. All rights reserved. <BR>
 This program and the accompanying materials
 are licensed and made available under the terms and conditions of the BSD License
 which accompanies this distribution.  The full text of the license may be found at
@@ -53,6 +53,25 @@ HashUpdate (
   IN UINTN          DataToHashLen
   );
 
+/**
+  Hash sequence complete without extending any PCR.
+
+  @param HashHandle    Hash handle.
+  @param DataToHash    Data to be hashed.
+  @param DataToHashLen Data size.
+  @param DigestList    Digest list.
+
+  @retval EFI_SUCCESS     Hash sequence complete and DigestList is returned.
+**/
+EFI_STATUS
+EFIAPI
+HashComplete (
+  IN HASH_HANDLE         HashHandle,
+  IN VOID                *DataToHash,
+  IN UINTN               DataToHashLen,
+  OUT TPML_DIGEST_VALUES *DigestList
+  );
+
 /**
   Hash sequence complete and extend to PCR.
 
@@ -58,6 +58,138 @@ EFI_SIGNATURE_ITEM mSupportSigItem[] = {
   {EFI_CERT_X509_SHA512_GUID,     0,               80           }
 };
 
+//
+// Parsed certificates of PK and KEK, reused by VerifyTimeBasedPayload().
+//
+AUTH_CERT_STORE mPkCertStore  = { NULL, NULL };
+AUTH_CERT_STORE mKekCertStore = { NULL, NULL };
+
+/**
+  Release the parsed certificates of a certificate store.
+
+  The certificates are only freed while they are still addressable. Once the
+  image has been relocated for OS runtime they are dropped instead.
+
+  @param[in, out] CertStore         Pointer to the certificate store.
+
+**/
+VOID
+FreeCertStore (
+  IN OUT AUTH_CERT_STORE    *CertStore
+  )
+{
+  if ((CertStore->VerifyContext != NULL) && (CertStore->Self == (VOID *) CertStore)) {
+    Pkcs7VerifyContextFree (CertStore->VerifyContext);
+  }
+  CertStore->VerifyContext = NULL;
+  CertStore->Self          = NULL;
+}
+
+/**
+  Get the PKCS#7 verification context of a certificate store, parsing the
+  X.509 certificates of the signature database when it is not cached yet.
+
+  @param[in, out] CertStore         Pointer to the certificate store.
+  @param[in]      Data              Pointer to the signature database (PK or KEK).
+  @param[in]      DataSize          Size of the signature database.
+  @param[in]      FirstCertOnly     TRUE to only trust the first certificate of
+                                    the database, as done for PK.
+
+  @return The PKCS#7 verification context, or NULL if it can not be built or
+          if any certificate can not be added to it. The caller then verifies
+          with Pkcs7Verify() directly.
+
+**/
+VOID *
+GetCertStoreContext (
+  IN OUT AUTH_CERT_STORE    *CertStore,
+  IN     VOID               *Data,
+  IN     UINTN              DataSize,
+  IN     BOOLEAN            FirstCertOnly
+  )
+{
+  EFI_SIGNATURE_LIST        *CertList;
+  EFI_SIGNATURE_DATA        *Cert;
+  UINTN                     CertCount;
+  UINTN                     Index;
+  UINTN                     AddedCount;
+
+  if (CertStore->VerifyContext != NULL) {
+    if (CertStore->Self == (VOID *) CertStore) {
+      return CertStore->VerifyContext;
+    }
+    FreeCertStore (CertStore);
+  }
+
+  CertStore->VerifyContext = Pkcs7VerifyContextNew ();
+  if (CertStore->VerifyContext == NULL) {
+    return NULL;
+  }
+  CertStore->Self = (VOID *) CertStore;
+
+  AddedCount = 0;
+  CertList   = (EFI_SIGNATURE_LIST *) Data;
+  while ((DataSize > 0) && (DataSize >= CertList->SignatureListSize)) {
+    if (FirstCertOnly || CompareGuid (&CertList->SignatureType, &gEfiCertX509Guid)) {
+      Cert      = (EFI_SIGNATURE_DATA *) ((UINT8 *) CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
+      CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
+      for (Index = 0; Index < CertCount; Index++) {
+        //
+        // Adding a certificate also fails when out of resources, so a store
+        // missing any certificate is never cached: a trusted certificate
+        // must not be left out of it until the variable is updated.
+        //
+        if (!Pkcs7VerifyContextAddCert (
+               CertStore->VerifyContext,
+               Cert->SignatureData,
+               CertList->SignatureSize - (sizeof (EFI_SIGNATURE_DATA) - 1)
+               )) {
+          DEBUG ((DEBUG_INFO, "AuthVariableLib: certificate %d can not be cached\n", AddedCount));
+          FreeCertStore (CertStore);
+          return NULL;
+        }
+        AddedCount++;
+        if (FirstCertOnly) {
+          break;
+        }
+        Cert = (EFI_SIGNATURE_DATA *) ((UINT8 *) Cert + CertList->SignatureSize);
+      }
+      if (FirstCertOnly) {
+        break;
+      }
+    }
+    DataSize -= CertList->SignatureListSize;
+    CertList = (EFI_SIGNATURE_LIST *) ((UINT8 *) CertList + CertList->SignatureListSize);
+  }
+
+  DEBUG ((DEBUG_INFO, "AuthVariableLib: %d certificate(s) cached\n", AddedCount));
+  return CertStore->VerifyContext;
+}
+
+/**
+  Drop the cached certificates of PK or KEK when the variable is updated.
+
+  @param[in] VariableName           Name of variable.
+  @param[in] VendorGuid             Guid of variable.
+
+**/
+VOID
+InvalidateCertStore (
+  IN CHAR16             *VariableName,
+  IN EFI_GUID           *VendorGuid
+  )
+{
+  if (!CompareGuid (VendorGuid, &gEfiGlobalVariableGuid)) {
+    return;
+  }
+
+  if (StrCmp (VariableName, EFI_PLATFORM_KEY_NAME) == 0) {
+    FreeCertStore (&mPkCertStore);
+  } else if (StrCmp (VariableName, EFI_KEY_EXCHANGE_KEY_NAME) == 0) {
+    FreeCertStore (&mKekCertStore);
+  }
+}
+
 /**
   Finds variable in storage blocks of volatile and non-volatile storage areas.
 
@@ -131,6 +263,7 @@ AuthServiceInternalUpdateVariable (
   AuthVariableInfo.DataSize = DataSize;
   AuthVariableInfo.Attributes = Attributes;
 
+  InvalidateCertStore (VariableName, VendorGuid);
   return mAuthVarLibContextIn->UpdateVariable (
            &AuthVariableInfo
            );
@@ -175,6 +308,7 @@ AuthServiceInternalUpdateVariableWithMonotonicCount (
   AuthVariableInfo.PubKeyIndex = KeyIndex;
   AuthVariableInfo.MonotonicCount = MonotonicCount;
 
+  InvalidateCertStore (VariableName, VendorGuid);
   return mAuthVarLibContextIn->UpdateVariable (
            &AuthVariableInfo
            );
@@ -246,6 +380,8 @@ AuthServiceInternalUpdateVariableWithTimeStamp (
   AuthVariableInfo.DataSize = DataSize;
   AuthVariableInfo.Attributes = Attributes;
   AuthVariableInfo.TimeStamp = TimeStamp;
+
+  InvalidateCertStore (VariableName, VendorGuid);
   return mAuthVarLibContextIn->UpdateVariable (
            &AuthVariableInfo
            );
@@ -2187,6 +2323,7 @@ VerifyTimeBasedPayload (
   UINTN                            CertStackSize;
   UINT8                            *CertsInCertDb;
   UINT32                           CertsSizeinDb;
+  VOID                             *VerifyContext;
 
   VerifyStatus           = FALSE;
   CertData               = NULL;
@@ -2355,16 +2492,29 @@ VerifyTimeBasedPayload (
     }
 
     //
-    // Verify Pkcs7 SignedData via Pkcs7Verify library.
+    // Verify Pkcs7 SignedData against the cached platform key, or via Pkcs7Verify
+    // library if the platform key can not be cached.
     //
-    VerifyStatus = Pkcs7Verify (
-                     SigData,
-                     SigDataSize,
-                     RootCert,
-                     RootCertSize,
-                     NewData,
-                     NewDataSize
-                     );
+    VerifyContext = GetCertStoreContext (&mPkCertStore, Data, DataSize, TRUE);
+    if (VerifyContext != NULL) {
+      VerifyStatus = Pkcs7VerifyWithContext (
+                       VerifyContext,
+                       SigData,
+                       SigDataSize,
+                       NewData,
+                       NewDataSize,
+                       NULL
+                       );
+    } else {
+      VerifyStatus = Pkcs7Verify (
+                       SigData,
+                       SigDataSize,
+                       RootCert,
+                       RootCertSize,
+                       NewData,
+                       NewDataSize
+                       );
+    }
 
   } else if (AuthVarType == AuthVarTypeKek) {
 
@@ -2381,6 +2531,22 @@ VerifyTimeBasedPayload (
       return Status;
     }
 
+    //
+    // Verify Pkcs7 SignedData against all cached X.509 certificates of KEK at once.
+    //
+    VerifyContext = GetCertStoreContext (&mKekCertStore, Data, DataSize, FALSE);
+    if (VerifyContext != NULL) {
+      VerifyStatus = Pkcs7VerifyWithContext (
+                       VerifyContext,
+                       SigData,
+                       SigDataSize,
+                       NewData,
+                       NewDataSize,
+                       NULL
+                       );
+      goto Exit;
+    }
+
     //
     // Ready to verify Pkcs7 SignedData. Go through KEK Signature Database to find out X.509 CertList.
     //
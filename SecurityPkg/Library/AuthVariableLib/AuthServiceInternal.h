@@ -122,6 +122,21 @@ typedef struct {
 } AUTH_CERT_DB_DATA;
 #pragma pack()
 
+///
+/// X.509 certificates of the PK or the KEK variable parsed into a PKCS#7
+/// verification context, kept across SetVariable() calls until the variable
+/// is updated.
+///
+typedef struct {
+  ///
+  /// Address of this structure when the context was built. The non-SMM
+  /// variable driver is relocated by SetVirtualAddressMap(), which leaves
+  /// the pointers inside the parsed certificates stale.
+  ///
+  VOID        *Self;
+  VOID        *VerifyContext;
+} AUTH_CERT_STORE;
+
 extern UINT8    *mPubKeyStore;
 extern UINT32   mPubKeyNumber;
 extern UINT32   mMaxKeyNumber;
@@ -133,6 +148,9 @@ extern UINT8    mVendorKeyState;
 
 extern VOID     *mHashCtx;
 
+extern AUTH_CERT_STORE  mPkCertStore;
+extern AUTH_CERT_STORE  mKekCertStore;
+
 extern AUTH_VAR_LIB_CONTEXT_IN *mAuthVarLibContextIn;
 
 
@@ -42,6 +42,23 @@ UINT8                               *mImageBase       = NULL;
 UINT8                               mImageDigest[MAX_DIGEST_SIZE];
 UINTN                               mImageDigestSize;
 
+//
+// Authenticode digests of the current image. The image is hashed once, with
+// every algorithm of mImageHashAlgMask at the same time, and the digests are
+// reused for the cache key and by the signatures and db/dbx checks.
+//
+UINT8                               mImageDigestCache[HASHALG_MAX][MAX_DIGEST_SIZE];
+BOOLEAN                             mImageDigestCacheValid[HASHALG_MAX];
+UINT32                              mImageHashAlgMask = 0;
+
+//
+// Set when a resource failure, like an allocation failure or a security
+// database that cannot be read, affected the verification of the current image.
+// The verdict then does not only depend on the image and the security databases
+// and it is not cached.
+//
+BOOLEAN                             mVerificationIncomplete = FALSE;
+
 //
 // Notify string for authorization UI.
 //
@@ -72,6 +89,20 @@ HASH_TABLE mHash[] = {
   { L"SHA512", 64, &mHashOidValue[32], 9, Sha512GetContextSize, Sha512Init, Sha512Update, Sha512Final}
 };
 
+//
+// Signature types of the X.509 certificate hashes in dbx and their hash algorithm
+//
+typedef struct {
+  EFI_GUID    *SignatureType;
+  UINT32      HashAlg;
+} CERT_HASH_TYPE;
+
+CERT_HASH_TYPE mCertHashType[] = {
+  { &gEfiCertX509Sha256Guid, HASHALG_SHA256 },
+  { &gEfiCertX509Sha384Guid, HASHALG_SHA384 },
+  { &gEfiCertX509Sha512Guid, HASHALG_SHA512 }
+};
+
 EFI_STRING mHashTypeStr;
 
 /**
@@ -272,9 +303,42 @@ GetImageType (
   return IMAGE_UNKNOWN;
 }
 
+/**
+  Add data to the hash contexts of all the algorithms an image is hashed with.
+
+  @param[in]  HashCtx   Hash contexts indexed by hash algorithm, NULL for the
+                        algorithms which are not used.
+  @param[in]  HashBase  The data to hash.
+  @param[in]  HashSize  Size of the data in bytes.
+
+  @retval TRUE          The data is added to all the contexts.
+  @retval FALSE         Fail to hash the data.
+
+**/
+BOOLEAN
+UpdatePeImageHash (
+  IN VOID                 **HashCtx,
+  IN UINT8                *HashBase,
+  IN UINTN                HashSize
+  )
+{
+  UINT32                    HashAlg;
+
+  for (HashAlg = 0; HashAlg < HASHALG_MAX; HashAlg++) {
+    if ((HashCtx[HashAlg] != NULL) && !mHash[HashAlg].HashUpdate (HashCtx[HashAlg], HashBase, HashSize)) {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
 /**
   Calculate hash of Pe/Coff image based on the authenticode image hashing in
   PE/COFF Specification 8.0 Appendix A
+
+  The digests are kept for the current image. The image is only hashed when the
+  digest of HashAlg is not known yet, and then also with all the algorithms of
+  mImageHashAlgMask whose digest is not known yet.
   
   Caution: This function may receive untrusted input.
   PE/COFF image is external input, so this function will validate its data structure
@@ -297,8 +361,8 @@ HashPeImage (
   BOOLEAN                   Status;
   UINT16                    Magic;
   EFI_IMAGE_SECTION_HEADER  *Section;
-  VOID                      *HashCtx;
-  UINTN                     CtxSize;
+  VOID                      *HashCtx[HASHALG_MAX];
+  UINT32                    Alg;
   UINT8                     *HashBase;
   UINTN                     HashSize;
   UINTN                     SumOfBytesHashed;
@@ -308,7 +372,7 @@ HashPeImage (
   UINT32                    CertSize;
   UINT32                    NumberOfRvaAndSizes;
 
-  HashCtx       = NULL;
+  ZeroMem (HashCtx, sizeof (HashCtx));
   SectionHeader = NULL;
   Status        = FALSE;
 
@@ -347,20 +411,29 @@ HashPeImage (
   }
 
   mHashTypeStr = mHash[HashAlg].Name;
-  CtxSize   = mHash[HashAlg].GetContextSize();
 
-  HashCtx = AllocatePool (CtxSize);
-  if (HashCtx == NULL) {
-    return FALSE;
+  if (mImageDigestCacheValid[HashAlg]) {
+    CopyMem (mImageDigest, mImageDigestCache[HashAlg], mImageDigestSize);
+    return TRUE;
   }
 
   // 1.  Load the image header into memory.
 
   // 2.  Initialize a SHA hash context.
-  Status = mHash[HashAlg].HashInit(HashCtx);
-
-  if (!Status) {
-    goto Done;
+  for (Alg = 0; Alg < HASHALG_MAX; Alg++) {
+    if (((Alg != HashAlg) && ((mImageHashAlgMask & (1 << Alg)) == 0)) ||
+        mImageDigestCacheValid[Alg] || (mHash[Alg].GetContextSize == NULL)) {
+      continue;
+    }
+    HashCtx[Alg] = AllocatePool (mHash[Alg].GetContextSize ());
+    if (HashCtx[Alg] == NULL) {
+      mVerificationIncomplete = TRUE;
+      goto Done;
+    }
+    Status = mHash[Alg].HashInit (HashCtx[Alg]);
+    if (!Status) {
+      goto Done;
+    }
   }
 
   //
@@ -407,7 +480,7 @@ HashPeImage (
     goto Done;
   }
 
-  Status  = mHash[HashAlg].HashUpdate(HashCtx, HashBase, HashSize);
+  Status  = UpdatePeImageHash (HashCtx, HashBase, HashSize);
   if (!Status) {
     goto Done;
   }
@@ -435,7 +508,7 @@ HashPeImage (
     }
 
     if (HashSize != 0) {
-      Status  = mHash[HashAlg].HashUpdate(HashCtx, HashBase, HashSize);
+      Status  = UpdatePeImageHash (HashCtx, HashBase, HashSize);
       if (!Status) {
         goto Done;
       }
@@ -459,7 +532,7 @@ HashPeImage (
     }
 
     if (HashSize != 0) {
-      Status  = mHash[HashAlg].HashUpdate(HashCtx, HashBase, HashSize);
+      Status  = UpdatePeImageHash (HashCtx, HashBase, HashSize);
       if (!Status) {
         goto Done;
       }
@@ -484,7 +557,7 @@ HashPeImage (
     }
 
     if (HashSize != 0) {
-      Status  = mHash[HashAlg].HashUpdate(HashCtx, HashBase, HashSize);
+      Status  = UpdatePeImageHash (HashCtx, HashBase, HashSize);
       if (!Status) {
         goto Done;
       }
@@ -523,6 +596,7 @@ HashPeImage (
   //
   SectionHeader = (EFI_IMAGE_SECTION_HEADER *) AllocateZeroPool (sizeof (EFI_IMAGE_SECTION_HEADER) * mNtHeader.Pe32->FileHeader.NumberOfSections);
   if (SectionHeader == NULL) {
+    mVerificationIncomplete = TRUE;
     Status = FALSE;
     goto Done;
   }
@@ -557,7 +631,7 @@ HashPeImage (
     HashBase  = mImageBase + Section->PointerToRawData;
     HashSize  = (UINTN) Section->SizeOfRawData;
 
-    Status  = mHash[HashAlg].HashUpdate(HashCtx, HashBase, HashSize);
+    Status  = UpdatePeImageHash (HashCtx, HashBase, HashSize);
     if (!Status) {
       goto Done;
     }
@@ -593,7 +667,7 @@ HashPeImage (
     if (mImageSize > CertSize + SumOfBytesHashed) {
       HashSize = (UINTN) (mImageSize - CertSize - SumOfBytesHashed);
 
-      Status  = mHash[HashAlg].HashUpdate(HashCtx, HashBase, HashSize);
+      Status  = UpdatePeImageHash (HashCtx, HashBase, HashSize);
       if (!Status) {
         goto Done;
       }
@@ -603,11 +677,22 @@ HashPeImage (
     }
   }
 
-  Status  = mHash[HashAlg].HashFinal(HashCtx, mImageDigest);
+  for (Alg = 0; Alg < HASHALG_MAX; Alg++) {
+    if (HashCtx[Alg] != NULL) {
+      Status = mHash[Alg].HashFinal (HashCtx[Alg], mImageDigestCache[Alg]);
+      if (!Status) {
+        goto Done;
+      }
+      mImageDigestCacheValid[Alg] = TRUE;
+    }
+  }
+  CopyMem (mImageDigest, mImageDigestCache[HashAlg], mImageDigestSize);
 
 Done:
-  if (HashCtx != NULL) {
-    FreePool (HashCtx);
+  for (Alg = 0; Alg < HASHALG_MAX; Alg++) {
+    if (HashCtx[Alg] != NULL) {
+      FreePool (HashCtx[Alg]);
+    }
   }
   if (SectionHeader != NULL) {
     FreePool (SectionHeader);
@@ -616,9 +701,7 @@ Done:
 }
 
 /**
-  Recognize the Hash algorithm in PE/COFF Authenticode and calculate hash of
-  Pe/Coff image based on the authenticode image hashing in PE/COFF Specification
-  8.0 Appendix A
+  Recognize the Hash algorithm in PE/COFF Authenticode.
 
   Caution: This function may receive untrusted input.
   PE/COFF image is external input, so this function will validate its data structure
@@ -627,17 +710,16 @@ Done:
   @param[in]  AuthData            Pointer to the Authenticode Signature retrieved from signed image.
   @param[in]  AuthDataSize        Size of the Authenticode Signature in bytes.
 
-  @retval EFI_UNSUPPORTED             Hash algorithm is not supported.
-  @retval EFI_SUCCESS                 Hash successfully.
+  @return The hash algorithm, or HASHALG_MAX if it is not supported.
 
 **/
-EFI_STATUS
-HashPeImageByType (
+UINT32
+GetAuthenticodeHashAlg (
   IN UINT8              *AuthData,
   IN UINTN              AuthDataSize
   )
 {
-  UINT8                     Index;
+  UINT32                    Index;
 
   for (Index = 0; Index < HASHALG_MAX; Index++) {
     //
@@ -660,7 +742,7 @@ HashPeImageByType (
     }
 
     if (AuthDataSize < 32 + mHash[Index].OidLength) {
-      return EFI_UNSUPPORTED;
+      return HASHALG_MAX;
     }
 
     if (CompareMem (AuthData + 32, mHash[Index].OidValue, mHash[Index].OidLength) == 0) {
@@ -668,6 +750,34 @@ HashPeImageByType (
     }
   }
 
+  return Index;
+}
+
+/**
+  Recognize the Hash algorithm in PE/COFF Authenticode and calculate hash of
+  Pe/Coff image based on the authenticode image hashing in PE/COFF Specification
+  8.0 Appendix A
+
+  Caution: This function may receive untrusted input.
+  PE/COFF image is external input, so this function will validate its data structure
+  within this image buffer before use.
+
+  @param[in]  AuthData            Pointer to the Authenticode Signature retrieved from signed image.
+  @param[in]  AuthDataSize        Size of the Authenticode Signature in bytes.
+
+  @retval EFI_UNSUPPORTED             Hash algorithm is not supported.
+  @retval EFI_SUCCESS                 Hash successfully.
+
+**/
+EFI_STATUS
+HashPeImageByType (
+  IN UINT8              *AuthData,
+  IN UINTN              AuthDataSize
+  )
+{
+  UINT32                    Index;
+
+  Index = GetAuthenticodeHashAlg (AuthData, AuthDataSize);
   if (Index == HASHALG_MAX) {
     return EFI_UNSUPPORTED;
   }
@@ -839,11 +949,12 @@ AddImageExeInfo (
 
   @param[in]  Certificate       Pointer to X.509 Certificate that is searched for.
   @param[in]  CertSize          Size of X.509 Certificate.
-  @param[in]  SignatureList     Pointer to the Signature List in forbidden database.
-  @param[in]  SignatureListSize Size of Signature List.
+  @param[in]  Database          The forbidden database.
   @param[out] RevocationTime    Return the time that the certificate was revoked.
 
-  @return TRUE   The certificate hash is found in the forbidden database.
+  @return TRUE   The certificate hash is found in the forbidden database, or the
+                 certificate cannot be hashed. The revocation time is zero in
+                 the latter case.
   @return FALSE  The certificate hash is not found in the forbidden database.
 
 **/
@@ -851,33 +962,24 @@ BOOLEAN
 IsCertHashFoundInDatabase (
   IN  UINT8               *Certificate,
   IN  UINTN               CertSize,
-  IN  EFI_SIGNATURE_LIST  *SignatureList,
-  IN  UINTN               SignatureListSize,
+  IN  SECURITY_DATABASE   *Database,
   OUT EFI_TIME            *RevocationTime
   )
 {
   BOOLEAN             IsFound;
   BOOLEAN             Status;
-  EFI_SIGNATURE_LIST  *DbxList;
-  UINTN               DbxSize;
   EFI_SIGNATURE_DATA  *CertHash;
-  UINTN               CertHashCount;
   UINTN               Index;
   UINT32              HashAlg;
   VOID                *HashCtx;
   UINT8               CertDigest[MAX_DIGEST_SIZE];
-  UINT8               *DbxCertHash;
-  UINTN               SiglistHeaderSize;
   UINT8               *TBSCert;
   UINTN               TBSCertSize;
 
   IsFound  = FALSE;
-  DbxList  = SignatureList;
-  DbxSize  = SignatureListSize;
   HashCtx  = NULL;
-  HashAlg  = HASHALG_MAX;
 
-  if ((RevocationTime == NULL) || (DbxList == NULL)) {
+  if ((RevocationTime == NULL) || (Database == NULL)) {
     return FALSE;
   }
 
@@ -888,31 +990,29 @@ IsCertHashFoundInDatabase (
     return FALSE;
   }
 
-  while ((DbxSize > 0) && (SignatureListSize >= DbxList->SignatureListSize)) {
+  for (Index = 0; Index < ARRAY_SIZE (mCertHashType); Index++) {
     //
-    // Determine Hash Algorithm of Certificate in the forbidden database.
+    // Only hash the certificate with the algorithms used in the forbidden database.
     //
-    if (CompareGuid (&DbxList->SignatureType, &gEfiCertX509Sha256Guid)) {
-      HashAlg = HASHALG_SHA256;
-    } else if (CompareGuid (&DbxList->SignatureType, &gEfiCertX509Sha384Guid)) {
-      HashAlg = HASHALG_SHA384;
-    } else if (CompareGuid (&DbxList->SignatureType, &gEfiCertX509Sha512Guid)) {
-      HashAlg = HASHALG_SHA512;
-    } else {
-      DbxSize -= DbxList->SignatureListSize;
-      DbxList  = (EFI_SIGNATURE_LIST *) ((UINT8 *) DbxList + DbxList->SignatureListSize);
+    if (!IsSignatureTypeInIndex (Database, mCertHashType[Index].SignatureType)) {
       continue;
     }
+    HashAlg = mCertHashType[Index].HashAlg;
 
     //
-    // Calculate the hash value of current TBSCertificate for comparision.
+    // Calculate the hash value of current TBSCertificate for comparision. Until
+    // it is done, the certificate is handled as revoked at any time, so that a
+    // failure to hash it does not let a revoked certificate through.
     //
+    IsFound = TRUE;
+    ZeroMem (RevocationTime, sizeof (EFI_TIME));
     if (mHash[HashAlg].GetContextSize == NULL) {
       goto Done;
     }
     ZeroMem (CertDigest, MAX_DIGEST_SIZE);
     HashCtx = AllocatePool (mHash[HashAlg].GetContextSize ());
     if (HashCtx == NULL) {
+      mVerificationIncomplete = TRUE;
       goto Done;
     }
     Status = mHash[HashAlg].HashInit (HashCtx);
@@ -927,32 +1027,29 @@ IsCertHashFoundInDatabase (
     if (!Status) {
       goto Done;
     }
-
-    SiglistHeaderSize = sizeof (EFI_SIGNATURE_LIST) + DbxList->SignatureHeaderSize;
-    CertHash          = (EFI_SIGNATURE_DATA *) ((UINT8 *) DbxList + SiglistHeaderSize);
-    CertHashCount     = (DbxList->SignatureListSize - SiglistHeaderSize) / DbxList->SignatureSize;
-    for (Index = 0; Index < CertHashCount; Index++) {
+    FreePool (HashCtx);
+    HashCtx = NULL;
+    IsFound = FALSE;
+
+    CertHash = FindSignatureInIndex (
+                 Database,
+                 mCertHashType[Index].SignatureType,
+                 CertDigest,
+                 mHash[HashAlg].DigestLength,
+                 NULL
+                 );
+    if (CertHash != NULL) {
       //
-      // Iterate each Signature Data Node within this CertList for verify.
+      // Hash of Certificate is found in forbidden database.
       //
-      DbxCertHash = CertHash->SignatureData;
-      if (CompareMem (DbxCertHash, CertDigest, mHash[HashAlg].DigestLength) == 0) {
-        //
-        // Hash of Certificate is found in forbidden database.
-        //
-        IsFound = TRUE;
+      IsFound = TRUE;
 
-        //
-        // Return the revocation time.
-        //
-        CopyMem (RevocationTime, (EFI_TIME *)(DbxCertHash + mHash[HashAlg].DigestLength), sizeof (EFI_TIME));
-        goto Done;
-      }
-      CertHash = (EFI_SIGNATURE_DATA *) ((UINT8 *) CertHash + DbxList->SignatureSize);
+      //
+      // Return the revocation time.
+      //
+      CopyMem (RevocationTime, (EFI_TIME *)(CertHash->SignatureData + mHash[HashAlg].DigestLength), sizeof (EFI_TIME));
+      goto Done;
     }
-
-    DbxSize -= DbxList->SignatureListSize;
-    DbxList  = (EFI_SIGNATURE_LIST *) ((UINT8 *) DbxList + DbxList->SignatureListSize);
   }
 
 Done:
@@ -971,7 +1068,8 @@ Done:
   @param[in]  CertType            Pointer to hash algrithom.
   @param[in]  SignatureSize       Size of Signature.
 
-  @return TRUE                    Found the signature in the variable database.
+  @return TRUE                    Found the signature in the variable database, or
+                                  the database is dbx and it cannot be read.
   @return FALSE                   Not found the signature in the variable database.
 
 **/
@@ -983,76 +1081,31 @@ IsSignatureFoundInDatabase (
   IN UINTN              SignatureSize
   )
 {
-  EFI_STATUS          Status;
+  SECURITY_DATABASE   *Database;
   EFI_SIGNATURE_LIST  *CertList;
   EFI_SIGNATURE_DATA  *Cert;
-  UINTN               DataSize;
-  UINT8               *Data;
-  UINTN               Index;
-  UINTN               CertCount;
-  BOOLEAN             IsFound;
 
-  //
-  // Read signature database variable.
-  //
-  IsFound   = FALSE;
-  Data      = NULL;
-  DataSize  = 0;
-  Status    = gRT->GetVariable (VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, NULL);
-  if (Status != EFI_BUFFER_TOO_SMALL) {
-    return FALSE;
+  Database = GetSecurityDatabase (VariableName);
+  if (Database == NULL) {
+    //
+    // An image cannot be cleared against a dbx which cannot be read.
+    //
+    return (BOOLEAN) (StrCmp (VariableName, EFI_IMAGE_SECURITY_DATABASE1) == 0);
   }
 
-  Data = (UINT8 *) AllocateZeroPool (DataSize);
-  if (Data == NULL) {
+  Cert = FindSignatureInIndex (Database, CertType, Signature, SignatureSize, &CertList);
+  if (Cert == NULL) {
     return FALSE;
   }
 
-  Status = gRT->GetVariable (VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, Data);
-  if (EFI_ERROR (Status)) {
-    goto Done;
-  }
   //
-  // Enumerate all signature data in SigDB to check if executable's signature exists.
+  // Entries in UEFI_IMAGE_SECURITY_DATABASE that are used to validate image should be measured
   //
-  CertList = (EFI_SIGNATURE_LIST *) Data;
-  while ((DataSize > 0) && (DataSize >= CertList->SignatureListSize)) {
-    CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
-    Cert      = (EFI_SIGNATURE_DATA *) ((UINT8 *) CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
-    if ((CertList->SignatureSize == sizeof(EFI_SIGNATURE_DATA) - 1 + SignatureSize) && (CompareGuid(&CertList->SignatureType, CertType))) {
-      for (Index = 0; Index < CertCount; Index++) {
-        if (CompareMem (Cert->SignatureData, Signature, SignatureSize) == 0) {
-          //
-          // Find the signature in database.
-          //
-          IsFound = TRUE;
-          //
-          // Entries in UEFI_IMAGE_SECURITY_DATABASE that are used to validate image should be measured
-          //
-          if (StrCmp(VariableName, EFI_IMAGE_SECURITY_DATABASE) == 0) {
-            SecureBootHook (VariableName, &gEfiImageSecurityDatabaseGuid, CertList->SignatureSize, Cert);
-          }
-          break;
-        }
-
-        Cert = (EFI_SIGNATURE_DATA *) ((UINT8 *) Cert + CertList->SignatureSize);
-      }
-
-      if (IsFound) {
-        break;
-      }
-    }
-
-    DataSize -= CertList->SignatureListSize;
-    CertList = (EFI_SIGNATURE_LIST *) ((UINT8 *) CertList + CertList->SignatureListSize);
-  }
-
-Done:
-  if (Data != NULL) {
-    FreePool (Data);
+  if (StrCmp(VariableName, EFI_IMAGE_SECURITY_DATABASE) == 0) {
+    SecureBootHook (VariableName, &gEfiImageSecurityDatabaseGuid, CertList->SignatureSize, Cert);
   }
 
-  return IsFound;
+  return TRUE;
 }
 
 /**
@@ -1165,14 +1218,19 @@ PassTimestampCheck (
   DbtDataSize = 0;
   Status   = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE2, &gEfiImageSecurityDatabaseGuid, NULL, &DbtDataSize, NULL);
   if (Status != EFI_BUFFER_TOO_SMALL) {
+    if (Status != EFI_NOT_FOUND) {
+      mVerificationIncomplete = TRUE;
+    }
     goto Done;
   }
   DbtData = (UINT8 *) AllocateZeroPool (DbtDataSize);
   if (DbtData == NULL) {
+    mVerificationIncomplete = TRUE;
     goto Done;
   }
   Status = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE2, &gEfiImageSecurityDatabaseGuid, NULL, &DbtDataSize, (VOID *) DbtData);
   if (EFI_ERROR (Status)) {
+    mVerificationIncomplete = TRUE;
     goto Done;
   }
 
@@ -1231,16 +1289,7 @@ IsForbiddenByDbx (
   IN UINTN                  AuthDataSize  
   )
 {
-  EFI_STATUS                Status;
   BOOLEAN                   IsForbidden;
-  UINT8                     *Data;
-  UINTN                     DataSize;
-  EFI_SIGNATURE_LIST        *CertList;
-  UINTN                     CertListSize;
-  EFI_SIGNATURE_DATA        *CertData;
-  UINT8                     *RootCert;
-  UINTN                     RootCertSize;
-  UINTN                     CertCount;
   UINTN                     Index;
   UINT8                     *CertBuffer;
   UINTN                     BufferLength;
@@ -1251,15 +1300,12 @@ IsForbiddenByDbx (
   UINT8                     *Cert;
   UINTN                     CertSize;
   EFI_TIME                  RevocationTime;
+  SECURITY_DATABASE         *Database;
+  SIGNATURE_INDEX_ENTRY     *Entry;
   //
   // Variable Initialization
   //
   IsForbidden       = FALSE;
-  Data              = NULL;
-  CertList          = NULL;
-  CertData          = NULL;
-  RootCert          = NULL;
-  RootCertSize      = 0;
   Cert              = NULL;
   CertBuffer        = NULL;
   BufferLength      = 0;
@@ -1267,63 +1313,59 @@ IsForbiddenByDbx (
   TrustedCertLength = 0;
 
   //
-  // The image will not be forbidden if dbx can't be got.
+  // The image is not forbidden if there is no dbx, but it is if dbx exists
+  // and cannot be read.
   //
-  DataSize = 0;
-  Status   = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, NULL);
-  if (Status != EFI_BUFFER_TOO_SMALL) {
-    return IsForbidden;
-  }
-  Data = (UINT8 *) AllocateZeroPool (DataSize);
-  if (Data == NULL) {
-    return IsForbidden;
+  Database = GetSecurityDatabase (EFI_IMAGE_SECURITY_DATABASE1);
+  if (Database == NULL) {
+    DEBUG ((DEBUG_INFO, "DxeImageVerificationLib: Image is signed but DBX cannot be read.\n"));
+    return TRUE;
   }
-
-  Status = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, (VOID *) Data);
-  if (EFI_ERROR (Status)) {
+  if (Database->Size == 0) {
     return IsForbidden;
   }
 
   //
   // Verify image signature with RAW X509 certificates in DBX database.
-  // If passed, the image will be forbidden.
+  // If passed, the image will be forbidden. The certificates are parsed once
+  // for all the images verified with the current dbx.
   //
-  CertList     = (EFI_SIGNATURE_LIST *) Data;
-  CertListSize = DataSize;
-  while ((CertListSize > 0) && (CertListSize >= CertList->SignatureListSize)) {
-    if (CompareGuid (&CertList->SignatureType, &gEfiCertX509Guid)) {
-      CertData  = (EFI_SIGNATURE_DATA *) ((UINT8 *) CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
-      CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
-
-      for (Index = 0; Index < CertCount; Index++) {
-        //
-        // Iterate each Signature Data Node within this CertList for verify.
-        //
-        RootCert     = CertData->SignatureData;
-        RootCertSize = CertList->SignatureSize - sizeof (EFI_GUID);
-
-        //
-        // Call AuthenticodeVerify library to Verify Authenticode struct.
-        //
-        IsForbidden = AuthenticodeVerify (
-                        AuthData,
-                        AuthDataSize,
-                        RootCert,
-                        RootCertSize,
-                        mImageDigest,
-                        mImageDigestSize
-                        );
-        if (IsForbidden) {
-          DEBUG ((DEBUG_INFO, "DxeImageVerificationLib: Image is signed but signature is forbidden by DBX.\n"));
-          goto Done;
-        }
-
-        CertData = (EFI_SIGNATURE_DATA *) ((UINT8 *) CertData + CertList->SignatureSize);
-      }
-    }
+  if ((Database->VerifyContext == NULL) && EFI_ERROR (BuildCertVerifyContext (Database))) {
+    mVerificationIncomplete = TRUE;
+    IsForbidden = TRUE;
+    goto Done;
+  }
+  if (Database->CertCount != 0) {
+    IsForbidden = AuthenticodeVerifyWithContext (
+                    Database->VerifyContext,
+                    AuthData,
+                    AuthDataSize,
+                    mImageDigest,
+                    mImageDigestSize,
+                    NULL
+                    );
+  }
 
-    CertListSize -= CertList->SignatureListSize;
-    CertList      = (EFI_SIGNATURE_LIST *) ((UINT8 *) CertList + CertList->SignatureListSize);
+  //
+  // The certificates which could not be added to the verification context are
+  // verified one by one, as an allocation failure leaves a certificate out of
+  // the context too.
+  //
+  for (Index = 0; !IsForbidden && (Index < Database->SkippedCertCount); Index++) {
+    mVerificationIncomplete = TRUE;
+    Entry       = &Database->Certs[Database->CertCount + Index];
+    IsForbidden = AuthenticodeVerify (
+                    AuthData,
+                    AuthDataSize,
+                    Entry->Signature->SignatureData,
+                    Entry->KeySize,
+                    mImageDigest,
+                    mImageDigestSize
+                    );
+  }
+  if (IsForbidden) {
+    DEBUG ((DEBUG_INFO, "DxeImageVerificationLib: Image is signed but signature is forbidden by DBX.\n"));
+    goto Done;
   }
 
   //
@@ -1344,6 +1386,10 @@ IsForbiddenByDbx (
   //
   Pkcs7GetSigners (AuthData, AuthDataSize, &CertBuffer, &BufferLength, &TrustedCert, &TrustedCertLength);
   if ((BufferLength == 0) || (CertBuffer == NULL)) {
+    //
+    // This is also the result of an allocation failure.
+    //
+    mVerificationIncomplete = TRUE;
     IsForbidden = TRUE;
     goto Done;
   }
@@ -1361,7 +1407,7 @@ IsForbiddenByDbx (
     //
     CertPtr = CertPtr + sizeof (UINT32) + CertSize;
 
-    if (IsCertHashFoundInDatabase (Cert, CertSize, (EFI_SIGNATURE_LIST *)Data, DataSize, &RevocationTime)) {
+    if (IsCertHashFoundInDatabase (Cert, CertSize, Database, &RevocationTime)) {
       //
       // Check the timestamp signature and signing time to determine if the image can be trusted.
       //
@@ -1380,10 +1426,6 @@ IsForbiddenByDbx (
   }
 
 Done:
-  if (Data != NULL) {
-    FreePool (Data);
-  }
-
   Pkcs7FreeSigners (CertBuffer);
   Pkcs7FreeSigners (TrustedCert);
 
@@ -1407,105 +1449,76 @@ IsAllowedByDb (
   IN UINTN              AuthDataSize
   )
 {
-  EFI_STATUS                Status;
   BOOLEAN                   VerifyStatus;
   EFI_SIGNATURE_LIST        *CertList;
   EFI_SIGNATURE_DATA        *CertData;
-  UINTN                     DataSize;
-  UINT8                     *Data;
   UINT8                     *RootCert;
   UINTN                     RootCertSize;
-  UINTN                     Index;
-  UINTN                     CertCount;
-  UINTN                     DbxDataSize;
-  UINT8                     *DbxData;
+  UINTN                     CertIndex;
+  SECURITY_DATABASE         *Database;
+  SECURITY_DATABASE         *DbxDatabase;
   EFI_TIME                  RevocationTime;
 
-  Data              = NULL;
   CertList          = NULL;
   CertData          = NULL;
   RootCert          = NULL;
-  DbxData           = NULL;
   RootCertSize      = 0;
   VerifyStatus      = FALSE;
 
-  DataSize = 0;
-  Status   = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, NULL);
-  if (Status == EFI_BUFFER_TOO_SMALL) {
-    Data = (UINT8 *) AllocateZeroPool (DataSize);
-    if (Data == NULL) {
-      return VerifyStatus;
+  Database = GetSecurityDatabase (EFI_IMAGE_SECURITY_DATABASE);
+  if ((Database != NULL) && (Database->Size != 0)) {
+    //
+    // Verify the signature in pkcs7 signed data with the X509 certificates in
+    // Signature List, parsed once for all the images verified with the current db.
+    // The first certificate which verifies the signature is returned.
+    //
+    if ((Database->VerifyContext == NULL) && EFI_ERROR (BuildCertVerifyContext (Database))) {
+      mVerificationIncomplete = TRUE;
+      goto Done;
     }
-
-    Status = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, (VOID *) Data);
-    if (EFI_ERROR (Status)) {
+    if (Database->SkippedCertCount != 0) {
+      //
+      // A certificate of db may have been left out by an allocation failure.
+      //
+      mVerificationIncomplete = TRUE;
+    }
+    if (Database->CertCount == 0) {
       goto Done;
     }
 
-    //
-    // Find X509 certificate in Signature List to verify the signature in pkcs7 signed data.
-    //
-    CertList = (EFI_SIGNATURE_LIST *) Data;
-    while ((DataSize > 0) && (DataSize >= CertList->SignatureListSize)) {
-      if (CompareGuid (&CertList->SignatureType, &gEfiCertX509Guid)) {
-        CertData  = (EFI_SIGNATURE_DATA *) ((UINT8 *) CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
-        CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
-
-        for (Index = 0; Index < CertCount; Index++) {
-          //
-          // Iterate each Signature Data Node within this CertList for verify.
-          //
-          RootCert     = CertData->SignatureData;
-          RootCertSize = CertList->SignatureSize - sizeof (EFI_GUID);
-
-          //
-          // Call AuthenticodeVerify library to Verify Authenticode struct.
-          //
-          VerifyStatus = AuthenticodeVerify (
-                           AuthData,
-                           AuthDataSize,
-                           RootCert,
-                           RootCertSize,
-                           mImageDigest,
-                           mImageDigestSize
-                           );
-          if (VerifyStatus) {
-            //
-            // Here We still need to check if this RootCert's Hash is revoked
-            //
-            Status   = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DbxDataSize, NULL);
-            if (Status == EFI_BUFFER_TOO_SMALL) {
-              goto Done;
-            }
-            DbxData = (UINT8 *) AllocateZeroPool (DbxDataSize);
-            if (DbxData == NULL) {
-              goto Done;
-            }
-
-            Status = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DbxDataSize, (VOID *) DbxData);
-            if (EFI_ERROR (Status)) {
-              goto Done;
-            }
-
-            if (IsCertHashFoundInDatabase (RootCert, RootCertSize, (EFI_SIGNATURE_LIST *)DbxData, DbxDataSize, &RevocationTime)) {
-              //
-              // Check the timestamp signature and signing time to determine if the RootCert can be trusted.
-              //
-              VerifyStatus = PassTimestampCheck (AuthData, AuthDataSize, &RevocationTime);
-              if (!VerifyStatus) {
-                DEBUG ((DEBUG_INFO, "DxeImageVerificationLib: Image is signed and signature is accepted by DB, but its root cert failed the timestamp check.\n"));
-              }
-            }
+    VerifyStatus = AuthenticodeVerifyWithContext (
+                     Database->VerifyContext,
+                     AuthData,
+                     AuthDataSize,
+                     mImageDigest,
+                     mImageDigestSize,
+                     &CertIndex
+                     );
+    if (VerifyStatus) {
+      ASSERT (CertIndex < Database->CertCount);
+      CertList     = Database->Certs[CertIndex].SignatureList;
+      CertData     = Database->Certs[CertIndex].Signature;
+      RootCert     = CertData->SignatureData;
+      RootCertSize = Database->Certs[CertIndex].KeySize;
 
-            goto Done;
-          }
+      //
+      // Here We still need to check if this RootCert's Hash is revoked
+      //
+      DbxDatabase = GetSecurityDatabase (EFI_IMAGE_SECURITY_DATABASE1);
+      if (DbxDatabase == NULL) {
+        VerifyStatus = FALSE;
+        goto Done;
+      }
 
-          CertData = (EFI_SIGNATURE_DATA *) ((UINT8 *) CertData + CertList->SignatureSize);
+      if (IsCertHashFoundInDatabase (RootCert, RootCertSize, DbxDatabase, &RevocationTime)) {
+        //
+        // Check the timestamp signature and signing time to determine if the RootCert can be trusted.
+        //
+        VerifyStatus = PassTimestampCheck (AuthData, AuthDataSize, &RevocationTime);
+        if (!VerifyStatus) {
+          DEBUG ((DEBUG_INFO, "DxeImageVerificationLib: Image is signed and signature is accepted by DB, but its root cert failed the timestamp check.\n"));
         }
       }
-
-      DataSize -= CertList->SignatureListSize;
-      CertList = (EFI_SIGNATURE_LIST *) ((UINT8 *) CertList + CertList->SignatureListSize);
     }
   }
 
@@ -1515,14 +1528,78 @@ Done:
     SecureBootHook (EFI_IMAGE_SECURITY_DATABASE, &gEfiImageSecurityDatabaseGuid, CertList->SignatureSize, CertData);
   }
 
-  if (Data != NULL) {
-    FreePool (Data);
+  return VerifyStatus;
+}
+
+/**
+  Get the hash algorithms of the Authenticode signatures of the current image.
+
+  Caution: This function may receive untrusted input.
+  PE/COFF image is external input, so this function will validate its data structure
+  within this image buffer before use.
+
+  @param[in]  SecDataDir  Certificate table directory entry, or NULL if the
+                          image has none.
+
+  @return Bit mask of the hash algorithms, one bit per HASHALG_ value.
+
+**/
+UINT32
+GetImageHashAlgMask (
+  IN EFI_IMAGE_DATA_DIRECTORY   *SecDataDir OPTIONAL
+  )
+{
+  UINT32                               HashAlgMask;
+  UINT32                               OffSet;
+  WIN_CERTIFICATE                      *WinCertificate;
+  WIN_CERTIFICATE_UEFI_GUID            *WinCertUefiGuid;
+  UINT8                                *AuthData;
+  UINTN                                AuthDataSize;
+  UINT32                               HashAlg;
+
+  HashAlgMask = 0;
+  if ((SecDataDir == NULL) ||
+      (SecDataDir->VirtualAddress > mImageSize) || (SecDataDir->Size > mImageSize - SecDataDir->VirtualAddress)) {
+    return HashAlgMask;
   }
-  if (DbxData != NULL) {
-    FreePool (DbxData);
+
+  for (OffSet = SecDataDir->VirtualAddress;
+       OffSet < (SecDataDir->VirtualAddress + SecDataDir->Size);
+       OffSet += (WinCertificate->dwLength + ALIGN_SIZE (WinCertificate->dwLength))) {
+    WinCertificate = (WIN_CERTIFICATE *) (mImageBase + OffSet);
+    if ((SecDataDir->VirtualAddress + SecDataDir->Size - OffSet) <= sizeof (WIN_CERTIFICATE) ||
+        (SecDataDir->VirtualAddress + SecDataDir->Size - OffSet) < WinCertificate->dwLength ||
+        WinCertificate->dwLength < sizeof (WIN_CERTIFICATE)) {
+      break;
+    }
+
+    if (WinCertificate->wCertificateType == WIN_CERT_TYPE_PKCS_SIGNED_DATA) {
+      if (WinCertificate->dwLength <= sizeof (WIN_CERTIFICATE)) {
+        break;
+      }
+      AuthData     = ((WIN_CERTIFICATE_EFI_PKCS *) WinCertificate)->CertData;
+      AuthDataSize = WinCertificate->dwLength - sizeof (WIN_CERTIFICATE);
+    } else if (WinCertificate->wCertificateType == WIN_CERT_TYPE_EFI_GUID) {
+      WinCertUefiGuid = (WIN_CERTIFICATE_UEFI_GUID *) WinCertificate;
+      if (WinCertificate->dwLength <= OFFSET_OF (WIN_CERTIFICATE_UEFI_GUID, CertData)) {
+        break;
+      }
+      if (!CompareGuid (&WinCertUefiGuid->CertType, &gEfiCertPkcs7Guid)) {
+        continue;
+      }
+      AuthData     = WinCertUefiGuid->CertData;
+      AuthDataSize = WinCertificate->dwLength - OFFSET_OF (WIN_CERTIFICATE_UEFI_GUID, CertData);
+    } else {
+      continue;
+    }
+
+    HashAlg = GetAuthenticodeHashAlg (AuthData, AuthDataSize);
+    if (HashAlg < HASHALG_MAX) {
+      HashAlgMask |= (1 << HashAlg);
+    }
   }
 
-  return VerifyStatus;
+  return HashAlgMask;
 }
 
 /**
@@ -1602,6 +1679,10 @@ DxeImageVerificationHandler (
   EFI_IMAGE_DATA_DIRECTORY             *SecDataDir;
   UINT32                               OffSet;
   CHAR16                               *NameStr;
+  UINT8                                CacheKey[SHA256_DIGEST_SIZE];
+  BOOLEAN                              CacheVerdict;
+  IMAGE_VERIFICATION_CACHE_ENTRY       *CacheEntry;
+  IMAGE_VERIFICATION_CACHE_ENTRY       NewCacheEntry;
 
   SignatureList     = NULL;
   SignatureListSize = 0;
@@ -1611,7 +1692,7 @@ DxeImageVerificationHandler (
   Action            = EFI_IMAGE_EXECUTION_AUTH_UNTESTED;
   Status            = EFI_ACCESS_DENIED;
   VerifyStatus      = EFI_ACCESS_DENIED;
-
+  CacheVerdict      = FALSE;
 
   //
   // Check the image type and get policy setting.
@@ -1682,6 +1763,10 @@ DxeImageVerificationHandler (
 
   mImageBase  = (UINT8 *) FileBuffer;
   mImageSize  = FileSize;
+  ZeroMem (mImageDigestCacheValid, sizeof (mImageDigestCacheValid));
+  mImageHashAlgMask = 0;
+  mVerificationIncomplete = FALSE;
+  SyncImageVerificationCache ();
 
   ZeroMem (&ImageContext, sizeof (ImageContext));
   ImageContext.Handle    = (VOID *) FileBuffer;
@@ -1756,6 +1841,37 @@ DxeImageVerificationHandler (
     }
   }
 
+  //
+  // The SHA-256 Authenticode digest is the hash of unsigned images and the key
+  // of the verification cache. The digests the signatures use are computed in
+  // the same pass over the image.
+  //
+  mImageHashAlgMask = GetImageHashAlgMask (SecDataDir);
+  if (!HashPeImage (HASHALG_SHA256)) {
+    DEBUG ((DEBUG_INFO, "DxeImageVerificationLib: Failed to hash this image using %s.\n", mHashTypeStr));
+    goto Done;
+  }
+
+  //
+  // Reuse the verdict of an earlier verification of the same image, as long as
+  // db, dbx and dbt did not change since. The authority which allowed the image
+  // was measured by SecureBootHook() during that verification.
+  //
+  if (GetImageVerificationCacheKey (mImageDigest, mImageBase, mImageSize, SecDataDir, CacheKey)) {
+    CacheEntry = LookupImageVerificationCache (CacheKey);
+    if (CacheEntry == NULL) {
+      CacheVerdict = TRUE;
+    } else if (CacheEntry->Allowed) {
+      return EFI_SUCCESS;
+    } else {
+      Action           = CacheEntry->Action;
+      mImageDigestSize = CacheEntry->ImageDigestSize;
+      CopyMem (&mCertType, &CacheEntry->CertType, sizeof (EFI_GUID));
+      CopyMem (mImageDigest, CacheEntry->ImageDigest, mImageDigestSize);
+      goto Done;
+    }
+  }
+
   //
   // Start Image Validation.
   //
@@ -1764,11 +1880,6 @@ DxeImageVerificationHandler (
     // This image is not signed. The SHA256 hash value of the image must match a record in the security database "db",
     // and not be reflected in the security data base "dbx".
     //
-    if (!HashPeImage (HASHALG_SHA256)) {
-      DEBUG ((DEBUG_INFO, "DxeImageVerificationLib: Failed to hash this image using %s.\n", mHashTypeStr));
-      goto Done;
-    }
-
     if (IsSignatureFoundInDatabase (EFI_IMAGE_SECURITY_DATABASE1, mImageDigest, &mCertType, mImageDigestSize)) {
       //
       // Image Hash is in forbidden database (DBX).
@@ -1781,7 +1892,8 @@ DxeImageVerificationHandler (
       //
       // Image Hash is in allowed database (DB).
       //
-      return EFI_SUCCESS;
+      Status = EFI_SUCCESS;
+      goto Done;
     }
 
     //
@@ -1887,9 +1999,30 @@ DxeImageVerificationHandler (
   }
 
   if (!EFI_ERROR (VerifyStatus)) {
-    return EFI_SUCCESS;
+    Status = EFI_SUCCESS;
   } else {
     Status = EFI_ACCESS_DENIED;
+  }
+
+Done:
+  //
+  // Only the verdicts which were reached with all the data they depend on are
+  // cached. A rejection caused by a resource failure is not.
+  //
+  if (CacheVerdict && !mVerificationIncomplete) {
+    ZeroMem (&NewCacheEntry, sizeof (NewCacheEntry));
+    CopyMem (NewCacheEntry.Key, CacheKey, SHA256_DIGEST_SIZE);
+    NewCacheEntry.Allowed = (BOOLEAN) (Status == EFI_SUCCESS);
+    NewCacheEntry.Action  = Action;
+    if (Action == EFI_IMAGE_EXECUTION_AUTH_SIG_FAILED || Action == EFI_IMAGE_EXECUTION_AUTH_SIG_FOUND) {
+      CopyMem (&NewCacheEntry.CertType, &mCertType, sizeof (EFI_GUID));
+      CopyMem (NewCacheEntry.ImageDigest, mImageDigest, mImageDigestSize);
+      NewCacheEntry.ImageDigestSize = mImageDigestSize;
+    }
+    AddImageVerificationCache (&NewCacheEntry);
+  }
+
+  if (Status != EFI_SUCCESS) {
     if (Action == EFI_IMAGE_EXECUTION_AUTH_SIG_FAILED || Action == EFI_IMAGE_EXECUTION_AUTH_SIG_FOUND) {
       //
       // Get image hash value as executable's signature.
@@ -1897,20 +2030,17 @@ DxeImageVerificationHandler (
       SignatureListSize = sizeof (EFI_SIGNATURE_LIST) + sizeof (EFI_SIGNATURE_DATA) - 1 + mImageDigestSize;
       SignatureList     = (EFI_SIGNATURE_LIST *) AllocateZeroPool (SignatureListSize);
       if (SignatureList == NULL) {
-        Status = EFI_OUT_OF_RESOURCES;
-        goto Done;
+        SignatureListSize = 0;
+      } else {
+        SignatureList->SignatureHeaderSize  = 0;
+        SignatureList->SignatureListSize    = (UINT32) SignatureListSize;
+        SignatureList->SignatureSize        = (UINT32) (sizeof (EFI_SIGNATURE_DATA) - 1 + mImageDigestSize);
+        CopyMem (&SignatureList->SignatureType, &mCertType, sizeof (EFI_GUID));
+        Signature = (EFI_SIGNATURE_DATA *) ((UINT8 *) SignatureList + sizeof (EFI_SIGNATURE_LIST));
+        CopyMem (Signature->SignatureData, mImageDigest, mImageDigestSize);
       }
-      SignatureList->SignatureHeaderSize  = 0;
-      SignatureList->SignatureListSize    = (UINT32) SignatureListSize;
-      SignatureList->SignatureSize        = (UINT32) (sizeof (EFI_SIGNATURE_DATA) - 1 + mImageDigestSize);
-      CopyMem (&SignatureList->SignatureType, &mCertType, sizeof (EFI_GUID));
-      Signature = (EFI_SIGNATURE_DATA *) ((UINT8 *) SignatureList + sizeof (EFI_SIGNATURE_LIST));
-      CopyMem (Signature->SignatureData, mImageDigest, mImageDigestSize);
     }
-  }
 
-Done:
-  if (Status != EFI_SUCCESS) {
     //
     // Policy decides to defer or reject the image; add its information in image executable information table.
     //
@@ -1949,6 +2079,8 @@ OnReadyToBoot (
   EFI_IMAGE_EXECUTION_INFO_TABLE  *ImageExeInfoTable;
   UINTN                           ImageExeInfoTableSize;
 
+  DumpImageVerificationCacheStatistics ();
+
   EfiGetSystemConfigurationTable (&gEfiImageSecurityDatabaseGuid, (VOID **) &ImageExeInfoTable);
   if (ImageExeInfoTable != NULL) {
     return;
@@ -2,7 +2,7 @@
   The internal header file includes the common header files, defines
   internal structure and functions used by ImageVerificationLib.
 
-Copyright (c) 2009 - 2014, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2009 - 2017, Intel Corporation. All rights reserved.<BR>
 This program and the accompanying materials
 are licensed and made available under the terms and conditions of the BSD License
 which accompanies this distribution.  The full text of the license may be found at
@@ -29,6 +29,7 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include <Library/DevicePathLib.h>
 #include <Library/SecurityManagementLib.h>
 #include <Library/PeCoffLib.h>
+#include <Library/SortLib.h>
 #include <Protocol/FirmwareVolume2.h>
 #include <Protocol/DevicePath.h>
 #include <Protocol/BlockIo.h>
@@ -204,4 +205,245 @@ typedef struct {
   HASH_FINAL               HashFinal;
 } HASH_TABLE;
 
+//
+// Signature of db or dbx, sorted by signature type, key size, key value and
+// position in the database. The key of a signature is its whole SignatureData,
+// except for the X.509 certificate hash types whose key is the certificate hash
+// without the revocation time.
+//
+typedef struct {
+  EFI_SIGNATURE_LIST          *SignatureList;
+  EFI_SIGNATURE_DATA          *Signature;
+  UINTN                       KeySize;
+} SIGNATURE_INDEX_ENTRY;
+
+//
+// Content of db, dbx or dbt read by SyncImageVerificationCache(), the index of
+// its signatures built at the first lookup, and the PKCS#7 verification context
+// of its X.509 certificates built at the first image signature verification.
+// Certs lists the certificates of the context in the same order, so that the
+// certificate number returned by AuthenticodeVerifyWithContext() gives the
+// signature in the database. The SkippedCertCount certificates which could not
+// be added to the context follow them.
+//
+typedef struct {
+  CHAR16                      *VariableName;
+  EFI_SIGNATURE_LIST          *Data;
+  UINTN                       Size;
+  BOOLEAN                     Unreadable;
+  BOOLEAN                     Indexed;
+  SIGNATURE_INDEX_ENTRY       *Index;
+  UINTN                       IndexCount;
+  VOID                        *VerifyContext;
+  SIGNATURE_INDEX_ENTRY       *Certs;
+  UINTN                       CertCount;
+  UINTN                       SkippedCertCount;
+} SECURITY_DATABASE;
+
+//
+// Set when a resource failure affected the verification of the current image,
+// so that its verdict is not cached
+//
+extern BOOLEAN                mVerificationIncomplete;
+
+//
+// Number of image verification verdicts remembered during the boot
+//
+#define IMAGE_VERIFICATION_CACHE_SIZE  32
+
+//
+// Image verification verdict, keyed by GetImageVerificationCacheKey()
+//
+typedef struct {
+  //
+  // Key of the image
+  //
+  UINT8                       Key[SHA256_DIGEST_SIZE];
+  //
+  // TRUE if the image passed the verification
+  //
+  BOOLEAN                     Allowed;
+  //
+  // Action recorded in the image execution information table for a rejected image
+  //
+  EFI_IMAGE_EXECUTION_ACTION  Action;
+  //
+  // Type and value of the image hash recorded for a rejected image
+  //
+  EFI_GUID                    CertType;
+  UINT8                       ImageDigest[MAX_DIGEST_SIZE];
+  UINTN                       ImageDigestSize;
+} IMAGE_VERIFICATION_CACHE_ENTRY;
+
+/**
+  Flush the image verification cache if db, dbx or dbt changed since the cached
+  verdicts were computed.
+
+**/
+VOID
+SyncImageVerificationCache (
+  VOID
+  );
+
+/**
+  Compute the key of an image in the verification cache.
+
+  The verdict only depends on the Authenticode digest of the image and on its
+  attribute certificate table, so the key is the SHA-256 digest of the SHA-256
+  Authenticode digest, of the certificate table directory entry and of the
+  certificate table.
+
+  @param[in]   ImageDigest  SHA-256 Authenticode digest of the image.
+  @param[in]   ImageBase    The image file.
+  @param[in]   ImageSize    Size of the image file in bytes.
+  @param[in]   SecDataDir   Certificate table directory entry, or NULL if the
+                            image has none.
+  @param[out]  Key          The key of the image.
+
+  @retval TRUE   The key is computed.
+  @retval FALSE  The certificate table is outside of the image, or there is not
+                 enough memory to compute the key.
+
+**/
+BOOLEAN
+GetImageVerificationCacheKey (
+  IN  CONST UINT8                        *ImageDigest,
+  IN  CONST UINT8                        *ImageBase,
+  IN  UINTN                              ImageSize,
+  IN  CONST EFI_IMAGE_DATA_DIRECTORY     *SecDataDir OPTIONAL,
+  OUT UINT8                              *Key
+  );
+
+/**
+  Find the verdict of an earlier verification of an image.
+
+  @param[in]  Key  Key of the image, see GetImageVerificationCacheKey().
+
+  @return  The cache entry of the image, or NULL if the image was not verified
+           with the current db, dbx and dbt.
+
+**/
+IMAGE_VERIFICATION_CACHE_ENTRY *
+LookupImageVerificationCache (
+  IN CONST UINT8                         *Key
+  );
+
+/**
+  Remember the verdict of the verification of an image. When the cache is full,
+  the oldest verdict is replaced.
+
+  @param[in]  Entry  The verdict and the key of the image.
+
+**/
+VOID
+AddImageVerificationCache (
+  IN CONST IMAGE_VERIFICATION_CACHE_ENTRY  *Entry
+  );
+
+/**
+  Report the hit and miss counts of the image verification cache.
+
+**/
+VOID
+DumpImageVerificationCacheStatistics (
+  VOID
+  );
+
+/**
+  Get the content of db, dbx or dbt read by the last SyncImageVerificationCache()
+  call, with the index of its signatures.
+
+  @param[in]  VariableName  Name of the database variable.
+
+  @return  The database, or NULL if it exists but cannot be read, or if its
+           index cannot be built.
+
+**/
+SECURITY_DATABASE *
+GetSecurityDatabase (
+  IN CHAR16                   *VariableName
+  );
+
+/**
+  Build the index of the signatures of a security database.
+
+  @param[in, out]  Database  The security database.
+
+  @retval EFI_SUCCESS           The index is built.
+  @retval EFI_OUT_OF_RESOURCES  There is not enough memory for the index.
+
+**/
+EFI_STATUS
+BuildSignatureIndex (
+  IN OUT SECURITY_DATABASE    *Database
+  );
+
+/**
+  Build the PKCS#7 verification context of the X.509 certificates of a security
+  database.
+
+  @param[in, out]  Database  The security database.
+
+  @retval EFI_SUCCESS           The verification context is built.
+  @retval EFI_OUT_OF_RESOURCES  There is not enough memory for the verification context.
+
+**/
+EFI_STATUS
+BuildCertVerifyContext (
+  IN OUT SECURITY_DATABASE    *Database
+  );
+
+/**
+  Free the index of the signatures of a security database, and the verification
+  context of its certificates.
+
+  @param[in, out]  Database  The security database.
+
+**/
+VOID
+FreeSignatureIndex (
+  IN OUT SECURITY_DATABASE    *Database
+  );
+
+/**
+  Find a signature in a security database.
+
+  When several signatures have the key, the first one in the database is
+  returned.
+
+  @param[in]   Database       The security database.
+  @param[in]   SignatureType  Type of the signature.
+  @param[in]   Key            Signature value, or certificate hash for the X.509
+                              certificate hash types.
+  @param[in]   KeySize        Size of Key in bytes.
+  @param[out]  SignatureList  Signature list holding the signature found.
+
+  @return  The signature, or NULL if it is not in the database.
+
+**/
+EFI_SIGNATURE_DATA *
+FindSignatureInIndex (
+  IN  SECURITY_DATABASE       *Database,
+  IN  EFI_GUID                *SignatureType,
+  IN  UINT8                   *Key,
+  IN  UINTN                   KeySize,
+  OUT EFI_SIGNATURE_LIST      **SignatureList OPTIONAL
+  );
+
+/**
+  Check whether a security database has signatures of a type.
+
+  @param[in]  Database       The security database.
+  @param[in]  SignatureType  Type of the signatures.
+
+  @retval TRUE   The database has at least one signature of this type.
+  @retval FALSE  The database has no signature of this type.
+
+**/
+BOOLEAN
+IsSignatureTypeInIndex (
+  IN SECURITY_DATABASE        *Database,
+  IN EFI_GUID                 *SignatureType
+  );
+
 #endif
@@ -0,0 +1,259 @@
+/** @file
+  Cache of the image verification verdicts.
+
+  The verdict of DxeImageVerificationHandler() only depends on the image content
+  and on the db, dbx and dbt variables once the policy and the secure boot mode
+  are known. It is remembered for the rest of the boot, keyed by the Authenticode
+  digest and the signatures of the image, so that an image loaded several times,
+  like an option ROM on each ConnectController() retry, is verified only once.
+  Verdicts affected by a resource failure are not remembered. The cache is
+  flushed whenever one of db, dbx or dbt differs from the content it was built
+  with. The same content is used by the signature lookups of the verification,
+  see SignatureIndex.c.
+
+Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+This program and the accompanying materials
+are licensed and made available under the terms and conditions of the BSD License
+which accompanies this distribution.  The full text of the license may be found at
+http://opensource.org/licenses/bsd-license.php
+
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "DxeImageVerificationLib.h"
+
+//
+// Content of db, dbx and dbt the cached verdicts were computed with.
+//
+SECURITY_DATABASE               mSecurityDatabaseSnapshot[] = {
+  {EFI_IMAGE_SECURITY_DATABASE,  NULL, 0, FALSE, FALSE, NULL, 0, NULL, NULL, 0, 0},
+  {EFI_IMAGE_SECURITY_DATABASE1, NULL, 0, FALSE, FALSE, NULL, 0, NULL, NULL, 0, 0},
+  {EFI_IMAGE_SECURITY_DATABASE2, NULL, 0, FALSE, FALSE, NULL, 0, NULL, NULL, 0, 0}
+};
+
+IMAGE_VERIFICATION_CACHE_ENTRY  mImageVerificationCache[IMAGE_VERIFICATION_CACHE_SIZE];
+UINTN                           mImageVerificationCacheCount  = 0;
+UINTN                           mImageVerificationCacheNext   = 0;
+UINTN                           mImageVerificationCacheHits   = 0;
+UINTN                           mImageVerificationCacheMisses = 0;
+
+/**
+  Flush the image verification cache if db, dbx or dbt changed since the cached
+  verdicts were computed.
+
+**/
+VOID
+SyncImageVerificationCache (
+  VOID
+  )
+{
+  UINTN                       Index;
+  SECURITY_DATABASE           *Snapshot;
+  VOID                        *Data;
+  UINTN                       DataSize;
+  BOOLEAN                     Changed;
+  EFI_STATUS                  Status;
+  BOOLEAN                     Unreadable;
+
+  Changed = FALSE;
+  for (Index = 0; Index < ARRAY_SIZE (mSecurityDatabaseSnapshot); Index++) {
+    Snapshot = &mSecurityDatabaseSnapshot[Index];
+    Data     = NULL;
+    DataSize = 0;
+    //
+    // A database that does not exist is handled as an empty one. A database
+    // that exists but cannot be read, for example because there is not enough
+    // memory for its content, is marked as such and GetSecurityDatabase() won't
+    // return it.
+    //
+    Status = GetVariable2 (Snapshot->VariableName, &gEfiImageSecurityDatabaseGuid, &Data, &DataSize);
+    if (EFI_ERROR (Status)) {
+      Data     = NULL;
+      DataSize = 0;
+    }
+    Unreadable = (BOOLEAN) (EFI_ERROR (Status) && (Status != EFI_NOT_FOUND));
+
+    if (!Unreadable && !Snapshot->Unreadable &&
+        DataSize == Snapshot->Size &&
+        (DataSize == 0 || CompareMem (Data, Snapshot->Data, DataSize) == 0)) {
+      if (Data != NULL) {
+        FreePool (Data);
+      }
+      continue;
+    }
+
+    Changed = TRUE;
+    FreeSignatureIndex (Snapshot);
+    if (Snapshot->Data != NULL) {
+      FreePool (Snapshot->Data);
+    }
+    Snapshot->Data       = Data;
+    Snapshot->Size       = DataSize;
+    Snapshot->Unreadable = Unreadable;
+  }
+
+  if (Changed && mImageVerificationCacheCount != 0) {
+    DEBUG ((DEBUG_INFO, "DxeImageVerificationLib: Security database changed, %d cached verdicts dropped.\n", mImageVerificationCacheCount));
+    mImageVerificationCacheCount = 0;
+    mImageVerificationCacheNext  = 0;
+  }
+}
+
+/**
+  Get the content of db, dbx or dbt read by the last SyncImageVerificationCache()
+  call, with the index of its signatures.
+
+  @param[in]  VariableName  Name of the database variable.
+
+  @return  The database, or NULL if it exists but cannot be read, or if its
+           index cannot be built.
+
+**/
+SECURITY_DATABASE *
+GetSecurityDatabase (
+  IN CHAR16                   *VariableName
+  )
+{
+  UINTN                       Index;
+  SECURITY_DATABASE           *Database;
+
+  for (Index = 0; Index < ARRAY_SIZE (mSecurityDatabaseSnapshot); Index++) {
+    Database = &mSecurityDatabaseSnapshot[Index];
+    if (StrCmp (Database->VariableName, VariableName) != 0) {
+      continue;
+    }
+
+    if (Database->Unreadable) {
+      mVerificationIncomplete = TRUE;
+      return NULL;
+    }
+
+    if (!Database->Indexed && EFI_ERROR (BuildSignatureIndex (Database))) {
+      mVerificationIncomplete = TRUE;
+      return NULL;
+    }
+    return Database;
+  }
+
+  ASSERT (FALSE);
+  return NULL;
+}
+
+/**
+  Compute the key of an image in the verification cache.
+
+  The verdict only depends on the Authenticode digest of the image and on its
+  attribute certificate table, so the key is the SHA-256 digest of the SHA-256
+  Authenticode digest, of the certificate table directory entry and of the
+  certificate table.
+
+  @param[in]   ImageDigest  SHA-256 Authenticode digest of the image.
+  @param[in]   ImageBase    The image file.
+  @param[in]   ImageSize    Size of the image file in bytes.
+  @param[in]   SecDataDir   Certificate table directory entry, or NULL if the
+                            image has none.
+  @param[out]  Key          The key of the image.
+
+  @retval TRUE   The key is computed.
+  @retval FALSE  The certificate table is outside of the image, or there is not
+                 enough memory to compute the key.
+
+**/
+BOOLEAN
+GetImageVerificationCacheKey (
+  IN  CONST UINT8                        *ImageDigest,
+  IN  CONST UINT8                        *ImageBase,
+  IN  UINTN                              ImageSize,
+  IN  CONST EFI_IMAGE_DATA_DIRECTORY     *SecDataDir OPTIONAL,
+  OUT UINT8                              *Key
+  )
+{
+  VOID                                   *HashCtx;
+  BOOLEAN                                Status;
+
+  if ((SecDataDir != NULL) &&
+      ((SecDataDir->VirtualAddress > ImageSize) || (SecDataDir->Size > ImageSize - SecDataDir->VirtualAddress))) {
+    return FALSE;
+  }
+
+  HashCtx = AllocatePool (Sha256GetContextSize ());
+  if (HashCtx == NULL) {
+    return FALSE;
+  }
+
+  Status = Sha256Init (HashCtx) && Sha256Update (HashCtx, ImageDigest, SHA256_DIGEST_SIZE);
+  if (Status && (SecDataDir != NULL)) {
+    Status = Sha256Update (HashCtx, SecDataDir, sizeof (*SecDataDir)) &&
+             Sha256Update (HashCtx, ImageBase + SecDataDir->VirtualAddress, SecDataDir->Size);
+  }
+  Status = Status && Sha256Final (HashCtx, Key);
+
+  FreePool (HashCtx);
+  return Status;
+}
+
+/**
+  Find the verdict of an earlier verification of an image.
+
+  @param[in]  Key  Key of the image, see GetImageVerificationCacheKey().
+
+  @return  The cache entry of the image, or NULL if the image was not verified
+           with the current db, dbx and dbt.
+
+**/
+IMAGE_VERIFICATION_CACHE_ENTRY *
+LookupImageVerificationCache (
+  IN CONST UINT8                         *Key
+  )
+{
+  UINTN                                  Index;
+
+  for (Index = 0; Index < mImageVerificationCacheCount; Index++) {
+    if (CompareMem (mImageVerificationCache[Index].Key, Key, SHA256_DIGEST_SIZE) == 0) {
+      mImageVerificationCacheHits++;
+      return &mImageVerificationCache[Index];
+    }
+  }
+
+  mImageVerificationCacheMisses++;
+  return NULL;
+}
+
+/**
+  Remember the verdict of the verification of an image. When the cache is full,
+  the oldest verdict is replaced.
+
+  @param[in]  Entry  The verdict and the key of the image.
+
+**/
+VOID
+AddImageVerificationCache (
+  IN CONST IMAGE_VERIFICATION_CACHE_ENTRY  *Entry
+  )
+{
+  CopyMem (&mImageVerificationCache[mImageVerificationCacheNext], Entry, sizeof (*Entry));
+  mImageVerificationCacheNext = (mImageVerificationCacheNext + 1) % IMAGE_VERIFICATION_CACHE_SIZE;
+  if (mImageVerificationCacheCount < IMAGE_VERIFICATION_CACHE_SIZE) {
+    mImageVerificationCacheCount++;
+  }
+}
+
+/**
+  Report the hit and miss counts of the image verification cache.
+
+**/
+VOID
+DumpImageVerificationCacheStatistics (
+  VOID
+  )
+{
+  DEBUG ((
+    DEBUG_INFO,
+    "DxeImageVerificationLib: Verification cache: %d hits, %d misses, %d entries.\n",
+    mImageVerificationCacheHits,
+    mImageVerificationCacheMisses,
+    mImageVerificationCacheCount
+    ));
+}
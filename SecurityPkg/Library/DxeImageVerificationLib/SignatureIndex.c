@@ -0,0 +1,465 @@
+/** @file
+  Sorted index of the signatures of the security databases.
+
+  Each image hash, and the hash of each certificate of the image signers, is
+  looked up in db and dbx. dbx holds hundreds of revoked hashes, so instead of a
+  scan of every signature list for each lookup, the signatures of a database are
+  sorted once for the content read by SyncImageVerificationCache() and found by
+  a binary search.
+
+  The X.509 certificates of db and dbx are also parsed once for the same content,
+  into a PKCS#7 verification context used for every image signature.
+
+Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+This program and the accompanying materials
+are licensed and made available under the terms and conditions of the BSD License
+which accompanies this distribution.  The full text of the license may be found at
+http://opensource.org/licenses/bsd-license.php
+
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "DxeImageVerificationLib.h"
+
+/**
+  Get the size of the key of a signature.
+
+  @param[in]  SignatureType      Type of the signature.
+  @param[in]  SignatureDataSize  Size of the SignatureData of the signature.
+
+  @return  Size of the key, or 0 if the signature is too small for its type.
+
+**/
+UINTN
+GetSignatureKeySize (
+  IN EFI_GUID               *SignatureType,
+  IN UINTN                  SignatureDataSize
+  )
+{
+  UINTN                     HashSize;
+
+  if (CompareGuid (SignatureType, &gEfiCertX509Sha256Guid)) {
+    HashSize = SHA256_DIGEST_SIZE;
+  } else if (CompareGuid (SignatureType, &gEfiCertX509Sha384Guid)) {
+    HashSize = SHA384_DIGEST_SIZE;
+  } else if (CompareGuid (SignatureType, &gEfiCertX509Sha512Guid)) {
+    HashSize = SHA512_DIGEST_SIZE;
+  } else {
+    return SignatureDataSize;
+  }
+
+  //
+  // The certificate hash is followed by the revocation time.
+  //
+  if (SignatureDataSize < HashSize + sizeof (EFI_TIME)) {
+    return 0;
+  }
+  return HashSize;
+}
+
+/**
+  Compare the key of an index entry with a key.
+
+  @param[in]  Entry          The index entry.
+  @param[in]  SignatureType  Type of the key.
+  @param[in]  Key            The key.
+  @param[in]  KeySize        Size of Key in bytes.
+
+  @retval 0   The keys are equal.
+  @retval <0  The key of Entry is sorted before Key.
+  @retval >0  The key of Entry is sorted after Key.
+
+**/
+INTN
+CompareSignatureKey (
+  IN SIGNATURE_INDEX_ENTRY  *Entry,
+  IN EFI_GUID               *SignatureType,
+  IN UINT8                  *Key,
+  IN UINTN                  KeySize
+  )
+{
+  INTN                      Result;
+
+  Result = CompareMem (&Entry->SignatureList->SignatureType, SignatureType, sizeof (EFI_GUID));
+  if (Result != 0) {
+    return Result;
+  }
+  if (Entry->KeySize != KeySize) {
+    return (Entry->KeySize < KeySize) ? -1 : 1;
+  }
+  return CompareMem (Entry->Signature->SignatureData, Key, KeySize);
+}
+
+/**
+  Compare two index entries, for PerformQuickSort().
+
+  Entries with the same key are sorted in database order, so that the first
+  one in the database comes first in the index.
+
+  @param[in]  Buffer1  The first index entry.
+  @param[in]  Buffer2  The second index entry.
+
+  @retval 0   The entries are the same.
+  @retval <0  Buffer1 is sorted before Buffer2.
+  @retval >0  Buffer1 is sorted after Buffer2.
+
+**/
+INTN
+EFIAPI
+CompareSignatureIndexEntry (
+  IN CONST VOID             *Buffer1,
+  IN CONST VOID             *Buffer2
+  )
+{
+  SIGNATURE_INDEX_ENTRY     *Entry1;
+  SIGNATURE_INDEX_ENTRY     *Entry2;
+  INTN                      Result;
+
+  Entry1 = (SIGNATURE_INDEX_ENTRY *) Buffer1;
+  Entry2 = (SIGNATURE_INDEX_ENTRY *) Buffer2;
+  Result = CompareSignatureKey (Entry1, &Entry2->SignatureList->SignatureType, Entry2->Signature->SignatureData, Entry2->KeySize);
+  if (Result != 0) {
+    return Result;
+  }
+  if (Entry1->Signature == Entry2->Signature) {
+    return 0;
+  }
+  return ((UINTN) Entry1->Signature < (UINTN) Entry2->Signature) ? -1 : 1;
+}
+
+/**
+  Search the position of the first entry with a key in a sorted index.
+
+  @param[in]  Index          The index entries.
+  @param[in]  Count          Number of entries in Index.
+  @param[in]  SignatureType  Type of the key.
+  @param[in]  Key            The key.
+  @param[in]  KeySize        Size of Key in bytes.
+
+  @return  The position of the key in the index.
+
+**/
+UINTN
+SearchSignatureIndex (
+  IN SIGNATURE_INDEX_ENTRY  *Index,
+  IN UINTN                  Count,
+  IN EFI_GUID               *SignatureType,
+  IN UINT8                  *Key,
+  IN UINTN                  KeySize
+  )
+{
+  UINTN                     Low;
+  UINTN                     High;
+  UINTN                     Middle;
+  INTN                      Result;
+
+  Low  = 0;
+  High = Count;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    Result = CompareSignatureKey (&Index[Middle], SignatureType, Key, KeySize);
+    if (Result < 0) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  return Low;
+}
+
+/**
+  Walk the signature lists of a security database and, if an index is given,
+  add each signature to it in database order.
+
+  The walk stops at the first malformed signature list, as the lists after it
+  cannot be located.
+
+  @param[in]       Database  The security database.
+  @param[in, out]  Index     Index to fill with the signatures, large enough for
+                             all of them, or NULL to only count them.
+
+  @return  Number of signatures in the database.
+
+**/
+UINTN
+WalkSignatureLists (
+  IN     SECURITY_DATABASE      *Database,
+  IN OUT SIGNATURE_INDEX_ENTRY  *Index OPTIONAL
+  )
+{
+  EFI_SIGNATURE_LIST            *SignatureList;
+  EFI_SIGNATURE_DATA            *Signature;
+  UINTN                         DataSize;
+  UINTN                         SignatureCount;
+  UINTN                         KeySize;
+  UINTN                         Count;
+  UINTN                         Number;
+
+  Count         = 0;
+  SignatureList = Database->Data;
+  DataSize      = Database->Size;
+  while ((DataSize >= sizeof (EFI_SIGNATURE_LIST)) && (DataSize >= SignatureList->SignatureListSize)) {
+    if ((SignatureList->SignatureListSize < sizeof (EFI_SIGNATURE_LIST)) ||
+        (SignatureList->SignatureHeaderSize > SignatureList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST))) {
+      break;
+    }
+
+    if (SignatureList->SignatureSize > sizeof (EFI_GUID)) {
+      KeySize        = GetSignatureKeySize (&SignatureList->SignatureType, SignatureList->SignatureSize - sizeof (EFI_GUID));
+      SignatureCount = (SignatureList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - SignatureList->SignatureHeaderSize) / SignatureList->SignatureSize;
+      Signature      = (EFI_SIGNATURE_DATA *) ((UINT8 *) SignatureList + sizeof (EFI_SIGNATURE_LIST) + SignatureList->SignatureHeaderSize);
+      for (Number = 0; (KeySize != 0) && (Number < SignatureCount); Number++) {
+        if (Index != NULL) {
+          Index[Count].SignatureList = SignatureList;
+          Index[Count].Signature     = Signature;
+          Index[Count].KeySize       = KeySize;
+        }
+        Count++;
+        Signature = (EFI_SIGNATURE_DATA *) ((UINT8 *) Signature + SignatureList->SignatureSize);
+      }
+    }
+
+    DataSize     -= SignatureList->SignatureListSize;
+    SignatureList = (EFI_SIGNATURE_LIST *) ((UINT8 *) SignatureList + SignatureList->SignatureListSize);
+  }
+
+  return Count;
+}
+
+/**
+  Build the index of the signatures of a security database.
+
+  @param[in, out]  Database  The security database.
+
+  @retval EFI_SUCCESS           The index is built.
+  @retval EFI_OUT_OF_RESOURCES  There is not enough memory for the index.
+
+**/
+EFI_STATUS
+BuildSignatureIndex (
+  IN OUT SECURITY_DATABASE    *Database
+  )
+{
+  UINTN                       Count;
+
+  FreeSignatureIndex (Database);
+
+  Count = WalkSignatureLists (Database, NULL);
+  if (Count != 0) {
+    Database->Index = AllocatePool (Count * sizeof (SIGNATURE_INDEX_ENTRY));
+    if (Database->Index == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    WalkSignatureLists (Database, Database->Index);
+    PerformQuickSort (Database->Index, Count, sizeof (SIGNATURE_INDEX_ENTRY), CompareSignatureIndexEntry);
+  }
+
+  Database->IndexCount = Count;
+  Database->Indexed    = TRUE;
+  return EFI_SUCCESS;
+}
+
+/**
+  Build the PKCS#7 verification context of the X.509 certificates of a security
+  database.
+
+  Pkcs7VerifyContextAddCert() fails both for a certificate which cannot be
+  parsed and when there is not enough memory to add it. The certificates which
+  are not added are listed after the ones of the context, so that the callers
+  can verify them one by one.
+
+  @param[in, out]  Database  The security database.
+
+  @retval EFI_SUCCESS           The verification context is built.
+  @retval EFI_OUT_OF_RESOURCES  There is not enough memory for the verification context.
+
+**/
+EFI_STATUS
+BuildCertVerifyContext (
+  IN OUT SECURITY_DATABASE    *Database
+  )
+{
+  EFI_SIGNATURE_LIST          *SignatureList;
+  EFI_SIGNATURE_DATA          *Signature;
+  UINTN                       DataSize;
+  UINTN                       SignatureCount;
+  UINTN                       Number;
+  UINTN                       Count;
+  UINTN                       Total;
+  UINTN                       Pass;
+  SIGNATURE_INDEX_ENTRY       *Entry;
+
+  ASSERT (Database->VerifyContext == NULL);
+
+  Database->VerifyContext = Pkcs7VerifyContextNew ();
+  if (Database->VerifyContext == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // The first pass counts the certificates, the second one adds them. The
+  // certificates which are not added are stored from the end of Certs, so that
+  // they follow the CertCount ones of the context once all are processed.
+  //
+  Total = 0;
+  for (Pass = 0; Pass < 2; Pass++) {
+    Count         = 0;
+    SignatureList = Database->Data;
+    DataSize      = Database->Size;
+    while ((DataSize >= sizeof (EFI_SIGNATURE_LIST)) && (DataSize >= SignatureList->SignatureListSize)) {
+      if ((SignatureList->SignatureListSize < sizeof (EFI_SIGNATURE_LIST)) ||
+          (SignatureList->SignatureHeaderSize > SignatureList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST))) {
+        break;
+      }
+
+      if (CompareGuid (&SignatureList->SignatureType, &gEfiCertX509Guid) &&
+          (SignatureList->SignatureSize > sizeof (EFI_GUID))) {
+        SignatureCount = (SignatureList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - SignatureList->SignatureHeaderSize) / SignatureList->SignatureSize;
+        Signature      = (EFI_SIGNATURE_DATA *) ((UINT8 *) SignatureList + sizeof (EFI_SIGNATURE_LIST) + SignatureList->SignatureHeaderSize);
+        for (Number = 0; Number < SignatureCount; Number++) {
+          if (Pass == 0) {
+            Count++;
+          } else {
+            if (Pkcs7VerifyContextAddCert (
+                  Database->VerifyContext,
+                  Signature->SignatureData,
+                  SignatureList->SignatureSize - sizeof (EFI_GUID)
+                  )) {
+              Entry = &Database->Certs[Database->CertCount++];
+            } else {
+              Entry = &Database->Certs[Total - 1 - Database->SkippedCertCount++];
+            }
+            Entry->SignatureList = SignatureList;
+            Entry->Signature     = Signature;
+            Entry->KeySize       = SignatureList->SignatureSize - sizeof (EFI_GUID);
+          }
+          Signature = (EFI_SIGNATURE_DATA *) ((UINT8 *) Signature + SignatureList->SignatureSize);
+        }
+      }
+
+      DataSize     -= SignatureList->SignatureListSize;
+      SignatureList = (EFI_SIGNATURE_LIST *) ((UINT8 *) SignatureList + SignatureList->SignatureListSize);
+    }
+
+    if (Count == 0) {
+      break;
+    }
+    if (Pass == 0) {
+      Total           = Count;
+      Database->Certs = AllocatePool (Count * sizeof (SIGNATURE_INDEX_ENTRY));
+      if (Database->Certs == NULL) {
+        Pkcs7VerifyContextFree (Database->VerifyContext);
+        Database->VerifyContext = NULL;
+        return EFI_OUT_OF_RESOURCES;
+      }
+    }
+  }
+
+  DEBUG ((DEBUG_INFO, "DxeImageVerificationLib: %d certificates of %s parsed, %d skipped.\n", Database->CertCount, Database->VariableName, Database->SkippedCertCount));
+  return EFI_SUCCESS;
+}
+
+/**
+  Free the index of the signatures of a security database, and the verification
+  context of its certificates.
+
+  @param[in, out]  Database  The security database.
+
+**/
+VOID
+FreeSignatureIndex (
+  IN OUT SECURITY_DATABASE    *Database
+  )
+{
+  if (Database->Index != NULL) {
+    FreePool (Database->Index);
+  }
+  Database->Index      = NULL;
+  Database->IndexCount = 0;
+  Database->Indexed    = FALSE;
+
+  if (Database->VerifyContext != NULL) {
+    Pkcs7VerifyContextFree (Database->VerifyContext);
+  }
+  if (Database->Certs != NULL) {
+    FreePool (Database->Certs);
+  }
+  Database->VerifyContext    = NULL;
+  Database->Certs            = NULL;
+  Database->CertCount        = 0;
+  Database->SkippedCertCount = 0;
+}
+
+/**
+  Find a signature in a security database.
+
+  When several signatures have the key, the first one in the database is
+  returned.
+
+  @param[in]   Database       The security database.
+  @param[in]   SignatureType  Type of the signature.
+  @param[in]   Key            Signature value, or certificate hash for the X.509
+                              certificate hash types.
+  @param[in]   KeySize        Size of Key in bytes.
+  @param[out]  SignatureList  Signature list holding the signature found.
+
+  @return  The signature, or NULL if it is not in the database.
+
+**/
+EFI_SIGNATURE_DATA *
+FindSignatureInIndex (
+  IN  SECURITY_DATABASE       *Database,
+  IN  EFI_GUID                *SignatureType,
+  IN  UINT8                   *Key,
+  IN  UINTN                   KeySize,
+  OUT EFI_SIGNATURE_LIST      **SignatureList OPTIONAL
+  )
+{
+  UINTN                       Position;
+  SIGNATURE_INDEX_ENTRY       *Entry;
+
+  Position = SearchSignatureIndex (Database->Index, Database->IndexCount, SignatureType, Key, KeySize);
+  if (Position == Database->IndexCount) {
+    return NULL;
+  }
+
+  Entry = &Database->Index[Position];
+  if (CompareSignatureKey (Entry, SignatureType, Key, KeySize) != 0) {
+    return NULL;
+  }
+
+  if (SignatureList != NULL) {
+    *SignatureList = Entry->SignatureList;
+  }
+  return Entry->Signature;
+}
+
+/**
+  Check whether a security database has signatures of a type.
+
+  @param[in]  Database       The security database.
+  @param[in]  SignatureType  Type of the signatures.
+
+  @retval TRUE   The database has at least one signature of this type.
+  @retval FALSE  The database has no signature of this type.
+
+**/
+BOOLEAN
+IsSignatureTypeInIndex (
+  IN SECURITY_DATABASE        *Database,
+  IN EFI_GUID                 *SignatureType
+  )
+{
+  UINTN                       Position;
+
+  //
+  // Keys are never empty, so the search of an empty key gives the first
+  // signature of the type, if any.
+  //
+  Position = SearchSignatureIndex (Database->Index, Database->IndexCount, SignatureType, NULL, 0);
+  return (BOOLEAN) ((Position < Database->IndexCount) &&
+                    CompareGuid (&Database->Index[Position].SignatureList->SignatureType, SignatureType));
+}
@@ -37,6 +37,8 @@
 #include <Protocol/FirmwareManagement.h>
 #include <Guid/SystemResourceTable.h>
 
+#include "FmpAuthenticationLibPkcs7Internal.h"
+
 /**
   The handler is used to do the authentication for FMP capsule based upon
   EFI_FIRMWARE_IMAGE_AUTHENTICATION.
@@ -73,6 +75,7 @@ FmpAuthenticatedHandlerPkcs7 (
   VOID                                      *P7Data;
   UINTN                                     P7Length;
   VOID                                      *TempBuffer;
+  VOID                                      *VerifyContext;
 
   DEBUG((DEBUG_INFO, "FmpAuthenticatedHandlerPkcs7 - Image: 0x%08x - 0x%08x\n", (UINTN)Image, (UINTN)ImageSize));
 
@@ -97,20 +100,34 @@ FmpAuthenticatedHandlerPkcs7 (
     &Image->MonotonicCount,
     sizeof(Image->MonotonicCount)
     );
-  CryptoStatus = Pkcs7Verify(
+
+  //
+  // The trusted certificate is parsed into a verification context, which may
+  // be kept for the next authentication with the same public key data.
+  //
+  VerifyContext = FmpPkcs7GetVerifyContext (PublicKeyData, PublicKeyDataLength);
+  if (VerifyContext == NULL) {
+    DEBUG((DEBUG_ERROR, "FmpAuthenticatedHandlerPkcs7: PublicKeyData is not a valid certificate\n"));
+    FreePool(TempBuffer);
+    Status = RETURN_SECURITY_VIOLATION;
+    goto Done;
+  }
+
+  CryptoStatus = Pkcs7VerifyWithContext(
+                   VerifyContext,
                    P7Data,
                    P7Length,
-                   PublicKeyData,
-                   PublicKeyDataLength,
                    (UINT8 *)TempBuffer,
-                   ImageSize - Image->AuthInfo.Hdr.dwLength
+                   ImageSize - Image->AuthInfo.Hdr.dwLength,
+                   NULL
                    );
+  FmpPkcs7PutVerifyContext (VerifyContext);
   FreePool(TempBuffer);
   if (!CryptoStatus) {
     //
     // If PKCS7 signature verification fails, AUTH tested failed bit is set.
     //
-    DEBUG((DEBUG_ERROR, "FmpAuthenticatedHandlerPkcs7: Pkcs7Verify() failed\n"));
+    DEBUG((DEBUG_ERROR, "FmpAuthenticatedHandlerPkcs7: Pkcs7VerifyWithContext() failed\n"));
     Status = RETURN_SECURITY_VIOLATION;
     goto Done;
   }
@@ -0,0 +1,47 @@
+/** @file
+  Internal functions of the FMP Authentication PKCS7 handler, which give the
+  PKCS#7 verification context of the public key data.
+
+  Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#ifndef __FMP_AUTHENTICATION_LIB_PKCS7_INTERNAL_H__
+#define __FMP_AUTHENTICATION_LIB_PKCS7_INTERNAL_H__
+
+/**
+  Get the PKCS#7 verification context holding the trusted certificate of the
+  public key data.
+
+  @param[in]  PublicKeyData           The public key data used to validate the signature.
+  @param[in]  PublicKeyDataLength     The length of the public key data.
+
+  @return  The PKCS#7 verification context, or NULL if the public key data is
+           not a certificate or there is not enough memory.
+
+**/
+VOID *
+FmpPkcs7GetVerifyContext (
+  IN CONST UINT8                        *PublicKeyData,
+  IN UINTN                              PublicKeyDataLength
+  );
+
+/**
+  Release a PKCS#7 verification context got from FmpPkcs7GetVerifyContext().
+
+  @param[in]  VerifyContext           The PKCS#7 verification context.
+
+**/
+VOID
+FmpPkcs7PutVerifyContext (
+  IN VOID                               *VerifyContext
+  );
+
+#endif
@@ -0,0 +1,69 @@
+/** @file
+  PKCS#7 verification context of the FMP Authentication PKCS7 handler for
+  DXE/PEI post memory phase.
+
+  A PEIM may run in place from flash, so nothing is kept in global variables:
+  the trusted certificate is parsed for each authentication.
+
+  Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include <Uefi.h>
+
+#include <Library/BaseCryptLib.h>
+
+#include "FmpAuthenticationLibPkcs7Internal.h"
+
+/**
+  Get the PKCS#7 verification context holding the trusted certificate of the
+  public key data.
+
+  @param[in]  PublicKeyData           The public key data used to validate the signature.
+  @param[in]  PublicKeyDataLength     The length of the public key data.
+
+  @return  The PKCS#7 verification context, or NULL if the public key data is
+           not a certificate or there is not enough memory.
+
+**/
+VOID *
+FmpPkcs7GetVerifyContext (
+  IN CONST UINT8                        *PublicKeyData,
+  IN UINTN                              PublicKeyDataLength
+  )
+{
+  VOID                                      *VerifyContext;
+
+  VerifyContext = Pkcs7VerifyContextNew ();
+  if (VerifyContext == NULL) {
+    return NULL;
+  }
+
+  if (!Pkcs7VerifyContextAddCert (VerifyContext, PublicKeyData, PublicKeyDataLength)) {
+    Pkcs7VerifyContextFree (VerifyContext);
+    return NULL;
+  }
+
+  return VerifyContext;
+}
+
+/**
+  Release a PKCS#7 verification context got from FmpPkcs7GetVerifyContext().
+
+  @param[in]  VerifyContext           The PKCS#7 verification context.
+
+**/
+VOID
+FmpPkcs7PutVerifyContext (
+  IN VOID                               *VerifyContext
+  )
+{
+  Pkcs7VerifyContextFree (VerifyContext);
+}
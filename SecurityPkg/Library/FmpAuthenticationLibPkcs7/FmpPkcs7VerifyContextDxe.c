@@ -0,0 +1,99 @@
+/** @file
+  PKCS#7 verification context of the FMP Authentication PKCS7 handler for DXE
+  phase.
+
+  A capsule is authenticated several times with the same public key data, when
+  it is checked and when it is applied. The verification context of the last
+  public key data is kept, so that its certificate is parsed only once.
+
+  Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include <Uefi.h>
+
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/BaseCryptLib.h>
+
+#include "FmpAuthenticationLibPkcs7Internal.h"
+
+UINT8                                   *mCachedPublicKeyData       = NULL;
+UINTN                                   mCachedPublicKeyDataLength  = 0;
+VOID                                    *mCachedVerifyContext       = NULL;
+
+/**
+  Get the PKCS#7 verification context holding the trusted certificate of the
+  public key data.
+
+  @param[in]  PublicKeyData           The public key data used to validate the signature.
+  @param[in]  PublicKeyDataLength     The length of the public key data.
+
+  @return  The PKCS#7 verification context, or NULL if the public key data is
+           not a certificate or there is not enough memory.
+
+**/
+VOID *
+FmpPkcs7GetVerifyContext (
+  IN CONST UINT8                        *PublicKeyData,
+  IN UINTN                              PublicKeyDataLength
+  )
+{
+  VOID                                      *VerifyContext;
+  UINT8                                     *CachedPublicKeyData;
+
+  if ((mCachedVerifyContext != NULL) &&
+      (mCachedPublicKeyDataLength == PublicKeyDataLength) &&
+      (CompareMem (mCachedPublicKeyData, PublicKeyData, PublicKeyDataLength) == 0)) {
+    return mCachedVerifyContext;
+  }
+
+  VerifyContext = Pkcs7VerifyContextNew ();
+  if (VerifyContext == NULL) {
+    return NULL;
+  }
+
+  CachedPublicKeyData = AllocateCopyPool (PublicKeyDataLength, PublicKeyData);
+  if ((CachedPublicKeyData == NULL) ||
+      !Pkcs7VerifyContextAddCert (VerifyContext, PublicKeyData, PublicKeyDataLength)) {
+    if (CachedPublicKeyData != NULL) {
+      FreePool (CachedPublicKeyData);
+    }
+    Pkcs7VerifyContextFree (VerifyContext);
+    return NULL;
+  }
+
+  if (mCachedVerifyContext != NULL) {
+    Pkcs7VerifyContextFree (mCachedVerifyContext);
+    FreePool (mCachedPublicKeyData);
+  }
+  mCachedPublicKeyData       = CachedPublicKeyData;
+  mCachedPublicKeyDataLength = PublicKeyDataLength;
+  mCachedVerifyContext       = VerifyContext;
+
+  return VerifyContext;
+}
+
+/**
+  Release a PKCS#7 verification context got from FmpPkcs7GetVerifyContext().
+
+  The context is kept for the next authentication.
+
+  @param[in]  VerifyContext           The PKCS#7 verification context.
+
+**/
+VOID
+FmpPkcs7PutVerifyContext (
+  IN VOID                               *VerifyContext
+  )
+{
+  ASSERT (VerifyContext == mCachedVerifyContext);
+}
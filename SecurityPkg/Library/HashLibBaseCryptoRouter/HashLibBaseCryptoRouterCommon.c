@@ -1,7 +1,7 @@
 /** @file
   This is BaseCrypto router support function.
 
-Copyright (c) 2013 - 2016, Intel Corporation. All rights reserved. <BR>
+Copyright (c) 2013 - 2017, Intel Corporation. All rights reserved. <BR>
 This program and the accompanying materials
 are licensed and made available under the terms and conditions of the BSD License
 which accompanies this distribution.  The full text of the license may be found at
@@ -18,9 +18,12 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include <Library/Tpm2CommandLib.h>
 #include <Library/DebugLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
 #include <Library/HashLib.h>
 #include <Protocol/Tcg2Protocol.h>
 
+#include "HashLibBaseCryptoRouterCommon.h"
+
 typedef struct {
   EFI_GUID  Guid;
   UINT32    Mask;
@@ -75,3 +78,98 @@ Tpm2SetHashToDigestList (
     );
   DigestList->count ++;
 }
+
+/**
+  Get the hash update function and the hash context of each hash interface
+  enabled in PcdTpm2HashMask.
+
+  @param HashInterface      Registered hash interfaces.
+  @param HashInterfaceCount Number of registered hash interfaces.
+  @param HashCtx            Hash context of each registered hash interface.
+  @param EnabledHashUpdate  Hash update function of each enabled hash interface.
+  @param EnabledHashCtx     Hash context of each enabled hash interface.
+
+  @return Number of enabled hash interfaces.
+**/
+UINTN
+EFIAPI
+GetEnabledHashInterfaces (
+  IN  HASH_INTERFACE  *HashInterface,
+  IN  UINTN           HashInterfaceCount,
+  IN  HASH_HANDLE     *HashCtx,
+  OUT HASH_UPDATE     *EnabledHashUpdate,
+  OUT HASH_HANDLE     *EnabledHashCtx
+  )
+{
+  UINTN        EnabledCount;
+  UINTN        Index;
+  UINT32       HashMask;
+
+  ASSERT (HashInterfaceCount <= HASH_COUNT);
+
+  EnabledCount = 0;
+  for (Index = 0; Index < HashInterfaceCount; Index++) {
+    HashMask = Tpm2GetHashMaskFromAlgo (&HashInterface[Index].HashGuid);
+    if ((HashMask & PcdGet32 (PcdTpm2HashMask)) != 0) {
+      EnabledHashUpdate[EnabledCount] = HashInterface[Index].HashUpdate;
+      EnabledHashCtx[EnabledCount]    = HashCtx[Index];
+      EnabledCount++;
+    }
+  }
+
+  return EnabledCount;
+}
+
+/**
+  Update the hash context of each hash interface enabled in PcdTpm2HashMask with
+  the same data.
+
+  When several interfaces are enabled, the data is hashed one chunk at a time by
+  all of them, so that it is read from memory once instead of once per interface.
+
+  @param HashInterface      Registered hash interfaces.
+  @param HashInterfaceCount Number of registered hash interfaces.
+  @param HashCtx            Hash context of each registered hash interface.
+  @param DataToHash         Data to be hashed.
+  @param DataToHashLen      Data size.
+**/
+VOID
+EFIAPI
+HashUpdateAllInterfaces (
+  IN HASH_INTERFACE  *HashInterface,
+  IN UINTN           HashInterfaceCount,
+  IN HASH_HANDLE     *HashCtx,
+  IN VOID            *DataToHash,
+  IN UINTN           DataToHashLen
+  )
+{
+  HASH_UPDATE  ActiveHashUpdate[HASH_COUNT];
+  HASH_HANDLE  ActiveHashCtx[HASH_COUNT];
+  UINTN        ActiveCount;
+  UINTN        Index;
+  UINT8        *Data;
+  UINTN        ChunkSize;
+
+  ActiveCount = GetEnabledHashInterfaces (
+                  HashInterface,
+                  HashInterfaceCount,
+                  HashCtx,
+                  ActiveHashUpdate,
+                  ActiveHashCtx
+                  );
+
+  if (ActiveCount == 1) {
+    ActiveHashUpdate[0] (ActiveHashCtx[0], DataToHash, DataToHashLen);
+    return;
+  }
+
+  Data = (UINT8 *)DataToHash;
+  while (DataToHashLen > 0) {
+    ChunkSize = MIN (DataToHashLen, HASH_UPDATE_CHUNK_SIZE);
+    for (Index = 0; Index < ActiveCount; Index++) {
+      ActiveHashUpdate[Index] (ActiveHashCtx[Index], Data, ChunkSize);
+    }
+    Data          += ChunkSize;
+    DataToHashLen -= ChunkSize;
+  }
+}
@@ -1,7 +1,7 @@
 /** @file
   This is BaseCrypto router support function definition.
 
-Copyright (c) 2013 - 2016, Intel Corporation. All rights reserved. <BR>
+Copyright (c) 2013 - 2017, Intel Corporation. All rights reserved. <BR>
 This program and the accompanying materials
 are licensed and made available under the terms and conditions of the BSD License
 which accompanies this distribution.  The full text of the license may be found at
@@ -15,6 +15,14 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #ifndef _HASH_LIB_BASE_CRYPTO_ROUTER_COMMON_H_
 #define _HASH_LIB_BASE_CRYPTO_ROUTER_COMMON_H_
 
+//
+// Size of the chunks that HashUpdateAllInterfaces passes to each hash interface
+// in turn. It is small enough for a chunk to stay in the data cache while all
+// the interfaces hash it, and a multiple of the SHA-1/SHA-2 block sizes so that
+// the interfaces do not have to buffer partial blocks between chunks.
+//
+#define HASH_UPDATE_CHUNK_SIZE  SIZE_16KB
+
 /**
   The function get hash mask info from algorithm.
 
@@ -41,4 +49,49 @@ Tpm2SetHashToDigestList (
   IN TPML_DIGEST_VALUES     *Digest
   );
 
+/**
+  Get the hash update function and the hash context of each hash interface
+  enabled in PcdTpm2HashMask.
+
+  @param HashInterface      Registered hash interfaces.
+  @param HashInterfaceCount Number of registered hash interfaces.
+  @param HashCtx            Hash context of each registered hash interface.
+  @param EnabledHashUpdate  Hash update function of each enabled hash interface.
+  @param EnabledHashCtx     Hash context of each enabled hash interface.
+
+  @return Number of enabled hash interfaces.
+**/
+UINTN
+EFIAPI
+GetEnabledHashInterfaces (
+  IN  HASH_INTERFACE  *HashInterface,
+  IN  UINTN           HashInterfaceCount,
+  IN  HASH_HANDLE     *HashCtx,
+  OUT HASH_UPDATE     *EnabledHashUpdate,
+  OUT HASH_HANDLE     *EnabledHashCtx
+  );
+
+/**
+  Update the hash context of each hash interface enabled in PcdTpm2HashMask with
+  the same data.
+
+  When several interfaces are enabled, the data is hashed one chunk at a time by
+  all of them, so that it is read from memory once instead of once per interface.
+
+  @param HashInterface      Registered hash interfaces.
+  @param HashInterfaceCount Number of registered hash interfaces.
+  @param HashCtx            Hash context of each registered hash interface.
+  @param DataToHash         Data to be hashed.
+  @param DataToHashLen      Data size.
+**/
+VOID
+EFIAPI
+HashUpdateAllInterfaces (
+  IN HASH_INTERFACE  *HashInterface,
+  IN UINTN           HashInterfaceCount,
+  IN HASH_HANDLE     *HashCtx,
+  IN VOID            *DataToHash,
+  IN UINTN           DataToHashLen
+  );
+
 #endif
@@ -2,6 +2,7 @@
   This library is BaseCrypto router. It will redirect hash request to each individual
   hash handler registerd, such as SHA1, SHA256.
   Platform can use PcdTpm2HashMask to mask some hash engines.
+  Platform can use PcdTpm2HashParallelThreshold to run the hash engines on the APs.
 
 Copyright (c) 2013 - 2017, Intel Corporation. All rights reserved. <BR>
 This program and the accompanying materials
@@ -22,15 +23,50 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include <Library/MemoryAllocationLib.h>
 #include <Library/PcdLib.h>
 #include <Library/HashLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Protocol/MpService.h>
+#include <Protocol/SmmBase2.h>
+#include <Guid/EventGroup.h>
 
 #include "HashLibBaseCryptoRouterCommon.h"
 
+//
+// Hash update of the enabled hash interfaces shared by the BSP and the APs.
+// Each processor takes the next hash interface not started yet until all of
+// them are done. The APs count themselves out in Exited once they stop
+// touching the job, so it is only reused after all of them are gone.
+//
+typedef struct {
+  HASH_UPDATE      HashUpdate[HASH_COUNT];
+  HASH_HANDLE      HashCtx[HASH_COUNT];
+  UINT32           Count;
+  volatile UINT32  Next;
+  volatile UINT32  Done;
+  UINT32           ApCount;
+  volatile UINT32  Exited;
+  VOID             *DataToHash;
+  UINTN            DataToHashLen;
+} HASH_UPDATE_JOB;
+
 HASH_INTERFACE   mHashInterface[HASH_COUNT] = {{{0}, NULL, NULL, NULL}};
 UINTN            mHashInterfaceCount = 0;
 
 UINT32           mSupportedHashMaskLast = 0;
 UINT32           mSupportedHashMaskCurrent = 0;
 
+EFI_MP_SERVICES_PROTOCOL  *mMpServices = NULL;
+
+//
+// The hash engines only run on the APs in a DXE module, before
+// ExitBootServices. It is never set in SMM and is cleared at ExitBootServices.
+//
+BOOLEAN          mHashOnApsAllowed = FALSE;
+BOOLEAN          mHashOnApsBusy = FALSE;
+EFI_EVENT        mHashOnApsWaitEvent = NULL;
+EFI_EVENT        mExitBootServicesEvent = NULL;
+HASH_UPDATE_JOB  mHashUpdateJob;
+
 /**
   Check mismatch of supported HashMask between modules
   that may link different HashInstanceLib instances.
@@ -52,6 +88,188 @@ CheckSupportedHashMaskMismatch (
   }
 }
 
+/**
+  Run the hash updates of a hash update job not started yet by another processor.
+
+  @param Job  The hash update job.
+**/
+VOID
+HashUpdateJobItems (
+  IN OUT HASH_UPDATE_JOB  *Job
+  )
+{
+  UINT32           Index;
+
+  for (;;) {
+    Index = InterlockedIncrement (&Job->Next) - 1;
+    if (Index >= Job->Count) {
+      break;
+    }
+    Job->HashUpdate[Index] (Job->HashCtx[Index], Job->DataToHash, Job->DataToHashLen);
+    InterlockedIncrement (&Job->Done);
+  }
+}
+
+/**
+  Run the hash updates of a hash update job on an AP.
+
+  @param Buffer  The hash update job.
+**/
+VOID
+EFIAPI
+HashUpdateProcedure (
+  IN OUT VOID  *Buffer
+  )
+{
+  HASH_UPDATE_JOB  *Job;
+
+  Job = (HASH_UPDATE_JOB *)Buffer;
+  HashUpdateJobItems (Job);
+  InterlockedIncrement (&Job->Exited);
+}
+
+/**
+  Update the hash context of each enabled hash interface on the BSP and the
+  APs, so that the hash interfaces run at the same time.
+
+  The data must be at least PcdTpm2HashParallelThreshold bytes, several hash
+  interfaces must be enabled and at least one AP must be enabled. It is never
+  done in SMM or after ExitBootServices.
+
+  The APs are started in non-blocking mode so that the BSP takes its share of
+  the hash interfaces, then the BSP waits for the hash interfaces taken by the
+  APs to be done. It does not wait for the MP services to see the APs finish.
+
+  @param HashCtx       Hash context of each registered hash interface.
+  @param DataToHash    Data to be hashed.
+  @param DataToHashLen Data size.
+
+  @retval TRUE   The hash contexts are updated.
+  @retval FALSE  The hash contexts are not updated and must be updated on the BSP.
+**/
+BOOLEAN
+HashUpdateOnAps (
+  IN HASH_HANDLE  *HashCtx,
+  IN VOID         *DataToHash,
+  IN UINTN        DataToHashLen
+  )
+{
+  EFI_STATUS       Status;
+  HASH_UPDATE_JOB  *Job;
+  UINTN            NumberOfProcessors;
+  UINTN            NumberOfEnabledProcessors;
+  BOOLEAN          Result;
+
+  if (!mHashOnApsAllowed ||
+      (DataToHashLen < PcdGet32 (PcdTpm2HashParallelThreshold))) {
+    return FALSE;
+  }
+
+  //
+  // The job may still be used by a caller interrupted on the BSP, or by APs
+  // that have not left the previous job yet.
+  //
+  Job = &mHashUpdateJob;
+  if (mHashOnApsBusy || (Job->Exited != Job->ApCount)) {
+    return FALSE;
+  }
+  mHashOnApsBusy = TRUE;
+  Result         = FALSE;
+
+  Job->Count = (UINT32)GetEnabledHashInterfaces (
+                         mHashInterface,
+                         mHashInterfaceCount,
+                         HashCtx,
+                         Job->HashUpdate,
+                         Job->HashCtx
+                         );
+  if (Job->Count < 2) {
+    goto Done;
+  }
+
+  //
+  // The MP services may be installed after the first measurements.
+  //
+  if (mMpServices == NULL) {
+    Status = gBS->LocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **)&mMpServices);
+    if (EFI_ERROR (Status)) {
+      mMpServices = NULL;
+      goto Done;
+    }
+  }
+
+  Status = mMpServices->GetNumberOfProcessors (mMpServices, &NumberOfProcessors, &NumberOfEnabledProcessors);
+  if (EFI_ERROR (Status) || (NumberOfEnabledProcessors < 2)) {
+    goto Done;
+  }
+
+  //
+  // The MP services signal the wait event when they see the APs finish, which
+  // may be after the job is done, so it is kept until the library is unloaded.
+  //
+  if (mHashOnApsWaitEvent == NULL) {
+    Status = gBS->CreateEvent (0, TPL_CALLBACK, NULL, NULL, &mHashOnApsWaitEvent);
+    if (EFI_ERROR (Status)) {
+      mHashOnApsWaitEvent = NULL;
+      goto Done;
+    }
+  }
+
+  Job->Next          = 0;
+  Job->Done          = 0;
+  Job->Exited        = 0;
+  Job->ApCount       = (UINT32)(NumberOfEnabledProcessors - 1);
+  Job->DataToHash    = DataToHash;
+  Job->DataToHashLen = DataToHashLen;
+  Status = mMpServices->StartupAllAPs (
+                          mMpServices,
+                          HashUpdateProcedure,
+                          FALSE,
+                          mHashOnApsWaitEvent,
+                          0,
+                          Job,
+                          NULL
+                          );
+  if (EFI_ERROR (Status)) {
+    //
+    // The APs are busy, or this is not the BSP. No AP took the job.
+    //
+    ASSERT (Job->Next == 0);
+    Job->ApCount = 0;
+    goto Done;
+  }
+
+  HashUpdateJobItems (Job);
+  while (Job->Done != Job->Count) {
+    CpuPause ();
+  }
+  Result = TRUE;
+
+Done:
+  mHashOnApsBusy = FALSE;
+  return Result;
+}
+
+/**
+  Update the hash context of each enabled hash interface, on the APs if the
+  data is large enough, otherwise on the current processor.
+
+  @param HashCtx       Hash context of each registered hash interface.
+  @param DataToHash    Data to be hashed.
+  @param DataToHashLen Data size.
+**/
+VOID
+HashUpdateEnabledInterfaces (
+  IN HASH_HANDLE  *HashCtx,
+  IN VOID         *DataToHash,
+  IN UINTN        DataToHashLen
+  )
+{
+  if (!HashUpdateOnAps (HashCtx, DataToHash, DataToHashLen)) {
+    HashUpdateAllInterfaces (mHashInterface, mHashInterfaceCount, HashCtx, DataToHash, DataToHashLen);
+  }
+}
+
 /**
   Start hash sequence.
 
@@ -108,33 +326,21 @@ HashUpdate (
   IN UINTN          DataToHashLen
   )
 {
-  HASH_HANDLE  *HashCtx;
-  UINTN        Index;
-  UINT32       HashMask;
-
   if (mHashInterfaceCount == 0) {
     return EFI_UNSUPPORTED;
   }
 
   CheckSupportedHashMaskMismatch ();
 
-  HashCtx = (HASH_HANDLE *)HashHandle;
-
-  for (Index = 0; Index < mHashInterfaceCount; Index++) {
-    HashMask = Tpm2GetHashMaskFromAlgo (&mHashInterface[Index].HashGuid);
-    if ((HashMask & PcdGet32 (PcdTpm2HashMask)) != 0) {
-      mHashInterface[Index].HashUpdate (HashCtx[Index], DataToHash, DataToHashLen);
-    }
-  }
+  HashUpdateEnabledInterfaces ((HASH_HANDLE *)HashHandle, DataToHash, DataToHashLen);
 
   return EFI_SUCCESS;
 }
 
 /**
-  Hash sequence complete and extend to PCR.
+  Hash sequence complete without extending any PCR.
 
   @param HashHandle    Hash handle.
-  @param PcrIndex      PCR to be extended.
   @param DataToHash    Data to be hashed.
   @param DataToHashLen Data size.
   @param DigestList    Digest list.
@@ -143,9 +349,8 @@ HashUpdate (
 **/
 EFI_STATUS
 EFIAPI
-HashCompleteAndExtend (
+HashComplete (
   IN HASH_HANDLE         HashHandle,
-  IN TPMI_DH_PCR         PcrIndex,
   IN VOID                *DataToHash,
   IN UINTN               DataToHashLen,
   OUT TPML_DIGEST_VALUES *DigestList
@@ -154,7 +359,6 @@ HashCompleteAndExtend (
   TPML_DIGEST_VALUES Digest;
   HASH_HANDLE        *HashCtx;
   UINTN              Index;
-  EFI_STATUS         Status;
   UINT32             HashMask;
 
   if (mHashInterfaceCount == 0) {
@@ -166,10 +370,11 @@ HashCompleteAndExtend (
   HashCtx = (HASH_HANDLE *)HashHandle;
   ZeroMem (DigestList, sizeof(*DigestList));
 
+  HashUpdateEnabledInterfaces (HashCtx, DataToHash, DataToHashLen);
+
   for (Index = 0; Index < mHashInterfaceCount; Index++) {
     HashMask = Tpm2GetHashMaskFromAlgo (&mHashInterface[Index].HashGuid);
     if ((HashMask & PcdGet32 (PcdTpm2HashMask)) != 0) {
-      mHashInterface[Index].HashUpdate (HashCtx[Index], DataToHash, DataToHashLen);
       mHashInterface[Index].HashFinal (HashCtx[Index], &Digest);
       Tpm2SetHashToDigestList (DigestList, &Digest);
     }
@@ -177,6 +382,37 @@ HashCompleteAndExtend (
 
   FreePool (HashCtx);
 
+  return EFI_SUCCESS;
+}
+
+/**
+  Hash sequence complete and extend to PCR.
+
+  @param HashHandle    Hash handle.
+  @param PcrIndex      PCR to be extended.
+  @param DataToHash    Data to be hashed.
+  @param DataToHashLen Data size.
+  @param DigestList    Digest list.
+
+  @retval EFI_SUCCESS     Hash sequence complete and DigestList is returned.
+**/
+EFI_STATUS
+EFIAPI
+HashCompleteAndExtend (
+  IN HASH_HANDLE         HashHandle,
+  IN TPMI_DH_PCR         PcrIndex,
+  IN VOID                *DataToHash,
+  IN UINTN               DataToHashLen,
+  OUT TPML_DIGEST_VALUES *DigestList
+  )
+{
+  EFI_STATUS         Status;
+
+  Status = HashComplete (HashHandle, DataToHash, DataToHashLen, DigestList);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   Status = Tpm2PcrExtend (
              PcrIndex,
              DigestList
@@ -273,8 +509,54 @@ RegisterHashInterfaceLib (
   return EFI_SUCCESS;
 }
 
+/**
+  Stop running the hash engines on the APs at ExitBootServices, as the boot
+  services and the MP services protocol go away.
+
+  @param  Event         The ExitBootServices event.
+  @param  Context       Not used.
+**/
+VOID
+EFIAPI
+HashLibExitBootServicesNotify (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  mHashOnApsAllowed = FALSE;
+}
+
+/**
+  Check whether the module is loaded in SMM.
+
+  @retval TRUE   The module is loaded in SMM.
+  @retval FALSE  The module is not loaded in SMM.
+**/
+BOOLEAN
+HashLibIsInSmm (
+  VOID
+  )
+{
+  EFI_STATUS                Status;
+  EFI_SMM_BASE2_PROTOCOL    *SmmBase2;
+  BOOLEAN                   InSmm;
+
+  Status = gBS->LocateProtocol (&gEfiSmmBase2ProtocolGuid, NULL, (VOID **)&SmmBase2);
+  if (EFI_ERROR (Status)) {
+    return FALSE;
+  }
+
+  InSmm = FALSE;
+  SmmBase2->InSmm (SmmBase2, &InSmm);
+  return InSmm;
+}
+
 /**
   The constructor function of HashLibBaseCryptoRouterDxe.
+
+  The hash engines are only allowed to run on the APs if
+  PcdTpm2HashParallelThreshold is not 0 and the module is not loaded in SMM,
+  until ExitBootServices.
   
   @param  ImageHandle   The firmware allocated handle for the EFI image.
   @param  SystemTable   A pointer to the EFI System Table.
@@ -302,5 +584,55 @@ HashLibBaseCryptoRouterDxeConstructor (
   Status = PcdSet32S (PcdTcg2HashAlgorithmBitmap, 0);
   ASSERT_EFI_ERROR (Status);
 
+  if ((PcdGet32 (PcdTpm2HashParallelThreshold) != 0) && !HashLibIsInSmm ()) {
+    Status = gBS->CreateEventEx (
+                    EVT_NOTIFY_SIGNAL,
+                    TPL_NOTIFY,
+                    HashLibExitBootServicesNotify,
+                    NULL,
+                    &gEfiEventExitBootServicesGuid,
+                    &mExitBootServicesEvent
+                    );
+    if (!EFI_ERROR (Status)) {
+      mHashOnApsAllowed = TRUE;
+    } else {
+      mExitBootServicesEvent = NULL;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  The destructor function of HashLibBaseCryptoRouterDxe.
+
+  @param  ImageHandle   The firmware allocated handle for the EFI image.
+  @param  SystemTable   A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS   The destructor executed correctly.
+
+**/
+EFI_STATUS
+EFIAPI
+HashLibBaseCryptoRouterDxeDestructor (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  mHashOnApsAllowed = FALSE;
+
+  if (mExitBootServicesEvent != NULL) {
+    gBS->CloseEvent (mExitBootServicesEvent);
+    mExitBootServicesEvent = NULL;
+  }
+
+  //
+  // Keep the wait event if the MP services may still signal it.
+  //
+  if ((mHashOnApsWaitEvent != NULL) && (mHashUpdateJob.Exited == mHashUpdateJob.ApCount)) {
+    gBS->CloseEvent (mHashOnApsWaitEvent);
+    mHashOnApsWaitEvent = NULL;
+  }
+
   return EFI_SUCCESS;
 }
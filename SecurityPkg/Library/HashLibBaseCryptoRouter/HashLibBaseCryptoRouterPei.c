@@ -187,9 +187,6 @@ HashUpdate (
   )
 {
   HASH_INTERFACE_HOB *HashInterfaceHob;
-  HASH_HANDLE        *HashCtx;
-  UINTN              Index;
-  UINT32             HashMask;
 
   HashInterfaceHob = InternalGetHashInterfaceHob (&gEfiCallerIdGuid);
   if (HashInterfaceHob == NULL) {
@@ -202,23 +199,21 @@ HashUpdate (
 
   CheckSupportedHashMaskMismatch (HashInterfaceHob);
 
-  HashCtx = (HASH_HANDLE *)HashHandle;
-
-  for (Index = 0; Index < HashInterfaceHob->HashInterfaceCount; Index++) {
-    HashMask = Tpm2GetHashMaskFromAlgo (&HashInterfaceHob->HashInterface[Index].HashGuid);
-    if ((HashMask & PcdGet32 (PcdTpm2HashMask)) != 0) {
-      HashInterfaceHob->HashInterface[Index].HashUpdate (HashCtx[Index], DataToHash, DataToHashLen);
-    }
-  }
+  HashUpdateAllInterfaces (
+    HashInterfaceHob->HashInterface,
+    HashInterfaceHob->HashInterfaceCount,
+    (HASH_HANDLE *)HashHandle,
+    DataToHash,
+    DataToHashLen
+    );
 
   return EFI_SUCCESS;
 }
 
 /**
-  Hash sequence complete and extend to PCR.
+  Hash sequence complete without extending any PCR.
 
   @param HashHandle    Hash handle.
-  @param PcrIndex      PCR to be extended.
   @param DataToHash    Data to be hashed.
   @param DataToHashLen Data size.
   @param DigestList    Digest list.
@@ -227,9 +222,8 @@ HashUpdate (
 **/
 EFI_STATUS
 EFIAPI
-HashCompleteAndExtend (
+HashComplete (
   IN HASH_HANDLE         HashHandle,
-  IN TPMI_DH_PCR         PcrIndex,
   IN VOID                *DataToHash,
   IN UINTN               DataToHashLen,
   OUT TPML_DIGEST_VALUES *DigestList
@@ -239,7 +233,6 @@ HashCompleteAndExtend (
   HASH_INTERFACE_HOB *HashInterfaceHob;
   HASH_HANDLE        *HashCtx;
   UINTN              Index;
-  EFI_STATUS         Status;
   UINT32             HashMask;
 
   HashInterfaceHob = InternalGetHashInterfaceHob (&gEfiCallerIdGuid);
@@ -256,10 +249,17 @@ HashCompleteAndExtend (
   HashCtx = (HASH_HANDLE *)HashHandle;
   ZeroMem (DigestList, sizeof(*DigestList));
 
+  HashUpdateAllInterfaces (
+    HashInterfaceHob->HashInterface,
+    HashInterfaceHob->HashInterfaceCount,
+    HashCtx,
+    DataToHash,
+    DataToHashLen
+    );
+
   for (Index = 0; Index < HashInterfaceHob->HashInterfaceCount; Index++) {
     HashMask = Tpm2GetHashMaskFromAlgo (&HashInterfaceHob->HashInterface[Index].HashGuid);
     if ((HashMask & PcdGet32 (PcdTpm2HashMask)) != 0) {
-      HashInterfaceHob->HashInterface[Index].HashUpdate (HashCtx[Index], DataToHash, DataToHashLen);
       HashInterfaceHob->HashInterface[Index].HashFinal (HashCtx[Index], &Digest);
       Tpm2SetHashToDigestList (DigestList, &Digest);
     }
@@ -267,6 +267,37 @@ HashCompleteAndExtend (
 
   FreePool (HashCtx);
 
+  return EFI_SUCCESS;
+}
+
+/**
+  Hash sequence complete and extend to PCR.
+
+  @param HashHandle    Hash handle.
+  @param PcrIndex      PCR to be extended.
+  @param DataToHash    Data to be hashed.
+  @param DataToHashLen Data size.
+  @param DigestList    Digest list.
+
+  @retval EFI_SUCCESS     Hash sequence complete and DigestList is returned.
+**/
+EFI_STATUS
+EFIAPI
+HashCompleteAndExtend (
+  IN HASH_HANDLE         HashHandle,
+  IN TPMI_DH_PCR         PcrIndex,
+  IN VOID                *DataToHash,
+  IN UINTN               DataToHashLen,
+  OUT TPML_DIGEST_VALUES *DigestList
+  )
+{
+  EFI_STATUS         Status;
+
+  Status = HashComplete (HashHandle, DataToHash, DataToHashLen, DigestList);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   Status = Tpm2PcrExtend (
              PcrIndex,
              DigestList
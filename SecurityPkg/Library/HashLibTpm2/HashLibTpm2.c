@@ -1,7 +1,7 @@
 /** @file
   This library uses TPM2 device to calculation hash.
 
-Copyright (c) 2013 - 2016, Intel Corporation. All rights reserved. <BR>
+Copyright (c) 2013 - 2017, Intel Corporation. All rights reserved. <BR>
 (C) Copyright 2015 Hewlett Packard Enterprise Development LP<BR>
 This program and the accompanying materials
 are licensed and made available under the terms and conditions of the BSD License
@@ -132,6 +132,84 @@ HashUpdate (
   return EFI_SUCCESS;
 }
 
+/**
+  Hash sequence complete without extending any PCR.
+
+  @param HashHandle    Hash handle.
+  @param DataToHash    Data to be hashed.
+  @param DataToHashLen Data size.
+  @param DigestList    Digest list.
+
+  @retval EFI_SUCCESS     Hash sequence complete and DigestList is returned.
+**/
+EFI_STATUS
+EFIAPI
+HashComplete (
+  IN HASH_HANDLE         HashHandle,
+  IN VOID                *DataToHash,
+  IN UINTN               DataToHashLen,
+  OUT TPML_DIGEST_VALUES *DigestList
+  )
+{
+  UINT8            *Buffer;
+  UINT64           HashLen;
+  TPM2B_MAX_BUFFER HashBuffer;
+  EFI_STATUS       Status;
+  TPM_ALG_ID       AlgoId;
+  TPM2B_DIGEST     Result;
+
+  AlgoId = Tpm2GetAlgoFromHashMask ();
+
+  Buffer = (UINT8 *)(UINTN)DataToHash;
+  for (HashLen = DataToHashLen; HashLen > sizeof(HashBuffer.buffer); HashLen -= sizeof(HashBuffer.buffer)) {
+
+    HashBuffer.size = sizeof(HashBuffer.buffer);
+    CopyMem(HashBuffer.buffer, Buffer, sizeof(HashBuffer.buffer));
+    Buffer += sizeof(HashBuffer.buffer);
+
+    Status = Tpm2SequenceUpdate((TPMI_DH_OBJECT)HashHandle, &HashBuffer);
+    if (EFI_ERROR(Status)) {
+      return EFI_DEVICE_ERROR;
+    }
+  }
+
+  //
+  // Last one
+  //
+  HashBuffer.size = (UINT16)HashLen;
+  CopyMem(HashBuffer.buffer, Buffer, (UINTN)HashLen);
+
+  ZeroMem(DigestList, sizeof(*DigestList));
+  DigestList->count = HASH_COUNT;
+
+  if (AlgoId == TPM_ALG_NULL) {
+    //
+    // TPM_RH_NULL returns the digests of all the PCR banks without extending any PCR.
+    //
+    Status = Tpm2EventSequenceComplete (
+               TPM_RH_NULL,
+               (TPMI_DH_OBJECT)HashHandle,
+               &HashBuffer,
+               DigestList
+               );
+  } else {
+    Status = Tpm2SequenceComplete (
+               (TPMI_DH_OBJECT)HashHandle,
+               &HashBuffer,
+               &Result
+               );
+    if (!EFI_ERROR(Status)) {
+      DigestList->count = 1;
+      DigestList->digests[0].hashAlg = AlgoId;
+      CopyMem (&DigestList->digests[0].digest, Result.buffer, Result.size);
+    }
+  }
+  if (EFI_ERROR(Status)) {
+    return EFI_DEVICE_ERROR;
+  }
+  return EFI_SUCCESS;
+}
+
 /**
   Hash sequence complete and extend to PCR.
 
@@ -29,6 +29,8 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include <Library/Tpm2CommandLib.h>
 #include <Library/HashLib.h>
 
+#include "Tcg2Dxe.h"
+
 UINTN  mTcg2DxeImageSize = 0;
 
 /**
@@ -413,7 +415,16 @@ MeasurePeImageAndExtend (
   //
   // 17.  Finalize the SHA hash.
   //
-  Status = HashCompleteAndExtend (HashHandle, PCRIndex, NULL, 0, DigestList);
+  Status = HashComplete (HashHandle, NULL, 0, DigestList);
+  if (EFI_ERROR (Status)) {
+    goto Finish;
+  }
+
+  //
+  // The image may run as soon as it is measured, so its PCR extend is never
+  // deferred.
+  //
+  Status = TcgDxeExtendPcrNow (PCRIndex, DigestList);
   if (EFI_ERROR (Status)) {
     goto Finish;
   }
@@ -25,6 +25,7 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include <Guid/EventExitBootServiceFailed.h>
 #include <Guid/ImageAuthentication.h>
 #include <Guid/TpmInstance.h>
+#include <Guid/IdleLoopEvent.h>
 
 #include <Protocol/DevicePath.h>
 #include <Protocol/MpService.h>
@@ -50,7 +51,11 @@ WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 #include <Library/ReportStatusCodeLib.h>
 #include <Library/Tcg2PhysicalPresenceLib.h>
 
-#define PERF_ID_TCG2_DXE  0x3120
+#include "Tcg2Dxe.h"
+
+#define PERF_ID_TCG2_DXE                   0x3120
+#define PERF_ID_TCG2_DXE_MEASURE_PE_IMAGE  0x3122
+#define PERF_ID_TCG2_DXE_PCR_EXTEND        0x3124
 
 typedef struct {
   CHAR16                                 *VariableName;
@@ -82,6 +87,11 @@ typedef struct {
   BOOLEAN                           EventLogTruncated;
 } TCG_EVENT_LOG_AREA_STRUCT;
 
+typedef struct {
+  TPMI_DH_PCR                       PcrIndex;
+  TPML_DIGEST_VALUES                DigestList;
+} TCG_PCR_EXTEND_ENTRY;
+
 typedef struct _TCG_DXE_DATA {
   EFI_TCG2_BOOT_SERVICE_CAPABILITY  BsCap;
   TCG_EVENT_LOG_AREA_STRUCT         EventLogAreaStruct[TCG_EVENT_LOG_AREA_COUNT_MAX];
@@ -119,6 +129,17 @@ VARIABLE_TYPE  mVariableType[] = {
 
 EFI_HANDLE mImageHandle;
 
+//
+// Ring buffer of the PCR extends deferred by TcgDxeExtendPcr(), oldest first.
+// It is only allocated when PcdTcg2PcrExtendQueueSize is not 0.
+//
+TCG_PCR_EXTEND_ENTRY  *mPcrExtendQueue      = NULL;
+UINTN                 mPcrExtendQueueSize   = 0;
+UINTN                 mPcrExtendQueueHead   = 0;
+UINTN                 mPcrExtendQueueCount  = 0;
+UINTN                 mPcrExtendDeferred    = 0;
+UINTN                 mPcrExtendDoneInIdle  = 0;
+
 /**
   Measure PE image into TPM log based on the authenticode image hashing in
   PE/COFF Specification 8.0 Appendix A.
@@ -146,6 +167,201 @@ MeasurePeImageAndExtend (
   OUT TPML_DIGEST_VALUES        *DigestList
   );
 
+/**
+  Extend the PCR of the oldest deferred PCR extend and remove it from the queue.
+
+  If the extend fails, the TPM is disabled and the whole queue is dropped.
+
+  @retval EFI_SUCCESS       The extend was done, or the queue is empty.
+  @retval EFI_DEVICE_ERROR  The extend failed.
+**/
+EFI_STATUS
+TcgDxeExtendQueuedPcr (
+  VOID
+  )
+{
+  EFI_STATUS                        Status;
+  EFI_TPL                           OldTpl;
+  TCG_PCR_EXTEND_ENTRY              *Entry;
+
+  //
+  // The entry is removed and extended in the same critical region, so that a
+  // flush from a notification function can not reorder the extends.
+  //
+  Status = EFI_SUCCESS;
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  if (mPcrExtendQueueCount != 0) {
+    Entry  = &mPcrExtendQueue[mPcrExtendQueueHead];
+    Status = Tpm2PcrExtend (Entry->PcrIndex, &Entry->DigestList);
+    mPcrExtendQueueHead = (mPcrExtendQueueHead + 1) % mPcrExtendQueueSize;
+    mPcrExtendQueueCount--;
+    if (EFI_ERROR (Status)) {
+      mPcrExtendQueueCount = 0;
+    }
+  }
+  gBS->RestoreTPL (OldTpl);
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((EFI_D_ERROR, "TcgDxeExtendQueuedPcr - %r. Disable TPM.\n", Status));
+    mTcgDxeData.BsCap.TPMPresentFlag = FALSE;
+    REPORT_STATUS_CODE (
+      EFI_ERROR_CODE | EFI_ERROR_MINOR,
+      (PcdGet32 (PcdStatusCodeSubClassTpmDevice) | EFI_P_EC_INTERFACE_ERROR)
+      );
+    return EFI_DEVICE_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Extend the PCRs of all the deferred PCR extends.
+
+  It must be called before anything may read the PCRs, so that the PCR values
+  always match the event log.
+
+  @retval EFI_SUCCESS       The queue is empty.
+  @retval EFI_DEVICE_ERROR  An extend failed, the TPM is disabled.
+**/
+EFI_STATUS
+TcgDxeFlushPcrExtendQueue (
+  VOID
+  )
+{
+  EFI_STATUS                        Status;
+
+  if (mPcrExtendQueueCount == 0) {
+    return EFI_SUCCESS;
+  }
+
+  PERF_START_EX (mImageHandle, "PcrExtend", "Tcg2Dxe", 0, PERF_ID_TCG2_DXE_PCR_EXTEND);
+  Status = EFI_SUCCESS;
+  while (!EFI_ERROR (Status) && (mPcrExtendQueueCount != 0)) {
+    Status = TcgDxeExtendQueuedPcr ();
+  }
+  PERF_END_EX (mImageHandle, "PcrExtend", "Tcg2Dxe", 0, PERF_ID_TCG2_DXE_PCR_EXTEND + 1);
+
+  return Status;
+}
+
+/**
+  Extend a PCR with a digest list.
+
+  If PcdTcg2PcrExtendQueueSize is not 0, the extend is only queued and done
+  later by TcgDxeFlushPcrExtendQueue() or in the idle loop of the DXE core.
+  When the queue is full, only the oldest deferred extend is done to make room,
+  outside of the critical region.
+
+  @param[in] PcrIndex     PCR to be extended.
+  @param[in] DigestList   Digest list to extend the PCR with.
+
+  @retval EFI_SUCCESS       The PCR is extended, or the extend is queued.
+  @retval EFI_DEVICE_ERROR  The extend failed.
+**/
+EFI_STATUS
+TcgDxeExtendPcr (
+  IN TPMI_DH_PCR                    PcrIndex,
+  IN TPML_DIGEST_VALUES             *DigestList
+  )
+{
+  EFI_STATUS                        Status;
+  EFI_TPL                           OldTpl;
+  TCG_PCR_EXTEND_ENTRY              *Entry;
+
+  if (mPcrExtendQueue == NULL) {
+    return Tpm2PcrExtend (PcrIndex, DigestList);
+  }
+
+  for (;;) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    if (mPcrExtendQueueCount < mPcrExtendQueueSize) {
+      Entry = &mPcrExtendQueue[(mPcrExtendQueueHead + mPcrExtendQueueCount) % mPcrExtendQueueSize];
+      Entry->PcrIndex = PcrIndex;
+      CopyMem (&Entry->DigestList, DigestList, sizeof (*DigestList));
+      mPcrExtendQueueCount++;
+      mPcrExtendDeferred++;
+      gBS->RestoreTPL (OldTpl);
+      return EFI_SUCCESS;
+    }
+    gBS->RestoreTPL (OldTpl);
+
+    //
+    // The queue is full. A notification function may have made room in the
+    // meantime, otherwise the oldest extend is done.
+    //
+    Status = TcgDxeExtendQueuedPcr ();
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+}
+
+/**
+  Extend a PCR with a digest list before returning.
+
+  The deferred PCR extends are done first, so that the PCRs are extended in the
+  order of the event log. It is used for the PE/COFF images, which must be
+  measured into the TPM before they run.
+
+  @param[in] PcrIndex     PCR to be extended.
+  @param[in] DigestList   Digest list to extend the PCR with.
+
+  @retval EFI_SUCCESS       The PCR is extended.
+  @retval EFI_DEVICE_ERROR  The extend failed.
+**/
+EFI_STATUS
+TcgDxeExtendPcrNow (
+  IN TPMI_DH_PCR                    PcrIndex,
+  IN TPML_DIGEST_VALUES             *DigestList
+  )
+{
+  EFI_STATUS                        Status;
+
+  Status = TcgDxeFlushPcrExtendQueue ();
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return Tpm2PcrExtend (PcrIndex, DigestList);
+}
+
+/**
+  Hash data and extend to PCR, the extend being deferred as with TcgDxeExtendPcr().
+
+  @param[in]  PcrIndex      PCR to be extended.
+  @param[in]  DataToHash    Data to be hashed.
+  @param[in]  DataToHashLen Data size.
+  @param[out] DigestList    Digest list.
+
+  @retval EFI_SUCCESS     Hash data and DigestList is returned.
+**/
+EFI_STATUS
+TcgDxeHashAndExtend (
+  IN  TPMI_DH_PCR                   PcrIndex,
+  IN  VOID                          *DataToHash,
+  IN  UINTN                         DataToHashLen,
+  OUT TPML_DIGEST_VALUES            *DigestList
+  )
+{
+  EFI_STATUS                        Status;
+  HASH_HANDLE                       HashHandle;
+
+  if (mPcrExtendQueue == NULL) {
+    return HashAndExtend (PcrIndex, DataToHash, DataToHashLen, DigestList);
+  }
+
+  Status = HashStart (&HashHandle);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+  Status = HashComplete (HashHandle, DataToHash, DataToHashLen, DigestList);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return TcgDxeExtendPcr (PcrIndex, DigestList);
+}
+
 /**
 
   This function dump raw data.
@@ -728,6 +944,11 @@ Tcg2GetEventLog (
     return EFI_INVALID_PARAMETER;
   }
 
+  //
+  // The caller may check the event log against the PCRs.
+  //
+  TcgDxeFlushPcrExtendQueue ();
+
   if (!mTcgDxeData.BsCap.TPMPresentFlag) {
     if (EventLogLocation != NULL) {
       *EventLogLocation = 0;
@@ -1051,68 +1272,72 @@ TcgDxeLogHashEvent (
   TCG_PCR_EVENT2                    TcgPcrEvent2;
   UINT8                             *DigestBuffer;
   UINT32                            *EventSizePtr;
+  BOOLEAN                           LogEvent[TCG_EVENT_LOG_AREA_COUNT_MAX];
 
   DEBUG ((EFI_D_INFO, "SupportedEventLogs - 0x%08x\n", mTcgDxeData.BsCap.SupportedEventLogs));
 
-  RetStatus = EFI_SUCCESS;
+  //
+  // Build the event header of every log format first, so that the event is
+  // appended to all the event logs in a single critical region.
+  //
+  DigestBuffer = (UINT8 *)&TcgPcrEvent2.Digest;
   for (Index = 0; Index < sizeof(mTcg2EventInfo)/sizeof(mTcg2EventInfo[0]); Index++) {
+    LogEvent[Index] = FALSE;
     if ((mTcgDxeData.BsCap.SupportedEventLogs & mTcg2EventInfo[Index].LogFormat) != 0) {
       DEBUG ((EFI_D_INFO, "  LogFormat - 0x%08x\n", mTcg2EventInfo[Index].LogFormat));
       switch (mTcg2EventInfo[Index].LogFormat) {
       case EFI_TCG2_EVENT_LOG_FORMAT_TCG_1_2:
         Status = GetDigestFromDigestList (TPM_ALG_SHA1, DigestList, &NewEventHdr->Digest);
-        if (!EFI_ERROR (Status)) {
-          //
-          // Enter critical region
-          //
-          OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
-          Status = TcgDxeLogEvent (
-                     mTcg2EventInfo[Index].LogFormat,
-                     NewEventHdr,
-                     sizeof(TCG_PCR_EVENT_HDR),
-                     NewEventData,
-                     NewEventHdr->EventSize
-                     );
-          if (Status != EFI_SUCCESS) {
-            RetStatus = Status;
-          }
-          gBS->RestoreTPL (OldTpl);
-          //
-          // Exit critical region
-          //
-        }
+        LogEvent[Index] = (BOOLEAN) !EFI_ERROR (Status);
         break;
       case EFI_TCG2_EVENT_LOG_FORMAT_TCG_2:
         ZeroMem (&TcgPcrEvent2, sizeof(TcgPcrEvent2));
         TcgPcrEvent2.PCRIndex = NewEventHdr->PCRIndex;
         TcgPcrEvent2.EventType = NewEventHdr->EventType;
-        DigestBuffer = (UINT8 *)&TcgPcrEvent2.Digest;
         EventSizePtr = CopyDigestListToBuffer (DigestBuffer, DigestList, mTcgDxeData.BsCap.ActivePcrBanks);
         CopyMem (EventSizePtr, &NewEventHdr->EventSize, sizeof(NewEventHdr->EventSize));
-
-        //
-        // Enter critical region
-        //
-        OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
-        Status = TcgDxeLogEvent (
-                   mTcg2EventInfo[Index].LogFormat,
-                   &TcgPcrEvent2,
-                   sizeof(TcgPcrEvent2.PCRIndex) + sizeof(TcgPcrEvent2.EventType) + GetDigestListBinSize (DigestBuffer) + sizeof(TcgPcrEvent2.EventSize),
-                   NewEventData,
-                   NewEventHdr->EventSize
-                   );
-        if (Status != EFI_SUCCESS) {
-          RetStatus = Status;
-        }
-        gBS->RestoreTPL (OldTpl);
-        //
-        // Exit critical region
-        //
+        LogEvent[Index] = TRUE;
         break;
       }
     }
   }
 
+  RetStatus = EFI_SUCCESS;
+
+  //
+  // Enter critical region
+  //
+  OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  for (Index = 0; Index < sizeof(mTcg2EventInfo)/sizeof(mTcg2EventInfo[0]); Index++) {
+    if (!LogEvent[Index]) {
+      continue;
+    }
+    if (mTcg2EventInfo[Index].LogFormat == EFI_TCG2_EVENT_LOG_FORMAT_TCG_1_2) {
+      Status = TcgDxeLogEvent (
+                 mTcg2EventInfo[Index].LogFormat,
+                 NewEventHdr,
+                 sizeof(TCG_PCR_EVENT_HDR),
+                 NewEventData,
+                 NewEventHdr->EventSize
+                 );
+    } else {
+      Status = TcgDxeLogEvent (
+                 mTcg2EventInfo[Index].LogFormat,
+                 &TcgPcrEvent2,
+                 sizeof(TcgPcrEvent2.PCRIndex) + sizeof(TcgPcrEvent2.EventType) + GetDigestListBinSize (DigestBuffer) + sizeof(TcgPcrEvent2.EventSize),
+                 NewEventData,
+                 NewEventHdr->EventSize
+                 );
+    }
+    if (Status != EFI_SUCCESS) {
+      RetStatus = Status;
+    }
+  }
+  gBS->RestoreTPL (OldTpl);
+  //
+  // Exit critical region
+  //
+
   return RetStatus;
 }
 
@@ -1142,13 +1367,14 @@ TcgDxeHashLogExtendEvent (
   )
 {
   EFI_STATUS                        Status;
+  EFI_STATUS                        FlushStatus;
   TPML_DIGEST_VALUES                DigestList;
 
   if (!mTcgDxeData.BsCap.TPMPresentFlag) {
     return EFI_DEVICE_ERROR;
   }
 
-  Status = HashAndExtend (
+  Status = TcgDxeHashAndExtend (
              NewEventHdr->PCRIndex,
              HashData,
              (UINTN)HashDataLen,
@@ -1158,9 +1384,23 @@ TcgDxeHashLogExtendEvent (
     if ((Flags & EFI_TCG2_EXTEND_ONLY) == 0) {
       Status = TcgDxeLogHashEvent (&DigestList, NewEventHdr, NewEventData);
     }
+
+    //
+    // The separator ends the pre-OS measurements of the PCR, so it is never
+    // left pending.
+    //
+    if (NewEventHdr->EventType == EV_SEPARATOR) {
+      FlushStatus = TcgDxeFlushPcrExtendQueue ();
+      if (EFI_ERROR (FlushStatus)) {
+        Status = FlushStatus;
+      }
+    }
   }
 
-  if (Status == EFI_DEVICE_ERROR) {
+  //
+  // The TPM may already be disabled by a failed deferred PCR extend.
+  //
+  if ((Status == EFI_DEVICE_ERROR) && mTcgDxeData.BsCap.TPMPresentFlag) {
     DEBUG ((EFI_D_ERROR, "TcgDxeHashLogExtendEvent - %r. Disable TPM.\n", Status));
     mTcgDxeData.BsCap.TPMPresentFlag = FALSE;
     REPORT_STATUS_CODE (
@@ -1227,18 +1467,20 @@ Tcg2HashLogExtendEvent (
   NewEventHdr.EventType = Event->Header.EventType;
   NewEventHdr.EventSize = Event->Size - sizeof(UINT32) - Event->Header.HeaderSize;
   if ((Flags & PE_COFF_IMAGE) != 0) {
+    PERF_START_EX (mImageHandle, "MeasurePe", "Tcg2Dxe", 0, PERF_ID_TCG2_DXE_MEASURE_PE_IMAGE);
     Status = MeasurePeImageAndExtend (
                NewEventHdr.PCRIndex,
                DataToHash,
                (UINTN)DataToHashLen,
                &DigestList
                );
+    PERF_END_EX (mImageHandle, "MeasurePe", "Tcg2Dxe", 0, PERF_ID_TCG2_DXE_MEASURE_PE_IMAGE + 1);
     if (!EFI_ERROR (Status)) {
       if ((Flags & EFI_TCG2_EXTEND_ONLY) == 0) {
         Status = TcgDxeLogHashEvent (&DigestList, &NewEventHdr, Event->Event);
       }
     }
-    if (Status == EFI_DEVICE_ERROR) {
+    if ((Status == EFI_DEVICE_ERROR) && mTcgDxeData.BsCap.TPMPresentFlag) {
       DEBUG ((EFI_D_ERROR, "MeasurePeImageAndExtend - %r. Disable TPM.\n", Status));
       mTcgDxeData.BsCap.TPMPresentFlag = FALSE;
       REPORT_STATUS_CODE (
@@ -1304,6 +1546,14 @@ Tcg2SubmitCommand (
     return EFI_INVALID_PARAMETER;
   }
 
+  //
+  // The command may read the PCRs.
+  //
+  Status = TcgDxeFlushPcrExtendQueue ();
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   Status = Tpm2SubmitCommand (
              InputParameterBlockSize,
              InputParameterBlock,
@@ -2332,6 +2582,17 @@ OnReadyToBoot (
     }
   }
 
+  //
+  // The boot option may read the PCRs.
+  //
+  Status = TcgDxeFlushPcrExtendQueue ();
+  if (EFI_ERROR (Status)) {
+    DEBUG ((EFI_D_ERROR, "Deferred PCR extends failed. Error!\n"));
+  }
+  if (mPcrExtendQueue != NULL) {
+    DEBUG ((EFI_D_INFO, "Tcg2Dxe deferred PCR extends - %d, done in idle loop - %d\n", mPcrExtendDeferred, mPcrExtendDoneInIdle));
+  }
+
   DEBUG ((EFI_D_INFO, "TPM2 Tcg2Dxe Measure Data when ReadyToBoot\n"));
   //
   // Increase boot attempt counter.
@@ -2379,6 +2640,11 @@ OnExitBootServices (
   if (EFI_ERROR (Status)) {
     DEBUG ((EFI_D_ERROR, "%a not Measured. Error!\n", EFI_EXIT_BOOT_SERVICES_SUCCEEDED));
   }
+
+  Status = TcgDxeFlushPcrExtendQueue ();
+  if (EFI_ERROR (Status)) {
+    DEBUG ((EFI_D_ERROR, "Deferred PCR extends failed. Error!\n"));
+  }
 }
 
 /**
@@ -2410,6 +2676,33 @@ OnExitBootServicesFailed (
     DEBUG ((EFI_D_ERROR, "%a not Measured. Error!\n", EFI_EXIT_BOOT_SERVICES_FAILED));
   }
 
+  Status = TcgDxeFlushPcrExtendQueue ();
+  if (EFI_ERROR (Status)) {
+    DEBUG ((EFI_D_ERROR, "Deferred PCR extends failed. Error!\n"));
+  }
+}
+
+/**
+  Idle loop event notification handler.
+
+  Do one deferred PCR extend while the DXE core has nothing else to do.
+
+  @param[in]  Event     Event whose notification function is being invoked
+  @param[in]  Context   Pointer to the notification function's context
+
+**/
+VOID
+EFIAPI
+OnIdleLoop (
+  IN      EFI_EVENT                 Event,
+  IN      VOID                      *Context
+  )
+{
+  if (mPcrExtendQueueCount != 0) {
+    if (!EFI_ERROR (TcgDxeExtendQueuedPcr ())) {
+      mPcrExtendDoneInIdle++;
+    }
+  }
 }
 
 /**
@@ -2572,6 +2865,25 @@ DriverEntry (
     Status = SetupEventLog ();
     ASSERT_EFI_ERROR (Status);
 
+    //
+    // Defer the PCR extends, and do them in the idle loop of the DXE core.
+    //
+    if (PcdGet32 (PcdTcg2PcrExtendQueueSize) != 0) {
+      mPcrExtendQueue = AllocatePool (PcdGet32 (PcdTcg2PcrExtendQueueSize) * sizeof (TCG_PCR_EXTEND_ENTRY));
+      if (mPcrExtendQueue != NULL) {
+        mPcrExtendQueueSize = PcdGet32 (PcdTcg2PcrExtendQueueSize);
+        Status = gBS->CreateEventEx (
+                        EVT_NOTIFY_SIGNAL,
+                        TPL_CALLBACK,
+                        OnIdleLoop,
+                        NULL,
+                        &gIdleLoopEventGuid,
+                        &Event
+                        );
+        ASSERT_EFI_ERROR (Status);
+      }
+    }
+
     //
     // Measure handoff tables, Boot#### variables etc.
     //
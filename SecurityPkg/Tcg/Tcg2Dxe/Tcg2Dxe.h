@@ -0,0 +1,58 @@
+/** @file
+  The internal header file shared by the source files of the Tcg2 DXE driver.
+
+Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
+This program and the accompanying materials 
+are licensed and made available under the terms and conditions of the BSD License 
+which accompanies this distribution.  The full text of the license may be found at 
+http://opensource.org/licenses/bsd-license.php
+
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS, 
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#ifndef __TCG2_DXE_H__
+#define __TCG2_DXE_H__
+
+#include <PiDxe.h>
+#include <IndustryStandard/Tpm20.h>
+
+/**
+  Extend a PCR with a digest list.
+
+  If PcdTcg2PcrExtendQueueSize is not 0, the extend is only queued and done
+  later by TcgDxeFlushPcrExtendQueue() or in the idle loop of the DXE core.
+
+  @param[in] PcrIndex     PCR to be extended.
+  @param[in] DigestList   Digest list to extend the PCR with.
+
+  @retval EFI_SUCCESS       The PCR is extended, or the extend is queued.
+  @retval EFI_DEVICE_ERROR  The extend failed.
+**/
+EFI_STATUS
+TcgDxeExtendPcr (
+  IN TPMI_DH_PCR                    PcrIndex,
+  IN TPML_DIGEST_VALUES             *DigestList
+  );
+
+/**
+  Extend a PCR with a digest list before returning.
+
+  The deferred PCR extends are done first, so that the PCRs are extended in the
+  order of the event log. It is used for the PE/COFF images, which must be
+  measured into the TPM before they run.
+
+  @param[in] PcrIndex     PCR to be extended.
+  @param[in] DigestList   Digest list to extend the PCR with.
+
+  @retval EFI_SUCCESS       The PCR is extended.
+  @retval EFI_DEVICE_ERROR  The extend failed.
+**/
+EFI_STATUS
+TcgDxeExtendPcrNow (
+  IN TPMI_DH_PCR                    PcrIndex,
+  IN TPML_DIGEST_VALUES             *DigestList
+  );
+
+#endif  // __TCG2_DXE_H__